@@ -4,6 +4,7 @@
 #include <memory>
 #include <iostream>
 
+#include "lib/bench/bench.hpp"
 #include "lib/utils.hpp"
 
 #include "crc/crc_test.hpp"
@@ -49,16 +50,28 @@ int main(void) {
 	/* */
 	mct::compare_output("crc32_intel_asm", calc_with_boost, calc_caller<crc32_intel_asm>);
 	mct::compare_output("crc32_intel", calc_with_boost, calc_caller<crc32_intel_asm>);
+	mct::compare_output("crc32c", calc_with_boost, calc_caller<crc32c>);
+	for (int level = MEAVE_CPU_SCALAR; level <= meave_cpu_level(); ++level) {
+		const auto f = crc32c_impl(static_cast<enum meave_cpu_level>(level));
+		mct::compare_output(meave_cpu_level_name(static_cast<enum meave_cpu_level>(level)), calc_with_boost, [f](const ::uint8_t *arr, const ::size_t len) {
+			return f(arr, len, CRC::INIT_REM) ^ CRC::FINAL_XOR;
+		});
+	}
 	$::cerr << $::endl;
 	$::cerr << $::endl;
 	/* */
-	mct::measure_speed("calc_with_boost", calc_with_boost);
-	$::cerr << $::endl;
-	mct::measure_speed("sse42_crc32", sse42_crc32);
-	$::cerr << $::endl;
-	mct::measure_speed("crc32_intel_asm", calc_caller<crc32_intel_asm>);
-	$::cerr << $::endl;
-	mct::measure_speed("crc32_intel", calc_caller<crc32_intel>);
+	meave::bench::Runner runner;
+	mct::measure_speed(runner, "calc_with_boost", calc_with_boost);
+	mct::measure_speed(runner, "sse42_crc32", sse42_crc32);
+	mct::measure_speed(runner, "crc32_intel_asm", calc_caller<crc32_intel_asm>);
+	mct::measure_speed(runner, "crc32_intel", calc_caller<crc32_intel>);
+	mct::measure_speed(runner, "crc32c", calc_caller<crc32c>);
+	for (int level = MEAVE_CPU_SCALAR; level <= meave_cpu_level(); ++level) {
+		const auto f = crc32c_impl(static_cast<enum meave_cpu_level>(level));
+		mct::measure_speed(runner, ($::string("crc32c.") + meave_cpu_level_name(static_cast<enum meave_cpu_level>(level))).c_str(), [f](const ::uint8_t *arr, const ::size_t len) {
+			return f(arr, len, CRC::INIT_REM) ^ CRC::FINAL_XOR;
+		});
+	}
 	/* */
-	return 0;
+	return runner.finish() ? 1 : 0;
 }
@@ -0,0 +1,63 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
+
+#include "lib/cpu.h"
+
+#include "funcs.h"
+
+/*
+ * CRC-32C (Castagnoli, reflected polynomial 0x82F63B78) of the crc32
+ *   instruction, with a table-driven fallback for CPUs without SSE4.2.
+ *   Like crc32_intel_asm(), no initial or final XOR: crc32c(p, len, ~0) ^ ~0
+ *   is the usual checksum.
+ */
+
+static uint32_t crc32c_table[256];
+
+__attribute__((constructor))
+static void crc32c_init_table(void) {
+	uint32_t byte;
+	for (byte = 0; byte < 256; ++byte) {
+		uint32_t crc = byte;
+		int bit;
+		for (bit = 0; bit < 8; ++bit)
+			crc = crc & 1 ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+		crc32c_table[byte] = crc;
+	}
+}
+
+uint32_t crc32c_scalar(const uint8_t *arr, size_t len, uint32_t val) {
+	for (; len; --len, ++arr)
+		val = crc32c_table[(val ^ *arr) & 0xFF] ^ (val >> 8);
+	return val;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(const uint8_t *arr, size_t len, uint32_t val) {
+	for (; len && ((uintptr_t)arr & 7); --len, ++arr)
+		val = _mm_crc32_u8(val, *arr);
+	uint64_t val64 = val;
+	for (; len >= 8; len -= 8, arr += 8)
+		val64 = _mm_crc32_u64(val64, *(const uint64_t*)arr);
+	val = val64;
+	for (; len; --len, ++arr)
+		val = _mm_crc32_u8(val, *arr);
+	return val;
+}
+
+typedef uint32_t (*crc32c_kernel)(const uint8_t*, size_t, uint32_t);
+
+crc32c_kernel crc32c_impl(const enum meave_cpu_level level) {
+	return level >= MEAVE_CPU_SSE42 ? crc32c_sse42 : crc32c_scalar;
+}
+
+uint32_t crc32c(const uint8_t *arr, size_t len, uint32_t val) {
+	static crc32c_kernel kernel = NULL;
+	crc32c_kernel k = __atomic_load_n(&kernel, __ATOMIC_RELAXED);
+	if (__builtin_expect(!k, 0)) {
+		k = crc32c_impl(meave_cpu_level());
+		__atomic_store_n(&kernel, k, __ATOMIC_RELAXED);
+	}
+	return k(arr, len, val);
+}
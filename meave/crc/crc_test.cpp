@@ -3,7 +3,6 @@
 #include <memory>
 #include <random>
 
-#include "lib/gettime.hpp"
 #include "lib/utils.hpp"
 #include "crc/crc_test.hpp"
 
@@ -44,19 +43,10 @@ void compare_output(const char *name, CRCFunc f_expected, CRCFunc f_real) {
 	}
 }
 
-void measure_speed(const char *name, CRCFunc f) {
-	for (::size_t suff = 0; suff < MAX_SUFF_LEN; ++suff) {
-		const ::size_t len = LEN + suff;
-		const auto time_beg = meave::getrealtime();
-		const auto res = f(&arr[0], len);
-		const auto time_end = meave::getrealtime();
-
-		$::cerr << "Speed: " << name
-			<< "; suff_len: " << suff
-			<< "; res: " << res
-			<< "; time: " << (time_end - time_beg)
-			<< "s;" << $::endl;
-	}
+void measure_speed(bench::Runner &runner, const char *name, CRCFunc f) {
+	runner.run(name, [&]() {
+		bench::do_not_optimize(f(&arr[0], LEN));
+	}, bench::Throughput::bytes(LEN));
 }
 
 } } } /* meave::crc::test */
@@ -3,13 +3,15 @@
 
 #	include <functional>
 
+#	include "lib/bench/bench.hpp"
+
 namespace meave { namespace crc { namespace test {
 
 typedef std::function<::uint32_t(const ::uint8_t*, ::size_t)> CRCFunc;
 
 void init_comparisions(void);
 void compare_output(const char *name, CRCFunc f_expected, CRCFunc f_real);
-void measure_speed(const char *name, CRCFunc f);
+void measure_speed(bench::Runner &runner, const char *name, CRCFunc f);
 
 } } } /* meave::crc::test */
 
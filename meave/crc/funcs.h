@@ -1,12 +1,21 @@
 #ifndef MEAVE_CRC_FUNCS_H
 #	define MEAVE_CRC_FUNCS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "lib/cpu.h"
+
 unsigned crc32_intel_asm(const unsigned char *arr, const unsigned long len, const unsigned val) __attribute__((pure));
 unsigned crc32_threesome_kernel(const unsigned char *arr, const unsigned long len_div_24, const unsigned val, const unsigned len_div_3) __attribute__((pure));
 uint32_t sse42_crc32(const uint8_t *bytes, const size_t len) __attribute__((pure));
 
 unsigned crc32_intel(const uint8_t *arr, size_t len, unsigned val) __attribute__((pure));
 
+/* crc32c.c: CRC-32C by the best kernel of the CPU (lib/cpu.h), and the kernels. */
+uint32_t crc32c(const uint8_t *arr, size_t len, uint32_t val) __attribute__((pure));
+uint32_t crc32c_scalar(const uint8_t *arr, size_t len, uint32_t val) __attribute__((pure));
+uint32_t crc32c_sse42(const uint8_t *arr, size_t len, uint32_t val) __attribute__((pure));
+uint32_t (*crc32c_impl(const enum meave_cpu_level level))(const uint8_t*, size_t, uint32_t);
+
 #endif // MEAVE_CRC_FUNCS_H
@@ -4,6 +4,7 @@
 #include "funcs.h"
 
 #include <stdio.h>
+__attribute__((target("sse4.2")))
 uint32_t sse42_crc32(const uint8_t *bytes, const size_t len) {
 	uint32_t hash = 0;
 	size_t i = 0;
@@ -15,7 +16,6 @@ uint32_t sse42_crc32(const uint8_t *bytes, const size_t len) {
 
 unsigned crc32_intel(const uint8_t *arr, size_t len, unsigned val) {
 	const size_t unalign_bytes = (~(uintptr_t)arr + 1) & 7;
-	fprintf(stderr, "%p: %ju %ju\n", arr, ((uintmax_t)(uintptr_t)arr) & 7, (uintmax_t)unalign_bytes);
 	if (__builtin_expect(unalign_bytes, 0)) {
 		val = crc32_intel_asm(arr, unalign_bytes, val);
 		len -= unalign_bytes;
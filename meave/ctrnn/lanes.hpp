@@ -0,0 +1,157 @@
+#ifndef MEAVE_CTRNN_LANES_HPP
+#	define MEAVE_CTRNN_LANES_HPP
+
+#	include "meave/commons.hpp"
+#	include "meave/ctrnn/neuron.hpp"
+#	include "meave/lib/cpu.hpp"
+#	include "meave/lib/simd/math.hpp"
+#	include "meave/lib/simd/vec.hpp"
+
+namespace meave { namespace ctrnn {
+
+/**
+ * Fully connected CTRNN simulated in LANES independent copies at once, e.g.
+ *   one genome in different scenarios. States are stored lane-minor
+ *   (v[unit][lane]) and computed by simd::Vec, the sigmoid too. The loops
+ *   are compiled for every level of meave/lib/cpu.hpp and run by the
+ *   widest one the CPU has, whatever the -m flags.
+ * Every lane computes what NNCalc computes, up to the accuracy of
+ *   simd::exp() (2 ulp) and rounding of FMA.
+ */
+template<typename Float, uns LANES = 8>
+class NNLanes {
+public:
+	enum : uns { LANES_NUM = LANES };
+
+	typedef Float Lanes[LANES];
+
+private:
+	typedef void (*ValKernel)(const NNLanes&, const Lanes[], const Float[], const Lanes[], const Float[], Lanes[]);
+	typedef void (*SigmKernel)(const NNLanes&, const Lanes[], const Float[], Lanes[]);
+
+	const uns units_num_;
+	const Float time_step_;
+
+	/**
+	 * V is a simd::Vec of at most LANES lanes, LANES / V::LANES of them
+	 *   make a Lanes.
+	 */
+	template<typename V>
+	MEAVE_SIMD_INLINE void val_body(const Lanes y[], const Float tc[], const Lanes ei[], const Float w[], Lanes v[]) const noexcept {
+		enum : uns { W = V::LANES, H = LANES / W };
+		for (uns i = 0; i < units_num_; ++i) {
+			V sum[H];
+			for (auto &$: sum)
+				$ = V::zero();
+			for (uns j = 0; j < units_num_; ++j) {
+				const V w_ij = w[i * units_num_ + j];
+				for (uns h = 0; h < H; ++h)
+					sum[h] = fma(w_ij, V::load(&y[j][h * W]), sum[h]);
+			}
+
+			const V k = time_step_ / tc[i];
+			for (uns h = 0; h < H; ++h) {
+				const V v_i = V::load(&v[i][h * W]);
+				fma(k, V::load(&ei[i][h * W]) - v_i + sum[h], v_i).store(&v[i][h * W]);
+			}
+		}
+	}
+
+	template<typename V>
+	MEAVE_SIMD_INLINE void sigm_body(const Lanes v[], const Float b[], Lanes y[]) const noexcept {
+		enum : uns { W = V::LANES, H = LANES / W };
+		for (uns i = 0; i < units_num_; ++i) {
+			for (uns h = 0; h < H; ++h)
+				sigmoid(V::load(&v[i][h * W]) + b[i]).store(&y[i][h * W]);
+		}
+	}
+
+	static void val_scalar(const NNLanes &nn, const Lanes y[], const Float tc[], const Lanes ei[], const Float w[], Lanes v[]) noexcept {
+		nn.val_body<simd::Native<Float, cpu::SCALAR, LANES>>(y, tc, ei, w, v);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_SSE42)
+	static void val_sse42(const NNLanes &nn, const Lanes y[], const Float tc[], const Lanes ei[], const Float w[], Lanes v[]) noexcept {
+		nn.val_body<simd::Native<Float, cpu::SSE42, LANES>>(y, tc, ei, w, v);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX2)
+	static void val_avx2(const NNLanes &nn, const Lanes y[], const Float tc[], const Lanes ei[], const Float w[], Lanes v[]) noexcept {
+		nn.val_body<simd::Native<Float, cpu::AVX2, LANES>>(y, tc, ei, w, v);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX512)
+	static void val_avx512(const NNLanes &nn, const Lanes y[], const Float tc[], const Lanes ei[], const Float w[], Lanes v[]) noexcept {
+		nn.val_body<simd::Native<Float, cpu::AVX512, LANES>>(y, tc, ei, w, v);
+	}
+
+	static void sigm_scalar(const NNLanes &nn, const Lanes v[], const Float b[], Lanes y[]) noexcept {
+		nn.sigm_body<simd::Native<Float, cpu::SCALAR, LANES>>(v, b, y);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_SSE42)
+	static void sigm_sse42(const NNLanes &nn, const Lanes v[], const Float b[], Lanes y[]) noexcept {
+		nn.sigm_body<simd::Native<Float, cpu::SSE42, LANES>>(v, b, y);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX2)
+	static void sigm_avx2(const NNLanes &nn, const Lanes v[], const Float b[], Lanes y[]) noexcept {
+		nn.sigm_body<simd::Native<Float, cpu::AVX2, LANES>>(v, b, y);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX512)
+	static void sigm_avx512(const NNLanes &nn, const Lanes v[], const Float b[], Lanes y[]) noexcept {
+		nn.sigm_body<simd::Native<Float, cpu::AVX512, LANES>>(v, b, y);
+	}
+
+	static const cpu::Kernels<ValKernel> &val_kernels() noexcept {
+		static const cpu::Kernels<ValKernel> $${{ &val_scalar, &val_sse42, &val_avx2, &val_avx512 }};
+		return $$;
+	}
+
+	static const cpu::Kernels<SigmKernel> &sigm_kernels() noexcept {
+		static const cpu::Kernels<SigmKernel> $${{ &sigm_scalar, &sigm_sse42, &sigm_avx2, &sigm_avx512 }};
+		return $$;
+	}
+
+public:
+	NNLanes(const UnitsNum<uns> &units_num, const TimeStep<Float> &time_step)
+	:	units_num_(*units_num)
+	,	time_step_(*time_step) {
+	}
+
+	uns units_num() const noexcept {
+		return units_num_;
+	}
+
+	/**
+	 * v[i] += time_step * (-v[i] + ei[i] + sum_j w[i*units_num + j] * y[j]) / tc[i]
+	 */
+	void val(const Lanes y[], const Float tc[], const Lanes ei[], const Float w[], Lanes v[]) const noexcept {
+		static const ValKernel kernel = val_kernels().impl();
+		kernel(*this, y, tc, ei, w, v);
+	}
+
+	/**
+	 * val() by the variant of level (e.g. to test it).
+	 */
+	void val(const Lanes y[], const Float tc[], const Lanes ei[], const Float w[], Lanes v[], const cpu::Level level) const noexcept {
+		val_kernels().impl(level)(*this, y, tc, ei, w, v);
+	}
+
+	/**
+	 * y[i] = sigmoid(v[i] + b[i])
+	 */
+	void sigm(const Lanes v[], const Float b[], Lanes y[]) const noexcept {
+		static const SigmKernel kernel = sigm_kernels().impl();
+		kernel(*this, v, b, y);
+	}
+
+	void sigm(const Lanes v[], const Float b[], Lanes y[], const cpu::Level level) const noexcept {
+		sigm_kernels().impl(level)(*this, v, b, y);
+	}
+};
+
+} } /* namespace ::meave::ctrnn */
+
+#endif // MEAVE_CTRNN_LANES_HPP
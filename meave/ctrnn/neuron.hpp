@@ -5,13 +5,19 @@
 
 #	include "meave/commons.hpp"
 #	include "meave/lib/math.hpp"
-#	include "meave/lib/simd.hpp"
+
+#	ifdef __AVX__
+#		include "meave/lib/simd.hpp"
+#	endif
 
 namespace meave { namespace ctrnn {
 
 PARAM_CLASS(TimeStep)
 
-template<typename Float>
+/**
+ * @tparam APPROX Whether sigmoid is computed by math::sigmoid_approx() .
+ */
+template<typename Float, bool APPROX = false>
 class NeuronCalc {
 protected:
 	const Float time_step_;
@@ -42,7 +48,7 @@ public:
 	}
 
 	Float sigm(const Float val, const Float bias) const noexcept {
-		return meave::math::sigmoid(bias + val);
+		return APPROX ? meave::math::sigmoid_approx(bias + val) : meave::math::sigmoid(bias + val);
 	}
 
 	template <typename ItY, typename ItW>
@@ -56,16 +62,27 @@ PARAM_CLASS(UnitsNum)
 /**
  * Fully connected CTRNN .
  *
+ * val() and sigm() are inlined into the trial loop, they are too short for
+ *   a dispatched kernel (meave/lib/cpu.hpp) to pay off.
+ *
+ * @tparam UNITS_NUM Number of units known at compile time, loops over units
+ *   are then fully unrolled. 0 -- the number is given to the constructor only.
+ * @tparam APPROX Fast approximate sigmoid, see NeuronCalc .
  */
-template<typename Float, typename Len>
-class NNCalc : NeuronCalc<Float> {
+template<typename Float, typename Len, Len UNITS_NUM = 0, bool APPROX = false>
+class NNCalc : NeuronCalc<Float, APPROX> {
 protected:
 	const Len units_num_;
 
 public:
 	NNCalc(const UnitsNum<Len> &units_num, const TimeStep<Float> &time_step)
-	:	NeuronCalc<Float>(time_step)
+	:	NeuronCalc<Float, APPROX>(time_step)
 	,	units_num_(*units_num) {
+		MEAVE_ASSERT(!UNITS_NUM || UNITS_NUM == units_num_);
+	}
+
+	Len units_num() const noexcept {
+		return UNITS_NUM ? UNITS_NUM : units_num_;
 	}
 
 	template<typename ItY, typename ItTC, typename ItEI, typename ItW, typename ItV>
@@ -74,10 +91,10 @@ public:
 		ItW it_w = b_w;
 		ItV it_v = b_v;
 		ItEI it_ei = b_ei;
-		for (Len val_idx = 0; val_idx != units_num_; ++val_idx) {
+		for (Len val_idx = 0; val_idx != units_num(); ++val_idx) {
 			Float sum = 0;
 			ItY it_y = b_y;
-			for (Len i = 0; i != units_num_; ++i) {
+			for (Len i = 0; i != units_num(); ++i) {
 				//DLOG(INFO) << "sum[" << (it_v - b_v) << "] += " << *it_w << " * " << *it_y;
 				sum += *it_w++ * *it_y++;
 			}
@@ -96,15 +113,17 @@ public:
 		ItB it_b = b_b;
 		ItV it_v = b_v;
 
-		for (Len i = 0; i != units_num_; ++i) {
+		for (Len i = 0; i != units_num(); ++i) {
 			//DLOG(INFO) << "y[" << i << "] = sigm(" << -*it_b << " + " << *it_v << ")";
-			*it_y++ = static_cast<const NeuronCalc<Float>&>(*this).sigm(*it_v++, *it_b++);
+			*it_y++ = static_cast<const NeuronCalc<Float, APPROX>&>(*this).sigm(*it_v++, *it_b++);
 		}
 
 		return b_y;
 	}
 };
 
+#	ifdef __AVX__
+
 class NeuronCalcAVX {
 protected:
 	using Float = float;
@@ -203,6 +222,8 @@ public:
 	}
 };
 
+#	endif // __AVX__
+
 } } /* namespace ::meave::ctrnn */
 
 #endif // MEAVE_CTRNN_NEURON_HPP
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "simple-trial.hpp"
 
 namespace {
@@ -55,16 +57,50 @@ struct Params {
 	constexpr float range() const noexcept {
 		return 5.f;
 	}
+
+	constexpr bool parallel_tournaments() const noexcept {
+		return false;
+	}
+
+	struct PrintQueue {
+		constexpr uns capacity() const noexcept {
+			return 1024;
+		}
+
+		constexpr meave::par::Backpressure backpressure() const noexcept {
+			return meave::par::Backpressure::BLOCK;
+		}
+	};
+
+	constexpr PrintQueue print_queue() const noexcept {
+		return PrintQueue();
+	}
+};
+
+/**
+ * Params of `simple-trial --parallel-tournaments'.
+ */
+struct ParallelParams : Params {
+	constexpr bool parallel_tournaments() const noexcept {
+		return true;
+	}
 };
 
 } /* Anonymouse Namespace */
 
+/**
+ * ./simple-trial [--parallel-tournaments]
+ */
 int
 main(int argc, char *argv[]) {
 		// Initialize Google's logging library.
 		google::InitGoogleLogging(argv[0]);
 
-		meave::ga::SimpleTrial<Params>{}();
+		if (argc > 1 && !::strcmp(argv[1], "--parallel-tournaments")) {
+			meave::ga::SimpleTrial<ParallelParams>{}();
+		} else {
+			meave::ga::SimpleTrial<Params>{}();
+		}
 
 		return 0;
 }
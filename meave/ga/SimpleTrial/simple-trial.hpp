@@ -6,11 +6,18 @@
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/str_printf.hpp"
 #	include "meave/lib/xrange.hpp"
+#	include "meave/lib/par/mpsc_queue.hpp"
+#	include "meave/lib/par/workers.hpp"
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/variation.hpp"
 
 #	include <algorithm>
+#	include <atomic>
+#	include <chrono>
 #	include <fstream>
+#	include <numeric>
 #	include <random>
+#	include <thread>
 #	include <tuple>
 
 namespace meave { namespace ga {
@@ -43,13 +50,25 @@ struct Nothing {
  *           Param::psize -- population size
  *           Param::range() -- range of weights: [-5.0, +5.0]
  *
+ *           Param::parallel_tournaments() -- play tournaments of disjoint pairs
+ *                                            in parallel rounds
+ *
+ *           -- Printing --
+ *           Param::print_queue().capacity() -- records waiting for the printer (power of 2)
+ *           Param::print_queue().backpressure() -- what to do when the printer falls behind
  */
 template <typename Params>
 class SimpleTrial : public Params {
 public:
 	typedef float Float;
 	typedef uns Len;
-	typedef $::default_random_engine RandomGenerator;
+
+	class RandomGenerator : public $::default_random_engine {
+	public:
+		RandomGenerator()
+		:	$::default_random_engine(meave::seed()) {
+		}
+	};
 
 private:
 	typedef Params P;
@@ -107,9 +126,37 @@ private:
 	NNCalc nncalc_;
 	$::vector<Float> population_;
 
-	mutable RandomGenerator rand_;
-	mutable $::uniform_real_distribution<Float> dist_;
-	mutable $::normal_distribution<Float> norm_dist_;
+	meave::par::Workers the_workers_;
+
+	/**
+	 * Record for the printer thread, which does all formatting and I/O.
+	 */
+	struct PrintRecord {
+		enum Kind {
+			  RESULTS_HEADER	///< Creates results file of the member.
+			, STATISTICS		///< Worst and best member of the population.
+		};
+
+		Kind kind_;
+		uns population_idx_;
+		uns member_;
+		uns min_idx_;
+		uns max_idx_;
+		Float min_fits_;
+		Float max_fits_;
+	};
+
+	meave::par::MpscQueue<PrintRecord> printer_queue_;
+	$::atomic<bool> printer_stop_;
+	$::thread the_printer_;
+
+	static thread_local RandomGenerator rand_;
+	static thread_local $::uniform_real_distribution<Float> dist_;
+	static thread_local $::normal_distribution<Float> norm_dist_;
+
+	uns cpus_num() const noexcept {
+		return $::max(1U, $::thread::hardware_concurrency());
+	}
 
 	/**
 	 * @return Genome size.
@@ -258,6 +305,39 @@ private:
 		return $::make_tuple(a, b);
 	}
 
+	/**
+	 * Draws pairs for one round of tournaments. Every member is in at most
+	 *   one pair and members of a pair are at most demewidth() apart as with
+	 *   choose_pair(). Members, that cannot find a free partner, sit out.
+	 */
+	$::vector<$::tuple<uns, uns>> choose_pairs() const noexcept {
+		static thread_local $::uniform_int_distribution<uns> dist_demewidth{1, P::demewidth()};
+
+		$::vector<uns> order(P::psize());
+		$::iota(order.begin(), order.end(), 0U);
+		$::shuffle(order.begin(), order.end(), rand_);
+
+		$::vector<bool> taken(P::psize(), false);
+		$::vector<$::tuple<uns, uns>> $$;
+		$$.reserve(P::psize() / 2);
+		for (const uns a: order) {
+			if (taken[a])
+				continue;
+
+			const uns first = dist_demewidth(rand_);
+			for (uns _ = 0; _ < P::demewidth(); ++_) {
+				const uns b = (a + (first + _ - 1) % P::demewidth() + 1) % P::psize();
+				if (!taken[b]) {
+					taken[a] = taken[b] = true;
+					$$.emplace_back(a, b);
+					break;
+				}
+			}
+		}
+
+		return $$;
+	}
+
 	/**
 	 * Performs transfusion and mutation on reals with a Gaussian vector mutation
 	 *
@@ -267,26 +347,122 @@ private:
 		const Float *m = &population_[gsize() * mother_idx];
 		Float *f = &population_[gsize() * father_idx];
 
+		Float u[gsize()];
+		Float g[gsize()];
 		for (uns i = 0; i < gsize(); ++i) {
-			if (dist_(rand_) < P::recprob())
-				f[i] = m[i];
+			u[i] = dist_(rand_);
+			g[i] = norm_dist_(rand_);
+		}
+
+		meave::ga::variation::gen_child_item_by_item(f, m, f, u, g, gsize(), P::recprob(), P::gaus_vec_mut());
+	}
+
+	/**
+	 * Evaluates whole population with FITNESS_FULL and hands the worst and
+	 *   the best member over to the printer.
+	 */
+	void population_statistics(const uns population_idx) noexcept {
+		Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
+		Float max_fits = -$::numeric_limits<Float>::max(); // The best member
+		uns min_idx = 0;
+		uns max_idx = 0;
+		for (uns i = 0; i < P::psize(); ++i) {
+			printer_queue_.push(PrintRecord{PrintRecord::RESULTS_HEADER, population_idx, i, 0, 0, 0, 0});
+			const Float fit = fitness<FITNESS_FULL>(i);
+
+			if (fit < min_fits)
+				$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
+			if (fit > max_fits)
+				$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
+		}
+
+		printer_queue_.push(PrintRecord{PrintRecord::STATISTICS, population_idx, 0, min_idx, max_idx, min_fits, max_fits});
+	}
 
-			f[i] += norm_dist_(rand_) * P::gaus_vec_mut();
-		
-			if (f[i] > 1.0)
-				f[i] = 2.0 - f[i];
+	void print(const PrintRecord &r, $::ostream &out_worstbest) const {
+		switch (r.kind_) {
+		case PrintRecord::RESULTS_HEADER: {
+			$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", r.population_idx_, r.member_), $::ofstream::trunc);
+			out_res << "Population" << "\t"
+				<< "Member" << "\t"
+				<< "Experiment" << "\t"
+				<< "Start" << "\t"
+				<< "Input" << "\t"
+				<< "RealOutput" << "\t"
+				<< "ExpectedOutput" << "\t"
+				<< "f" << "\n";
+			break;
+		}
+
+		case PrintRecord::STATISTICS:
+			out_worstbest << r.min_idx_ << "\t" << r.min_fits_ << "\t" << r.max_idx_ << "\t" << r.max_fits_ << "\n";
 
-			f[i] = ::meave::math::abs(f[i]);
+			LOG(INFO) << "Population Statistics";
+			LOG(INFO) << "\tPopulation: " << r.population_idx_;
+			LOG(INFO) << "\tmin-fitness (worst memmber): " << r.min_fits_ << '[' << r.min_idx_ << ']';
+			LOG(INFO) << "\tmax-fitness (best member): " << r.max_fits_ << '[' << r.max_idx_ << ']';
+			break;
 		}
 	}
 
+	/**
+	 * Body of the printer thread. It sleeps a bit when there is nothing to
+	 *   print, so producers never have to wake it up. Records pushed before
+	 *   printer_stop_ are all printed.
+	 */
+	void printer() {
+		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
+		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
+
+		PrintRecord r;
+		for (;;) {
+			const bool stop = printer_stop_.load($::memory_order_acquire);
+			bool printed = false;
+			while (printer_queue_.pop(r)) {
+				print(r, out_worstbest);
+				printed = true;
+			}
+			if (stop)
+				break;
+			if (!printed) {
+				out_worstbest.flush();
+				$::this_thread::sleep_for($::chrono::milliseconds(1));
+			}
+		}
+
+		if (printer_queue_.dropped())
+			LOG(WARNING) << "Printer dropped " << printer_queue_.dropped() << " records";
+	}
+
 	/**
 	 * Perform's Inman's microbial algorithm with fitness eveluations anytime.
 	 * Fitness function is in the range (-inf, +1] .
 	 */
 	void evolve() noexcept {
-		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
-		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
+		if (P::parallel_tournaments()) {
+			uns tournaments = 0;
+			for (uns population_idx = 0; tournaments < 5 * P::psize() * gsize() + 1; ) {
+				const $::vector<$::tuple<uns, uns>> pairs = choose_pairs();
+
+				$::vector<Float> fits(2 * pairs.size());
+				the_workers_.for_each(0, fits.size(), [this, &pairs, &fits](const uns _) {
+					fits[_] = fitness<>(_ % 2 ? $::get<1>(pairs[_ / 2]) : $::get<0>(pairs[_ / 2]));
+				});
+
+				for (uns _ = 0; _ < pairs.size(); ++_) {
+					if (fits[2*_] > fits[2*_ + 1]) {
+						gen_child($::get<0>(pairs[_]), $::get<1>(pairs[_]));
+					} else {
+						gen_child($::get<1>(pairs[_]), $::get<0>(pairs[_]));
+					}
+				}
+
+				tournaments += pairs.size();
+				for (; (population_idx + 1) * P::psize() <= tournaments; ++population_idx)
+					population_statistics(population_idx);
+			}
+			return;
+		}
 
 		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
 			$::tuple<uns, uns> pair = choose_pair();
@@ -301,57 +477,46 @@ private:
 				gen_child($::get<1>(pair), $::get<0>(pair));
 			}
 
-			if (0 == (popgen_idx + 1) % P::psize()) {
-				const uns population_idx = popgen_idx/P::psize();
-				Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
-				Float max_fits = -$::numeric_limits<Float>::max(); // The best member
-				uns min_idx = 0;
-				uns max_idx = 0;
-				for (uns i = 0; i < P::psize(); ++i) {
-					$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", population_idx, i), $::ofstream::trunc);
-					out_res << "Population" << "\t"
-						<< "Member" << "\t"
-						<< "Experiment" << "\t"
-						<< "Start" << "\t"
-						<< "Input" << "\t"
-						<< "RealOutput" << "\t"
-						<< "ExpectedOutput" << "\t"
-						<< "f" << $::endl;
-					const Float fit = fitness<FITNESS_FULL>(i, [population_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
-					});
-
-					if (fit < min_fits)
-						$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
-					if (fit > max_fits)
-						$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
-				}
-
-				out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << $::endl;
-
-				LOG(INFO) << "Population Statistics";
-				LOG(INFO) << "\tPopulation: " << (popgen_idx / P::psize());
-				LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
-				LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
-			}
+			if (0 == (popgen_idx + 1) % P::psize())
+				population_statistics(popgen_idx/P::psize());
 		}
 	}
 
 public:
-	SimpleTrial() noexcept
+	SimpleTrial()
 	:	nncalc_(P::nn(), P::ts())
 	,	population_(P::psize() * gsize())
-	,	rand_(meave::seed())
-	,	dist_(0.0, 1.0)
-	,	printer_queue_(, 1)
+	,	the_workers_(cpus_num())
+	,	printer_queue_(P::print_queue().capacity(), P::print_queue().backpressure())
+	,	printer_stop_(false)
 	,	the_printer_([this]() {this->printer(); }) {
 		$::generate(population_.begin(), population_.end(), [this]() -> Float { return dist_(rand_); });
 	}
+	SimpleTrial(const SimpleTrial&) = delete;
+	SimpleTrial &operator=(const SimpleTrial&) = delete;
 
 	void operator()() noexcept {
 		evolve();
 	}
+
+	/**
+	 * Waits until everything is printed.
+	 */
+	~SimpleTrial() noexcept {
+		printer_stop_.store(true, $::memory_order_release);
+		the_printer_.join();
+	}
 };
 
+template <typename Params>
+thread_local typename SimpleTrial<Params>::RandomGenerator SimpleTrial<Params>::rand_;
+
+template <typename Params>
+thread_local $::uniform_real_distribution<typename SimpleTrial<Params>::Float> SimpleTrial<Params>::dist_;
+
+template <typename Params>
+thread_local $::normal_distribution<typename SimpleTrial<Params>::Float> SimpleTrial<Params>::norm_dist_;
+
 } } /* meave::ga */
 
 #endif // MEAVE_GA_SIMPLE_TRIAL_HPP
@@ -0,0 +1,276 @@
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+
+#include "config.hpp"
+
+namespace meave { namespace ga {
+
+Config::Config() noexcept
+:	gens_(10000)
+,	gaus_vec_mut_(0.01)
+,	psize_(0)
+,	recprob_(1/2.f)
+,	demewidth_(5)
+,	trial_(50)
+,	eval_(30)
+,	repeat_(100)
+,	velrange_(2)
+,	startposrange_(100)
+,	no_racing_(false)
+,	progressive_precision_(false)
+,	approx_margin_(0.005)
+,	ts_(0.1)
+,	nn_(3)
+,	range_(5.f)
+,	pso_omega_(1/8.f)
+,	pso_particle_best_(1/3.f)
+,	pso_subswarm_best_(1/3.f)
+,	pso_global_best_(1/3.f)
+,	pso_subswarms_num_(5)
+,	mf_enabled_(false)
+,	mf_min_scenarios_(275)
+,	mf_eta_(2) {
+}
+
+bool Config::parse(const int argc, const char * const argv[]) noexcept {
+	// Let's make the code less verbose.
+	namespace po = boost::program_options;
+	using po::value;
+	using po::bool_switch;
+
+	const $::string S_USAGE = $::string("Usage: ") + argv[0] + " [options]";
+
+	$::string config_file;
+
+	po::options_description main_options("Main options");
+	main_options.add_options()
+	("help"       , "display the help message and exit")
+	("config-file", value(&config_file)->default_value(config_file), "configuration file")
+	;
+
+	po::options_description evolution_options("Evolution options");
+	evolution_options.add_options()
+	("gens"         , value(&gens_)->default_value(gens_), "number of generations")
+	("gaus-vec-mut" , value(&gaus_vec_mut_)->default_value(gaus_vec_mut_, "0.01"), "Gaussian vector mutation")
+	("psize"        , value(&psize_)->default_value(psize_), "population size (0 -- 6*nn + 2)")
+	("recprob"      , value(&recprob_)->default_value(recprob_), "probability of recombination")
+	("demewidth"    , value(&demewidth_)->default_value(demewidth_), "deme width")
+	;
+
+	po::options_description fitness_options("Fitness evaluation options");
+	fitness_options.add_options()
+	("trial"        , value(&trial_)->default_value(trial_), "units of time for each trial")
+	("eval"         , value(&eval_)->default_value(eval_), "time at which the agent starts being evaluated")
+	("repeat"       , value(&repeat_)->default_value(repeat_), "number of trials per fitness evaluation")
+	("velrange"     , value(&velrange_)->default_value(velrange_), "range of velocities [0, velrange]")
+	("startposrange", value(&startposrange_)->default_value(startposrange_), "range of starting positions [0, startposrange]")
+	("no-racing"    , bool_switch(&no_racing_)->default_value(no_racing_), "evaluate children fully even if they cannot improve any best")
+	("progressive-precision", bool_switch(&progressive_precision_)->default_value(progressive_precision_), "screen children by approximate sigmoid, evaluate exactly only those that may improve a best")
+	("approx-margin", value(&approx_margin_)->default_value(approx_margin_, "0.005"), "fitness margin of screening by approximate sigmoid")
+	("ts"           , value(&ts_)->default_value(ts_, "0.1"), "time step of Euler integration")
+	;
+
+	po::options_description ctrnn_options("CTRNN options");
+	ctrnn_options.add_options()
+	("nn"           , value(&nn_)->default_value(nn_), "number of neurons")
+	("range"        , value(&range_)->default_value(range_), "range of weights [-range, +range]")
+	;
+
+	po::options_description pso_options("Particle swarm options (section [pso] of config file)");
+	pso_options.add_options()
+	("pso.omega"        , value(&pso_omega_)->default_value(pso_omega_, "0.125"), "inertia of velocity")
+	("pso.particle-best", value(&pso_particle_best_)->default_value(pso_particle_best_, "1/3"), "attraction to the best position of particle")
+	("pso.subswarm-best", value(&pso_subswarm_best_)->default_value(pso_subswarm_best_, "1/3"), "attraction to the best position of subswarm")
+	("pso.global-best"  , value(&pso_global_best_)->default_value(pso_global_best_, "1/3"), "attraction to the best position of swarm")
+	("pso.subswarms-num", value(&pso_subswarms_num_)->default_value(pso_subswarms_num_), "number of subswarms")
+	;
+
+	po::options_description mf_options("Multi-fidelity options (section [multi-fidelity] of config file)");
+	mf_options.add_options()
+	("multi-fidelity.enabled"      , bool_switch(&mf_enabled_)->default_value(mf_enabled_), "evaluate sweeps of children by successive halving")
+	("multi-fidelity.min-scenarios", value(&mf_min_scenarios_)->default_value(mf_min_scenarios_), "scenarios of the coarsest rung")
+	("multi-fidelity.eta"          , value(&mf_eta_)->default_value(mf_eta_), "1/eta of children is promoted to eta-times more scenarios")
+	;
+
+	po::options_description conf_file_options;
+	conf_file_options.add(evolution_options).add(fitness_options).add(ctrnn_options).add(pso_options).add(mf_options);
+
+	po::options_description full_options;
+	full_options.add(main_options).add(conf_file_options);
+
+	try {
+		po::variables_map option_map;
+		po::store(po::parse_command_line(argc, argv, full_options), option_map);
+
+		if (option_map.count("help")) {
+			$::cerr << S_USAGE << "\n" << full_options << $::endl;
+			return false;
+		}
+
+		config_file = option_map["config-file"].as<$::string>();
+		if (!config_file.empty()) {
+			$::ifstream config_stream(config_file.c_str());
+			if (!config_stream) {
+				$::cerr << "Error: Cannot open config file: `" << config_file << "' for reading." << $::endl;
+				return false;
+			}
+
+			// Options of command line are stored first, so they win.
+			po::store(po::parse_config_file(config_stream, conf_file_options, false), option_map);
+		}
+
+		po::notify(option_map);
+	} catch (const po::error &error) {
+		$::cerr << "Error: " << error.what() << "\n" << "\n" << S_USAGE << "\n" << full_options << $::endl;
+		return false;
+	}
+
+	if (!nn_) {
+		$::cerr << "Error: nn must be positive" << $::endl;
+		return false;
+	}
+	if (!pso_subswarms_num_ || pso_subswarms_num_ > psize()) {
+		$::cerr << "Error: pso.subswarms-num must be in interval <1," << psize() << ">" << $::endl;
+		return false;
+	}
+	if (mf_eta_ < 2) {
+		$::cerr << "Error: multi-fidelity.eta must be at least 2" << $::endl;
+		return false;
+	}
+	if (approx_margin_ < 0) {
+		$::cerr << "Error: approx-margin must not be negative" << $::endl;
+		return false;
+	}
+	if (eval_ >= trial_ || !(ts_ > 0)) {
+		$::cerr << "Error: eval must be less than trial and ts must be positive" << $::endl;
+		return false;
+	}
+
+	return true;
+}
+
+uns Config::gens() const noexcept {
+	return gens_;
+}
+
+float Config::gaus_vec_mut() const noexcept {
+	return gaus_vec_mut_;
+}
+
+uns Config::psize() const noexcept {
+	return psize_ ? psize_ : 6*nn_ + 2;
+}
+
+float Config::recprob() const noexcept {
+	return recprob_;
+}
+
+uns Config::demewidth() const noexcept {
+	return demewidth_;
+}
+
+uns Config::trial() const noexcept {
+	return trial_;
+}
+
+uns Config::eval() const noexcept {
+	return eval_;
+}
+
+uns Config::repeat() const noexcept {
+	return repeat_;
+}
+
+uns Config::velrange() const noexcept {
+	return velrange_;
+}
+
+uns Config::startposrange() const noexcept {
+	return startposrange_;
+}
+
+bool Config::racing() const noexcept {
+	return !no_racing_;
+}
+
+bool Config::progressive_precision() const noexcept {
+	return progressive_precision_;
+}
+
+float Config::approx_margin() const noexcept {
+	return approx_margin_;
+}
+
+float Config::ts() const noexcept {
+	return ts_;
+}
+
+uns Config::nn() const noexcept {
+	return nn_;
+}
+
+float Config::range() const noexcept {
+	return range_;
+}
+
+float Config::pso_omega() const noexcept {
+	return pso_omega_;
+}
+
+float Config::pso_particle_best() const noexcept {
+	return pso_particle_best_;
+}
+
+float Config::pso_subswarm_best() const noexcept {
+	return pso_subswarm_best_;
+}
+
+float Config::pso_global_best() const noexcept {
+	return pso_global_best_;
+}
+
+uns Config::pso_subswarms_num() const noexcept {
+	return pso_subswarms_num_;
+}
+
+bool Config::mf_enabled() const noexcept {
+	return mf_enabled_;
+}
+
+uns Config::mf_min_scenarios() const noexcept {
+	return mf_min_scenarios_;
+}
+
+uns Config::mf_eta() const noexcept {
+	return mf_eta_;
+}
+
+$::ostream& operator<<($::ostream &o, const Config &$) {
+	return o << "gens:" << $.gens() << $::endl
+		 << "gaus-vec-mut:" << $.gaus_vec_mut() << $::endl
+		 << "psize:" << $.psize() << $::endl
+		 << "recprob:" << $.recprob() << $::endl
+		 << "demewidth:" << $.demewidth() << $::endl
+		 << "trial:" << $.trial() << $::endl
+		 << "eval:" << $.eval() << $::endl
+		 << "repeat:" << $.repeat() << $::endl
+		 << "velrange:" << $.velrange() << $::endl
+		 << "startposrange:" << $.startposrange() << $::endl
+		 << "racing:" << $.racing() << $::endl
+		 << "progressive-precision:" << $.progressive_precision() << $::endl
+		 << "approx-margin:" << $.approx_margin() << $::endl
+		 << "ts:" << $.ts() << $::endl
+		 << "nn:" << $.nn() << $::endl
+		 << "range:" << $.range() << $::endl
+		 << "pso.omega:" << $.pso_omega() << $::endl
+		 << "pso.particle-best:" << $.pso_particle_best() << $::endl
+		 << "pso.subswarm-best:" << $.pso_subswarm_best() << $::endl
+		 << "pso.global-best:" << $.pso_global_best() << $::endl
+		 << "pso.subswarms-num:" << $.pso_subswarms_num() << $::endl
+		 << "multi-fidelity.enabled:" << $.mf_enabled() << $::endl
+		 << "multi-fidelity.min-scenarios:" << $.mf_min_scenarios() << $::endl
+		 << "multi-fidelity.eta:" << $.mf_eta();
+}
+
+} } /* namespace meave::ga */
@@ -0,0 +1,87 @@
+#ifndef MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_CONFIG_HPP
+#	define MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_CONFIG_HPP
+
+#	include <ostream>
+
+#	include "meave/commons.hpp"
+
+namespace meave { namespace ga {
+
+/**
+ * Experiment parameters read from command line and config file, see
+ *   examples/boost/program_options . Defaults are the values the experiment
+ *   was compiled with before.
+ */
+class Config {
+public:
+	Config() noexcept;
+
+	bool parse(const int argc, const char * const argv[]) noexcept;
+
+	uns gens() const noexcept;
+	float gaus_vec_mut() const noexcept;
+	uns psize() const noexcept;
+	float recprob() const noexcept;
+	uns demewidth() const noexcept;
+
+	uns trial() const noexcept;
+	uns eval() const noexcept;
+	uns repeat() const noexcept;
+	uns velrange() const noexcept;
+	uns startposrange() const noexcept;
+	bool racing() const noexcept;
+	bool progressive_precision() const noexcept;
+	float approx_margin() const noexcept;
+
+	float ts() const noexcept;
+
+	uns nn() const noexcept;
+	float range() const noexcept;
+
+	float pso_omega() const noexcept;
+	float pso_particle_best() const noexcept;
+	float pso_subswarm_best() const noexcept;
+	float pso_global_best() const noexcept;
+	uns pso_subswarms_num() const noexcept;
+
+	bool mf_enabled() const noexcept;
+	uns mf_min_scenarios() const noexcept;
+	uns mf_eta() const noexcept;
+
+private:
+	uns gens_;
+	float gaus_vec_mut_;
+	uns psize_;		///< 0 -- 6*nn() + 2
+	float recprob_;
+	uns demewidth_;
+
+	uns trial_;
+	uns eval_;
+	uns repeat_;
+	uns velrange_;
+	uns startposrange_;
+	bool no_racing_;
+	bool progressive_precision_;
+	float approx_margin_;
+
+	float ts_;
+
+	uns nn_;
+	float range_;
+
+	float pso_omega_;
+	float pso_particle_best_;
+	float pso_subswarm_best_;
+	float pso_global_best_;
+	uns pso_subswarms_num_;
+
+	bool mf_enabled_;
+	uns mf_min_scenarios_;
+	uns mf_eta_;
+};
+
+$::ostream& operator<<($::ostream &o, const Config &$);
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_CONFIG_HPP
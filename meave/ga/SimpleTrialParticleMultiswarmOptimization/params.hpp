@@ -0,0 +1,211 @@
+#ifndef MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_PARAMS_HPP
+#	define MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_PARAMS_HPP
+
+#	include "meave/commons.hpp"
+
+#	include "config.hpp"
+
+namespace meave { namespace ga {
+
+/**
+ * Parameters of one run, copied from Config so that the hot path reads
+ *   them by inlined accessors.
+ * @tparam N_N Number of neurons the kernels are specialized for, 0 -- generic.
+ */
+template<uns N_N>
+class Params {
+public:
+	enum : uns { NN = N_N };
+
+private:
+	uns gens_;
+	float gaus_vec_mut_;
+	uns psize_;
+	float recprob_;
+	uns demewidth_;
+	uns trial_;
+	uns eval_;
+	uns repeat_;
+	uns velrange_;
+	uns startposrange_;
+	bool racing_;
+	bool progressive_precision_;
+	float approx_margin_;
+	float ts_;
+	uns nn_;
+	float range_;
+
+public:
+	class ParticleSwarmOptimization {
+	private:
+		float omega_;
+		uns subswarms_num_;
+
+	public:
+		class Psi {
+		private:
+			float particle_best_;
+			float subswarm_best_;
+			float global_best_;
+
+		public:
+			explicit Psi(const Config &config) noexcept
+			:	particle_best_(config.pso_particle_best())
+			,	subswarm_best_(config.pso_subswarm_best())
+			,	global_best_(config.pso_global_best()) {
+			}
+
+			float particle_best() const noexcept {
+				return particle_best_;
+			}
+			float subswarm_best() const noexcept {
+				return subswarm_best_;
+			}
+			float global_best() const noexcept {
+				return global_best_;
+			}
+		} psi;
+
+		explicit ParticleSwarmOptimization(const Config &config) noexcept
+		:	omega_(config.pso_omega())
+		,	subswarms_num_(config.pso_subswarms_num())
+		,	psi(config) {
+		}
+
+		float omega() const noexcept {
+			return omega_;
+		}
+
+		uns subswarms_num() const noexcept {
+			return subswarms_num_;
+		}
+	};
+
+	class MultiFidelity {
+	private:
+		bool enabled_;
+		uns min_scenarios_;
+		uns eta_;
+
+	public:
+		explicit MultiFidelity(const Config &config) noexcept
+		:	enabled_(config.mf_enabled())
+		,	min_scenarios_(config.mf_min_scenarios())
+		,	eta_(config.mf_eta()) {
+		}
+
+		bool enabled() const noexcept {
+			return enabled_;
+		}
+
+		uns min_scenarios() const noexcept {
+			return min_scenarios_;
+		}
+
+		uns eta() const noexcept {
+			return eta_;
+		}
+	};
+
+private:
+	ParticleSwarmOptimization pso_;
+	MultiFidelity multi_fidelity_;
+
+public:
+	explicit Params(const Config &config = Config()) noexcept
+	:	gens_(config.gens())
+	,	gaus_vec_mut_(config.gaus_vec_mut())
+	,	psize_(config.psize())
+	,	recprob_(config.recprob())
+	,	demewidth_(config.demewidth())
+	,	trial_(config.trial())
+	,	eval_(config.eval())
+	,	repeat_(config.repeat())
+	,	velrange_(config.velrange())
+	,	startposrange_(config.startposrange())
+	,	racing_(config.racing())
+	,	progressive_precision_(config.progressive_precision())
+	,	approx_margin_(config.approx_margin())
+	,	ts_(config.ts())
+	,	nn_(config.nn())
+	,	range_(config.range())
+	,	pso_(config)
+	,	multi_fidelity_(config) {
+	}
+
+	uns gens() const noexcept {
+		return gens_;
+	}
+
+	float gaus_vec_mut() const noexcept {
+		return gaus_vec_mut_;
+	}
+
+	uns psize() const noexcept {
+		return psize_;
+	}
+
+	float recprob() const noexcept {
+		return recprob_;
+	}
+
+	uns demewidth() const noexcept {
+		return demewidth_;
+	}
+
+	uns trial() const noexcept {
+		return trial_;
+	}
+
+	uns eval() const noexcept {
+		return eval_;
+	}
+
+	uns repeat() const noexcept {
+		return repeat_;
+	}
+
+	uns velrange() const noexcept {
+		return velrange_;
+	}
+
+	uns startposrange() const noexcept {
+		return startposrange_;
+	}
+
+	bool racing() const noexcept {
+		return racing_;
+	}
+
+	bool progressive_precision() const noexcept {
+		return progressive_precision_;
+	}
+
+	float approx_margin() const noexcept {
+		return approx_margin_;
+	}
+
+	float ts() const noexcept {
+		return ts_;
+	}
+
+	constexpr uns nn() const noexcept {
+		return N_N ? N_N : nn_;
+	}
+
+	float range() const noexcept {
+		return range_;
+	}
+
+	const ParticleSwarmOptimization &pso() const noexcept {
+		return pso_;
+	}
+
+	const MultiFidelity &multi_fidelity() const noexcept {
+		return multi_fidelity_;
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_PARAMS_HPP
@@ -1,89 +1,17 @@
 #include <tuple>
 
+#include "config.hpp"
+#include "params.hpp"
 #include "simple-trial.hpp"
+#include "meave/lib/trace.hpp"
 
 namespace {
 
-struct Params {
-	constexpr uns gens() const noexcept {
-		return 10000;
-	}
-
-	constexpr float gaus_vec_mut() const noexcept {
-		return 0.01;
-	}
-
-	constexpr uns psize() const noexcept {
-		return 6*nn() + 2;
-	}
-
-	constexpr float recprob() const noexcept {
-		return 1/2.f;
-	}
-
- 	constexpr uns demewidth() const noexcept {
-		return 5;
-	}
-
- 
- 	constexpr uns trial() const noexcept {
-		return 50;
-	}
-
-	constexpr uns eval() const noexcept {
-		return 30;
-	}
-
-	constexpr uns repeat() const noexcept {
-		return 100;
-	}
-
- 	constexpr uns velrange() const noexcept {
-		return 2;
-	}
-
-	constexpr uns startposrange() const noexcept {
-		return 100;
-	}
-
-	constexpr float ts() const noexcept {
-		return 0.1;
-	}
-
- 	constexpr uns nn() const noexcept {
-		return 3;
-	}
-
-	constexpr float range() const noexcept {
-		return 5.f;
-	}
-
-	struct ParticleSwarmOptimization {
-		constexpr float omega() const noexcept {
-			return 1/8.f;
-		}
-
-		struct {
-			constexpr float particle_best() const noexcept {
-				return 1/3.f;
-			}
-			constexpr float subswarm_best() const noexcept {
-				return 1/3.f;
-			}
-			constexpr float global_best() const noexcept {
-				return 1/3.f;
-			}
-		} psi;
-
-		constexpr uns subswarms_num() const noexcept {
-			return 5;
-		}
-	};
-
-	constexpr ParticleSwarmOptimization pso() const noexcept {
-		return ParticleSwarmOptimization();
-	}
-};
+template<uns NN>
+void run(const meave::ga::Config &config) {
+	LOG(INFO) << "Kernels for nn = " << (NN ? meave::str_printf("%u", NN) : $::string("any"));
+	meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, meave::ga::Params<NN>>{meave::ga::Params<NN>(config)}();
+}
 
 } /* Anonymouse Namespace */
 
@@ -92,7 +20,22 @@ main(int argc, char *argv[]) {
 		// Initialize Google's logging library.
 		google::InitGoogleLogging(argv[0]);
 
-		meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, Params>{}();
+		meave::ga::Config config;
+		if (!config.parse(argc, argv))
+			return 1;
+		LOG(INFO) << "Configuration:\n" << config;
+		const meave::trace::Session trace_session;
+
+		// Common sizes of network run with kernels specialized at compile time.
+		switch (config.nn()) {
+		case 2: run<2>(config); break;
+		case 3: run<3>(config); break;
+		case 4: run<4>(config); break;
+		case 5: run<5>(config); break;
+		case 6: run<6>(config); break;
+		case 8: run<8>(config); break;
+		default: run<0>(config); break;
+		}
 
 		return 0;
 }
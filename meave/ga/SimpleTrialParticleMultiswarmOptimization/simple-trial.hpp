@@ -5,12 +5,19 @@
 #	include "meave/lib/math.hpp"
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/str_printf.hpp"
+#	include "meave/lib/trace.hpp"
 #	include "meave/lib/xrange.hpp"
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/metrics.hpp"
+#	include "meave/ga/multi_fidelity.hpp"
+#	include "meave/ga/variation.hpp"
 
 #	include <algorithm>
+#	include <cstdint>
 #	include <future>
 #	include <fstream>
+#	include <memory>
 #	include <sstream>
 #	include <random>
 #	include <tuple>
@@ -41,12 +48,20 @@ struct SinglePrecision {
  *           Param::repeat() -- number of trials per fitness evaluation (100)
  *           Param::velrange() -- range of different possible velocities [0, 2]
  *           Param::startposrange() -- range of different starting positions [0, 100]
+ *           Param::racing() -- cut evaluations of children that cannot improve any best (true)
+ *           Param::progressive_precision() -- screen children by approximate sigmoid, only those
+ *                                             that may improve a best are evaluated exactly (false)
+ *           Param::approx_margin() -- fitness margin of the screening (0.005)
+ *           Param::multi_fidelity().enabled() -- evaluate sweeps of children by successive halving (false)
+ *           Param::multi_fidelity().min_scenarios() -- scenarios of the coarsest rung (275)
+ *           Param::multi_fidelity().eta() -- promoted fraction 1/eta and growth of rungs (2)
  *
  *           -- euler integration parameters -- 
  *           Param::ts() -- time step of simulation <floating point>
  *
  *           -- CTRNN parameters --
  *           Param::nn() -- number of neurons (3)
+ *           Param::NN -- number of neurons known at compile time, 0 -- generic kernel
  *           Param::psize -- population size
  *           Param::range() -- range of weights: [-5.0, +5.0]
  *
@@ -87,8 +102,8 @@ public:
 	}
 
 	uns rand_index() noexcept {
-		static thread_local $::uniform_int_distribution<uns> dist(0, P::psize() - 1);
-		return dist(rand_);
+		// Not a static: runs of a sweep share the thread and differ in psize.
+		return $::uniform_int_distribution<uns>(0, P::psize() - 1)(rand_);
 	}
 
 	/**
@@ -157,9 +172,11 @@ private:
 	};
 
 private:
-	typedef meave::ctrnn::NNCalc<Float, Len> NNCalc;
+	typedef meave::ctrnn::NNCalc<Float, Len, P::NN> NNCalc;
+	typedef meave::ctrnn::NNCalc<Float, Len, P::NN, true> NNCalcApprox;
 
 	NNCalc nncalc_;
+	NNCalcApprox nncalc_approx_;	///< Screening only, no fitness computed by it is ever recorded.
 	$::vector<Float> positions_;
 	$::vector<Float> best_positions_;
 	$::vector<Float> velocities_;
@@ -173,6 +190,21 @@ private:
 	mutable $::uniform_real_distribution<Float> dist_;
 	mutable $::normal_distribution<Float> norm_dist_;
 
+	const $::vector<uns> mixed_order_;	///< Order of scenarios for racing.
+	SuccessiveHalving halving_;
+
+	::uint64_t sims_raced_;	///< Simulations of raced evaluations since the last statistics.
+	::uint64_t sims_saved_;	///< Simulations of them cut by racing.
+	::uint64_t children_screened_;	///< Children screened by approximate sigmoid since the last statistics.
+	::uint64_t children_rechecked_;	///< Of them evaluated exactly.
+
+	mutable ::uint64_t sims_;	///< Simulations run so far, the cost of the run.
+	::uint64_t evals_;	///< Fitness evaluations so far.
+	::uint64_t sims_cut_;	///< Simulations cut by racing so far.
+	::uint64_t stats_evals_;	///< Evaluations of population statistics, not in evals_ .
+	::uint64_t stats_sims_;	///< Their simulations, not in sims_ .
+	uns popgen_idx_;	///< Children generated so far.
+
 	/**
 	 * @todo int/float (0.1) has big rounding error...
 	 * @return Number of timesteps after which agents starts to be evaluated.
@@ -218,53 +250,128 @@ private:
 		f.close();
 	}
 
+	/**
+	 * Racing: run_sim() never returns more than 1, so after k of n
+	 *   simulations with sum f the fitness cannot exceed (f + n - k) / n .
+	 * @return true When the bound is below threshold and the evaluation
+	 *   may stop, bound is then set.
+	 */
+	bool hopeless(const Float f, const uns k, const uns n, const Float threshold, Float &bound) noexcept {
+		bound = (f + (n - k)) / n;
+		if (bound >= threshold)
+			return false;
+		sims_saved_ += n - k;
+		sims_cut_ += n - k;
+		return true;
+	}
+
 	/**
 	 * Fitness evaluation.
+	 * @param threshold Racing -- the evaluation is cut as soon as the fitness
+	 *   provably cannot reach threshold. Scenarios of FITNESS_FULL are then
+	 *   taken in a well-mixed order, so the bound drops early.
+	 * @tparam APPROX Simulations by approximate sigmoid, for screening only.
+	 * @return Fitness, or its upper bound below threshold when the evaluation was cut.
 	 */
 	enum FitnessKind {
 		  FITNESS_RAND
 		, FITNESS_FULL
 	};
-	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
-	Float fitness(const uns index, Wr wr = Nothing()) noexcept {
+	template<FitnessKind FK = FITNESS_RAND, bool APPROX = false, typename Wr = Nothing>
+	Float fitness(const uns index, Wr wr = Nothing(), const Float threshold = -$::numeric_limits<Float>::max()) noexcept {
+		const trace::Scope scope(APPROX ? "fitness (approx)" : "fitness", "ga");
 		const Phenotype phe = phenotype(index);
+		const bool racing = P::racing() && threshold > -$::numeric_limits<Float>::max();
+		++evals_;
 
 		Float f = 0;
+		Float bound;
 		if (FK == FITNESS_RAND) {
 			// Regular fitness evaluation
-			for (uns repeat = P::repeat(); repeat--; ) {
+			if (racing)
+				sims_raced_ += P::repeat();
+			for (uns repeat = 0; repeat < P::repeat(); ++repeat) {
 				const Float vel = dist_(rand_) * P::velrange();
 				const Float start_pos = dist_(rand_) * P::startposrange();
 
-				f += run_sim(start_pos, vel, phe, wr);
+				f += run_sim<APPROX>(start_pos, vel, phe, wr);
+				if (racing && hopeless(f, repeat + 1, P::repeat(), threshold, bound))
+					return bound;
 			}
 			f /= P::repeat();
 		}
 		if (FK == FITNESS_FULL) {
-			const uns i_max = 200;
-			for (const uns i: meave::make_xrange(0U, i_max)) {
-				Float temp = 0;
-				const uns j_max = 11;
-				for (const uns j: meave::make_xrange(0U, j_max)) {
-					const uns start_pos = j*10;
-					const Float f_start_pos = static_cast<Float>(start_pos);
-					const Float f_vel = static_cast<Float>(i) / 100;
-					const Float err = run_sim(f_start_pos, f_vel, phe, wr);
-					temp += err;
-				};
-				temp /= j_max;
-				f += temp;
-			};
-			f /= i_max;
+			// Results by scenario, a complete evaluation is the same mean of
+			//   means with racing as without it.
+			Float sims[SCENARIOS_NUM];
+			if (racing) {
+				const uns n = SCENARIOS_NUM;
+				sims_raced_ += n;
+				for (uns k = 0; k < n; ++k) {
+					sims[mixed_order_[k]] = scenario_sim<APPROX>(phe, mixed_order_[k], wr);
+					f += sims[mixed_order_[k]];
+					if (hopeless(f, k + 1, n, threshold, bound))
+						return bound;
+				}
+			} else {
+				for (uns _ = 0; _ < SCENARIOS_NUM; ++_)
+					sims[_] = scenario_sim<APPROX>(phe, _, wr);
+			}
+			f = mean_of_means(sims);
 		}
 		return f;
 	}
 
+	/**
+	 * @return Mean over velocities of means over start positions, rounded
+	 *   as before racing.
+	 */
+	static Float mean_of_means(const Float sims[]) noexcept {
+		Float $$ = 0;
+		for (uns i = 0; i < VELOCITIES_NUM; ++i) {
+			Float temp = 0;
+			for (uns j = 0; j < STARTS_NUM; ++j)
+				temp += sims[i * STARTS_NUM + j];
+			temp /= STARTS_NUM;
+			$$ += temp;
+		}
+		return $$ / VELOCITIES_NUM;
+	}
+
+	/**
+	 * Scenarios of FITNESS_FULL: every velocity i/100 of VELOCITIES_NUM with
+	 *   every start position j*10 of STARTS_NUM, scenario = i*STARTS_NUM + j .
+	 */
+	enum {
+		  VELOCITIES_NUM = 200
+		, STARTS_NUM = 11
+		, SCENARIOS_NUM = VELOCITIES_NUM * STARTS_NUM
+	};
+	template<bool APPROX = false, typename Wr = Nothing>
+	Float scenario_sim(const Phenotype &phe, const uns scenario, Wr wr = Nothing()) const noexcept {
+		const uns i = scenario / STARTS_NUM;
+		const uns j = scenario % STARTS_NUM;
+		const uns start_pos = j*10;
+		const Float f_start_pos = static_cast<Float>(start_pos);
+		const Float f_vel = static_cast<Float>(i) / 100;
+		return run_sim<APPROX>(f_start_pos, f_vel, phe, wr);
+	}
+
+	const NNCalc &nncalc($::false_type) const noexcept {
+		return nncalc_;
+	}
+
+	const NNCalcApprox &nncalc($::true_type) const noexcept {
+		return nncalc_approx_;
+	}
+
 	/**
 	 * Runs simulation for one phenotype...
 	 */
-	template<typename WRITER>
+	template<bool APPROX = false, typename WRITER = Nothing>
 	Float run_sim(const double start, const double vel, const Phenotype &phenotype, WRITER wr = Nothing()) const noexcept {
+		const auto &nncalc = this->nncalc($::integral_constant<bool, APPROX>());
+
 		$::vector<Float> y(P::nn());
 		$::vector<Float> ei(P::nn(), 0.0);
 		std::vector<Float> v(P::nn());
@@ -276,12 +383,12 @@ private:
 		Float distance = start;
 		Float f = 0;
 		for (uns trial_idx = 0; trial_idx < trials_num(); ++trial_idx) {
-			nncalc_.sigm(v.begin(), phenotype.biases().begin(), y.begin());
+			nncalc.sigm(v.begin(), phenotype.biases().begin(), y.begin());
 
 			distance += P::ts() * vel;
 			const Float input = distance / 20;
 			ei[0] = input;
-			nncalc_.val(y.begin(), phenotype.time_constants().begin(), ei.begin(), phenotype.weights().begin(), v.begin());
+			nncalc.val(y.begin(), phenotype.time_constants().begin(), ei.begin(), phenotype.weights().begin(), v.begin());
 			const auto out = v[P::nn() - 1];
 
 			wr(start, input, trial_idx, out, vel, f);
@@ -291,11 +398,16 @@ private:
 			}
 		}
 
+		++sims_;
 		const Float $$ = 1 - f / (P::trial() - P::eval());
 		return $$;
 	}
 
-	void maybe_gen_child(const uns picked_idx) noexcept {
+	/**
+	 * Moves particle picked_idx by its velocity.
+	 */
+	void move(const uns picked_idx) noexcept {
+		const trace::Scope scope("variation", "ga");
 		// https://en.wikipedia.org/wiki/Particle_swarm_optimization
 		DLOG(INFO) << "Picked idx:" << picked_idx;
 
@@ -308,27 +420,30 @@ private:
 		const uns subswarm_idx = subswarm_map_[picked_idx];
 		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
+		Float rp[gsize()];
+		Float rs[gsize()];
+		Float rg[gsize()];
 		for (uns _ = 0; _ < gsize(); ++_) {
-			const Float rp = uniform_dist<0, 1, 1>();
-			const Float rs = uniform_dist<0, 1, 1>();
-			const Float rg = uniform_dist<0, 1, 1>();
-
-			DLOG(INFO) << "v[" << _ << "] = " << P::pso().omega() << " * " << v[_] << " + "
-				   << P::pso().psi.particle_best() << " * " << rp << " * " << "(" << best_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.subswarm_best() << " * " << rs << " * " << "(" << subswarm_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.global_best() << " * " << rg << " * " << "(" << global_best_x[_] << " - " << x[_] << ")";
-			v[_] = P::pso().omega() * v[_] +
-				      P::pso().psi.particle_best() * rp * (best_x[_] - x[_]) +
-				      P::pso().psi.subswarm_best() * rs * (subswarm_x[_] - x[_]) +
-				      P::pso().psi.global_best() * rg * (global_best_x[_] - x[_]);
+			rp[_] = uniform_dist<0, 1, 1>();
+			rs[_] = uniform_dist<0, 1, 1>();
+			rg[_] = uniform_dist<0, 1, 1>();
 		}
 
-		for (uns _ = 0; _ < gsize(); ++_) {
-			DLOG(INFO) << "x[" << _ << "] += " << v[_];
-			x[_] += v[_];
-		}
+		meave::ga::variation::pso_move(x, v, best_x, subswarm_x, global_best_x, rp, rs, rg, gsize(),
+					       P::pso().omega(), P::pso().psi.particle_best(), P::pso().psi.subswarm_best(), P::pso().psi.global_best());
+	}
+
+	/**
+	 * Updates the bests by fitness fit of the new position of particle picked_idx.
+	 */
+	void record(const uns picked_idx, const Float fit) noexcept {
+		Float *x = &positions_[gsize() * picked_idx];
+		Float *best_x = &best_positions_[gsize() * picked_idx];
+		Float *global_best_x = &best_positions_[gsize() * P::psize()];
+		Float *v = &velocities_[gsize() * picked_idx];
+		const uns subswarm_idx = subswarm_map_[picked_idx];
+		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
-		const Float fit = fitness<FITNESS_FULL>(picked_idx);
 		DLOG(INFO) << "New member generated:\n"
 			      "\tmin - max = " << *$::min_element(&x[0], &x[gsize()]) << " - " << *$::max_element(&x[0], &x[gsize()]) << "\n"
 			      "\tvmin - vmax = " << *$::min_element(&v[0], &v[gsize()]) << " - " << *$::max_element(&v[0], &v[gsize()]) << "\n"
@@ -350,6 +465,58 @@ private:
 		}
 	}
 
+	void maybe_gen_child(const uns picked_idx) noexcept {
+		move(picked_idx);
+
+		// The child changes nothing unless it beats at least one of the bests.
+		const uns subswarm_idx = subswarm_map_[picked_idx];
+		const Float threshold = $::min({best_fitnesses_[picked_idx], best_subswarm_fitnesses_[subswarm_idx], best_fitnesses_[P::psize()]});
+		if (P::progressive_precision()) {
+			// Approximate fitness differs from the exact one by far less than the margin.
+			const Float screen_threshold = threshold - P::approx_margin();
+			++children_screened_;
+			// The exact evaluation replays the initial noise of the approximate
+			//   one, so they differ only by the sigmoid.
+			const RandomGenerator rand = rand_;
+			const $::uniform_real_distribution<Float> dist = dist_;
+			if (fitness<FITNESS_FULL, true>(picked_idx, Nothing(), screen_threshold) < screen_threshold)
+				return;
+			++children_rechecked_;
+			rand_ = rand;
+			dist_ = dist;
+		}
+		record(picked_idx, fitness<FITNESS_FULL>(picked_idx, Nothing(), threshold));
+	}
+
+	/**
+	 * Multi-fidelity sweep: moves all particles at once and evaluates them by
+	 *   successive halving. Only children whose estimate beats the best of
+	 *   their subswarm or the global best are evaluated fully, and only those
+	 *   may update the bests.
+	 */
+	void gen_children() noexcept {
+		$::vector<Phenotype> phes;
+		for (uns _ = 0; _ < P::psize(); ++_) {
+			move(_);
+			phes.push_back(phenotype(_));
+		}
+
+		$::vector<SuccessiveHalving::Result> results(P::psize());
+		halving_(P::psize(), [this, &phes](const uns c, const uns scenario) -> Float {
+			return scenario_sim(phes[c], scenario);
+		}, [this](const uns c, const Float estimate) -> bool {
+			return estimate > $::min(best_subswarm_fitnesses_[subswarm_map_[c]], best_fitnesses_[P::psize()]);
+		}, [](const uns b, const uns e, auto &&fn) {
+			for (uns i = b; i < e; ++i)
+				fn(i);
+		}, &results[0]);
+
+		for (uns _ = 0; _ < P::psize(); ++_) {
+			if (results[_].full(SCENARIOS_NUM))
+				record(_, results[_].fitness_);
+		}
+	}
+
 	template<typename It, typename Jt>
 	$::string dbg_items(const uns num, const It members, const Jt fitnesses) const noexcept {
 		assert(members != It());
@@ -366,63 +533,102 @@ private:
 		return o.str();
 	}
 
+	/**
+	 * Full fitness of every member (written to results_PPP_MMM.csv), the
+	 *   worst and the best one to out_worstbest . Its evaluations are not
+	 *   work of the optimizer, they are counted apart from evals_ and sims_ .
+	 */
+	void population_statistics(const uns popgen_idx, $::ostream &out_worstbest) noexcept {
+		const trace::Scope scope("statistics", "ga");
+		const uns positions_idx = popgen_idx/P::psize();
+		const ::uint64_t evals = evals_;
+		const ::uint64_t sims = sims_;
+		Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
+		Float max_fits = -$::numeric_limits<Float>::max(); // The best member
+		uns min_idx = 0;
+		uns max_idx = 0;
+		for (uns i = 0; i < P::psize(); ++i) {
+			$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", positions_idx, i), $::ofstream::trunc);
+			out_res << "Population" << "\t"
+				<< "Member" << "\t"
+				<< "Experiment" << "\t"
+				<< "Start" << "\t"
+				<< "Input" << "\t"
+				<< "RealOutput" << "\t"
+				<< "ExpectedOutput" << "\t"
+				<< "f" << "\n";
+			const Float fit = fitness<FITNESS_FULL>(i, [positions_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+				out_res << positions_idx << "\t"
+					<< i << "\t"
+					<< idx << "\t"
+					<< start << "\t"
+					<< input << "\t"
+					<< real << "\t"
+					<< expected << "\t"
+					<< f << "\n";
+			});
+
+			if (fit < min_fits)
+				$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
+			if (fit > max_fits)
+				$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
+		}
+
+		stats_evals_ += evals_ - evals;
+		stats_sims_ += sims_ - sims;
+		evals_ = evals;
+		sims_ = sims;
+
+		out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << "\n";
+
+		LOG(INFO) << "Population Statistics";
+		LOG(INFO) << "\tPopulation: " << (popgen_idx / P::psize());
+		LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
+		LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
+		EvalCounter::log(evals_, sims_, stats_evals_, stats_sims_, trials_num());
+		if (sims_raced_) {
+			LOG(INFO) << "\tsimulations saved by racing: " << 100. * sims_saved_ / sims_raced_ << '%';
+			sims_raced_ = sims_saved_ = 0;
+		}
+		if (children_screened_) {
+			LOG(INFO) << "\tchildren evaluated exactly after screening: " << 100. * children_rechecked_ / children_screened_ << '%';
+			children_screened_ = children_rechecked_ = 0;
+		}
+		if (P::multi_fidelity().enabled()) {
+			LOG(INFO) << "\tsimulations saved by successive halving: " << 100. * halving_.saved() << '%';
+			halving_.reset_stats();
+		}
+	}
+
 	/**
 	 * Perform's Particle MultiSwarm Optimization.
 	 * Fitness function is in the range (-inf, +1] .
+	 * Work of every generation is published in metrics (meave/ga/metrics.hpp),
+	 *   a sweep publishes its runs by itself.
 	 */
 	void evolve() noexcept {
 		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
 		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
 
-		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
-			maybe_gen_child(popgen_idx % P::psize());
-
-			if (0 == (popgen_idx + 1) % P::psize()) {
-				const uns positions_idx = popgen_idx/P::psize();
-				Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
-				Float max_fits = -$::numeric_limits<Float>::max(); // The best member
-				uns min_idx = 0;
-				uns max_idx = 0;
-				for (uns i = 0; i < P::psize(); ++i) {
-					$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", positions_idx, i), $::ofstream::trunc);
-					out_res << "Population" << "\t"
-						<< "Member" << "\t"
-						<< "Experiment" << "\t"
-						<< "Start" << "\t"
-						<< "Input" << "\t"
-						<< "RealOutput" << "\t"
-						<< "ExpectedOutput" << "\t"
-						<< "f" << "\n";
-					const Float fit = fitness<FITNESS_FULL>(i, [positions_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
-						out_res << positions_idx << "\t"
-							<< i << "\t"
-							<< idx << "\t"
-							<< start << "\t"
-							<< input << "\t"
-							<< real << "\t"
-							<< expected << "\t"
-							<< f << "\n";
-					});
-
-					if (fit < min_fits)
-						$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
-					if (fit > max_fits)
-						$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
-				}
-
-				out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << "\n";
-
-				LOG(INFO) << "Population Statistics";
-				LOG(INFO) << "\tPopulation: " << (popgen_idx / P::psize());
-				LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
-				LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
-			}
+		const $::unique_ptr<Metrics> metrics = make_metrics(1, "pso");
+		for (bool more = true; more; ) {
+			more = step(&out_worstbest);
+			if (metrics)
+				metrics->update(0, [this](Metrics::Values &v) {
+					v.evaluations_ = evals_;
+					v.simulations_ = sims_;
+					v.cache_hits_ = sims_cut_;
+					v.generation_ = generation();
+					v.best_fitness_ = best_fitness();
+				});
 		}
 	}
 
 public:
-	SimpleTrialParticleMultiswarmOptimization() noexcept
-	:	nncalc_(P::nn(), P::ts())
+	explicit SimpleTrialParticleMultiswarmOptimization(const Params &params = Params()) noexcept
+	:	Params(params)
+	,	nncalc_(P::nn(), P::ts())
+	,	nncalc_approx_(P::nn(), P::ts())
 	,	positions_(P::psize() * gsize(), 0.f)
 	,	best_positions_((P::psize() + 1) * gsize(), 0.f)
 	,	velocities_(P::psize() * gsize(), 0.f)
@@ -430,7 +636,19 @@ public:
 	,	best_subswarm_positions_(P::pso().subswarms_num() * gsize(), 0.f)
 	,	best_subswarm_fitnesses_(P::pso().subswarms_num(), 0.f)
 	,	subswarm_map_(P::psize(), 0)
-	,	rand_(meave::seed()) {
+	,	rand_(meave::seed())
+	,	mixed_order_(mixed_scenario_order(SCENARIOS_NUM))
+	,	halving_(SCENARIOS_NUM, P::multi_fidelity().min_scenarios(), P::multi_fidelity().eta())
+	,	sims_raced_(0)
+	,	sims_saved_(0)
+	,	children_screened_(0)
+	,	children_rechecked_(0)
+	,	sims_(0)
+	,	evals_(0)
+	,	sims_cut_(0)
+	,	stats_evals_(0)
+	,	stats_sims_(0)
+	,	popgen_idx_(0) {
 		$::generate(positions_.begin(), positions_.end(), [this]() -> Float { return uniform_dist<0, +1, 1>(); });
 		$::generate(velocities_.begin(), velocities_.end(), [this]() -> Float { return uniform_dist<-1, +1, 1>(); });
 		$::copy(positions_.begin(), positions_.end(), best_positions_.begin());
@@ -462,6 +680,62 @@ public:
 	void operator()() noexcept {
 		evolve();
 	}
+
+	/**
+	 * One sweep of the optimization: children up to the next population
+	 *   statistics, which are computed only with out_worstbest .
+	 * @return false When the run is finished.
+	 */
+	bool step($::ostream *out_worstbest = nullptr) noexcept {
+		const trace::Scope scope("generation", "ga");
+		const uns popgen_end = 5 * P::psize() * gsize() + 1;
+		while (popgen_idx_ < popgen_end) {
+			const uns popgen_idx = popgen_idx_++;
+			if (!P::multi_fidelity().enabled())
+				maybe_gen_child(popgen_idx % P::psize());
+			else if (0 == popgen_idx % P::psize())
+				gen_children();
+
+			if (0 == (popgen_idx + 1) % P::psize()) {
+				if (out_worstbest)
+					population_statistics(popgen_idx, *out_worstbest);
+				return popgen_idx_ < popgen_end;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @return Fitness of the best position found so far.
+	 */
+	Float best_fitness() const noexcept {
+		return best_fitnesses_[P::psize()];
+	}
+
+	/**
+	 * @return Simulations run so far, including the initial evaluation, not population statistics.
+	 */
+	::uint64_t sims() const noexcept {
+		return sims_;
+	}
+
+	::uint64_t evaluations() const noexcept {
+		return evals_;
+	}
+
+	/**
+	 * @return Simulations racing spared so far.
+	 */
+	::uint64_t sims_cut() const noexcept {
+		return sims_cut_;
+	}
+
+	/**
+	 * @return Populations generated so far.
+	 */
+	uns generation() const noexcept {
+		return popgen_idx_ / P::psize();
+	}
 };
 
 } } /* meave::ga */
@@ -0,0 +1,462 @@
+/*
+ * Hyper-parameter sweep of SimpleTrialParticleMultiswarmOptimization: runs
+ *   of all combinations of the swept values share one pool of threads.
+ *
+ * usage: sweep [sweep options] [experiment options]
+ *          --set psize=20,40 --set pso.omega=0.1,0.2,0.4 --trial 30
+ *          -- see sweep --help and simple-trial --help
+ *
+ * Options which are not options of the sweep are the base configuration of
+ *   every run, --set NAME=V1,V2,... adds --NAME Vi to it. Switches are swept
+ *   by values on and off.
+ *
+ * A run is advanced by one step (children of one population) per task of
+ *   the pool (meave/lib/par/steal_pool.hpp) and the task resubmits itself,
+ *   so runs take turns fairly however many there are. A run stops when it
+ *   finishes, exhausts its budget of thread CPU time (--max-seconds) or of
+ *   simulations (--max-sims), or is dominated: after --grace steps its best
+ *   fitness is worse than the median of best fitnesses of other runs at the
+ *   same step (median stopping rule).
+ *
+ * The consolidated table (TSV, the best run first) is written to --out.
+ *
+ * Every thread publishes its counters after each step in a metrics segment
+ *   (meave/ga/metrics.hpp) in --metrics, watch them by meave-top.
+ */
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "config.hpp"
+#include "params.hpp"
+#include "simple-trial.hpp"
+#include "meave/ga/metrics.hpp"
+#include "meave/lib/par/steal_pool.hpp"
+#include "meave/lib/trace.hpp"
+
+namespace {
+
+typedef meave::ga::SinglePrecision::Float Float;
+
+struct Options {
+	uns threads_;
+	double max_seconds_;	///< 0 -- unlimited
+	::uint64_t max_sims_;	///< 0 -- unlimited
+	uns grace_;
+	$::string out_file_;
+	$::string metrics_dir_;	///< Empty -- no metrics segment.
+	$::vector<$::string> sets_;
+	$::vector<$::string> base_;	///< Options of the experiment.
+
+	Options() noexcept
+	:	threads_($::max(1U, $::thread::hardware_concurrency()))
+	,	max_seconds_(0)
+	,	max_sims_(0)
+	,	grace_(5)
+	,	out_file_("./sweep.tsv")
+	,	metrics_dir_("/dev/shm") {
+	}
+
+	bool parse(const int argc, const char * const argv[]) {
+		namespace po = boost::program_options;
+		using po::value;
+
+		const $::string S_USAGE = $::string("Usage: ") + argv[0] + " [sweep options] [experiment options]";
+
+		po::options_description options("Sweep options");
+		options.add_options()
+		("help"       , "display the help message and exit")
+		("threads"    , value(&threads_)->default_value(threads_), "number of threads")
+		("max-seconds", value(&max_seconds_)->default_value(max_seconds_), "CPU time budget of a run in seconds (0 -- unlimited)")
+		("max-sims"   , value(&max_sims_)->default_value(max_sims_), "budget of simulations of a run (0 -- unlimited)")
+		("grace"      , value(&grace_)->default_value(grace_), "steps before a dominated run may be cancelled")
+		("out"        , value(&out_file_)->default_value(out_file_), "results table")
+		("metrics"    , value(&metrics_dir_)->default_value(metrics_dir_), "directory of the live metrics segment for meave-top (empty -- none)")
+		("set"        , value(&sets_)->composing(), "NAME=V1,V2,... swept option of the experiment, may be repeated")
+		;
+
+		try {
+			po::variables_map option_map;
+			const po::parsed_options parsed = po::command_line_parser(argc, argv).options(options).allow_unregistered().run();
+			po::store(parsed, option_map);
+			if (option_map.count("help")) {
+				$::cerr << S_USAGE << "\n" << options << $::endl;
+				return false;
+			}
+			po::notify(option_map);
+			base_ = po::collect_unrecognized(parsed.options, po::include_positional);
+		} catch (const po::error &error) {
+			$::cerr << "Error: " << error.what() << "\n\n" << S_USAGE << "\n" << options << $::endl;
+			return false;
+		}
+
+		if (!threads_) {
+			$::cerr << "Error: threads must be positive" << $::endl;
+			return false;
+		}
+		return true;
+	}
+};
+
+/**
+ * Swept option and its values.
+ */
+struct Axis {
+	$::string name_;
+	$::vector<$::string> values_;
+
+	bool parse(const $::string &set) {
+		const auto eq = set.find('=');
+		if (eq == $::string::npos || !eq) {
+			$::cerr << "Error: --set " << set << ": NAME=V1,V2,... expected" << $::endl;
+			return false;
+		}
+		name_ = set.substr(0, eq);
+		$::istringstream values(set.substr(eq + 1));
+		for ($::string value; $::getline(values, value, ',');)
+			values_.push_back(value);
+		if (values_.empty()) {
+			$::cerr << "Error: --set " << set << ": no values" << $::endl;
+			return false;
+		}
+		return true;
+	}
+};
+
+/**
+ * Run of the experiment advanced step by step, independent of the number
+ *   of neurons its kernels are specialized for.
+ */
+class Run {
+public:
+	virtual ~Run() noexcept {
+	}
+
+	/**
+	 * @return false When the run is finished.
+	 */
+	virtual bool step() noexcept = 0;
+	virtual Float best_fitness() const noexcept = 0;
+	virtual ::uint64_t sims() const noexcept = 0;
+	virtual ::uint64_t evaluations() const noexcept = 0;
+	virtual ::uint64_t sims_cut() const noexcept = 0;
+	virtual uns generation() const noexcept = 0;
+};
+
+template<uns NN>
+class PsoRun : public Run {
+private:
+	meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, meave::ga::Params<NN>> pso_;
+
+public:
+	explicit PsoRun(const meave::ga::Config &config) noexcept
+	:	pso_(meave::ga::Params<NN>(config)) {
+	}
+
+	bool step() noexcept override {
+		return pso_.step();
+	}
+
+	Float best_fitness() const noexcept override {
+		return pso_.best_fitness();
+	}
+
+	::uint64_t sims() const noexcept override {
+		return pso_.sims();
+	}
+
+	::uint64_t evaluations() const noexcept override {
+		return pso_.evaluations();
+	}
+
+	::uint64_t sims_cut() const noexcept override {
+		return pso_.sims_cut();
+	}
+
+	uns generation() const noexcept override {
+		return pso_.generation();
+	}
+};
+
+/**
+ * Common sizes of network run with kernels specialized at compile time,
+ *   as in simple-trial.
+ */
+$::unique_ptr<Run> make_run(const meave::ga::Config &config) {
+	switch (config.nn()) {
+	case 2: return $::unique_ptr<Run>(new PsoRun<2>(config));
+	case 3: return $::unique_ptr<Run>(new PsoRun<3>(config));
+	case 4: return $::unique_ptr<Run>(new PsoRun<4>(config));
+	case 5: return $::unique_ptr<Run>(new PsoRun<5>(config));
+	case 6: return $::unique_ptr<Run>(new PsoRun<6>(config));
+	case 8: return $::unique_ptr<Run>(new PsoRun<8>(config));
+	default: return $::unique_ptr<Run>(new PsoRun<0>(config));
+	}
+}
+
+double thread_seconds() noexcept {
+	struct ::timespec ts;
+	::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+struct Job {
+	enum Status {
+		  RUNNING
+		, FINISHED
+		, OUT_OF_TIME
+		, OUT_OF_SIMS
+		, CANCELLED
+	};
+
+	uns id_;
+	$::vector<$::string> values_;
+	meave::ga::Config config_;
+	$::unique_ptr<Run> run_;	///< Created by the first step, destroyed by the last one.
+	Status status_;
+	uns steps_;
+	::uint64_t sims_;
+	::uint64_t evals_;
+	::uint64_t sims_cut_;
+	double seconds_;
+	Float best_;
+
+	Job(const uns id, const $::vector<$::string> &values, const meave::ga::Config &config)
+	:	id_(id)
+	,	values_(values)
+	,	config_(config)
+	,	status_(RUNNING)
+	,	steps_(0)
+	,	sims_(0)
+	,	evals_(0)
+	,	sims_cut_(0)
+	,	seconds_(0)
+	,	best_(-$::numeric_limits<Float>::max()) {
+	}
+
+	static const char *status_str(const Status status) noexcept {
+		static const char *const STRS[] = { "running", "finished", "out-of-time", "out-of-sims", "cancelled" };
+		return STRS[status];
+	}
+};
+
+/**
+ * @return Metrics segment with a slot per thread, null when disabled or
+ *   when it cannot be created -- the sweep doesn't need it.
+ */
+$::unique_ptr<meave::ga::Metrics> make_metrics(const Options &opts) {
+	return meave::ga::make_metrics(opts.threads_, "sweep", opts.metrics_dir_.c_str());
+}
+
+class Sweep {
+private:
+	const Options &opts_;
+	$::vector<$::unique_ptr<Job>> jobs_;
+
+	$::mutex mutex_;
+	$::vector<$::vector<Float>> curves_;	///< curves_[step] -- best fitnesses of runs after step+1 steps.
+
+	/**
+	 * Records the best fitness of job after its last step.
+	 * @return Whether the job is worse than the median of other runs at that step.
+	 */
+	bool dominated(const Job &job) {
+		constexpr uns MIN_PEERS = 3;
+
+		$::lock_guard<$::mutex> lock(mutex_);
+		if (curves_.size() < job.steps_)
+			curves_.resize(job.steps_);
+		$::vector<Float> peers = curves_[job.steps_ - 1];
+		curves_[job.steps_ - 1].push_back(job.best_);
+
+		if (job.steps_ <= opts_.grace_ || peers.size() < MIN_PEERS)
+			return false;
+		const auto mid = peers.begin() + peers.size() / 2;
+		$::nth_element(peers.begin(), mid, peers.end());
+		return job.best_ < *mid;
+	}
+
+	/**
+	 * Adds the work of the last step of job to the metrics of this thread.
+	 */
+	void publish(const Job &job) noexcept {
+		if (!metrics_)
+			return;
+		const Run &run = *job.run_;
+		metrics_->update(meave::par::StealPool::current(), [this, &job, &run](meave::ga::Metrics::Values &v) {
+			v.evaluations_ += run.evaluations() - job.evals_;
+			v.simulations_ += run.sims() - job.sims_;
+			v.cache_hits_ += run.sims_cut() - job.sims_cut_;
+			v.queue_depth_ = pool_.queued();
+			v.generation_ = run.generation();
+			v.task_ = job.id_;
+			v.best_fitness_ = run.best_fitness();
+		});
+	}
+
+	void step(Job &job) noexcept {
+		const double start = thread_seconds();
+		if (!job.run_)
+			job.run_ = make_run(job.config_);
+		const bool more = job.run_->step();
+		job.seconds_ += thread_seconds() - start;
+
+		++job.steps_;
+		publish(job);
+		job.sims_ = job.run_->sims();
+		job.evals_ = job.run_->evaluations();
+		job.sims_cut_ = job.run_->sims_cut();
+		job.best_ = job.run_->best_fitness();
+
+		if (!more)
+			job.status_ = Job::FINISHED;
+		else if (opts_.max_seconds_ > 0 && job.seconds_ >= opts_.max_seconds_)
+			job.status_ = Job::OUT_OF_TIME;
+		else if (opts_.max_sims_ && job.sims_ >= opts_.max_sims_)
+			job.status_ = Job::OUT_OF_SIMS;
+		// The curve is recorded also by stopped runs, they are peers as well.
+		if (dominated(job) && job.status_ == Job::RUNNING)
+			job.status_ = Job::CANCELLED;
+
+		if (job.status_ != Job::RUNNING) {
+			job.run_.reset();
+			LOG(INFO) << "Run " << job.id_ << ' ' << Job::status_str(job.status_) << " after " << job.steps_ << " steps, best fitness " << job.best_;
+			return;
+		}
+		pool_.submit([this, &job]() { step(job); });
+	}
+
+	$::unique_ptr<meave::ga::Metrics> metrics_;	///< Null -- not published.
+	meave::par::StealPool pool_;	///< The last member, its destructor waits for tasks using the others.
+
+public:
+	Sweep(const Options &opts, $::vector<$::unique_ptr<Job>> &&jobs)
+	:	opts_(opts)
+	,	jobs_($::move(jobs))
+	,	metrics_(make_metrics(opts))
+	,	pool_(opts.threads_) {
+	}
+
+	void operator()() {
+		for (auto &$: jobs_) {
+			Job &job = *$;
+			pool_.submit([this, &job]() { step(job); });
+		}
+		pool_.wait();
+	}
+
+	/**
+	 * Writes the table of runs, the best one first.
+	 */
+	void write(const $::vector<Axis> &axes, $::ostream &out) const {
+		$::vector<const Job*> jobs;
+		for (const auto &$: jobs_)
+			jobs.push_back($.get());
+		$::stable_sort(jobs.begin(), jobs.end(), [](const Job *a, const Job *b) {
+			return a->best_ > b->best_;
+		});
+
+		out << "Run";
+		for (const auto &$: axes)
+			out << "\t" << $.name_;
+		out << "\t" << "Status" << "\t" << "Steps" << "\t" << "Sims" << "\t" << "Seconds" << "\t" << "BestFitness" << "\n";
+		for (const Job *$: jobs) {
+			out << $->id_;
+			for (const auto &value: $->values_)
+				out << "\t" << value;
+			out << "\t" << Job::status_str($->status_)
+				<< "\t" << $->steps_
+				<< "\t" << $->sims_
+				<< "\t" << $->seconds_
+				<< "\t" << $->best_ << "\n";
+		}
+	}
+};
+
+/**
+ * @return Configurations of all combinations of values of axes, empty on error.
+ */
+$::vector<$::unique_ptr<Job>> make_jobs(const char *argv0, const Options &opts, const $::vector<Axis> &axes) {
+	$::vector<$::unique_ptr<Job>> $$;
+	$::vector<uns> idx(axes.size(), 0);
+	for (uns id = 0;; ++id) {
+		$::vector<$::string> args{argv0};
+		args.insert(args.end(), opts.base_.begin(), opts.base_.end());
+		$::vector<$::string> values;
+		for (uns _ = 0; _ < axes.size(); ++_) {
+			const $::string &value = axes[_].values_[idx[_]];
+			values.push_back(value);
+			if (value == "off")
+				continue;
+			args.push_back("--" + axes[_].name_);
+			if (value != "on")
+				args.push_back(value);
+		}
+
+		$::vector<const char*> argv;
+		for (const auto &$: args)
+			argv.push_back($.c_str());
+		meave::ga::Config config;
+		if (!config.parse(argv.size(), &argv[0])) {
+			$$.clear();
+			return $$;
+		}
+		$$.emplace_back(new Job(id, values, config));
+
+		// The next combination, the last axis changes the fastest.
+		uns _ = axes.size();
+		while (_ && ++idx[_ - 1] == axes[_ - 1].values_.size())
+			idx[--_] = 0;
+		if (!_)
+			return $$;
+	}
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(int argc, char *argv[]) {
+		// Initialize Google's logging library.
+		google::InitGoogleLogging(argv[0]);
+
+		Options opts;
+		if (!opts.parse(argc, argv))
+			return 1;
+
+		$::vector<Axis> axes(opts.sets_.size());
+		for (uns _ = 0; _ < axes.size(); ++_) {
+			if (!axes[_].parse(opts.sets_[_]))
+				return 1;
+		}
+
+		$::vector<$::unique_ptr<Job>> jobs = make_jobs(argv[0], opts, axes);
+		if (jobs.empty())
+			return 1;
+		LOG(INFO) << "Sweep of " << jobs.size() << " runs on " << opts.threads_ << " threads";
+
+		Sweep sweep(opts, $::move(jobs));
+		{
+			const meave::trace::Session trace_session;
+			sweep();
+		}
+
+		$::ofstream out(opts.out_file_, $::ofstream::trunc);
+		sweep.write(axes, out);
+		if (!out) {
+			$::cerr << "Error: Cannot write " << opts.out_file_ << $::endl;
+			return 1;
+		}
+
+		return 0;
+}
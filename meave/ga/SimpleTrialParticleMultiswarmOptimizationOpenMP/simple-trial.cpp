@@ -1,3 +1,5 @@
+#include <cstring>
+#include <iostream>
 #include <tuple>
 
 #include "simple-trial.hpp"
@@ -83,17 +85,45 @@ struct Params {
 	constexpr ParticleSwarmOptimization pso() const noexcept {
 		return ParticleSwarmOptimization();
 	}
+
+	constexpr meave::par::Placement placement() const noexcept {
+		return meave::par::Placement::SCATTER;
+	}
+
+	struct Checkpoint {
+		constexpr uns interval() const noexcept {
+			return 1;
+		}
+
+		constexpr const char *file() const noexcept {
+			return "./checkpoint.dat";
+		}
+	};
+
+	constexpr Checkpoint checkpoint() const noexcept {
+		return Checkpoint();
+	}
 };
 
 } /* Anonymouse Namespace */
 
 int
-main(int /* argc */, char *argv[]) {
+main(int argc, char *argv[]) {
 		// Initialize Google's logging library.
 		google::InitGoogleLogging(argv[0]);
 
+		bool resume = false;
+		for (int _ = 1; _ < argc; ++_) {
+			if (!::strcmp(argv[_], "--resume")) {
+				resume = true;
+			} else {
+				$::cerr << "usage: " << argv[0] << " [--resume]" << $::endl;
+				return 1;
+			}
+		}
+
 		LOG(INFO) << "Dia dhuit ar domhan!";
-		meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, Params>{}();
+		meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, Params>{resume}();
 
 		return 0;
 }
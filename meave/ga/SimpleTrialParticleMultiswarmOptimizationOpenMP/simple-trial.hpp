@@ -3,22 +3,33 @@
 #	define MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_HPP
 
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/metrics.hpp"
+#	include "meave/ga/variation.hpp"
 #	include "meave/commons.hpp"
+#	include "meave/lib/checkpoint.hpp"
 #	include "meave/lib/math.hpp"
+#	include "meave/lib/math/sum.hpp"
 #	include "meave/lib/raii/accumulate_flush.hpp"
 #	include "meave/lib/raii/mmap_create.hpp"
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/str_printf.hpp"
 #	include "meave/lib/xrange.hpp"
+#	include "meave/lib/par/topology.hpp"
 
 #	include <algorithm>
 #	include <atomic>
+#	include <cstdlib>
+#	include <cstring>
 #	include <numeric>
 #	include <future>
 #	include <fstream>
+#	include <memory>
 #	include <sstream>
 #	include <random>
 #	include <tuple>
+#	include <omp.h>
+#	include <unistd.h>
 
 namespace meave { namespace ga {
 
@@ -56,6 +67,13 @@ struct SinglePrecision {
  *           Param::range() -- range of weights: [-5.0, +5.0]
  *
  *           Param::subgen_lens() -- range of lens for subgen() [+5, +5]
+ *
+ *           -- Checkpoints --
+ *           Param::checkpoint().interval() -- generations between checkpoints
+ *           Param::checkpoint().file() -- file with the last checkpoint
+ *
+ *           -- Thread Parameters --
+ *           Param::placement() -- placement of OpenMP threads on CPUs (meave::par::Placement)
  */
 template <typename Types, typename Params>
 class SimpleTrialParticleMultiswarmOptimization : public Types
@@ -117,8 +135,15 @@ public:
 		return static_cast<uns>( static_cast<Float>(this->trial())/this->ts() );
 	}
 
-	constexpr uns cpus_num() const noexcept {
-		return 8;
+	/**
+	 * @return Threads filling the machine, at most MEAVE_THREADS when it is set
+	 *   (e.g. to measure scaling, meave/ga/bench).
+	 */
+	uns cpus_num() const noexcept {
+		const uns $$ = topology_.threads_num(P::placement());
+		const char *env = ::getenv("MEAVE_THREADS");
+		const int limit = env ? ::atoi(env) : 0;
+		return limit > 0 ? $::min($$, uns(limit)) : $$;
 	}
 
 private:
@@ -183,9 +208,16 @@ private:
 	$::vector<Float> best_subswarm_positions_;
 	$::vector<Float> best_subswarm_fitnesses_;
 
+	EvalCounter eval_counter_;
+
 	$::vector<uns> subswarm_map_;
 
+	const meave::par::Topology topology_;
 	const uns cpus_num_;
+	const $::vector<uns> pus_;
+
+	meave::checkpoint::Writer checkpointer_;
+	uns popgen_begin_;	///< Where evolve() starts, it is not 0 after resume.
 
 	static thread_local RandomGenerator rand_;
 	static thread_local $::uniform_real_distribution<Float> dist_;
@@ -241,39 +273,52 @@ private:
 	enum FitnessKind {
 		  FITNESS_RAND
 		, FITNESS_FULL
+		, FITNESS_STATISTICS	///< FITNESS_FULL of population statistics, not counted as work of the optimizer.
 	};
 	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
 	Float fitness(const uns index, Wr wr = Nothing()) noexcept {
 		const Phenotype phe = phenotype(index);
+		if (FK == FITNESS_STATISTICS)
+			eval_counter_.add_statistics(200 * 11);
+		else
+			eval_counter_.add(FK == FITNESS_FULL ? 200 * 11 : P::repeat());
 
 		if (FK == FITNESS_RAND) {
-			Float sum = 0;
-			#pragma omp parallel for reduction(+:sum)
+			// Scenarios and their noise drawn by this thread in order, results by
+			//   index summed in fixed order, the same for any number of threads.
+			$::vector<Float> vels(P::repeat());
+			$::vector<Float> start_poss(P::repeat());
+			$::vector<unsigned> seeds(P::repeat());
 			for (uns _ = 0; _ < P::repeat(); ++_) {
-				const Float vel = dist_(rand_) * P::velrange();
-				const Float start_pos = dist_(rand_) * P::startposrange();
-
-				sum += run_sim(start_pos, vel, phe, wr);
+				vels[_] = dist_(rand_) * P::velrange();
+				start_poss[_] = dist_(rand_) * P::startposrange();
+				seeds[_] = rand_();
 			}
-			return sum / P::repeat();
+			$::vector<Float> sims(P::repeat());
+			#pragma omp parallel for
+			for (uns _ = 0; _ < P::repeat(); ++_)
+				sims[_] = run_sim(start_poss[_], vels[_], phe, seeds[_], wr);
+			return meave::math::compensated_sum(&sims[0], P::repeat()) / P::repeat();
 		}
-		if (FK == FITNESS_FULL) {
+		if (FK == FITNESS_FULL || FK == FITNESS_STATISTICS) {
 			const uns i_max = 200;
-			Float sum = 0;
-			#pragma omp parallel for reduction(+:sum)
+			const uns j_max = 11;
+			$::vector<unsigned> seeds(i_max * j_max);
+			$::generate(seeds.begin(), seeds.end(), [this]() -> unsigned { return rand_(); });
+			$::vector<Float> temps(i_max);
+			#pragma omp parallel for
 			for (uns _ = 0; _ < i_max; ++_) {
 				Float temp = 0;
-				const uns j_max = 11;
 				for (const uns j: meave::make_xrange(0U, j_max)) {
 					const uns start_pos = j*10;
 					const Float f_start_pos = Float(start_pos);
 					const Float f_vel = Float(_) / 100;
-					const Float err = run_sim(f_start_pos, f_vel, phe, wr);
+					const Float err = run_sim(f_start_pos, f_vel, phe, seeds[_ * j_max + j], wr);
 					temp += err;
 				}
-				sum += temp /= j_max;
+				temps[_] = temp / j_max;
 			}
-			return sum / i_max;
+			return meave::math::compensated_sum(&temps[0], i_max) / i_max;
 		}
 		assert(0);
 		return Float();
@@ -281,15 +326,19 @@ private:
 
 	/**
 	 * Runs simulation for one phenotype...
+	 * @param seed Seed of the initial noise of neurons, so that the result
+	 *   doesn't depend on the thread running the simulation.
 	 */
 	template<typename WRITER>
-	Float run_sim(const double start, const double vel, const Phenotype &phenotype, WRITER wr = Nothing()) const noexcept {
+	Float run_sim(const double start, const double vel, const Phenotype &phenotype, const unsigned seed, WRITER wr = Nothing()) const noexcept {
 		$::vector<Float> y(P::nn());
 		$::vector<Float> ei(P::nn(), 0.0);
 		std::vector<Float> v(P::nn());
 
-		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this](const Float $) -> Float {
-			return -$ + dist_(rand_) * 2 * P::range() - P::range();
+		$::default_random_engine noise(seed);
+		$::uniform_real_distribution<Float> noise_dist;
+		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this, &noise, &noise_dist](const Float $) -> Float {
+			return -$ + noise_dist(noise) * 2 * P::range() - P::range();
 		});
 
 		Float distance = start;
@@ -327,25 +376,17 @@ private:
 		const uns subswarm_idx = subswarm_map_[picked_idx];
 		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
+		Float rp[gsize()];
+		Float rs[gsize()];
+		Float rg[gsize()];
 		for (uns _ = 0; _ < gsize(); ++_) {
-			const Float rp = uniform_dist<0, 1, 1>();
-			const Float rs = uniform_dist<0, 1, 1>();
-			const Float rg = uniform_dist<0, 1, 1>();
-
-			DLOG(INFO) << "v[" << _ << "] = " << P::pso().omega() << " * " << v[_] << " + "
-				   << P::pso().psi.particle_best() << " * " << rp << " * " << "(" << best_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.subswarm_best() << " * " << rs << " * " << "(" << subswarm_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.global_best() << " * " << rg << " * " << "(" << global_best_x[_] << " - " << x[_] << ")";
-			v[_] = P::pso().omega() * v[_] +
-				      P::pso().psi.particle_best() * rp * (best_x[_] - x[_]) +
-				      P::pso().psi.subswarm_best() * rs * (subswarm_x[_] - x[_]) +
-				      P::pso().psi.global_best() * rg * (global_best_x[_] - x[_]);
+			rp[_] = uniform_dist<0, 1, 1>();
+			rs[_] = uniform_dist<0, 1, 1>();
+			rg[_] = uniform_dist<0, 1, 1>();
 		}
 
-		for (uns _ = 0; _ < gsize(); ++_) {
-			DLOG(INFO) << "x[" << _ << "] += " << v[_];
-			x[_] += v[_];
-		}
+		meave::ga::variation::pso_move(x, v, best_x, subswarm_x, global_best_x, rp, rs, rg, gsize(),
+					       P::pso().omega(), P::pso().psi.particle_best(), P::pso().psi.subswarm_best(), P::pso().psi.global_best());
 
 		const Float fit = fitness<FITNESS_FULL>(picked_idx);
 		DLOG(INFO) << "New member generated:\n"
@@ -458,32 +499,137 @@ private:
 			return *this;
 		}
 	};
+
+	/**
+	 * Sizes the OpenMP team to cpus_num_ and pins its threads by
+	 *   Param::placement(). The team is fixed, so the runtime keeps the same
+	 *   threads for every parallel region and they stay pinned. OMP_PROC_BIND
+	 *   (and OMP_PLACES) take precedence when they are set.
+	 */
+	void bind_threads() const {
+		omp_set_dynamic(0);
+		omp_set_num_threads(cpus_num_);
+		if (P::placement() == meave::par::Placement::NONE || omp_get_proc_bind() != omp_proc_bind_false)
+			return;
+
+		#pragma omp parallel
+		{
+			const uns th_id = omp_get_thread_num();
+			if (!topology_.bind_thread(pus_[th_id]))
+				LOG(WARNING) << "Cannot bind thread " << th_id << " to cpu " << topology_.pus()[pus_[th_id]].os_index_ << ": " << ::strerror(errno);
+		}
+	}
+
+	/**
+	 * Checkpoint of the complete state, evolve() continues by popgen_idx.
+	 *   Random generators are thread-local, so each thread of the OpenMP
+	 *   team stores its own. The distributions have no hidden state except
+	 *   of norm_dist_, which is stored as well.
+	 * @param worstbest_len Length of worstbest.csv flushed up to popgen_idx.
+	 */
+	meave::checkpoint::Out save_state(const uns popgen_idx, const ::uint64_t worstbest_len) {
+		$::vector<$::string> rands;
+		#pragma omp parallel
+		{
+			#pragma omp single
+			rands.resize(omp_get_num_threads());
+
+			$::ostringstream o;
+			o << static_cast<const $::default_random_engine&>(rand_) << ' ' << dist_ << ' ' << norm_dist_;
+			rands[omp_get_thread_num()] = o.str();
+		}
+
+		meave::checkpoint::Out $$;
+		$$.put(P::psize()).put(gsize()).put(P::pso().subswarms_num());
+		$$.put(popgen_idx);
+		$$.put(positions_).put(best_positions_).put(velocities_);
+		$$.put(best_fitnesses_).put(best_subswarm_positions_).put(best_subswarm_fitnesses_);
+		$$.put(subswarm_map_);
+		$$.put(eval_counter_.evals()).put(eval_counter_.sims());
+		$$.put(eval_counter_.stats_evals()).put(eval_counter_.stats_sims());
+		$$.put(worstbest_len);
+		$$.put(::uint64_t(rands.size()));
+		for (const $::string &$: rands)
+			$$.put($);
+		return $$;
+	}
+
+	/**
+	 * Restores state stored by save_state(). Rows of worstbest.csv written
+	 *   after the checkpoint are cut off, evolve() writes them again.
+	 * @throw Error When the checkpoint doesn't match Params.
+	 */
+	void restore_state(meave::checkpoint::In &in) {
+		uns psize, gsize_, subswarms_num;
+		in.get(psize).get(gsize_).get(subswarms_num);
+		if (psize != P::psize() || gsize_ != gsize() || subswarms_num != P::pso().subswarms_num())
+			throw Error("Checkpoint of different parameters: psize %u, gsize %u, subswarms %u", psize, gsize_, subswarms_num);
+
+		in.get(popgen_begin_);
+		in.get(positions_).get(best_positions_).get(velocities_);
+		in.get(best_fitnesses_).get(best_subswarm_positions_).get(best_subswarm_fitnesses_);
+		in.get(subswarm_map_);
+
+		::uint64_t evals, sims, stats_evals, stats_sims;
+		in.get(evals).get(sims).get(stats_evals).get(stats_sims);
+		eval_counter_.restore(evals, sims, stats_evals, stats_sims);
+
+		::uint64_t worstbest_len;
+		in.get(worstbest_len);
+		if (-1 == ::truncate("./worstbest.csv", worstbest_len))
+			throw Error("Cannot truncate ./worstbest.csv to %lu bytes: %m", static_cast<unsigned long>(worstbest_len));
+
+		::uint64_t rands_num;
+		in.get(rands_num);
+		$::vector<$::string> rands(rands_num);
+		for ($::string &$: rands)
+			in.get($);
+
+		uns threads_num = 0;
+		#pragma omp parallel
+		{
+			#pragma omp single
+			threads_num = omp_get_num_threads();
+
+			if (uns(omp_get_thread_num()) < rands.size()) {
+				$::istringstream i(rands[omp_get_thread_num()]);
+				i >> static_cast<$::default_random_engine&>(rand_) >> dist_ >> norm_dist_;
+			}
+		}
+		if (threads_num != rands.size())
+			LOG(WARNING) << "Checkpoint was taken with " << rands.size() << " threads, running with " << threads_num
+				     << ", the run won't continue exactly as it would without restart";
+
+		LOG(INFO) << "Resumed from " << P::checkpoint().file() << " at generation " << popgen_begin_ / P::psize();
+	}
+
 	/**
 	 * Perform's Particle MultiSwarm Optimization.
 	 * Fitness function is in the range (-inf, +1] .
+	 * Work of every generation is published in metrics (meave/ga/metrics.hpp).
 	 */
 	void evolve() {
-		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
+		$::ofstream out_worstbest("./worstbest.csv", popgen_begin_ ? $::ofstream::app : $::ofstream::trunc);
 
-		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
+		if (!popgen_begin_)
+			out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
 
-		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
+		const $::unique_ptr<Metrics> metrics = make_metrics(1, "pso-openmp");
+		for (uns popgen_idx = popgen_begin_; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
 			maybe_gen_child(popgen_idx % P::psize());
 
 			if (0 == (popgen_idx + 1) % P::psize()) {
 				const uns positions_idx = popgen_idx/P::psize();
 				PopulationMinMax pmM;
-				#pragma omp declare reduction(PopulationMinMaxReduction: class PopulationMinMax: \
-					omp_out=(omp_out + omp_in) ) \
-					initializer( omp_priv= PopulationMinMax() )
-				#pragma omp parallel for reduction(PopulationMinMaxReduction:pmM)
+				// Members one by one, each fitness() runs in parallel; its noise is
+				//   then drawn by this thread, whatever the number of threads.
 				for (uns _ = 0; _ < P::psize(); ++_) {
 					/*raii::MMapCreate mc{ str_printf("./results_%.3u_%.3u.dat", positions_idx, _).c_str(), 200*11*trials_num()*sizeof(Result) };
 					union {
 						void *v_;
 						Result *r_;
 					} p_item { *mc };*/
-					const Float fit = fitness<FITNESS_FULL>(_, [this, positions_idx, _/*, &p_item*/](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+					const Float fit = fitness<FITNESS_STATISTICS>(_, [this, positions_idx, _/*, &p_item*/](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
 						//new (p_item.r_++) Result(positions_idx, _, idx, start, input, real, expected, f);
 					});
 
@@ -496,12 +642,30 @@ private:
 				LOG(INFO) << "\tPopulation: " << popgen_idx / P::psize();
 				LOG(INFO) << "\tmin-fitness (worst memmber): " << pmM.min_fits_ << '[' << pmM.min_pos_ << ']';
 				LOG(INFO) << "\tmax-fitness (best member): " << pmM.max_fits_ << '[' << pmM.max_pos_ << ']';
+				eval_counter_.log(trials_num());
+				if (metrics)
+					metrics->update(0, [this, positions_idx](Metrics::Values &v) {
+						v.evaluations_ = eval_counter_.evals();
+						v.simulations_ = eval_counter_.sims();
+						v.generation_ = positions_idx + 1;
+						v.best_fitness_ = best_fitnesses_[P::psize()];
+					});
+
+				if (0 == (positions_idx + 1) % P::checkpoint().interval()) {
+					// Statistics must not get behind the checkpoint, the checkpointer
+					//   fsync()-s them before it.
+					out_worstbest.flush();
+					checkpointer_(save_state(popgen_idx + 1, out_worstbest.tellp()));
+				}
 			}
 		}
 	}
 
 public:
-	SimpleTrialParticleMultiswarmOptimization() noexcept
+	/**
+	 * @param resume Continue from the last checkpoint, if there is any.
+	 */
+	explicit SimpleTrialParticleMultiswarmOptimization(const bool resume = false)
 	:	nncalc_(P::nn(), P::ts())
 	,	positions_(P::psize() * gsize(), 0.f)
 	,	best_positions_((P::psize() + 1) * gsize(), 0.f)
@@ -510,7 +674,19 @@ public:
 	,	best_subswarm_positions_(P::pso().subswarms_num() * gsize(), 0.f)
 	,	best_subswarm_fitnesses_(P::pso().subswarms_num(), 0.f)
 	,	subswarm_map_(P::psize(), 0)
-	,	cpus_num_(cpus_num()) {
+	,	cpus_num_(cpus_num())
+	,	pus_(topology_.placement(P::placement(), cpus_num_))
+	,	checkpointer_(P::checkpoint().file(), {"./worstbest.csv"})
+	,	popgen_begin_(0) {
+		bind_threads();
+
+		$::string payload;
+		if (resume && meave::checkpoint::load(P::checkpoint().file(), payload)) {
+			meave::checkpoint::In in($::move(payload));
+			restore_state(in);
+			return;
+		}
+
 		$::generate(positions_.begin(), positions_.end(), [this]() -> Float { return uniform_dist<0, +1, 1>(); });
 		$::generate(velocities_.begin(), velocities_.end(), [this]() -> Float { return uniform_dist<-1, +1, 1>(); });
 		$::copy(positions_.begin(), positions_.end(), best_positions_.begin());
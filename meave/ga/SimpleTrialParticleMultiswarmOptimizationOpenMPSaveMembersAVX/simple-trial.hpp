@@ -2,10 +2,13 @@
 #	define MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_HPP
 
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/genome_archive.hpp"
+#	include "meave/ga/variation.hpp"
 #	include "meave/commons.hpp"
 #	include "meave/lib/math.hpp"
+#	include "meave/lib/math/sum.hpp"
 #	include "meave/lib/raii/accumulate_flush.hpp"
-#	include "meave/lib/raii/mmap_create.hpp"
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/simd.hpp"
 #	include "meave/lib/str_printf.hpp"
@@ -185,6 +188,8 @@ private:
 	$::vector<Float> best_subswarm_positions_;
 	$::vector<Float> best_subswarm_fitnesses_;
 
+	EvalCounter eval_counter_;
+
 	$::vector<uns> subswarm_map_;
 
 	const uns cpus_num_;
@@ -243,39 +248,52 @@ private:
 	enum FitnessKind {
 		  FITNESS_RAND
 		, FITNESS_FULL
+		, FITNESS_STATISTICS	///< FITNESS_FULL of population statistics, not counted as work of the optimizer.
 	};
 	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
 	Float fitness(const uns index, Wr wr = Nothing()) noexcept {
 		const Phenotype phe = phenotype(index);
+		if (FK == FITNESS_STATISTICS)
+			eval_counter_.add_statistics(200 * 11);
+		else
+			eval_counter_.add(FK == FITNESS_FULL ? 200 * 11 : P::repeat());
 
 		if (FK == FITNESS_RAND) {
-			Float sum = 0;
-			#pragma omp parallel for reduction(+:sum)
+			// Scenarios and their noise drawn by this thread in order, results by
+			//   index summed in fixed order, the same for any number of threads.
+			$::vector<Float> vels(P::repeat());
+			$::vector<Float> start_poss(P::repeat());
+			$::vector<unsigned> seeds(P::repeat());
 			for (uns _ = 0; _ < P::repeat(); ++_) {
-				const Float vel = dist_(rand_) * P::velrange();
-				const Float start_pos = dist_(rand_) * P::startposrange();
-
-				sum += run_sim(start_pos, vel, phe, wr);
+				vels[_] = dist_(rand_) * P::velrange();
+				start_poss[_] = dist_(rand_) * P::startposrange();
+				seeds[_] = rand_();
 			}
-			return sum / P::repeat();
+			$::vector<Float> sims(P::repeat());
+			#pragma omp parallel for
+			for (uns _ = 0; _ < P::repeat(); ++_)
+				sims[_] = run_sim(start_poss[_], vels[_], phe, seeds[_], wr);
+			return meave::math::compensated_sum(&sims[0], P::repeat()) / P::repeat();
 		}
-		if (FK == FITNESS_FULL) {
+		if (FK == FITNESS_FULL || FK == FITNESS_STATISTICS) {
 			const uns i_max = 200;
-			Float sum = 0;
-			#pragma omp parallel for reduction(+:sum)
+			const uns j_max = 11;
+			$::vector<unsigned> seeds(i_max * j_max);
+			$::generate(seeds.begin(), seeds.end(), [this]() -> unsigned { return rand_(); });
+			$::vector<Float> temps(i_max);
+			#pragma omp parallel for
 			for (uns _ = 0; _ < i_max; ++_) {
 				Float temp = 0;
-				const uns j_max = 11;
 				for (const uns j: meave::make_xrange(0U, j_max)) {
 					const uns start_pos = j*10;
 					const Float f_start_pos = Float(start_pos);
 					const Float f_vel = Float(_) / 100;
-					const Float err = run_sim(f_start_pos, f_vel, phe, wr);
+					const Float err = run_sim(f_start_pos, f_vel, phe, seeds[_ * j_max + j], wr);
 					temp += err;
 				}
-				sum += temp /= j_max;
+				temps[_] = temp / j_max;
 			}
-			return sum / i_max;
+			return meave::math::compensated_sum(&temps[0], i_max) / i_max;
 		}
 		assert(0);
 		return Float();
@@ -286,14 +304,18 @@ private:
 	 */
 	/**
 	 * Runs simulation for one phenotype...
+	 * @param seed Seed of the initial noise of neurons, so that the result
+	 *   doesn't depend on the thread running the simulation.
 	 */
-	Float run_sim(const double start, const double vel, const Phenotype &phenotype) const noexcept {
+	Float run_sim(const double start, const double vel, const Phenotype &phenotype, const unsigned seed) const noexcept {
 		$::vector<Float> y(P::nn());
 		$::vector<Float> ei(P::nn(), 0.0);
 		std::vector<Float> v(P::nn());
 
-		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this](const Float $) -> Float {
-			return -$ + dist_(rand_) * 2 * P::randinit() - P::randinit();
+		$::default_random_engine noise(seed);
+		$::uniform_real_distribution<Float> noise_dist;
+		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this, &noise, &noise_dist](const Float $) -> Float {
+			return -$ + noise_dist(noise) * 2 * P::randinit() - P::randinit();
 		});
 
 		Float distance = start;
@@ -360,25 +382,17 @@ private:
 		const uns subswarm_idx = subswarm_map_[picked_idx];
 		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
+		Float rp[gsize()];
+		Float rs[gsize()];
+		Float rg[gsize()];
 		for (uns _ = 0; _ < gsize(); ++_) {
-			const Float rp = uniform_dist<0, 1, 1>();
-			const Float rs = uniform_dist<0, 1, 1>();
-			const Float rg = uniform_dist<0, 1, 1>();
-
-			DLOG(INFO) << "v[" << _ << "] = " << P::pso().omega() << " * " << v[_] << " + "
-				   << P::pso().psi.particle_best() << " * " << rp << " * " << "(" << best_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.subswarm_best() << " * " << rs << " * " << "(" << subswarm_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.global_best() << " * " << rg << " * " << "(" << global_best_x[_] << " - " << x[_] << ")";
-			v[_] = P::pso().omega() * v[_] +
-				      P::pso().psi.particle_best() * rp * (best_x[_] - x[_]) +
-				      P::pso().psi.subswarm_best() * rs * (subswarm_x[_] - x[_]) +
-				      P::pso().psi.global_best() * rg * (global_best_x[_] - x[_]);
+			rp[_] = uniform_dist<0, 1, 1>();
+			rs[_] = uniform_dist<0, 1, 1>();
+			rg[_] = uniform_dist<0, 1, 1>();
 		}
 
-		for (uns _ = 0; _ < gsize(); ++_) {
-			DLOG(INFO) << "x[" << _ << "] += " << v[_];
-			x[_] += v[_];
-		}
+		meave::ga::variation::pso_move(x, v, best_x, subswarm_x, global_best_x, rp, rs, rg, gsize(),
+					       P::pso().omega(), P::pso().psi.particle_best(), P::pso().psi.subswarm_best(), P::pso().psi.global_best());
 
 		const Float fit = fitness<FITNESS_FULL>(picked_idx);
 		DLOG(INFO) << "New member generated:\n"
@@ -497,24 +511,8 @@ private:
 	 * Fitness function is in the range (-inf, +1] .
 	 */
 	void evolve() {
-		struct MemberPod {
-			uns population_id_;
-			uns member_id_;
-			Float genome_[gsize()];
-
-			MemberPod() = delete;
-			MemberPod(const uns population_id, const uns member_id, const Float *g)
-			:	population_id_(population_id)
-			,	member_id_(member_id) {
-				::memcpy(genome_, g, sizeof genome_);
-			}
-		};
-
-		raii::MMapCreate members_mem("members.dat", (5 * P::psize() * gsize() + 1) * sizeof(MemberPod));
-		union {
-			void *v_;
-			MemberPod *p_;
-		} members{*members_mem};
+		// Genomes of every population, see simple-trial-analyse/members-eval .
+		GenomeArchive<Float> members("members.dat", gsize(), P::nn());
 		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
 		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
 
@@ -523,15 +521,14 @@ private:
 
 			if (0 == (popgen_idx + 1) % P::psize()) {
 				const uns positions_idx = popgen_idx/P::psize();
+				for (uns _ = 0; _ < P::psize(); ++_)
+					members.append(positions_idx, _, &positions_[_*gsize()]);
+
 				PopulationMinMax pmM;
-				#pragma omp declare reduction(PopulationMinMaxReduction: class PopulationMinMax: \
-					omp_out=(omp_out + omp_in) ) \
-					initializer( omp_priv= PopulationMinMax() )
-				#pragma omp parallel for reduction(PopulationMinMaxReduction:pmM)
+				// Members one by one, each fitness() runs in parallel; its noise is
+				//   then drawn by this thread, whatever the number of threads.
 				for (uns _ = 0; _ < P::psize(); ++_) {
-					const Float fit = fitness<FITNESS_FULL>(_);
-
-					new(&members.p_[popgen_idx - _]) MemberPod{positions_idx, _, &positions_[_*gsize()]};
+					const Float fit = fitness<FITNESS_STATISTICS>(_);
 					pmM += PopulationMinMax(_, _, fit, fit);
 				};
 
@@ -541,6 +538,7 @@ private:
 				LOG(INFO) << "\tPopulation: " << popgen_idx / P::psize();
 				LOG(INFO) << "\tmin-fitness (worst memmber): " << pmM.min_fits_ << '[' << pmM.min_pos_ << ']';
 				LOG(INFO) << "\tmax-fitness (best member): " << pmM.max_fits_ << '[' << pmM.max_pos_ << ']';
+				eval_counter_.log(trials_num());
 			}
 		}
 	}
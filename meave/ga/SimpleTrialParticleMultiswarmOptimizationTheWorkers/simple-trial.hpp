@@ -3,6 +3,8 @@
 #	define MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_HPP
 
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/variation.hpp"
 #	include "meave/commons.hpp"
 #	include "meave/lib/math.hpp"
 #	include "meave/lib/seed.hpp"
@@ -182,6 +184,8 @@ private:
 	$::vector<Float> best_subswarm_positions_;
 	$::vector<Float> best_subswarm_fitnesses_;
 
+	EvalCounter eval_counter_;
+
 	$::vector<uns> subswarm_map_;
 
 	const uns cpus_num_;
@@ -241,10 +245,15 @@ private:
 	enum FitnessKind {
 		  FITNESS_RAND
 		, FITNESS_FULL
+		, FITNESS_STATISTICS	///< FITNESS_FULL of population statistics, not counted as work of the optimizer.
 	};
 	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
 	Float fitness(const uns index, Wr wr = Nothing()) noexcept {
 		const Phenotype phe = phenotype(index);
+		if (FK == FITNESS_STATISTICS)
+			eval_counter_.add_statistics(200 * 11);
+		else
+			eval_counter_.add(FK == FITNESS_FULL ? 200 * 11 : P::repeat());
 
 		if (FK == FITNESS_RAND) {
 			return the_workers_(0, P::repeat(), [this, &phe, &wr](const uns) -> Float {
@@ -254,7 +263,7 @@ private:
 				return run_sim(start_pos, vel, phe, wr);
 			}) / P::repeat();
 		}
-		if (FK == FITNESS_FULL) {
+		if (FK == FITNESS_FULL || FK == FITNESS_STATISTICS) {
 			const uns i_max = 200;
 			return the_workers_(0U, i_max, [this, &phe, &wr](const uns _) -> Float {
 				Float temp = 0;
@@ -321,25 +330,17 @@ private:
 		const uns subswarm_idx = subswarm_map_[picked_idx];
 		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
+		Float rp[gsize()];
+		Float rs[gsize()];
+		Float rg[gsize()];
 		for (uns _ = 0; _ < gsize(); ++_) {
-			const Float rp = uniform_dist<0, 1, 1>();
-			const Float rs = uniform_dist<0, 1, 1>();
-			const Float rg = uniform_dist<0, 1, 1>();
-
-			DLOG(INFO) << "v[" << _ << "] = " << P::pso().omega() << " * " << v[_] << " + "
-				   << P::pso().psi.particle_best() << " * " << rp << " * " << "(" << best_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.subswarm_best() << " * " << rs << " * " << "(" << subswarm_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.global_best() << " * " << rg << " * " << "(" << global_best_x[_] << " - " << x[_] << ")";
-			v[_] = P::pso().omega() * v[_] +
-				      P::pso().psi.particle_best() * rp * (best_x[_] - x[_]) +
-				      P::pso().psi.subswarm_best() * rs * (subswarm_x[_] - x[_]) +
-				      P::pso().psi.global_best() * rg * (global_best_x[_] - x[_]);
+			rp[_] = uniform_dist<0, 1, 1>();
+			rs[_] = uniform_dist<0, 1, 1>();
+			rg[_] = uniform_dist<0, 1, 1>();
 		}
 
-		for (uns _ = 0; _ < gsize(); ++_) {
-			DLOG(INFO) << "x[" << _ << "] += " << v[_];
-			x[_] += v[_];
-		}
+		meave::ga::variation::pso_move(x, v, best_x, subswarm_x, global_best_x, rp, rs, rg, gsize(),
+					       P::pso().omega(), P::pso().psi.particle_best(), P::pso().psi.subswarm_best(), P::pso().psi.global_best());
 
 		const Float fit = fitness<FITNESS_FULL>(picked_idx);
 		DLOG(INFO) << "New member generated:\n"
@@ -494,7 +495,7 @@ private:
 						<< "RealOutput" << "\t"
 						<< "ExpectedOutput" << "\t"
 						<< "f" << "\n";
-					const Float fit = fitness<FITNESS_FULL>(_, [this, positions_idx, _, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+					const Float fit = fitness<FITNESS_STATISTICS>(_, [this, positions_idx, _, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
 						out_res << positions_idx << "\t"
 							<< _ << "\t"
 							<< idx << "\t"
@@ -519,6 +520,7 @@ private:
 				LOG(INFO) << "\tPopulation: " << popgen_idx / P::psize();
 				LOG(INFO) << "\tmin-fitness (worst memmber): " << pmM.min_fits_ << '[' << pmM.min_pos_ << ']';
 				LOG(INFO) << "\tmax-fitness (best member): " << pmM.max_fits_ << '[' << pmM.max_pos_ << ']';
+				eval_counter_.log(trials_num());
 			}
 		}
 	}
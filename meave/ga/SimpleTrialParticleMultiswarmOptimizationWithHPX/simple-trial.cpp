@@ -4,6 +4,7 @@
 #include <boost/program_options.hpp>
 
 #include <tuple>
+#include <vector>
 
 #include "meave/lib/str_printf.hpp"
 #include "simple-trial.hpp"
@@ -93,40 +94,26 @@ struct Params {
 
 } /* Anonymouse Namespace */
 
-#if 0
 namespace aux {
-	int run(boost::program_options::variables_map&) {
-	$::cerr << "xyz[" <<  __FILE__ << ':' << __LINE__ << ']' << $::endl;
-		meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, Params>{}();
-		return 0;
+	typedef meave::ga::Evaluation<meave::ga::SinglePrecision, Params> Evaluation;
+
+	/**
+	 * Full fitness of the genome, evaluated on the locality it was sent to.
+	 */
+	float fitness_full(const $::vector<float> &genome) {
+		static const Evaluation the_evaluation;
+		return the_evaluation.fitness<Evaluation::FITNESS_FULL>(&genome[0]);
 	}
 } /* Namespace aux */
-//HPX_PLAIN_ACTION(aux::run, run_particle_swarm_optimization_action);
-
-int hpx_main(int argc, char* argv[]) {
-	$::cerr << "xyz[" <<  __FILE__ << ':' << __LINE__ << ']' << $::endl;
-    // Any HPX application logic goes here...
-    return hpx::finalize();
-}
-#endif
+HPX_PLAIN_ACTION(aux::fitness_full, fitness_full_action);
 
 #include <hpx/hpx_main.hpp>
 
 int main(int argc, char* argv[]) {
-	$::cerr << "xyz[" <<  __FILE__ << ':' << __LINE__ << ']' << $::endl;
 	// Initialize Google's logging library.
 	google::InitGoogleLogging(argv[0]);
-/*
-	$::cerr << "xyz[" <<  __FILE__ << ':' << __LINE__ << ']' << $::endl;
-	boost::program_options::options_description desc_cmdline(meave::str_printf("usage: %s [options]", argv[0]));
 
-	$::cerr << "xyz[" <<  __FILE__ << ':' << __LINE__ << ']' << $::endl;
-	// Initialize HPX, run hpx_main as the first HPX thread, and
-	// wait for hpx::finalize being called.
-*/
-
-	meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, Params>{}();
+	// Only the console locality runs main(), the others just serve fitness_full_action.
+	meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, Params, fitness_full_action>{}();
 	return 0;
-
-//	return hpx::init(aux::run, desc_cmdline, argc, argv);
 }
@@ -3,18 +3,27 @@
 
 #	include "meave/commons.hpp"
 #	include "meave/lib/math.hpp"
+#	include "meave/lib/math/sum.hpp"
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/str_printf.hpp"
 #	include "meave/lib/xrange.hpp"
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/variation.hpp"
 
 #	include <algorithm>
-#	include <future>
+#	include <atomic>
 #	include <fstream>
+#	include <hpx/include/lcos.hpp>
+#	include <hpx/include/runtime.hpp>
+#	include <hpx/lcos/local/spinlock.hpp>
+#	include <hpx/parallel/algorithms/for_each.hpp>
 #	include <hpx/parallel/algorithms/transform_reduce.hpp>
+#	include <mutex>
 #	include <sstream>
 #	include <random>
 #	include <tuple>
+#	include <vector>
 
 namespace meave { namespace ga {
 
@@ -28,69 +37,33 @@ struct SinglePrecision {
 };
 
 /**
- * @tparam Params
- *           -- Evolution Parameters --
- *           Param::gens() -- number of generaitions (10_000)
- *           Param::gaus_vec_mut -- Gassian vector mutation (0.01)
- *           Param::psize -- population size (20)
- *           Param::recprob() -- probability of recombination (0.5)
- *           Param::demewidth() -- deme width
- *
- *           -- Fitness Evaluation Parameters --
- *           Param::trial() -- units of time for each trial (50)
- *           Param::eval() -- time at which the agent starts being evaluated
- *           Param::repeat() -- number of trials per fitness evaluation (100)
- *           Param::velrange() -- range of different possible velocities [0, 2]
- *           Param::startposrange() -- range of different starting positions [0, 100]
+ * Fitness evaluation of one genome.
  *
- *           -- euler integration parameters -- 
- *           Param::ts() -- time step of simulation <floating point>
+ * It needs nothing from the population, so it runs wherever the genome is
+ *   sent: the evolution calls it through an HPX action (see
+ *   SimpleTrialParticleMultiswarmOptimization), every locality has its own
+ *   instance.
  *
- *           -- CTRNN parameters --
- *           Param::nn() -- number of neurons (3)
- *           Param::psize -- population size
- *           Param::range() -- range of weights: [-5.0, +5.0]
- *
- *           Param::subgen_lens() -- range of lens for subgen() [+5, +5]
+ * @tparam Params -- see SimpleTrialParticleMultiswarmOptimization
  */
 template <typename Types, typename Params>
-class SimpleTrialParticleMultiswarmOptimization : public Types
-				       , public Params {
+class Evaluation : public Types
+		 , public Params {
 public:
 	typedef typename Types::Float Float;
 	typedef typename Types::Len Len;
-	typedef std::default_random_engine RandomGenerator;
 
-	Float dist() noexcept {
-		return dist_(rand_);
-	}
-
-	Float norm_dist() noexcept {
-		return norm_dist_(rand_);
-	}
-
-	template<int a, int b, int div>
-	Float uniform_dist() noexcept {
-		static thread_local $::uniform_real_distribution<Float> dist(a/float(div), b/float(div));
-		return dist(rand_);
-	}
-
-	template<int mean, int stddev, int div>
-	Float normal_dist() noexcept {
-		static thread_local $::normal_distribution<Float> dist(mean/float(div), stddev/float(div));
-		return dist(rand_);
-	}
-
-	template<uns a, uns b>
-	uns uniform_uns_dist() noexcept {
-		static thread_local $::uniform_int_distribution<uns> dist(a, b);
-		return dist(rand_);
-	}
+	class RandomGenerator : public $::default_random_engine {
+	public:
+		RandomGenerator()
+		:	$::default_random_engine(meave::seed()) {
+		}
+	};
 
-	uns rand_index() noexcept {
-		static thread_local $::uniform_int_distribution<uns> dist(0, P::psize() - 1);
-		return dist(rand_);
-	}
+	enum FitnessKind {
+		  FITNESS_RAND
+		, FITNESS_FULL
+	};
 
 	/**
 	 * @return Genome size.
@@ -157,22 +130,12 @@ private:
 		}
 	};
 
-private:
 	typedef meave::ctrnn::NNCalc<Float, Len> NNCalc;
 
 	NNCalc nncalc_;
-	$::vector<Float> positions_;
-	$::vector<Float> best_positions_;
-	$::vector<Float> velocities_;
-	$::vector<Float> best_fitnesses_;
-	$::vector<Float> best_subswarm_positions_;
-	$::vector<Float> best_subswarm_fitnesses_;
 
-	$::vector<uns> subswarm_map_;
-
-	mutable RandomGenerator rand_;
-	mutable $::uniform_real_distribution<Float> dist_;
-	mutable $::normal_distribution<Float> norm_dist_;
+	static thread_local RandomGenerator rand_;
+	static thread_local $::uniform_real_distribution<Float> dist_;
 
 	/**
 	 * @todo int/float (0.1) has big rounding error...
@@ -183,12 +146,10 @@ private:
 	}
 
 	/**
-	 * Convert index-th genotype to phenotype.
+	 * Convert genotype to phenotype.
 	 * @return Desired phenotype.
 	 */
-	Phenotype phenotype(const uns index) const {
-		const Float *it_gen = &positions_[index * gsize()];
-
+	Phenotype phenotype(const Float *it_gen) const {
 		Phenotype $$;
 
 		const Float *it_w_end = it_gen;
@@ -212,83 +173,21 @@ private:
 		return $$;
 	}
 
-private:
-	void save_member(const uns index, const std::string &file_name) const {
-		$::ofstream f(file_name);
-		f.write(&positions_[index*gsize()], gsize()*sizeof(positions_[0]));
-		f.close();
-	}
-
-	/**
-	 * Fitness evaluation.
-	 */
-	enum FitnessKind {
-		  FITNESS_RAND
-		, FITNESS_FULL
-	};
-	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
-	Float fitness(const uns index, Wr wr = Nothing()) noexcept {
-		const Phenotype phe = phenotype(index);
-
-		if (FK == FITNESS_RAND) {
-			// Regular fitness evaluation
-			const Float f = hpx::parallel::transform_reduce(
-			  hpx::parallel::par
-			, meave::num_it(0U), meave::num_it(P::repeat())
-			, [&phe, &wr, this](uns) -> Float {
-				const Float vel = dist_(rand_) * P::velrange();
-				const Float start_pos = dist_(rand_) * P::startposrange();
-
-				return run_sim(start_pos, vel, phe, wr);
-			}
-			, 0
-			, [](const Float x, const Float y) -> Float {
-				return x + y;
-			});
-			return f / P::repeat();
-		}
-
-		assert(FK == FITNESS_FULL);
-		// Full fitness evaluation
-		const uns i_max = 200;
-		const Float f = hpx::parallel::transform_reduce(
-		  hpx::parallel::par
-		, meave::num_it(0U), meave::num_it(i_max)
-		, [&phe, &wr, this](const uns i) -> Float {
-			const uns j_max = 11;
-			const Float temp = hpx::parallel::transform_reduce(
-			  hpx::parallel::par
-			, meave::num_it(0U), meave::num_it(j_max)
-			, [i, &phe, &wr, this](const uns j) -> Float {
-				const uns start_pos = j*10;
-				const Float f_start_pos = Float(start_pos);
-				const Float f_vel = Float(i) / 100;
-				return run_sim(f_start_pos, f_vel, phe, wr);
-			}
-			, 0
-			, [](const Float x, const Float y) -> Float {
-				return x + y;
-			});
-			return temp / j_max;
-		}
-		, 0
-		, [](const Float x, const Float y) -> Float {
-			return x + y;
-		});
-		return f / i_max;
-	}
-
 	/**
 	 * Runs simulation for one phenotype...
+	 * @param seed Seed of the initial noise of neurons, so that the result
+	 *   doesn't depend on the thread running the simulation.
 	 */
 	template<typename WRITER>
-	Float run_sim(const double start, const double vel, const Phenotype &phenotype, WRITER wr = Nothing()) const noexcept {
+	Float run_sim(const double start, const double vel, const Phenotype &phenotype, const unsigned seed, WRITER wr = Nothing()) const noexcept {
 		$::vector<Float> y(P::nn());
 		$::vector<Float> ei(P::nn(), 0.0);
 		std::vector<Float> v(P::nn());
 
-		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this](const Float $) -> Float {
-			return -$ + dist_(rand_) * 2 * P::range() - P::range();
+		$::default_random_engine noise(seed);
+		$::uniform_real_distribution<Float> noise_dist;
+		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this, &noise, &noise_dist](const Float $) -> Float {
+			return -$ + noise_dist(noise) * 2 * P::range() - P::range();
 		});
 
 		Float distance = start;
@@ -313,7 +212,208 @@ private:
 		return $$;
 	}
 
-	void maybe_gen_child(const uns picked_idx) noexcept {
+public:
+	Evaluation() noexcept
+	:	nncalc_(P::nn(), P::ts()) {
+	}
+
+	/**
+	 * Fitness evaluation of gsize() genes starting at genome.
+	 */
+	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
+	Float fitness(const Float *genome, Wr wr = Nothing()) const noexcept {
+		const Phenotype phe = phenotype(genome);
+
+		// Scenarios and their noise are drawn by this thread in order, results
+		//   are stored by index and summed in fixed order, unlike
+		//   transform_reduce the sum doesn't depend on scheduling.
+		if (FK == FITNESS_RAND) {
+			// Regular fitness evaluation
+			$::vector<Float> vels(P::repeat());
+			$::vector<Float> start_poss(P::repeat());
+			$::vector<unsigned> seeds(P::repeat());
+			for (uns _ = 0; _ < P::repeat(); ++_) {
+				vels[_] = dist_(rand_) * P::velrange();
+				start_poss[_] = dist_(rand_) * P::startposrange();
+				seeds[_] = rand_();
+			}
+			$::vector<Float> sims(P::repeat());
+			hpx::parallel::for_each(
+			  hpx::parallel::par
+			, meave::num_it(0U), meave::num_it(P::repeat())
+			, [&sims, &vels, &start_poss, &seeds, &phe, &wr, this](const uns i) {
+				sims[i] = run_sim(start_poss[i], vels[i], phe, seeds[i], wr);
+			});
+			return meave::math::compensated_sum(&sims[0], P::repeat()) / P::repeat();
+		}
+
+		assert(FK == FITNESS_FULL);
+		// Full fitness evaluation
+		const uns i_max = 200;
+		const uns j_max = 11;
+		$::vector<unsigned> seeds(i_max * j_max);
+		$::generate(seeds.begin(), seeds.end(), []() -> unsigned { return rand_(); });
+		$::vector<Float> sims(i_max * j_max);
+		hpx::parallel::for_each(
+		  hpx::parallel::par
+		, meave::num_it(0U), meave::num_it(i_max * j_max)
+		, [&sims, &seeds, &phe, &wr, this](const uns ij) {
+			const uns i = ij / j_max;
+			const uns j = ij % j_max;
+			const uns start_pos = j*10;
+			const Float f_start_pos = Float(start_pos);
+			const Float f_vel = Float(i) / 100;
+			sims[ij] = run_sim(f_start_pos, f_vel, phe, seeds[ij], wr);
+		});
+		// Mean of means over start positions, as by velocity before.
+		$::vector<Float> temps(i_max);
+		for (uns i = 0; i < i_max; ++i)
+			temps[i] = meave::math::compensated_sum(&sims[i * j_max], j_max) / j_max;
+		return meave::math::compensated_sum(&temps[0], i_max) / i_max;
+	}
+};
+
+template <typename Types, typename Params>
+thread_local typename Evaluation<Types, Params>::RandomGenerator Evaluation<Types, Params>::rand_;
+
+template <typename Types, typename Params>
+thread_local $::uniform_real_distribution<typename Evaluation<Types, Params>::Float> Evaluation<Types, Params>::dist_;
+
+/**
+ * @tparam Params
+ *           -- Evolution Parameters --
+ *           Param::gens() -- number of generaitions (10_000)
+ *           Param::gaus_vec_mut -- Gassian vector mutation (0.01)
+ *           Param::psize -- population size (20)
+ *           Param::recprob() -- probability of recombination (0.5)
+ *           Param::demewidth() -- deme width
+ *
+ *           -- Fitness Evaluation Parameters --
+ *           Param::trial() -- units of time for each trial (50)
+ *           Param::eval() -- time at which the agent starts being evaluated
+ *           Param::repeat() -- number of trials per fitness evaluation (100)
+ *           Param::velrange() -- range of different possible velocities [0, 2]
+ *           Param::startposrange() -- range of different starting positions [0, 100]
+ *
+ *           -- euler integration parameters --
+ *           Param::ts() -- time step of simulation <floating point>
+ *
+ *           -- CTRNN parameters --
+ *           Param::nn() -- number of neurons (3)
+ *           Param::psize -- population size
+ *           Param::range() -- range of weights: [-5.0, +5.0]
+ *
+ *           Param::subgen_lens() -- range of lens for subgen() [+5, +5]
+ *
+ * @tparam Action
+ *           HPX action Float(const $::vector<Float> &genome) returning full
+ *           fitness (Evaluation::FITNESS_FULL) of the genome. Genomes are
+ *           sent to all localities round-robin.
+ */
+template <typename Types, typename Params, typename Action>
+class SimpleTrialParticleMultiswarmOptimization : public Types
+				       , public Params {
+public:
+	typedef typename Types::Float Float;
+	typedef typename Types::Len Len;
+	typedef std::default_random_engine RandomGenerator;
+
+	Float dist() noexcept {
+		return dist_(rand_);
+	}
+
+	Float norm_dist() noexcept {
+		return norm_dist_(rand_);
+	}
+
+	template<int a, int b, int div>
+	Float uniform_dist() noexcept {
+		static thread_local $::uniform_real_distribution<Float> dist(a/float(div), b/float(div));
+		return dist(rand_);
+	}
+
+	template<int mean, int stddev, int div>
+	Float normal_dist() noexcept {
+		static thread_local $::normal_distribution<Float> dist(mean/float(div), stddev/float(div));
+		return dist(rand_);
+	}
+
+	template<uns a, uns b>
+	uns uniform_uns_dist() noexcept {
+		static thread_local $::uniform_int_distribution<uns> dist(a, b);
+		return dist(rand_);
+	}
+
+	uns rand_index() noexcept {
+		static thread_local $::uniform_int_distribution<uns> dist(0, P::psize() - 1);
+		return dist(rand_);
+	}
+
+	/**
+	 * @return Genome size.
+	 */
+	constexpr uns gsize() const noexcept {
+		return P::nn()*P::nn() + 2*P::nn();
+	}
+
+private:
+	typedef Params P;
+	typedef meave::ga::Evaluation<Types, Params> Evaluation;
+	typedef hpx::lcos::local::spinlock Mutex;
+
+	Evaluation evaluation_;
+	$::vector<Float> positions_;
+	$::vector<Float> best_positions_;
+	$::vector<Float> velocities_;
+	$::vector<Float> best_fitnesses_;
+	$::vector<Float> best_subswarm_positions_;
+	$::vector<Float> best_subswarm_fitnesses_;
+
+	EvalCounter eval_counter_;
+
+	$::vector<uns> subswarm_map_;
+
+	/**
+	 * Positions evaluated in the last two generations: while the statistics
+	 *   of generation n are written, generation n + 1 is already running.
+	 */
+	$::vector<Float> evaluated_positions_[2];
+
+	$::vector<hpx::naming::id_type> localities_;
+	$::atomic<uns> next_locality_;
+
+	/**
+	 * Guards the swarm: particles move and update bests from continuations
+	 *   running concurrently.
+	 */
+	Mutex mutex_;
+
+	mutable RandomGenerator rand_;
+	mutable $::uniform_real_distribution<Float> dist_;
+	mutable $::normal_distribution<Float> norm_dist_;
+
+private:
+	void save_member(const uns index, const std::string &file_name) const {
+		$::ofstream f(file_name);
+		f.write(&positions_[index*gsize()], gsize()*sizeof(positions_[0]));
+		f.close();
+	}
+
+	/**
+	 * Sends the genome to the next locality.
+	 * @return Future of its full fitness.
+	 */
+	hpx::future<Float> remote_fitness($::vector<Float> genome) {
+		const uns locality = next_locality_++ % localities_.size();
+		eval_counter_.add(200 * 11);
+		return hpx::async<Action>(localities_[locality], $::move(genome));
+	}
+
+	/**
+	 * Moves the particle.
+	 * @return Its new position.
+	 */
+	$::vector<Float> move(const uns picked_idx) noexcept {
 		// https://en.wikipedia.org/wiki/Particle_swarm_optimization
 		DLOG(INFO) << "Picked idx:" << picked_idx;
 
@@ -326,30 +426,33 @@ private:
 		const uns subswarm_idx = subswarm_map_[picked_idx];
 		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
+		Float rp[gsize()];
+		Float rs[gsize()];
+		Float rg[gsize()];
 		for (uns _ = 0; _ < gsize(); ++_) {
-			const Float rp = uniform_dist<0, 1, 1>();
-			const Float rs = uniform_dist<0, 1, 1>();
-			const Float rg = uniform_dist<0, 1, 1>();
-
-			DLOG(INFO) << "v[" << _ << "] = " << P::pso().omega() << " * " << v[_] << " + "
-				   << P::pso().psi.particle_best() << " * " << rp << " * " << "(" << best_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.subswarm_best() << " * " << rs << " * " << "(" << subswarm_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.global_best() << " * " << rg << " * " << "(" << global_best_x[_] << " - " << x[_] << ")";
-			v[_] = P::pso().omega() * v[_] +
-				      P::pso().psi.particle_best() * rp * (best_x[_] - x[_]) +
-				      P::pso().psi.subswarm_best() * rs * (subswarm_x[_] - x[_]) +
-				      P::pso().psi.global_best() * rg * (global_best_x[_] - x[_]);
+			rp[_] = uniform_dist<0, 1, 1>();
+			rs[_] = uniform_dist<0, 1, 1>();
+			rg[_] = uniform_dist<0, 1, 1>();
 		}
 
-		for (uns _ = 0; _ < gsize(); ++_) {
-			DLOG(INFO) << "x[" << _ << "] += " << v[_];
-			x[_] += v[_];
-		}
+		meave::ga::variation::pso_move(x, v, best_x, subswarm_x, global_best_x, rp, rs, rg, gsize(),
+					       P::pso().omega(), P::pso().psi.particle_best(), P::pso().psi.subswarm_best(), P::pso().psi.global_best());
+
+		return $::vector<Float>(&x[0], &x[gsize()]);
+	}
+
+	/**
+	 * Updates bests by the particle, that was at position x and has fitness fit.
+	 */
+	void record(const uns picked_idx, const Float *x, const Float fit) noexcept {
+		Float *best_x = &best_positions_[gsize() * picked_idx];
+		Float *global_best_x = &best_positions_[gsize() * P::psize()];
+
+		const uns subswarm_idx = subswarm_map_[picked_idx];
+		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
-		const Float fit = fitness<FITNESS_FULL>(picked_idx);
 		DLOG(INFO) << "New member generated:\n"
 			      "\tmin - max = " << *$::min_element(&x[0], &x[gsize()]) << " - " << *$::max_element(&x[0], &x[gsize()]) << "\n"
-			      "\tvmin - vmax = " << *$::min_element(&v[0], &v[gsize()]) << " - " << *$::max_element(&v[0], &v[gsize()]) << "\n"
 			      "\tnew fitness, previous fitness, global fitness: " << fit << "; " << best_fitnesses_[picked_idx] << "; " << best_fitnesses_[P::psize()];
 		if (best_fitnesses_[picked_idx] < fit) {
 			DLOG(INFO) << "Rewriting local best";
@@ -368,92 +471,141 @@ private:
 		}
 	}
 
-	template<typename It, typename Jt>
-	$::string dbg_items(const uns num, const It members, const Jt fitnesses) const noexcept {
-		assert(members != It());
-		$::stringstream o;
-
-		for (uns _ = 0; _ < num; _++) {
-			if (_)
-				o << ", ";
-			o << members[_];
-			if (fitnesses != Jt())
-				o << "(" << fitnesses[_] << ")";
+	/**
+	 * One generation of the particle: when prev (its previous generation)
+	 *   is ready, the particle moves, its new position is evaluated on some
+	 *   locality and bests are updated.
+	 * The particle doesn't wait for the rest of the swarm, so moves of the
+	 *   next generation overlap evaluations of the current one.
+	 * @return Future of the new fitness.
+	 */
+	hpx::shared_future<Float> gen_child(const uns picked_idx, const uns generation, const hpx::shared_future<Float> &prev) {
+		hpx::future<Float> $$ = prev.then([this, picked_idx, generation](const hpx::shared_future<Float>&) {
+			$::vector<Float> x;
+			{
+				$::lock_guard<Mutex> lock(mutex_);
+				x = move(picked_idx);
+			}
+			$::copy(x.begin(), x.end(), &evaluated_positions_[generation % 2][gsize() * picked_idx]);
+
+			return remote_fitness(x).then([this, picked_idx, generation](hpx::future<Float> f) -> Float {
+				const Float fit = f.get();
+				$::lock_guard<Mutex> lock(mutex_);
+				record(picked_idx, &evaluated_positions_[generation % 2][gsize() * picked_idx], fit);
+				return fit;
+			});
+		});
+		return $$.share();
+	}
+
+	/**
+	 * Writes results of members evaluated in the generation.
+	 */
+	void population_statistics(const uns generation, $::ostream &out_worstbest) const noexcept {
+		const Float *positions = &evaluated_positions_[generation % 2][0];
+
+		Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
+		Float max_fits = -$::numeric_limits<Float>::max(); // The best member
+		uns min_idx = 0;
+		uns max_idx = 0;
+		for (uns i = 0; i < P::psize(); ++i) {
+			eval_counter_.add_statistics(200 * 11);
+			$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", generation, i), $::ofstream::trunc);
+			out_res << "Population" << "\t"
+				<< "Member" << "\t"
+				<< "Experiment" << "\t"
+				<< "Start" << "\t"
+				<< "Input" << "\t"
+				<< "RealOutput" << "\t"
+				<< "ExpectedOutput" << "\t"
+				<< "f" << "\n";
+			const Float fit = evaluation_.template fitness<Evaluation::FITNESS_FULL>(&positions[i * gsize()], [generation, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+				out_res << generation << "\t"
+					<< i << "\t"
+					<< idx << "\t"
+					<< start << "\t"
+					<< input << "\t"
+					<< real << "\t"
+					<< expected << "\t"
+					<< f << "\n";
+			});
+
+			if (fit < min_fits)
+				$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
+			if (fit > max_fits)
+				$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
 		}
 
-		return o.str();
+		out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << "\n";
+
+		LOG(INFO) << "Population Statistics";
+		LOG(INFO) << "\tPopulation: " << generation;
+		LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
+		LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
+		eval_counter_.log(evaluation_.trials_num());
 	}
 
 	/**
 	 * Perform's Particle MultiSwarm Optimization.
 	 * Fitness function is in the range (-inf, +1] .
+	 *
+	 * Generation n + 1 is started before waiting for generation n, so the
+	 *   swarm is never drained: while the last particles of generation n are
+	 *   evaluated, the others already move and evaluate again. Statistics of
+	 *   generation n are written meanwhile.
 	 */
-	void evolve() noexcept {
+	void evolve() {
 		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
 		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
 
-		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
-			maybe_gen_child(popgen_idx % P::psize());
-
-			if (0 == (popgen_idx + 1) % P::psize()) {
-				const uns positions_idx = popgen_idx/P::psize();
-				Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
-				Float max_fits = -$::numeric_limits<Float>::max(); // The best member
-				uns min_idx = 0;
-				uns max_idx = 0;
-				for (uns i = 0; i < P::psize(); ++i) {
-					$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", positions_idx, i), $::ofstream::trunc);
-					out_res << "Population" << "\t"
-						<< "Member" << "\t"
-						<< "Experiment" << "\t"
-						<< "Start" << "\t"
-						<< "Input" << "\t"
-						<< "RealOutput" << "\t"
-						<< "ExpectedOutput" << "\t"
-						<< "f" << "\n";
-					const Float fit = fitness<FITNESS_FULL>(i, [positions_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
-						out_res << positions_idx << "\t"
-							<< i << "\t"
-							<< idx << "\t"
-							<< start << "\t"
-							<< input << "\t"
-							<< real << "\t"
-							<< expected << "\t"
-							<< f << "\n";
-					});
-
-					if (fit < min_fits)
-						$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
-					if (fit > max_fits)
-						$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
-				}
-
-				out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << "\n";
-
-				LOG(INFO) << "Population Statistics";
-				LOG(INFO) << "\tPopulation: " << (popgen_idx / P::psize());
-				LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
-				LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
+		const uns gens = 5 * gsize();
+		$::vector<hpx::shared_future<Float>> current(P::psize(), hpx::make_ready_future(Float(0)).share());
+		for (uns _ = 0; _ < P::psize(); ++_)
+			current[_] = gen_child(_, 0, current[_]);
+
+		for (uns generation = 0; generation < gens; ++generation) {
+			$::vector<hpx::shared_future<Float>> next;
+			if (generation + 1 < gens) {
+				next.reserve(P::psize());
+				for (uns _ = 0; _ < P::psize(); ++_)
+					next.push_back(gen_child(_, generation + 1, current[_]));
 			}
+
+			hpx::wait_all(current);
+			for (const auto &f: current)
+				f.get(); // Rethrows errors of remote evaluation.
+			population_statistics(generation, out_worstbest);
+
+			current = $::move(next);
 		}
 	}
 
 public:
-	SimpleTrialParticleMultiswarmOptimization() noexcept
-	:	nncalc_(P::nn(), P::ts())
-	,	positions_(P::psize() * gsize(), 0.f)
+	SimpleTrialParticleMultiswarmOptimization()
+	:	positions_(P::psize() * gsize(), 0.f)
 	,	best_positions_((P::psize() + 1) * gsize(), 0.f)
 	,	velocities_(P::psize() * gsize(), 0.f)
 	,	best_fitnesses_(P::psize() + 1, 0.f)
 	,	best_subswarm_positions_(P::pso().subswarms_num() * gsize(), 0.f)
 	,	best_subswarm_fitnesses_(P::pso().subswarms_num(), 0.f)
 	,	subswarm_map_(P::psize(), 0)
+	,	evaluated_positions_{$::vector<Float>(P::psize() * gsize(), 0.f), $::vector<Float>(P::psize() * gsize(), 0.f)}
+	,	localities_(hpx::find_all_localities())
+	,	next_locality_(0)
 	,	rand_(meave::seed()) {
+		LOG(INFO) << "Fitness is evaluated on " << localities_.size() << " localities";
+
 		$::generate(positions_.begin(), positions_.end(), [this]() -> Float { return uniform_dist<0, +1, 1>(); });
 		$::generate(velocities_.begin(), velocities_.end(), [this]() -> Float { return uniform_dist<-1, +1, 1>(); });
 		$::copy(positions_.begin(), positions_.end(), best_positions_.begin());
+
+		$::vector<hpx::future<Float>> fitnesses;
+		fitnesses.reserve(P::psize());
+		for (uns _ = 0; _ < P::psize(); ++_) {
+			fitnesses.push_back(remote_fitness($::vector<Float>(&positions_[_ * gsize()], &positions_[(_ + 1) * gsize()])));
+		}
 		for (uns _ = 0; _ < P::psize(); ++_) {
-			best_fitnesses_[_] = fitness<FITNESS_FULL>(_);
+			best_fitnesses_[_] = fitnesses[_].get();
 		}
 		// .end() - 1, because last element is used for the best fitness of the whole population.
 		const auto max_idx = $::max_element(best_fitnesses_.begin(), best_fitnesses_.end() - 1) - best_fitnesses_.begin();
@@ -477,7 +629,7 @@ public:
 		}
 	}
 
-	void operator()() noexcept {
+	void operator()() {
 		evolve();
 	}
 };
@@ -1,6 +1,7 @@
 #include <tuple>
 
 #include "simple-trial.hpp"
+#include "meave/lib/trace.hpp"
 
 namespace {
 
@@ -83,6 +84,10 @@ struct Params {
 	constexpr ParticleSwarmOptimization pso() const noexcept {
 		return ParticleSwarmOptimization();
 	}
+
+	constexpr meave::par::Placement placement() const noexcept {
+		return meave::par::Placement::SCATTER;
+	}
 };
 
 } /* Anonymouse Namespace */
@@ -93,6 +98,7 @@ main(int /* argc */, char *argv[]) {
 		google::InitGoogleLogging(argv[0]);
 
 		LOG(INFO) << "Dia dhuit ar domhan!";
+		const meave::trace::Session trace_session;
 		meave::ga::SimpleTrialParticleMultiswarmOptimization<meave::ga::SinglePrecision, Params>{}();
 
 		return 0;
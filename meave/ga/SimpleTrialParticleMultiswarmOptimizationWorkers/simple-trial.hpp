@@ -3,18 +3,27 @@
 #	define MEAVE_GA_SIMPLE_TRIAL_PARTICLE_MULTISWARM_OPTIMIZATION_HPP
 
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/metrics.hpp"
+#	include "meave/ga/trajectory.hpp"
+#	include "meave/ga/variation.hpp"
 #	include "meave/commons.hpp"
 #	include "meave/lib/math.hpp"
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/str_printf.hpp"
+#	include "meave/lib/trace.hpp"
 #	include "meave/lib/xrange.hpp"
+#	include "meave/lib/par/topology.hpp"
 #	include "meave/lib/par/workers.hpp"
 
 #	include <algorithm>
 #	include <atomic>
+#	include <cstdlib>
+#	include <cstring>
 #	include <numeric>
 #	include <future>
 #	include <fstream>
+#	include <memory>
 #	include <sstream>
 #	include <random>
 #	include <tuple>
@@ -55,6 +64,9 @@ struct SinglePrecision {
  *           Param::range() -- range of weights: [-5.0, +5.0]
  *
  *           Param::subgen_lens() -- range of lens for subgen() [+5, +5]
+ *
+ *           -- Thread Parameters --
+ *           Param::placement() -- placement of worker threads on CPUs (meave::par::Placement)
  */
 template <typename Types, typename Params>
 class SimpleTrialParticleMultiswarmOptimization : public Types
@@ -116,8 +128,15 @@ public:
 		return static_cast<uns>( static_cast<Float>(this->trial())/this->ts() );
 	}
 
-	constexpr uns cpus_num() const noexcept {
-		return 8;
+	/**
+	 * @return Threads filling the machine, at most MEAVE_THREADS when it is set
+	 *   (e.g. to measure scaling, meave/ga/bench).
+	 */
+	uns cpus_num() const noexcept {
+		const uns $$ = topology_.threads_num(P::placement());
+		const char *env = ::getenv("MEAVE_THREADS");
+		const int limit = env ? ::atoi(env) : 0;
+		return limit > 0 ? $::min($$, uns(limit)) : $$;
 	}
 
 private:
@@ -175,17 +194,24 @@ private:
 
 	NNCalc nncalc_;
 
-	$::vector<Float> positions_;
-	$::vector<Float> best_positions_;
-	$::vector<Float> velocities_;
+	const meave::par::Topology topology_;
+	const uns cpus_num_;
+	const $::vector<uns> pus_;
+	meave::par::Workers the_workers_;
+
+	// Slices of members are first touched by the threads that evaluate them.
+	meave::par::FirstTouchArray<Float> positions_;
+	meave::par::FirstTouchArray<Float> best_positions_;
+	meave::par::FirstTouchArray<Float> velocities_;
 	$::vector<Float> best_fitnesses_;
 	$::vector<Float> best_subswarm_positions_;
 	$::vector<Float> best_subswarm_fitnesses_;
 
+	EvalCounter eval_counter_;
+
 	$::vector<uns> subswarm_map_;
 
-	const uns cpus_num_;
-	meave::par::Workers the_workers_;
+	TrajectoryLog trajectory_log_;
 
 	static thread_local RandomGenerator rand_;
 	static thread_local $::uniform_real_distribution<Float> dist_;
@@ -241,29 +267,49 @@ private:
 	enum FitnessKind {
 		  FITNESS_RAND
 		, FITNESS_FULL
+		, FITNESS_STATISTICS	///< FITNESS_FULL of population statistics, not counted as work of the optimizer.
 	};
+	/**
+	 * @param seed Seed of the noise of the simulations, drawn by the calling
+	 *   thread (or given, when the calls run on the workers).
+	 */
 	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
-	Float fitness(const uns index, Wr wr = Nothing()) noexcept {
+	Float fitness(const uns index, Wr wr = Nothing(), const unsigned seed = rand_()) noexcept {
+		const trace::Scope scope("fitness", "ga");
+		$::default_random_engine noise(seed);
 		const Phenotype phe = phenotype(index);
+		if (FK == FITNESS_STATISTICS)
+			eval_counter_.add_statistics(200 * 11);
+		else
+			eval_counter_.add(FK == FITNESS_FULL ? 200 * 11 : P::repeat());
 
 		if (FK == FITNESS_RAND) {
-			return the_workers_(0, P::repeat(), [this, &phe, &wr](const uns) -> Float {
-				const Float vel = dist_(rand_) * P::velrange();
-				const Float start_pos = dist_(rand_) * P::startposrange();
-
-				return run_sim(start_pos, vel, phe, wr);
+			// Scenarios and their noise drawn by this thread in order, the same
+			//   for any scheduling of the workers.
+			$::vector<Float> vels(P::repeat());
+			$::vector<Float> start_poss(P::repeat());
+			$::vector<unsigned> seeds(P::repeat());
+			for (uns _ = 0; _ < P::repeat(); ++_) {
+				vels[_] = dist_(rand_) * P::velrange();
+				start_poss[_] = dist_(rand_) * P::startposrange();
+				seeds[_] = noise();
+			}
+			return the_workers_.sum(0, P::repeat(), [this, &phe, &wr, &vels, &start_poss, &seeds](const uns _) -> Float {
+				return run_sim(start_poss[_], vels[_], phe, seeds[_], wr);
 			}) / P::repeat();
 		}
-		if (FK == FITNESS_FULL) {
+		if (FK == FITNESS_FULL || FK == FITNESS_STATISTICS) {
 			const uns i_max = 200;
-			return the_workers_(0U, i_max, [this, &phe, &wr](const uns _) -> Float {
+			const uns j_max = 11;
+			$::vector<unsigned> seeds(i_max * j_max);
+			$::generate(seeds.begin(), seeds.end(), [&noise]() -> unsigned { return noise(); });
+			return the_workers_.sum(0U, i_max, [this, &phe, &wr, &seeds, j_max](const uns _) -> Float {
 				Float temp = 0;
-				const uns j_max = 11;
 				for (const uns j: meave::make_xrange(0U, j_max)) {
 					const uns start_pos = j*10;
 					const Float f_start_pos = Float(start_pos);
 					const Float f_vel = Float(_) / 100;
-					const Float err = run_sim(f_start_pos, f_vel, phe, wr);
+					const Float err = run_sim(f_start_pos, f_vel, phe, seeds[_ * j_max + j], wr);
 					temp += err;
 				}
 				return temp /= j_max;
@@ -275,15 +321,19 @@ private:
 
 	/**
 	 * Runs simulation for one phenotype...
+	 * @param seed Seed of the initial noise of neurons, so that the result
+	 *   doesn't depend on the thread running the simulation.
 	 */
 	template<typename WRITER>
-	Float run_sim(const double start, const double vel, const Phenotype &phenotype, WRITER wr = Nothing()) const noexcept {
+	Float run_sim(const double start, const double vel, const Phenotype &phenotype, const unsigned seed, WRITER wr = Nothing()) const noexcept {
 		$::vector<Float> y(P::nn());
 		$::vector<Float> ei(P::nn(), 0.0);
 		std::vector<Float> v(P::nn());
 
-		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this](const Float $) -> Float {
-			return -$ + dist_(rand_) * 2 * P::range() - P::range();
+		$::default_random_engine noise(seed);
+		$::uniform_real_distribution<Float> noise_dist;
+		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this, &noise, &noise_dist](const Float $) -> Float {
+			return -$ + noise_dist(noise) * 2 * P::range() - P::range();
 		});
 
 		Float distance = start;
@@ -309,6 +359,7 @@ private:
 	}
 
 	void maybe_gen_child(const uns picked_idx) noexcept {
+		const trace::Scope scope("child", "ga");
 		// https://en.wikipedia.org/wiki/Particle_swarm_optimization
 		DLOG(INFO) << "Picked idx:" << picked_idx;
 
@@ -321,25 +372,17 @@ private:
 		const uns subswarm_idx = subswarm_map_[picked_idx];
 		Float *subswarm_x = &best_subswarm_positions_[gsize() * subswarm_idx];
 
+		Float rp[gsize()];
+		Float rs[gsize()];
+		Float rg[gsize()];
 		for (uns _ = 0; _ < gsize(); ++_) {
-			const Float rp = uniform_dist<0, 1, 1>();
-			const Float rs = uniform_dist<0, 1, 1>();
-			const Float rg = uniform_dist<0, 1, 1>();
-
-			DLOG(INFO) << "v[" << _ << "] = " << P::pso().omega() << " * " << v[_] << " + "
-				   << P::pso().psi.particle_best() << " * " << rp << " * " << "(" << best_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.subswarm_best() << " * " << rs << " * " << "(" << subswarm_x[_] << " - " << x[_] << ")" << " + "
-				   << P::pso().psi.global_best() << " * " << rg << " * " << "(" << global_best_x[_] << " - " << x[_] << ")";
-			v[_] = P::pso().omega() * v[_] +
-				      P::pso().psi.particle_best() * rp * (best_x[_] - x[_]) +
-				      P::pso().psi.subswarm_best() * rs * (subswarm_x[_] - x[_]) +
-				      P::pso().psi.global_best() * rg * (global_best_x[_] - x[_]);
+			rp[_] = uniform_dist<0, 1, 1>();
+			rs[_] = uniform_dist<0, 1, 1>();
+			rg[_] = uniform_dist<0, 1, 1>();
 		}
 
-		for (uns _ = 0; _ < gsize(); ++_) {
-			DLOG(INFO) << "x[" << _ << "] += " << v[_];
-			x[_] += v[_];
-		}
+		meave::ga::variation::pso_move(x, v, best_x, subswarm_x, global_best_x, rp, rs, rg, gsize(),
+					       P::pso().omega(), P::pso().psi.particle_best(), P::pso().psi.subswarm_best(), P::pso().psi.global_best());
 
 		const Float fit = fitness<FITNESS_FULL>(picked_idx);
 		DLOG(INFO) << "New member generated:\n"
@@ -473,42 +516,28 @@ private:
 	/**
 	 * Perform's Particle MultiSwarm Optimization.
 	 * Fitness function is in the range (-inf, +1] .
+	 * Work of every generation is published in metrics (meave/ga/metrics.hpp).
 	 */
 	void evolve() noexcept {
 		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
 
 		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
 
+		const $::unique_ptr<Metrics> metrics = make_metrics(1, "pso-workers");
 		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
 			maybe_gen_child(popgen_idx % P::psize());
 
 			if (0 == (popgen_idx + 1) % P::psize()) {
+				const trace::Scope scope("statistics", "ga");
 				const uns positions_idx = popgen_idx/P::psize();
-				PopulationMinMax pmM = the_workers_(0, P::psize(), [this, positions_idx](const uns _) -> PopulationMinMax {
-					$::stringstream out_res;
-					out_res << "Population" << "\t"
-						<< "Member" << "\t"
-						<< "Experiment" << "\t"
-						<< "Start" << "\t"
-						<< "Input" << "\t"
-						<< "RealOutput" << "\t"
-						<< "ExpectedOutput" << "\t"
-						<< "f" << "\n";
-					const Float fit = fitness<FITNESS_FULL>(_, [this, positions_idx, _, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
-						out_res << positions_idx << "\t"
-							<< _ << "\t"
-							<< idx << "\t"
-							<< start << "\t"
-							<< input << "\t"
-							<< real << "\t"
-							<< expected << "\t"
-							<< f << $::endl;
-					});
-
-					{
-						$::ofstream file(str_printf("./results_%.3u_%.3u.csv", positions_idx, _), $::ofstream::trunc);
-						file << out_res.rdbuf();
-					}
+				// Seeds of the members drawn here, not by the workers evaluating them.
+				$::vector<unsigned> seeds(P::psize());
+				$::generate(seeds.begin(), seeds.end(), [this]() -> unsigned { return rand_(); });
+				PopulationMinMax pmM = the_workers_(0, P::psize(), [this, positions_idx, &seeds](const uns _) -> PopulationMinMax {
+					TrajectoryLog::Appender trajectory(trajectory_log_, positions_idx, _);
+					const Float fit = fitness<FITNESS_STATISTICS>(_, [&trajectory](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+						trajectory(start, input, idx, real, expected, f);
+					}, seeds[_]);
 
 					return PopulationMinMax(_, _, fit, fit);
 				});
@@ -519,25 +548,51 @@ private:
 				LOG(INFO) << "\tPopulation: " << popgen_idx / P::psize();
 				LOG(INFO) << "\tmin-fitness (worst memmber): " << pmM.min_fits_ << '[' << pmM.min_pos_ << ']';
 				LOG(INFO) << "\tmax-fitness (best member): " << pmM.max_fits_ << '[' << pmM.max_pos_ << ']';
+				eval_counter_.log(trials_num());
+				if (metrics)
+					metrics->update(0, [this, positions_idx](Metrics::Values &v) {
+						v.evaluations_ = eval_counter_.evals();
+						v.simulations_ = eval_counter_.sims();
+						v.generation_ = positions_idx + 1;
+						v.best_fitness_ = best_fitnesses_[P::psize()];
+					});
 			}
 		}
 	}
 
 public:
-	SimpleTrialParticleMultiswarmOptimization() noexcept
+	SimpleTrialParticleMultiswarmOptimization()
 	:	nncalc_(P::nn(), P::ts())
-	,	positions_(P::psize() * gsize(), 0.f)
-	,	best_positions_((P::psize() + 1) * gsize(), 0.f)
-	,	velocities_(P::psize() * gsize(), 0.f)
+	,	cpus_num_(cpus_num())
+	,	pus_(topology_.placement(P::placement(), cpus_num_))
+	,	the_workers_(cpus_num_, [this](const uns th_id) {
+			if (P::placement() != meave::par::Placement::NONE && !topology_.bind_thread(pus_[th_id]))
+				LOG(WARNING) << "Cannot bind thread " << th_id << " to cpu " << topology_.pus()[pus_[th_id]].os_index_ << ": " << ::strerror(errno);
+		})
+	,	positions_(P::psize() * gsize())
+	,	best_positions_((P::psize() + 1) * gsize())
+	,	velocities_(P::psize() * gsize())
 	,	best_fitnesses_(P::psize() + 1, 0.f)
 	,	best_subswarm_positions_(P::pso().subswarms_num() * gsize(), 0.f)
 	,	best_subswarm_fitnesses_(P::pso().subswarms_num(), 0.f)
 	,	subswarm_map_(P::psize(), 0)
-	,	cpus_num_(cpus_num())
-	,	the_workers_(cpus_num_) {
-		$::generate(positions_.begin(), positions_.end(), [this]() -> Float { return uniform_dist<0, +1, 1>(); });
-		$::generate(velocities_.begin(), velocities_.end(), [this]() -> Float { return uniform_dist<-1, +1, 1>(); });
-		$::copy(positions_.begin(), positions_.end(), best_positions_.begin());
+	,	trajectory_log_("./trajectory.dat") {
+		// Drawn here in order, the same for any number of threads; the threads
+		//   only copy them, so the pages are first touched by them.
+		$::vector<Float> positions(P::psize() * gsize());
+		$::vector<Float> velocities(P::psize() * gsize());
+		for (uns _ = 0; _ < P::psize() * gsize(); ++_) {
+			positions[_] = uniform_dist<0, +1, 1>();
+			velocities[_] = uniform_dist<-1, +1, 1>();
+		}
+		the_workers_.for_threads([this, &positions, &velocities](const uns th_id) {
+			const auto s = the_workers_.slice(0, P::psize(), th_id);
+			for (uns _ = s.first * gsize(); _ < s.second * gsize(); ++_) {
+				positions_[_] = positions[_];
+				velocities_[_] = velocities[_];
+				best_positions_[_] = positions[_];
+			}
+		});
 		for (uns _ = 0; _ < P::psize(); ++_) {
 			best_fitnesses_[_] = fitness<FITNESS_FULL>(_);
 		}
@@ -7,9 +7,11 @@
 #	include "meave/lib/str_printf.hpp"
 #	include "meave/lib/xrange.hpp"
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/trajectory.hpp"
 
 #	include <algorithm>
 #	include <fstream>
+#	include <random>
 #	include <sstream>
 #	include <tuple>
 
@@ -108,6 +110,7 @@ private:
 
 	NNCalc nncalc_;
 	$::vector<Float> population_;
+	TrajectoryLog trajectory_log_;
 
 	mutable RandomGenerator rand_;
 	mutable $::uniform_real_distribution<Float> dist_;
@@ -379,24 +382,9 @@ private:
 				uns min_idx = 0;
 				uns max_idx = 0;
 				for (uns i = 0; i < P::psize(); ++i) {
-					$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", population_idx, i), $::ofstream::trunc);
-					out_res << "Population" << "\t"
-						<< "Member" << "\t"
-						<< "Experiment" << "\t"
-						<< "Start" << "\t"
-						<< "Input" << "\t"
-						<< "RealOutput" << "\t"
-						<< "ExpectedOutput" << "\t"
-						<< "f" << $::endl;
-					const Float fit = fitness<FITNESS_FULL>(i, [population_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
-						out_res << population_idx << "\t"
-							<< i << "\t"
-							<< idx << "\t"
-							<< start << "\t"
-							<< input << "\t"
-							<< real << "\t"
-							<< expected << "\t"
-							<< f << $::endl;
+					TrajectoryLog::Appender trajectory(trajectory_log_, population_idx, i);
+					const Float fit = fitness<FITNESS_FULL>(i, [&trajectory](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+						trajectory(start, input, idx, real, expected, f);
 					});
 
 					if (fit < min_fits)
@@ -416,9 +404,10 @@ private:
 	}
 
 public:
-	SimpleTrialSubGen() noexcept
+	SimpleTrialSubGen()
 	:	nncalc_(P::nn(), P::ts())
 	,	population_(P::psize() * gsize())
+	,	trajectory_log_("./trajectory.dat")
 	,	rand_(meave::seed())
 	,	dist_(0.0, 1.0) {
 		$::generate(population_.begin(), population_.end(), [this]() -> Float { return dist_(rand_); });
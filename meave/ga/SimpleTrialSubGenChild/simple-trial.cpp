@@ -1,3 +1,4 @@
+#include <cstring>
 #include <tuple>
 
 #include "simple-trial.hpp"
@@ -61,16 +62,36 @@ struct Params {
 	constexpr $::tuple<uns, uns> subgen_lens() const noexcept {
 		return $::make_tuple(5, 5);
 	}
+
+	constexpr bool parallel_tournaments() const noexcept {
+		return false;
+	}
+};
+
+/**
+ * Params of `simple-trial --parallel-tournaments'.
+ */
+struct ParallelParams : Params {
+	constexpr bool parallel_tournaments() const noexcept {
+		return true;
+	}
 };
 
 } /* Anonymouse Namespace */
 
+/**
+ * ./simple-trial [--parallel-tournaments]
+ */
 int
 main(int argc, char *argv[]) {
 		// Initialize Google's logging library.
 		google::InitGoogleLogging(argv[0]);
 
-		meave::ga::SimpleTrialSubGen<meave::ga::SinglePrecision, Params, meave::ga::GenChildNormal>{}();
+		if (argc > 1 && !::strcmp(argv[1], "--parallel-tournaments")) {
+			meave::ga::SimpleTrialSubGen<meave::ga::SinglePrecision, ParallelParams, meave::ga::GenChildNormal>{}();
+		} else {
+			meave::ga::SimpleTrialSubGen<meave::ga::SinglePrecision, Params, meave::ga::GenChildNormal>{}();
+		}
 
 		return 0;
 }
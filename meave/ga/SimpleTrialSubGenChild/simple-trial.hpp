@@ -6,11 +6,19 @@
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/str_printf.hpp"
 #	include "meave/lib/xrange.hpp"
+#	include "meave/lib/par/workers.hpp"
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/metrics.hpp"
+#	include "meave/ga/variation.hpp"
 
 #	include <algorithm>
 #	include <fstream>
+#	include <memory>
+#	include <numeric>
+#	include <random>
 #	include <sstream>
+#	include <thread>
 #	include <tuple>
 
 namespace meave { namespace ga {
@@ -24,24 +32,27 @@ struct SinglePrecision {
 	typedef uns Len;
 };
 
+/**
+ * Draws random numbers for one child in the same order as they were
+ *   drawn gene by gene: u[] uniform in [0, 1), g[] normal N(0, 1) .
+ */
+template <typename T, typename Float>
+void gen_child_rand(T &t, Float u[], Float g[]) {
+	for (uns _ = 0; _ < t.gsize(); ++_) {
+		u[_] = t.dist();
+		g[_] = t.norm_dist();
+	}
+}
+
 template <typename T>
 struct GenChildItemByItem {
 	template <typename Float>
 	void operator()(Float d[], const Float m[], const Float f[]) {
 		T &t = static_cast<T&>(*this);
-		for (uns _ = 0; _ < t.gsize(); ++_) {
-			if (t.dist() < t.recprob())
-				d[_] = m[_];
-			else
-				d[_] = f[_];
-
-			d[_] += t.norm_dist() * t.gaus_vec_mut();
-		
-			if (d[_] > 1.0)
-				d[_] = 2.0 - d[_];
-
-			d[_] = ::meave::math::abs(d[_]);
-		}
+		Float u[t.gsize()];
+		Float g[t.gsize()];
+		gen_child_rand(t, u, g);
+		meave::ga::variation::gen_child_item_by_item(d, m, f, u, g, t.gsize(), t.recprob(), t.gaus_vec_mut());
 	}
 };
 
@@ -51,19 +62,10 @@ struct GenChildLinear {
 	void operator()(Float d[], const Float m[], const Float f[]) {
 		T &t = static_cast<T&>(*this);
 		const Float r = t.dist();
-		for (uns _ = 0; _ < t.gsize(); ++_) {
-			if (t.dist() < t.recprob())
-				d[_] = m[_];
-			else
-				d[_] = r*m[_] + (1 - r)*f[_];
-
-			d[_] += t.norm_dist() * t.gaus_vec_mut();
-		
-			if (d[_] > 1.0)
-				d[_] = 2.0 - d[_];
-
-			d[_] = ::meave::math::abs(d[_]);
-		}
+		Float u[t.gsize()];
+		Float g[t.gsize()];
+		gen_child_rand(t, u, g);
+		meave::ga::variation::gen_child_linear(d, m, f, r, u, g, t.gsize(), t.recprob(), t.gaus_vec_mut());
 	}
 };
 
@@ -73,16 +75,10 @@ struct GenChildNormal {
 	void operator()(Float d[], const Float m[], const Float f[]) {
 		T &t = static_cast<T&>(*this);
 		const Float r = t.template normal_dist<9, 1, 10>();
-		for (uns _ = 0; _ < t.gsize(); ++_) {
-			if (t.dist() < t.recprob())
-				d[_] = r*m[_] + (1 - r)*f[_];
-			else
-				d[_] = (1-r)*m[_] + r*f[_];
-
-			d[_] += t.norm_dist() * t.gaus_vec_mut();
-		
-			d[_] = d[_] - long(d[_]);
-		}
+		Float u[t.gsize()];
+		Float g[t.gsize()];
+		gen_child_rand(t, u, g);
+		meave::ga::variation::gen_child_normal(d, m, f, r, u, g, t.gsize(), t.recprob(), t.gaus_vec_mut());
 	}
 };
 
@@ -111,6 +107,8 @@ struct GenChildNormal {
  *           Param::range() -- range of weights: [-5.0, +5.0]
  *
  *           Param::subgen_lens() -- range of lens for subgen() [+5, +5]
+ *           Param::parallel_tournaments() -- play tournaments of disjoint groups
+ *                                            in parallel rounds
  */
 template <typename Types, typename Params, template<typename> class GenChildT>
 class SimpleTrialSubGen : public Types
@@ -120,7 +118,13 @@ public:
 	typedef GenChildT<SimpleTrialSubGen<Types, Params, GenChildT>> GenChild;
 	typedef typename Types::Float Float;
 	typedef typename Types::Len Len;
-	typedef $::default_random_engine RandomGenerator;
+
+	class RandomGenerator : public $::default_random_engine {
+	public:
+		RandomGenerator()
+		:	$::default_random_engine(meave::seed()) {
+		}
+	};
 
 	Float dist() noexcept {
 		return dist_(rand_);
@@ -157,6 +161,10 @@ public:
 		return static_cast<uns>( static_cast<Float>(this->trial())/this->ts() );
 	}
 
+	uns cpus_num() const noexcept {
+		return $::max(1U, $::thread::hardware_concurrency());
+	}
+
 private:
 	typedef Params P;
 
@@ -214,9 +222,12 @@ private:
 	NNCalc nncalc_;
 	$::vector<Float> population_;
 
-	mutable RandomGenerator rand_;
-	mutable $::uniform_real_distribution<Float> dist_;
-	mutable $::normal_distribution<Float> norm_dist_;
+	meave::par::Workers the_workers_;
+	mutable EvalCounter eval_counter_;	///< Counted by const fitness().
+
+	static thread_local RandomGenerator rand_;
+	static thread_local $::uniform_real_distribution<Float> dist_;
+	static thread_local $::normal_distribution<Float> norm_dist_;
 
 	/**
 	 * @todo int/float (0.1) has big rounding error...
@@ -273,6 +284,10 @@ private:
 	template<FitnessKind FK = FITNESS_RAND, typename Wr = Nothing>
 	Float fitness(const uns index, Wr wr = Nothing()) const noexcept {
 		const Phenotype phe = phenotype(index);
+		if (FK == FITNESS_FULL)
+			eval_counter_.add_statistics(200 * 11);
+		else
+			eval_counter_.add(P::repeat());
 
 		Float f = 0;
 		if (FK == FITNESS_RAND) {
@@ -381,6 +396,13 @@ private:
 		}
 
 		DLOG(INFO) << "choose_pair, items: [" << dbg_items(subgen_len, members, evals) << "]";
+		return pick(subgen_len, members, evals);
+	}
+
+	/**
+	 * @return Two best members of a tournament and the worst one.
+	 */
+	PairDesc pick(const uns subgen_len, const uns members[], const Float evals[]) const noexcept {
 		uns max_idx[2]{0, 1};
 		if (evals[0] < evals[1])
 			$::swap(max_idx[0], max_idx[1]);
@@ -398,6 +420,28 @@ private:
 
 		return PairDesc(members[max_idx[0]], members[max_idx[1]], members[min_idx]);
 	}
+
+	/**
+	 * Draws groups for one round of tournaments. Every member is in at most
+	 *   one group, members left over after the last full group sit out.
+	 * @return Members of groups one after another and offsets of groups' ends.
+	 */
+	$::tuple<$::vector<uns>, $::vector<uns>> choose_groups() const noexcept {
+		const auto subgen_lens = Params::subgen_lens();
+		$::uniform_int_distribution<uns> dist_len{$::get<0>(subgen_lens), $::get<1>(subgen_lens)};
+
+		$::vector<uns> members(P::psize());
+		$::iota(members.begin(), members.end(), 0U);
+		$::shuffle(members.begin(), members.end(), rand_);
+
+		$::vector<uns> ends;
+		for (uns end = dist_len(rand_); end <= P::psize(); end += dist_len(rand_))
+			ends.push_back(end);
+		members.resize(ends.empty() ? 0 : ends.back());
+
+		return $::make_tuple($::move(members), $::move(ends));
+	}
+
 	friend $::ostream &operator<<($::ostream &_, const PairDesc &$) noexcept {
 		return _ << "{" << $.max(0)
 			 << ", " << $.max(1)
@@ -436,60 +480,112 @@ private:
 		gen_child_func(d, m, f);
 	}
 
+	/**
+	 * Evaluates whole population with FITNESS_FULL, writes trajectories
+	 *   and reports the worst and the best member.
+	 * @return Fitness of the best member.
+	 */
+	Float population_statistics(const uns population_idx, $::ostream &out_worstbest) noexcept {
+		Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
+		Float max_fits = -$::numeric_limits<Float>::max(); // The best member
+		uns min_idx = 0;
+		uns max_idx = 0;
+		for (uns i = 0; i < P::psize(); ++i) {
+			$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", population_idx, i), $::ofstream::trunc);
+			out_res << "Population" << "\t"
+				<< "Member" << "\t"
+				<< "Experiment" << "\t"
+				<< "Start" << "\t"
+				<< "Input" << "\t"
+				<< "RealOutput" << "\t"
+				<< "ExpectedOutput" << "\t"
+				<< "f" << $::endl;
+			const Float fit = fitness<FITNESS_FULL>(i, [population_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+				out_res << population_idx << "\t"
+					<< i << "\t"
+					<< idx << "\t"
+					<< start << "\t"
+					<< input << "\t"
+					<< real << "\t"
+					<< expected << "\t"
+					<< f << $::endl;
+			});
+
+			if (fit < min_fits)
+				$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
+			if (fit > max_fits)
+				$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
+		}
+
+		out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << $::endl;
+
+		LOG(INFO) << "Population Statistics";
+		LOG(INFO) << "\tPopulation: " << population_idx;
+		LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
+		LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
+		return max_fits;
+	}
+
+	/**
+	 * Publishes work done so far and the best member of population
+	 *   population_idx in metrics, if there are any.
+	 */
+	void publish(Metrics *metrics, const uns population_idx, const Float best) const noexcept {
+		if (!metrics)
+			return;
+		metrics->update(0, [this, population_idx, best](Metrics::Values &v) {
+			v.evaluations_ = eval_counter_.evals();
+			v.simulations_ = eval_counter_.sims();
+			v.generation_ = population_idx + 1;
+			v.best_fitness_ = best;
+		});
+	}
+
 	/**
 	 * Perform's Inman's microbial algorithm with fitness eveluations anytime.
 	 * Fitness function is in the range (-inf, +1] .
+	 * Work of every generation is published in metrics (meave/ga/metrics.hpp).
 	 */
 	void evolve() noexcept {
 		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
 		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
 
+		const $::unique_ptr<Metrics> metrics = make_metrics(1, "subgen-child");
+
+		if (P::parallel_tournaments()) {
+			uns tournaments = 0;
+			for (uns population_idx = 0; tournaments < 5 * P::psize() * gsize() + 1; ) {
+				$::vector<uns> members;
+				$::vector<uns> ends;
+				$::tie(members, ends) = choose_groups();
+
+				$::vector<Float> evals(members.size());
+				the_workers_.for_each(0, members.size(), [this, &members, &evals](const uns _) {
+					evals[_] = fitness<>(members[_]);
+				});
+
+				for (uns _ = 0, begin = 0; _ < ends.size(); begin = ends[_++]) {
+					PairDesc picked = pick(ends[_] - begin, &members[begin], &evals[begin]);
+					DLOG(INFO) << "Picked-members: " << picked;
+
+					gen_child(picked);
+				}
+
+				tournaments += ends.size();
+				for (; (population_idx + 1) * P::psize() <= tournaments; ++population_idx)
+					publish(metrics.get(), population_idx, population_statistics(population_idx, out_worstbest));
+			}
+			return;
+		}
+
 		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
 			PairDesc picked = choose_pair();
 			DLOG(INFO) << "Picked-members: " << picked;
 
 			gen_child(picked);
 
-			if (0 == (popgen_idx + 1) % P::psize()) {
-				const uns population_idx = popgen_idx/P::psize();
-				Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
-				Float max_fits = -$::numeric_limits<Float>::max(); // The best member
-				uns min_idx = 0;
-				uns max_idx = 0;
-				for (uns i = 0; i < P::psize(); ++i) {
-					$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", population_idx, i), $::ofstream::trunc);
-					out_res << "Population" << "\t"
-						<< "Member" << "\t"
-						<< "Experiment" << "\t"
-						<< "Start" << "\t"
-						<< "Input" << "\t"
-						<< "RealOutput" << "\t"
-						<< "ExpectedOutput" << "\t"
-						<< "f" << $::endl;
-					const Float fit = fitness<FITNESS_FULL>(i, [population_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
-						out_res << population_idx << "\t"
-							<< i << "\t"
-							<< idx << "\t"
-							<< start << "\t"
-							<< input << "\t"
-							<< real << "\t"
-							<< expected << "\t"
-							<< f << $::endl;
-					});
-
-					if (fit < min_fits)
-						$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
-					if (fit > max_fits)
-						$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
-				}
-
-				out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << $::endl;
-
-				LOG(INFO) << "Population Statistics";
-				LOG(INFO) << "\tPopulation: " << (popgen_idx / P::psize());
-				LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
-				LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
-			}
+			if (0 == (popgen_idx + 1) % P::psize())
+				publish(metrics.get(), popgen_idx/P::psize(), population_statistics(popgen_idx/P::psize(), out_worstbest));
 		}
 	}
 
@@ -497,8 +593,7 @@ public:
 	SimpleTrialSubGen() noexcept
 	:	nncalc_(P::nn(), P::ts())
 	,	population_(P::psize() * gsize())
-	,	rand_(meave::seed())
-	,	dist_(0.0, 1.0) {
+	,	the_workers_(cpus_num()) {
 		$::generate(population_.begin(), population_.end(), [this]() -> Float { return dist_(rand_); });
 	}
 
@@ -507,6 +602,15 @@ public:
 	}
 };
 
+template <typename Types, typename Params, template<typename> class GenChildT>
+thread_local typename SimpleTrialSubGen<Types, Params, GenChildT>::RandomGenerator SimpleTrialSubGen<Types, Params, GenChildT>::rand_;
+
+template <typename Types, typename Params, template<typename> class GenChildT>
+thread_local $::uniform_real_distribution<typename SimpleTrialSubGen<Types, Params, GenChildT>::Float> SimpleTrialSubGen<Types, Params, GenChildT>::dist_;
+
+template <typename Types, typename Params, template<typename> class GenChildT>
+thread_local $::normal_distribution<typename SimpleTrialSubGen<Types, Params, GenChildT>::Float> SimpleTrialSubGen<Types, Params, GenChildT>::norm_dist_;
+
 } } /* meave::ga */
 
 #endif // MEAVE_GA_SIMPLE_TRIAL_HPP
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <tuple>
 
 #include "simple-trial.hpp"
@@ -70,21 +71,136 @@ struct Params {
 		constexpr float crossover_probability() const noexcept {
 			return 1/2.f;
 		}
+
+		constexpr bool generational() const noexcept {
+			return false;
+		}
 	};
 
 	constexpr DifferentialEvolution differential_evolution() const noexcept {
 		return DifferentialEvolution();
 	}
+
+	struct Islands {
+		constexpr uns num() const noexcept {
+			return 1;
+		}
+
+		constexpr uns interval() const noexcept {
+			return 5;
+		}
+
+		constexpr uns migrants() const noexcept {
+			return 2;
+		}
+
+		constexpr meave::ga::Topology topology() const noexcept {
+			return meave::ga::Topology::RING;
+		}
+
+		constexpr meave::ga::MigrantSelection selection() const noexcept {
+			return meave::ga::MigrantSelection::BEST;
+		}
+	};
+
+	constexpr Islands islands() const noexcept {
+		return Islands();
+	}
+
+	struct Farm {
+		constexpr uns workers() const noexcept {
+			return 0;
+		}
+
+		constexpr uns depth() const noexcept {
+			return 4;
+		}
+	};
+
+	constexpr Farm farm() const noexcept {
+		return Farm();
+	}
+
+	struct MultiFidelity {
+		constexpr bool enabled() const noexcept {
+			return false;
+		}
+
+		constexpr uns min_scenarios() const noexcept {
+			return 275;
+		}
+
+		constexpr uns eta() const noexcept {
+			return 2;
+		}
+	};
+
+	constexpr MultiFidelity multi_fidelity() const noexcept {
+		return MultiFidelity();
+	}
+};
+
+/**
+ * Params of `simple-trial --generational': every generation evaluates
+ *   trials of all members as one batch.
+ */
+struct GenerationalParams : Params {
+	struct DifferentialEvolution : Params::DifferentialEvolution {
+		constexpr bool generational() const noexcept {
+			return true;
+		}
+	};
+
+	constexpr DifferentialEvolution differential_evolution() const noexcept {
+		return DifferentialEvolution();
+	}
+};
+
+/**
+ * Params of `simple-trial --islands': 4 islands of generational DE in
+ *   a ring, every one in its own ./island_NNN directory.
+ */
+struct IslandsParams : GenerationalParams {
+	struct Islands : GenerationalParams::Islands {
+		constexpr uns num() const noexcept {
+			return 4;
+		}
+	};
+
+	constexpr Islands islands() const noexcept {
+		return Islands();
+	}
 };
 
+template<typename P>
+void run() {
+	typedef meave::ga::SimpleTrialDifferentialEvolution<meave::ga::SinglePrecision, P> DE;
+	constexpr auto islands = P().islands();
+	static_assert(islands.num() == 1 || P().differential_evolution().generational(), "Islands need generational DE");
+	if (islands.num() > 1) {
+		meave::ga::Islands<DE>{islands.num(), islands.interval(), islands.migrants(), islands.topology(), islands.selection()}(DE::record_len());
+	} else {
+		DE{}();
+	}
+}
+
 } /* Anonymouse Namespace */
 
+/**
+ * ./simple-trial [--generational | --islands]
+ */
 int
 main(int argc, char *argv[]) {
 		// Initialize Google's logging library.
 		google::InitGoogleLogging(argv[0]);
 
-		meave::ga::SimpleTrialDifferentialEvolution<meave::ga::SinglePrecision, Params>{}();
+		if (argc > 1 && !::strcmp(argv[1], "--islands")) {
+			run<IslandsParams>();
+		} else if (argc > 1 && !::strcmp(argv[1], "--generational")) {
+			run<GenerationalParams>();
+		} else {
+			run<Params>();
+		}
 
 		return 0;
 }
@@ -6,13 +6,23 @@
 #	include "meave/lib/seed.hpp"
 #	include "meave/lib/str_printf.hpp"
 #	include "meave/lib/xrange.hpp"
+#	include "meave/lib/par/farm.hpp"
+#	include "meave/lib/par/workers.hpp"
 #	include "meave/ctrnn/neuron.hpp"
+#	include "meave/ga/eval_counter.hpp"
+#	include "meave/ga/islands.hpp"
+#	include "meave/ga/metrics.hpp"
+#	include "meave/ga/multi_fidelity.hpp"
+#	include "meave/ga/variation.hpp"
 
 #	include <algorithm>
 #	include <future>
 #	include <fstream>
+#	include <memory>
+#	include <numeric>
 #	include <sstream>
 #	include <random>
+#	include <thread>
 #	include <tuple>
 
 namespace meave { namespace ga {
@@ -51,6 +61,30 @@ struct SinglePrecision {
  *           Param::range() -- range of weights: [-5.0, +5.0]
  *
  *           Param::subgen_lens() -- range of lens for subgen() [+5, +5]
+ *
+ *           -- Differential Evolution Parameters --
+ *           Param::differential_evolution().differential_weight() -- F (1/8)
+ *           Param::differential_evolution().crossover_probability() -- CR (1/2)
+ *           Param::differential_evolution().generational() -- generational DE/rand/1/bin
+ *                                                             instead of one target at a time
+ *
+ *           -- Island Model Parameters (generational DE only) --
+ *           Param::islands().num() -- number of islands, 1 turns the island model off
+ *           Param::islands().interval() -- generations between migrations
+ *           Param::islands().migrants() -- number of emigrants per migration
+ *           Param::islands().topology() -- where migrants go (Topology)
+ *           Param::islands().selection() -- who emigrates (MigrantSelection)
+ *
+ *           -- Fitness Farm Parameters (generational DE only) --
+ *           Param::farm().workers() -- number of worker processes evaluating batches,
+ *                                      0 evaluates them by threads of this process
+ *           Param::farm().depth() -- outstanding requests per worker process
+ *
+ *           -- Multi-Fidelity Parameters (generational DE only) --
+ *           Param::multi_fidelity().enabled() -- members are evaluated on the FITNESS_FULL grid,
+ *                                                trials by successive halving (the farm is not used)
+ *           Param::multi_fidelity().min_scenarios() -- scenarios of the coarsest rung
+ *           Param::multi_fidelity().eta() -- promoted fraction 1/eta and growth of rungs
  */
 template <typename Types, typename Params>
 class SimpleTrialDifferentialEvolution : public Types
@@ -58,7 +92,13 @@ class SimpleTrialDifferentialEvolution : public Types
 public:
 	typedef typename Types::Float Float;
 	typedef typename Types::Len Len;
-	typedef std::default_random_engine RandomGenerator;
+
+	class RandomGenerator : public $::default_random_engine {
+	public:
+		RandomGenerator()
+		:	$::default_random_engine(meave::seed()) {
+		}
+	};
 
 	Float dist() noexcept {
 		return dist_(rand_);
@@ -91,6 +131,11 @@ public:
 		return dist(rand_);
 	}
 
+	uns rand_gene() noexcept {
+		static thread_local $::uniform_int_distribution<uns> dist(0, gsize() - 1);
+		return dist(rand_);
+	}
+
 	/**
 	 * @return Genome size.
 	 */
@@ -106,6 +151,20 @@ public:
 		return static_cast<uns>( static_cast<Float>(this->trial())/this->ts() );
 	}
 
+	/**
+	 * Islands are separate processes, they share the CPUs.
+	 */
+	uns cpus_num() const noexcept {
+		return $::max(1U, $::thread::hardware_concurrency() / P::islands().num());
+	}
+
+	/**
+	 * @return Length of migrant record: fitness and genome.
+	 */
+	static constexpr uns record_len() noexcept {
+		return Params().nn()*Params().nn() + 2*Params().nn() + 1;
+	}
+
 private:
 	typedef Params P;
 
@@ -163,9 +222,20 @@ private:
 	NNCalc nncalc_;
 	$::vector<Float> population_;
 
-	mutable RandomGenerator rand_;
-	mutable $::uniform_real_distribution<Float> dist_;
-	mutable $::normal_distribution<Float> norm_dist_;
+	// Used only by generational DE.
+	$::vector<Float> fitnesses_;
+	$::vector<Float> trials_;
+	$::vector<Float> trial_fitnesses_;
+
+	// The farm forks before the_workers_ start their threads, see make_farm().
+	$::unique_ptr<meave::par::Farm<Float>> the_farm_;
+	meave::par::Workers the_workers_;
+	SuccessiveHalving halving_;
+	mutable EvalCounter eval_counter_;	///< Counted by const fitness() too.
+
+	static thread_local RandomGenerator rand_;
+	static thread_local $::uniform_real_distribution<Float> dist_;
+	static thread_local $::normal_distribution<Float> norm_dist_;
 
 	/**
 	 * @todo int/float (0.1) has big rounding error...
@@ -180,8 +250,14 @@ private:
 	 * @return Desired phenotype.
 	 */
 	Phenotype phenotype(const uns index) const {
-		const Float *it_gen = &population_[index * gsize()];
+		return phenotype(&population_[index * gsize()]);
+	}
 
+	/**
+	 * Convert genotype to phenotype.
+	 * @return Desired phenotype.
+	 */
+	Phenotype phenotype(const Float *it_gen) const {
 		Phenotype $$;
 
 		const Float *it_w_end = it_gen;
@@ -225,14 +301,21 @@ private:
 		results.reserve(200);
 
 		const Phenotype phe = phenotype(index);
+		if (FK == FITNESS_FULL)
+			eval_counter_.add_statistics(SCENARIOS_NUM);
+		else
+			eval_counter_.add(P::repeat());
 
+		// Scenarios and the seeds of their noise are drawn by this thread, the
+		//   threads of the tasks would each seed a new generator.
 		if (FK == FITNESS_RAND) {
 			// Regular fitness evaluation
 			for (uns repeat = P::repeat(); repeat--; ) {
 				const Float vel = dist_(rand_) * P::velrange();
 				const Float start_pos = dist_(rand_) * P::startposrange();
-				results.emplace_back( $::async($::launch::async, [this, start_pos, vel, &phe, &wr]() -> Float {
-					return run_sim(start_pos, vel, phe, wr);
+				const unsigned seed = rand_();
+				results.emplace_back( $::async($::launch::async, [this, start_pos, vel, seed, &phe, &wr]() -> Float {
+					return run_sim(start_pos, vel, phe, seed, wr);
 				}));
 			}
 
@@ -246,14 +329,16 @@ private:
 			const uns i_max = 200;
 
 			for (const uns i: meave::make_xrange(0U, i_max)) {
-				results.emplace_back( $::async($::launch::async, [this, i, &phe, &wr]() -> Float {
+				const unsigned seed = rand_();
+				results.emplace_back( $::async($::launch::async, [this, i, seed, &phe, &wr]() -> Float {
+					$::default_random_engine seeds(seed);
 					Float temp = 0;
 					const uns j_max = 11;
 					for (const uns j: meave::make_xrange(0U, j_max)) {
 						const uns start_pos = j*10;
 						const Float f_start_pos = static_cast<Float>(start_pos);
 						const Float f_vel = static_cast<Float>(i) / 100;
-						const Float err = run_sim(f_start_pos, f_vel, phe, wr);
+						const Float err = run_sim(f_start_pos, f_vel, phe, seeds(), wr);
 						temp += err;
 					};
 					return temp /= j_max;
@@ -271,17 +356,90 @@ private:
 		return 0.f;
 	}
 
+	/**
+	 * FITNESS_RAND evaluation of a genome done entirely by the calling thread.
+	 *   It is used for batches, where parallelism comes from evaluating
+	 *   many genomes at once.
+	 */
+	Float batch_fitness(const Float *genome) const noexcept {
+		const Phenotype phe = phenotype(genome);
+
+		Float f = 0;
+		for (uns repeat = P::repeat(); repeat--; ) {
+			const Float vel = dist_(rand_) * P::velrange();
+			const Float start_pos = dist_(rand_) * P::startposrange();
+			f += run_sim(start_pos, vel, phe, rand_(), Nothing());
+		}
+		return f / P::repeat();
+	}
+
+	/**
+	 * Scenarios of FITNESS_FULL: every velocity i/100 of VELOCITIES_NUM with
+	 *   every start position j*10 of STARTS_NUM, scenario = i*STARTS_NUM + j .
+	 */
+	enum {
+		  VELOCITIES_NUM = 200
+		, STARTS_NUM = 11
+		, SCENARIOS_NUM = VELOCITIES_NUM * STARTS_NUM
+	};
+	Float scenario_sim(const Phenotype &phe, const uns scenario) const noexcept {
+		const uns i = scenario / STARTS_NUM;
+		const uns j = scenario % STARTS_NUM;
+		return run_sim(Float(j*10), Float(i) / 100, phe, rand_(), Nothing());
+	}
+
+	/**
+	 * FITNESS_FULL evaluation of a genome done entirely by the calling thread.
+	 */
+	Float grid_fitness(const Float *genome) const noexcept {
+		const Phenotype phe = phenotype(genome);
+
+		Float f = 0;
+		for (uns scenario = 0; scenario < SCENARIOS_NUM; ++scenario)
+			f += scenario_sim(phe, scenario);
+		return f / SCENARIOS_NUM;
+	}
+
+	/**
+	 * Evaluation of n genomes stored one after another, either by the farm
+	 *   of processes or by threads. It is FITNESS_FULL with multi-fidelity
+	 *   evaluation, FITNESS_RAND otherwise.
+	 */
+	void batch_fitness(const Float *genomes, const uns n, Float *fitnesses) noexcept {
+		for (uns _ = 0; _ < n; ++_)
+			eval_counter_.add(P::multi_fidelity().enabled() ? uns(SCENARIOS_NUM) : P::repeat());
+		if (P::multi_fidelity().enabled()) {
+			the_workers_.for_each(0, n, [this, genomes, fitnesses](const uns _) {
+				fitnesses[_] = grid_fitness(&genomes[gsize() * _]);
+			});
+			return;
+		}
+
+		if (the_farm_) {
+			the_farm_->evaluate(genomes, n, fitnesses);
+			return;
+		}
+
+		the_workers_.for_each(0, n, [this, genomes, fitnesses](const uns _) {
+			fitnesses[_] = batch_fitness(&genomes[gsize() * _]);
+		});
+	}
+
 	/**
 	 * Runs simulation for one phenotype...
+	 * @param seed Seed of the initial noise of neurons, so that the result
+	 *   doesn't depend on the thread running the simulation.
 	 */
 	template<typename WRITER>
-	Float run_sim(const double start, const double vel, const Phenotype &phenotype, WRITER wr = Nothing()) const noexcept {
+	Float run_sim(const double start, const double vel, const Phenotype &phenotype, const unsigned seed, WRITER wr = Nothing()) const noexcept {
 		$::vector<Float> y(P::nn());
 		$::vector<Float> ei(P::nn(), 0.0);
 		std::vector<Float> v(P::nn());
 
-		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this](const Float $) -> Float {
-			return -$ + dist_(rand_) * 2 * P::range() - P::range();
+		$::default_random_engine noise(seed);
+		$::uniform_real_distribution<Float> noise_dist;
+		$::transform(phenotype.biases().begin(), phenotype.biases().end(), v.begin(), [this, &noise, &noise_dist](const Float $) -> Float {
+			return -$ + noise_dist(noise) * 2 * P::range() - P::range();
 		});
 
 		Float distance = start;
@@ -346,10 +504,17 @@ private:
 	};
 
 	Picked pick() noexcept {
-		uns x[4];
-		for (uns i = 0; i < sizeof(x)/sizeof(*x); ) {
+		return pick(rand_index());
+	}
+
+	/**
+	 * Picks three mutually different members that differ also from the target.
+	 */
+	Picked pick(const uns target) noexcept {
+		uns x[4] = { target };
+		for (uns i = 1; i < sizeof(x)/sizeof(*x); ) {
 			x[i] = rand_index();
-			if (i == 0 || &x[i] == $::find(&x[0], &x[i], x[i]))
+			if (&x[i] == $::find(&x[0], &x[i], x[i]))
 				++i;
 		}
 
@@ -395,6 +560,78 @@ private:
 		}
 	}
 
+	/**
+	 * Builds trial vector for every member of the population (DE/rand/1/bin).
+	 *   Random numbers are drawn first, so the loop over genes has no calls
+	 *   and no branches and can be vectorized.
+	 */
+	void gen_trials() noexcept {
+		const Float F = P::differential_evolution().differential_weight();
+		const Float CR = P::differential_evolution().crossover_probability();
+
+		Float u[gsize()];
+		for (uns target = 0; target < P::psize(); ++target) {
+			const Picked picked = pick(target);
+			const uns R = rand_gene();
+			$::generate(&u[0], &u[gsize()], [this]() -> Float { return dist(); });
+			u[R] = -1;
+
+			const Float *x = &population_[gsize() * picked.x()];
+			const Float *a = &population_[gsize() * picked.a()];
+			const Float *b = &population_[gsize() * picked.b()];
+			const Float *c = &population_[gsize() * picked.c()];
+			Float *t = &trials_[gsize() * target];
+
+			meave::ga::variation::de_trial(t, x, a, b, c, u, gsize(), F, CR);
+		}
+	}
+
+	/**
+	 * Evaluates all trial vectors at once and replaces every target, whose
+	 *   stored fitness is not better than fitness of its trial vector.
+	 */
+	void select_trials() noexcept {
+		if (P::multi_fidelity().enabled())
+			halve_trials();
+		else
+			batch_fitness(&trials_[0], P::psize(), &trial_fitnesses_[0]);
+
+		uns replaced = 0;
+		for (uns _ = 0; _ < P::psize(); ++_) {
+			if (trial_fitnesses_[_] >= fitnesses_[_]) {
+				$::copy(&trials_[gsize() * _], &trials_[gsize() * (_ + 1)], &population_[gsize() * _]);
+				fitnesses_[_] = trial_fitnesses_[_];
+				++replaced;
+			}
+		}
+		DLOG(INFO) << "Replaced members: " << replaced << '/' << P::psize();
+	}
+
+	/**
+	 * Evaluates trial vectors by successive halving. Only trials whose
+	 *   estimate reaches the stored fitness of their target are evaluated on
+	 *   the full grid, the others get -inf and are rejected.
+	 */
+	void halve_trials() noexcept {
+		$::vector<Phenotype> phes;
+		for (uns _ = 0; _ < P::psize(); ++_)
+			phes.push_back(phenotype(&trials_[gsize() * _]));
+
+		$::vector<SuccessiveHalving::Result> results(P::psize());
+		halving_(P::psize(), [this, &phes](const uns c, const uns scenario) -> Float {
+			return scenario_sim(phes[c], scenario);
+		}, [this](const uns c, const Float estimate) -> bool {
+			return estimate >= fitnesses_[c];
+		}, [this](const uns b, const uns e, auto &&fn) {
+			the_workers_.for_each(b, e, fn);
+		}, &results[0]);
+
+		for (uns _ = 0; _ < P::psize(); ++_) {
+			trial_fitnesses_[_] = results[_].full(SCENARIOS_NUM) ? results[_].fitness_ : -$::numeric_limits<Float>::infinity();
+			eval_counter_.add(results[_].scenarios_);
+		}
+	}
+
 	friend $::ostream &operator<<($::ostream &_, const Picked &$) noexcept {
 		return _ << "{ x:" << $.x()
 			 << ", a:" << $.a()
@@ -419,74 +656,197 @@ private:
 		return o.str();
 	}
 
+	/**
+	 * Evaluates whole population with FITNESS_FULL, writes trajectories
+	 *   and reports the worst and the best member.
+	 * @return Fitness of the best member.
+	 */
+	Float population_statistics(const uns population_idx, $::ostream &out_worstbest) const noexcept {
+		Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
+		Float max_fits = -$::numeric_limits<Float>::max(); // The best member
+		uns min_idx = 0;
+		uns max_idx = 0;
+		for (uns i = 0; i < P::psize(); ++i) {
+			$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", population_idx, i), $::ofstream::trunc);
+			out_res << "Population" << "\t"
+				<< "Member" << "\t"
+				<< "Experiment" << "\t"
+				<< "Start" << "\t"
+				<< "Input" << "\t"
+				<< "RealOutput" << "\t"
+				<< "ExpectedOutput" << "\t"
+				<< "f" << $::endl;
+			const Float fit = fitness<FITNESS_FULL>(i, [population_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
+				out_res << population_idx << "\t"
+					<< i << "\t"
+					<< idx << "\t"
+					<< start << "\t"
+					<< input << "\t"
+					<< real << "\t"
+					<< expected << "\t"
+					<< f << $::endl;
+			});
+
+			if (fit < min_fits)
+				$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
+			if (fit > max_fits)
+				$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
+		}
+
+		out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << $::endl;
+
+		LOG(INFO) << "Population Statistics";
+		LOG(INFO) << "\tPopulation: " << population_idx;
+		LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
+		LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
+		return max_fits;
+	}
+
+	/**
+	 * Publishes work done so far and the best member of population
+	 *   population_idx in metrics, if there are any.
+	 */
+	void publish(Metrics *metrics, const uns population_idx, const Float best) const noexcept {
+		if (!metrics)
+			return;
+		metrics->update(0, [this, population_idx, best](Metrics::Values &v) {
+			v.evaluations_ = eval_counter_.evals();
+			v.simulations_ = eval_counter_.sims();
+			v.generation_ = population_idx + 1;
+			v.best_fitness_ = best;
+		});
+	}
+
 	/**
 	 * Perform's Differential evolution.
 	 * Fitness function is in the range (-inf, +1] .
+	 *
+	 * Generational DE evaluates every trial vector only once and compares it
+	 *   with the stored fitness of its target, the other mode evaluates both
+	 *   the target and the trial vector for every step.
+	 *
+	 * after_generation(evaluations) is called after every generation of
+	 *   generational DE with number of evaluations done so far. Work of every
+	 *   generation is published in metrics (meave/ga/metrics.hpp).
 	 */
-	void evolve() noexcept {
+	template<typename Fn>
+	void evolve(Fn &&after_generation) noexcept {
 		$::ofstream out_worstbest("./worstbest.csv", $::ofstream::trunc);
 		out_worstbest << "MinFitnessIndex" << "\t" << "MinFitnessValue" << "\t" << "MaxFitnessIndex" << "\t" << "MaxFitnessValue" << $::endl;
 
-		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
-			maybe_gen_child();
+		const $::unique_ptr<Metrics> metrics = make_metrics(1, "de");
+
+		if (P::differential_evolution().generational()) {
+			batch_fitness(&population_[0], P::psize(), &fitnesses_[0]);
 
-			if (0 == (popgen_idx + 1) % P::psize()) {
-				const uns population_idx = popgen_idx/P::psize();
-				Float min_fits = +$::numeric_limits<Float>::max(); // The worst member
-				Float max_fits = -$::numeric_limits<Float>::max(); // The best member
-				uns min_idx = 0;
-				uns max_idx = 0;
-				for (uns i = 0; i < P::psize(); ++i) {
-					$::ofstream out_res(str_printf("./results_%.3u_%.3u.csv", population_idx, i), $::ofstream::trunc);
-					out_res << "Population" << "\t"
-						<< "Member" << "\t"
-						<< "Experiment" << "\t"
-						<< "Start" << "\t"
-						<< "Input" << "\t"
-						<< "RealOutput" << "\t"
-						<< "ExpectedOutput" << "\t"
-						<< "f" << $::endl;
-					const Float fit = fitness<FITNESS_FULL>(i, [population_idx, i, &out_res](const float start, const float input, const uns idx, const double real, const double expected, const double f) {
-						out_res << population_idx << "\t"
-							<< i << "\t"
-							<< idx << "\t"
-							<< start << "\t"
-							<< input << "\t"
-							<< real << "\t"
-							<< expected << "\t"
-							<< f << $::endl;
-					});
-
-					if (fit < min_fits)
-						$::tie(min_fits, min_idx) = $::make_tuple(fit, i);
-					if (fit > max_fits)
-						$::tie(max_fits, max_idx) = $::make_tuple(fit, i);
+			for (uns population_idx = 0; population_idx < 5 * gsize(); ++population_idx) {
+				gen_trials();
+				select_trials();
+				publish(metrics.get(), population_idx, population_statistics(population_idx, out_worstbest));
+				if (P::multi_fidelity().enabled()) {
+					LOG(INFO) << "\tsimulations saved by successive halving: " << 100. * halving_.saved() << '%';
+					halving_.reset_stats();
 				}
+				after_generation(::uint64_t(population_idx + 2) * P::psize());
+			}
+			return;
+		}
 
-				out_worstbest << min_idx << "\t" << min_fits << "\t" << max_idx << "\t" << max_fits << $::endl;
+		for (uns popgen_idx = 0; popgen_idx < 5 * P::psize() * gsize() + 1; ++popgen_idx) {
+			maybe_gen_child();
 
-				LOG(INFO) << "Population Statistics";
-				LOG(INFO) << "\tPopulation: " << (popgen_idx / P::psize());
-				LOG(INFO) << "\tmin-fitness (worst memmber): " << min_fits << '[' << min_idx << ']';
-				LOG(INFO) << "\tmax-fitness (best member): " << max_fits << '[' << max_idx << ']';
-			}
+			if (0 == (popgen_idx + 1) % P::psize())
+				publish(metrics.get(), popgen_idx/P::psize(), population_statistics(popgen_idx/P::psize(), out_worstbest));
 		}
 	}
 
+	/**
+	 * @return Farm of P::farm().workers() processes, null without them.
+	 *   It is called before any thread is started: a forked child has only
+	 *   the thread that forked it, and a mutex held by another thread
+	 *   (of the_workers_, of glog) would stay locked in the child forever.
+	 *   Workers evaluate by batch_fitness(genome), which needs nothing
+	 *   constructed after nncalc_ .
+	 */
+	$::unique_ptr<meave::par::Farm<Float>> make_farm() {
+		if (!P::farm().workers() || P::multi_fidelity().enabled())
+			return nullptr;
+		return $::unique_ptr<meave::par::Farm<Float>>(new meave::par::Farm<Float>(P::farm().workers(), P::farm().depth(), gsize(), [this](const Float *genome) {
+			return batch_fitness(genome);
+		}));
+	}
+
 public:
 	SimpleTrialDifferentialEvolution() noexcept
 	:	nncalc_(P::nn(), P::ts())
 	,	population_(P::psize() * gsize())
-	,	rand_(meave::seed())
-	,	dist_(0.0, 1.0) {
+	,	fitnesses_(P::psize())
+	,	trials_(P::psize() * gsize())
+	,	trial_fitnesses_(P::psize())
+	,	the_farm_(make_farm())
+	,	the_workers_(cpus_num())
+	,	halving_(SCENARIOS_NUM, P::multi_fidelity().min_scenarios(), P::multi_fidelity().eta()) {
 		$::generate(population_.begin(), population_.end(), [this]() -> Float { return dist_(rand_); });
 	}
 
 	void operator()() noexcept {
-		evolve();
+		evolve(Nothing());
+	}
+
+	template<typename Fn>
+	void operator()(Fn &&after_generation) noexcept {
+		evolve(after_generation);
+	}
+
+	/**
+	 * Writes records (fitness, genome) of n members chosen by selection.
+	 */
+	void emigrants(const MigrantSelection selection, const uns n, Float out[]) noexcept {
+		MEAVE_ASSERT(n <= P::psize());
+
+		$::vector<uns> idx(P::psize());
+		$::iota(idx.begin(), idx.end(), 0U);
+		switch (selection) {
+		case MigrantSelection::BEST:
+			$::partial_sort(idx.begin(), idx.begin() + n, idx.end(), [this](const uns a, const uns b) {
+				return fitnesses_[a] > fitnesses_[b];
+			});
+			break;
+
+		case MigrantSelection::RANDOM:
+			$::shuffle(idx.begin(), idx.end(), rand_);
+			break;
+		}
+
+		for (uns _ = 0; _ < n; ++_, out += record_len()) {
+			out[0] = fitnesses_[idx[_]];
+			$::copy(&population_[gsize() * idx[_]], &population_[gsize() * (idx[_] + 1)], &out[1]);
+		}
+	}
+
+	/**
+	 * Every immigrant replaces the worst member, if it is better.
+	 */
+	void immigrants(const uns n, const Float in[]) noexcept {
+		for (uns _ = 0; _ < n; ++_, in += record_len()) {
+			const uns worst = $::min_element(fitnesses_.begin(), fitnesses_.end()) - fitnesses_.begin();
+			if (in[0] > fitnesses_[worst]) {
+				fitnesses_[worst] = in[0];
+				$::copy(&in[1], &in[record_len()], &population_[gsize() * worst]);
+			}
+		}
 	}
 };
 
+template <typename Types, typename Params>
+thread_local typename SimpleTrialDifferentialEvolution<Types, Params>::RandomGenerator SimpleTrialDifferentialEvolution<Types, Params>::rand_;
+
+template <typename Types, typename Params>
+thread_local $::uniform_real_distribution<typename SimpleTrialDifferentialEvolution<Types, Params>::Float> SimpleTrialDifferentialEvolution<Types, Params>::dist_;
+
+template <typename Types, typename Params>
+thread_local $::normal_distribution<typename SimpleTrialDifferentialEvolution<Types, Params>::Float> SimpleTrialDifferentialEvolution<Types, Params>::norm_dist_;
+
 } } /* meave::ga */
 
 #endif // MEAVE_GA_SIMPLE_TRIAL_DIFFERENTIAL_EVOLUTION_HPP
@@ -0,0 +1,101 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <meave/commons.hpp>
+#include <meave/ga/genome_archive.hpp>
+
+/*
+ * Genomes of populations of different sizes are appended into an archive
+ *   that has to grow many times and are read back by populations, once
+ *   from the finished archive and once from a copy of the archive taken
+ *   before it was closed (a crashed run without index).
+ */
+
+namespace {
+
+typedef meave::ga::GenomeArchive<float> GenomeArchive;
+typedef meave::ga::GenomeArchiveReader<float> GenomeArchiveReader;
+
+constexpr uns GSIZE = 15;
+constexpr uns NN = 3;
+constexpr uns POPULATIONS = 50;
+
+uns members_num(const uns population) noexcept {
+	return 20 + population % 7;
+}
+
+float gene(const uns population, const uns member, const uns _) noexcept {
+	return population * 1e3f + member + _ / 16.f;
+}
+
+void check(const char *file_name, const bool complete) {
+	const GenomeArchiveReader reader(file_name);
+	assert(reader.complete() == complete);
+	assert(reader.gsize() == GSIZE && reader.nn() == NN);
+	assert(reader.populations().size() == POPULATIONS);
+
+	::uint64_t records = 0;
+	// Population 2k + 1 is missing, so the index is searched.
+	for (uns population = 0; population < 2 * POPULATIONS; ++population) {
+		const auto range = reader.records(population);
+		if (population % 2) {
+			assert(range.first == range.second);
+			continue;
+		}
+		assert(range.first == records);
+		assert(range.second - range.first == members_num(population));
+		for (::uint64_t record = range.first; record < range.second; ++record) {
+			const uns member = record - range.first;
+			assert(reader.population(record) == population && reader.member(record) == member);
+			for (uns _ = 0; _ < GSIZE; ++_)
+				assert(reader.genome(record)[_] == gene(population, member, _));
+		}
+		records = range.second;
+	}
+	assert(records == reader.size());
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	const char *file_name = "./test-genome-archive.dat";
+	const char *crashed_file_name = "./test-genome-archive-crashed.dat";
+
+	{
+		GenomeArchive archive(file_name, GSIZE, NN, 8192);
+		$::vector<float> genome(GSIZE);
+		for (uns population = 0; population < 2 * POPULATIONS; population += 2) {
+			for (uns member = 0; member < members_num(population); ++member) {
+				for (uns _ = 0; _ < GSIZE; ++_)
+					genome[_] = gene(population, member, _);
+				archive.append(population, member, &genome[0]);
+			}
+		}
+
+		bool thrown = false;
+		try {
+			archive.append(0, 0, &genome[0]);
+		} catch (const meave::Error &) {
+			thrown = true;
+		}
+		assert(thrown);
+
+		assert(0 == ::system(($::string("cp ") + file_name + " " + crashed_file_name).c_str()));
+	}
+
+	check(file_name, true);
+	check(crashed_file_name, false);
+
+	::unlink(file_name);
+	::unlink(crashed_file_name);
+	$::cerr << "OK" << $::endl;
+	return 0;
+}
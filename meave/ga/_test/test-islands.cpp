@@ -0,0 +1,139 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include <unistd.h>
+
+#include <meave/commons.hpp>
+#include <meave/ga/islands.hpp>
+#include <meave/lib/seed.hpp>
+#include <meave/lib/str_printf.hpp>
+
+/*
+ * Runs islands that only exchange migrants and checks where they ran
+ *   (./island_NNN), who they received migrants from, and that their
+ *   MEAVE_SEED seeds differ.
+ */
+
+namespace {
+
+constexpr uns ISLANDS = 4;
+
+/**
+ * Emigrants carry the index of their island, the island writes what it
+ *   got to ./result in its directory.
+ */
+class Island {
+public:
+	typedef float Float;
+
+	enum : uns { RECORD_LEN = 2, MIN_GENERATIONS = 20, MAX_GENERATIONS = 5000 };
+
+private:
+	uns index_;
+	unsigned seed_;
+	uns received_;
+	$::set<uns> from_;
+
+public:
+	Island()
+	:	index_(-1)
+	,	seed_(meave::seed())
+	,	received_(0) {
+		char cwd[PATH_MAX];
+		assert(::getcwd(cwd, sizeof(cwd)));
+		const char *const base = ::strrchr(cwd, '/') + 1;
+		assert(1 == ::sscanf(base, "island_%u", &index_));
+		assert(base == meave::str_printf("island_%.3u", index_));
+	}
+
+	void emigrants(const meave::ga::MigrantSelection, const uns n, Float out[]) noexcept {
+		for (uns _ = 0; _ < n; ++_, out += RECORD_LEN) {
+			out[0] = index_;
+			out[1] = _;
+		}
+	}
+
+	void immigrants(const uns n, const Float in[]) noexcept {
+		for (uns _ = 0; _ < n; ++_, in += RECORD_LEN)
+			from_.insert(in[0]);
+		received_ += n;
+	}
+
+	/**
+	 * Generations go on until something is received, islands don't wait
+	 *   for each other.
+	 */
+	template<typename Fn>
+	void operator()(Fn &&after_generation) {
+		for (uns gen = 0; gen < MIN_GENERATIONS || (!received_ && gen < MAX_GENERATIONS); ++gen) {
+			::usleep(1000);
+			after_generation(::uint64_t(gen + 1) * 10);
+		}
+
+		$::FILE *const f = ::fopen("result", "w");
+		assert(f);
+		::fprintf(f, "%u %u %u", index_, seed_, received_);
+		for (const uns $: from_)
+			::fprintf(f, " %u", $);
+		::fclose(f);
+	}
+};
+
+void check(const meave::ga::Topology topology) {
+	char dir[] = "/tmp/test-islands-XXXXXX";
+	assert(::mkdtemp(dir));
+	assert(0 == ::chdir(dir));
+
+	meave::ga::Islands<Island>{ISLANDS, 5, 2, topology, meave::ga::MigrantSelection::BEST}(Island::RECORD_LEN, 0.01);
+	assert(0 == ::access("migration.dat", F_OK));
+
+	$::set<unsigned> seeds;
+	for (uns island = 0; island < ISLANDS; ++island) {
+		const $::string result = meave::str_printf("island_%.3u/result", island);
+		$::FILE *const f = ::fopen(result.c_str(), "r");
+		assert(f);
+		uns index, received;
+		unsigned seed;
+		assert(3 == ::fscanf(f, "%u %u %u", &index, &seed, &received));
+		$::set<uns> from;
+		for (uns $; 1 == ::fscanf(f, "%u", &$); )
+			from.insert($);
+		::fclose(f);
+		::unlink(result.c_str());
+		::rmdir(result.substr(0, result.find('/')).c_str());
+
+		assert(index == island);
+		assert(received > 0);
+		assert(!from.count(island));
+		if (topology == meave::ga::Topology::RING)
+			assert(from == $::set<uns>{(island + ISLANDS - 1) % ISLANDS});
+		seeds.insert(seed);
+	}
+	assert(seeds.size() == ISLANDS);
+
+	::unlink("migration.dat");
+	assert(0 == ::chdir("/"));
+	assert(0 == ::rmdir(dir));
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	::setenv("MEAVE_SEED", "1", 1);
+
+	check(meave::ga::Topology::RING);
+	check(meave::ga::Topology::FULL);
+	check(meave::ga::Topology::RANDOM);
+	$::cerr << "islands: OK" << $::endl;
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+#undef NDEBUG
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/gettime.hpp>
+#include <meave/ga/metrics.hpp>
+
+/*
+ * Checks that readers of a metrics segment see only consistent slots while
+ *   writers update them, and measures the cost of an update.
+ */
+
+namespace {
+
+typedef meave::ga::Metrics Metrics;
+typedef meave::ga::MetricsReader MetricsReader;
+
+constexpr uns THREADS = 3;
+constexpr uns UPDATES = 200000;
+
+/**
+ * All values of a slot are derived from k, a torn read mixes two k's.
+ */
+void fill(Metrics::Values &v, const ::uint64_t k) noexcept {
+	v.evaluations_ = k;
+	v.simulations_ = 2200 * k;
+	v.cache_hits_ = 3 * k;
+	v.queue_depth_ = k % 7;
+	v.generation_ = k / 10;
+	v.task_ = k;
+	v.best_fitness_ = -1. / (k + 1);
+}
+
+bool consistent(const Metrics::Values &v) noexcept {
+	if (!v.updated_)
+		return !v.evaluations_ && !v.best_fitness_;
+	Metrics::Values expected;
+	fill(expected, v.evaluations_);
+	return v.simulations_ == expected.simulations_
+	    && v.cache_hits_ == expected.cache_hits_
+	    && v.queue_depth_ == expected.queue_depth_
+	    && v.generation_ == expected.generation_
+	    && v.task_ == expected.task_
+	    && v.best_fitness_ == expected.best_fitness_;
+}
+
+void check_concurrent() {
+	Metrics metrics(THREADS, "test-metrics", "/tmp");
+	MetricsReader reader(metrics.file_name().c_str());
+	assert(reader.slots_num() == THREADS);
+	assert(reader.pid() == ::getpid());
+	assert(reader.name() == "test-metrics");
+
+	Metrics::Values v;
+	for (uns _ = 0; _ < THREADS; ++_)
+		assert(reader.read(_, v) && v.evaluations_ == 0 && v.updated_ == 0);
+
+	$::atomic<uns> running(THREADS);
+	$::vector<$::thread> writers;
+	for (uns th = 0; th < THREADS; ++th) {
+		writers.emplace_back([&metrics, &running, th]() {
+			for (::uint64_t k = 1; k <= UPDATES; ++k)
+				metrics.update(th, [k](Metrics::Values &v) { fill(v, k); });
+			--running;
+		});
+	}
+
+	uns reads = 0, failed = 0;
+	::uint64_t last[THREADS] = {};
+	while (running) {
+		for (uns th = 0; th < THREADS; ++th) {
+			if (!reader.read(th, v)) {
+				++failed;
+				continue;
+			}
+			++reads;
+			assert(consistent(v));
+			// One writer per slot, its values never go back.
+			assert(v.evaluations_ >= last[th]);
+			last[th] = v.evaluations_;
+		}
+	}
+	for (auto &$: writers)
+		$.join();
+
+	for (uns th = 0; th < THREADS; ++th)
+		assert(reader.read(th, v) && v.evaluations_ == UPDATES && consistent(v) && v.updated_ > 0);
+	$::cerr << reads << " consistent reads, " << failed << " given up while writers were busy" << $::endl;
+}
+
+void check_unlink() {
+	$::string file_name;
+	{
+		Metrics metrics(1, "test-metrics", "/tmp");
+		file_name = metrics.file_name();
+		assert(!::access(file_name.c_str(), F_OK));
+	}
+	assert(::access(file_name.c_str(), F_OK));
+}
+
+void measure() {
+	constexpr uns REPEAT = 1000000;
+	Metrics metrics(1, "test-metrics", "/tmp");
+
+	const double t0 = meave::gettime();
+	for (uns _ = 0; _ < REPEAT; ++_)
+		metrics.update(0, [_](Metrics::Values &v) { ++v.evaluations_; v.simulations_ += 2200; v.generation_ = _ / 100; });
+	const double t1 = meave::gettime();
+
+	$::cerr << "update: " << (t1 - t0) / REPEAT * 1e9 << " ns" << $::endl;
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_concurrent();
+	check_unlink();
+	measure();
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/ga/multi_fidelity.hpp>
+
+/*
+ * Checks the mixed order of scenarios and successive halving of candidates
+ *   with known mean scores: the best ones must survive and be evaluated
+ *   fully, others must stop early.
+ */
+
+namespace {
+
+typedef meave::ga::SuccessiveHalving SuccessiveHalving;
+
+constexpr uns VELOCITIES = 200;
+constexpr uns STARTS = 11;
+constexpr uns N = VELOCITIES * STARTS;
+
+/**
+ * Score of a candidate in a scenario: its mean plus a zero-mean wave over
+ *   velocities, so coarse estimates are noisy but unbiased.
+ */
+float score(const uns candidate, const uns scenario) noexcept {
+	const uns velocity = scenario / STARTS;
+	return -float(candidate) + ::sin(velocity * 2 * M_PI / VELOCITIES) * 3;
+}
+
+void check_order() {
+	const $::vector<uns> order = meave::ga::mixed_scenario_order(N);
+	assert($::set<uns>(order.begin(), order.end()).size() == N);
+
+	$::set<uns> starts;
+	for (uns k = 0; k < STARTS; ++k)
+		starts.insert(order[k] % STARTS);
+	assert(starts.size() == STARTS);
+}
+
+void check_halving() {
+	constexpr uns M = 40;
+	SuccessiveHalving halving(N, 137, 2);
+	assert(halving.rungs().front() == 137 && halving.rungs().back() == N);
+
+	$::vector<SuccessiveHalving::Result> results(M);
+	halving(M, score, [](const uns, const float estimate) {
+		return estimate > -3;
+	}, [](const uns b, const uns e, auto &&fn) {
+		for (uns i = b; i < e; ++i)
+			fn(i);
+	}, &results[0]);
+
+	// Candidates 0 .. 2 are contenders and the best ones, so they win every rung.
+	for (uns c = 0; c < M; ++c) {
+		if (c < 3) {
+			assert(results[c].full(N));
+			assert(::fabs(results[c].fitness_ + float(c)) < 1e-3);
+		} else {
+			assert(!results[c].full(N));
+			assert(results[c].scenarios_ >= 137);
+		}
+	}
+	assert(results[M - 1].scenarios_ == 137);
+
+	$::cerr << "successive halving saved " << 100 * halving.saved() << "% of simulations" << $::endl;
+	assert(halving.saved() > 0.75);
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_order();
+	check_halving();
+
+	return 0;
+}
@@ -0,0 +1,152 @@
+#undef NDEBUG
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/cpu.hpp>
+#include <meave/lib/gettime.hpp>
+#include <meave/ga/novelty.hpp>
+
+/*
+ * Compares k nearest neighbours from the archive, brute force and through
+ *   the vantage-point tree, with a naive search and measures both ways.
+ */
+
+namespace {
+
+typedef meave::ga::NoveltyArchive<float> Archive;
+
+constexpr uns K = 15;
+
+$::default_random_engine rand_;
+
+$::vector<float> random_descs(const uns n, const uns dim) {
+	$::uniform_real_distribution<float> dist(0.f, 1.f);
+	$::vector<float> $$(n * dim);
+	$::generate($$.begin(), $$.end(), [&dist]() { return dist(rand_); });
+	return $$;
+}
+
+$::vector<float> naive_knn(const $::vector<float> &descs, const uns dim, const float *q, const uns k) {
+	$::vector<float> $$;
+	for (uns i = 0; i < descs.size() / dim; ++i) {
+		double d2 = 0;
+		for (uns j = 0; j < dim; ++j)
+			d2 += (q[j] - descs[i * dim + j]) * (q[j] - descs[i * dim + j]);
+		$$.push_back(::sqrt(d2));
+	}
+	$::sort($$.begin(), $$.end());
+	$$.resize($::min<::size_t>(k, $$.size()));
+	return $$;
+}
+
+/**
+ * Descriptors like sampled outputs of a simulation: sine waves of random
+ *   amplitude and phase, intrinsically 2-dimensional.
+ */
+$::vector<float> wave_descs(const uns n, const uns dim) {
+	$::uniform_real_distribution<float> dist(0.f, 1.f);
+	$::vector<float> $$(n * dim);
+	for (uns i = 0; i < n; ++i) {
+		const float a = dist(rand_);
+		const float phi = dist(rand_) * 2 * M_PI;
+		for (uns j = 0; j < dim; ++j)
+			$$[i * dim + j] = a * ::sin(j * 0.3f + phi);
+	}
+	return $$;
+}
+
+void check_dist2() {
+	for (uns dim = 1; dim < 40; ++dim) {
+		const $::vector<float> a = random_descs(1, dim);
+		const $::vector<float> b = random_descs(1, dim);
+		float scalar = 0;
+		for (uns _ = 0; _ < dim; ++_)
+			scalar += (a[_] - b[_]) * (a[_] - b[_]);
+		for (int l = meave::cpu::SCALAR; l <= meave::cpu::detected(); ++l)
+			assert(::fabs(meave::ga::novelty::dist2(&a[0], &b[0], dim, meave::cpu::Level(l)) - scalar) < 1e-5 * (1 + scalar));
+	}
+}
+
+/**
+ * Inserts n descriptors in batches of 100, checks queries after every batch.
+ */
+void check_knn(const uns n, const uns dim, const uns brute_max) {
+	Archive archive(dim, brute_max);
+	const $::vector<float> descs = random_descs(n, dim);
+	const $::vector<float> queries = random_descs(20, dim);
+
+	$::vector<float> dists(K);
+	for (uns done = 0; done < n; ) {
+		const uns batch = $::min(100U, n - done);
+		archive.insert(batch, &descs[done * dim]);
+		done += batch;
+		assert(archive.size() == done);
+
+		const $::vector<float> inserted(descs.begin(), descs.begin() + done * dim);
+		for (uns q = 0; q < 20; ++q) {
+			const $::vector<float> expected = naive_knn(inserted, dim, &queries[q * dim], K);
+			assert(archive.knn(&queries[q * dim], K, &dists[0]) == expected.size());
+			for (uns _ = 0; _ < expected.size(); ++_)
+				assert(::fabs(dists[_] - expected[_]) < 1e-5);
+		}
+	}
+
+	// A descriptor of the archive is its own nearest neighbour.
+	uns idx;
+	assert(archive.knn(archive[n / 3], 1, &dists[0], &idx) == 1);
+	assert(dists[0] == 0 && idx == n / 3);
+
+	// Nothing is nearer than the 0 nearest.
+	assert(archive.knn(&queries[0], 0, nullptr) == 0);
+	assert(archive.novelty(&queries[0], 0) == 0);
+}
+
+void measure(const char *name, $::vector<float> (*gen)(uns, uns), const uns n, const uns dim) {
+	const $::vector<float> descs = gen(n, dim);
+	const $::vector<float> queries = gen(1000, dim);
+
+	Archive brute(dim, n);
+	Archive tree(dim, 0);
+	brute.insert(n, &descs[0]);
+	tree.insert(n, &descs[0]);
+
+	const auto seq_for = [](const uns b, const uns e, auto &&fn) {
+		for (uns i = b; i < e; ++i)
+			fn(i);
+	};
+	$::vector<float> out_brute(1000), out_tree(1000);
+
+	const double t0 = meave::gettime();
+	brute.novelty(1000, &queries[0], K, &out_brute[0], seq_for);
+	const double t1 = meave::gettime();
+	tree.novelty(1000, &queries[0], K, &out_tree[0], seq_for);
+	const double t2 = meave::gettime();
+
+	for (uns _ = 0; _ < 1000; ++_)
+		assert(::fabs(out_brute[_] - out_tree[_]) < 1e-5);
+	$::cerr << name << " archive " << n << " x " << dim << ": brute force " << (t1 - t0) * 1e3 << " us/query, vp-tree " << (t2 - t1) * 1e3 << " us/query" << $::endl;
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_dist2();
+	check_knn(1000, 5, 1 << 20);
+	check_knn(3000, 13, 200);
+	check_knn(3000, 8, 0);
+
+	measure("uniform", random_descs, 2000, 8);
+	measure("uniform", random_descs, 50000, 8);
+	measure("uniform", random_descs, 50000, 24);
+	measure("wave", wave_descs, 2000, 24);
+	measure("wave", wave_descs, 50000, 24);
+
+	return 0;
+}
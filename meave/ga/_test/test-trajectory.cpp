@@ -0,0 +1,102 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <meave/commons.hpp>
+#include <meave/ga/trajectory.hpp>
+
+/*
+ * Members of several populations are logged concurrently into a log that
+ *   has to grow many times, then every row is read back from the file.
+ */
+
+namespace {
+
+typedef meave::ga::TrajectoryLog TrajectoryLog;
+
+constexpr uns POPULATIONS = 3;
+constexpr uns MEMBERS = 4;
+constexpr uns BLOCK_ROWS = 100;
+
+uns rows_num(const uns population, const uns member) noexcept {
+	return 1 + population * 1000 + member * 337;
+}
+
+float value(const uns population, const uns member, const uns row, const uns column) noexcept {
+	return population * 1e4f + member * 1e3f + row + column / 8.f;
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	const char *file_name = "./test-trajectory.dat";
+
+	{
+		TrajectoryLog log(file_name, 4096);
+		$::vector<$::thread> threads;
+		for (uns member = 0; member < MEMBERS; ++member) {
+			threads.emplace_back([&log, member]() {
+				for (uns population = 0; population < POPULATIONS; ++population) {
+					TrajectoryLog::Appender trajectory(log, population, member, BLOCK_ROWS);
+					for (uns row = 0; row < rows_num(population, member); ++row) {
+						trajectory(value(population, member, row, 0), value(population, member, row, 1), row,
+							   value(population, member, row, 2), value(population, member, row, 3), value(population, member, row, 4));
+					}
+				}
+			});
+		}
+		for (auto &th: threads)
+			th.join();
+	}
+
+	$::ifstream in(file_name, $::ifstream::binary);
+	$::vector<char> file(($::istreambuf_iterator<char>(in)), $::istreambuf_iterator<char>());
+	assert(file.size() >= sizeof(TrajectoryLog::Header));
+
+	TrajectoryLog::Header header;
+	::memcpy(&header, &file[0], sizeof header);
+	assert(!::memcmp(header.magic_, TrajectoryLog::magic(), sizeof header.magic_));
+	assert(header.used_ == file.size());
+
+	$::map<$::pair<uns, uns>, uns> rows;
+	for (::size_t off = sizeof header; off < file.size(); ) {
+		TrajectoryLog::BlockHeader block;
+		::memcpy(&block, &file[off], sizeof block);
+		off += sizeof block;
+		assert(block.rows_ && block.rows_ <= BLOCK_ROWS);
+
+		uns &done = rows[$::make_pair(block.population_, block.member_)];
+		for (uns _ = 0; _ < block.rows_; ++_) {
+			const uns row = done + _;
+			::uint32_t experiment;
+			::memcpy(&experiment, &file[off + _ * sizeof experiment], sizeof experiment);
+			assert(experiment == row);
+			for (uns column = 0; column < 5; ++column) {
+				float x;
+				::memcpy(&x, &file[off + block.rows_ * (sizeof experiment + column * sizeof x) + _ * sizeof x], sizeof x);
+				assert(x == value(block.population_, block.member_, row, column));
+			}
+		}
+		done += block.rows_;
+		off += block.rows_ * TrajectoryLog::row_size();
+	}
+
+	assert(rows.size() == POPULATIONS * MEMBERS);
+	for (const auto &r: rows)
+		assert(r.second == rows_num(r.first.first, r.first.second));
+
+	::unlink(file_name);
+	$::cerr << "OK: " << file.size() << " bytes" << $::endl;
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/cpu.hpp>
+#include <meave/lib/gettime.hpp>
+#include <meave/ga/variation.hpp>
+
+/*
+ * Compares variants of every level of meave/ga/variation.hpp the CPU has
+ *   with the per-gene loops, checks that nothing behind n is written and
+ *   measures both.
+ */
+
+namespace {
+
+namespace v = meave::ga::variation;
+
+constexpr uns MAX_N = 67;
+constexpr uns REPEAT = 200000;
+constexpr float SENTINEL = 1234.5f;
+
+$::default_random_engine rand_;
+
+struct Genes {
+	$::vector<float> x_;
+
+	explicit Genes(const float lo = 0.f, const float hi = 1.f)
+	:	x_(MAX_N + 8) {
+		$::uniform_real_distribution<float> dist(lo, hi);
+		$::generate(x_.begin(), x_.end(), [&dist]() { return dist(rand_); });
+	}
+
+	float *operator*() noexcept {
+		return &x_[0];
+	}
+};
+
+bool compare(const char *name, const uns n, const $::vector<float> &expected, const $::vector<float> &real) {
+	bool $$ = true;
+	for (uns _ = 0; _ < expected.size(); ++_) {
+		const float tolerance = _ < n ? 1e-5f : 0.f;
+		if (::fabsf(expected[_] - real[_]) > tolerance) {
+			$::cerr << name << ": n=" << n << " [" << _ << "] " << expected[_] << " != " << real[_] << $::endl;
+			$$ = false;
+		}
+	}
+	return $$;
+}
+
+template<typename Fn>
+double measure(Fn &&fn) {
+	const double b = meave::getrealtime();
+	for (uns _ = 0; _ < REPEAT; ++_)
+		fn();
+	return meave::getrealtime() - b;
+}
+
+template<typename Scalar, typename Vector>
+bool test(const char *name, const meave::cpu::Level level, Scalar &&scalar, Vector &&vector) {
+	bool $$ = true;
+	for (uns n = 0; n <= MAX_N; ++n) {
+		$::vector<float> expected(MAX_N + 8, SENTINEL);
+		$::vector<float> real(MAX_N + 8, SENTINEL);
+		scalar(&expected[0], n);
+		vector(&real[0], n);
+		$$ = compare(name, n, expected, real) && $$;
+	}
+
+	const uns gsize = 15;
+	$::vector<float> d(gsize);
+	const double scalar_time = measure([&]() { scalar(&d[0], gsize); });
+	const double vector_time = measure([&]() { vector(&d[0], gsize); });
+	$::cerr << name << ": " << ($$ ? "OK" : "FAILED") << "; scalar: " << scalar_time << " seconds; " << meave::cpu::name(level) << ": " << vector_time << " seconds" << $::endl;
+	return $$;
+}
+
+} /* anonymous namespace */
+
+int
+main(void) {
+	bool ok = true;
+
+	Genes x, a, b, c, u, g(-3.f, +3.f);
+	Genes best, subswarm, global, rs, rg;
+	for (int l = meave::cpu::SCALAR; l <= meave::cpu::detected(); ++l) {
+		const meave::cpu::Level level = meave::cpu::Level(l);
+		ok = test("de_trial", level,
+			[&](float *t, const uns n) { v::de_trial<float>(t, *x, *a, *b, *c, *u, n, 1/8.f, 1/2.f); },
+			[&](float *t, const uns n) { v::de_trial(t, *x, *a, *b, *c, *u, n, 1/8.f, 1/2.f, level); }) && ok;
+		ok = test("gen_child_item_by_item", level,
+			[&](float *d, const uns n) { v::gen_child_item_by_item<float>(d, *a, *b, *u, *g, n, 1/2.f, 0.1f); },
+			[&](float *d, const uns n) { v::gen_child_item_by_item(d, *a, *b, *u, *g, n, 1/2.f, 0.1f, level); }) && ok;
+		ok = test("gen_child_linear", level,
+			[&](float *d, const uns n) { v::gen_child_linear<float>(d, *a, *b, 0.3f, *u, *g, n, 1/2.f, 0.1f); },
+			[&](float *d, const uns n) { v::gen_child_linear(d, *a, *b, 0.3f, *u, *g, n, 1/2.f, 0.1f, level); }) && ok;
+		ok = test("gen_child_normal", level,
+			[&](float *d, const uns n) { v::gen_child_normal<float>(d, *a, *b, 0.9f, *u, *g, n, 1/2.f, 0.1f); },
+			[&](float *d, const uns n) { v::gen_child_normal(d, *a, *b, 0.9f, *u, *g, n, 1/2.f, 0.1f, level); }) && ok;
+
+		Genes vel_scalar(-1.f, +1.f);
+		Genes vel_vector = vel_scalar;
+		ok = test("pso_move", level,
+			[&](float *x, const uns n) { $::copy(*a, *a + n, x); v::pso_move<float>(x, *vel_scalar, *best, *subswarm, *global, *u, *rs, *rg, n, 0.7f, 1.5f, 1.5f, 0.5f); },
+			[&](float *x, const uns n) { $::copy(*a, *a + n, x); v::pso_move(x, *vel_vector, *best, *subswarm, *global, *u, *rs, *rg, n, 0.7f, 1.5f, 1.5f, 0.5f, level); }) && ok;
+		ok = compare("pso_move velocities", MAX_N, vel_scalar.x_, vel_vector.x_) && ok;
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
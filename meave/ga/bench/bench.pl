@@ -0,0 +1,193 @@
+#!/usr/bin/env perl
+
+# Benchmark matrix of the multiswarm variants:
+#   ./bench.pl [options] [VARIANT...]
+#
+# Every variant (directory SimpleTrialParticleMultiswarmOptimization<VARIANT>,
+#   its simple-trial built) runs for every number of threads with the same
+#   seed (MEAVE_SEED) for --budget seconds of wall time in its own temporary
+#   directory. Serial is the plain SimpleTrialParticleMultiswarmOptimization,
+#   run on 1 thread only. Population statistics it logs
+#   (meave/ga/eval_counter.hpp) give evaluations/s and simulated steps/s of
+#   the optimizer (evaluations of the statistics themselves are not counted)
+#   and time to --target fitness; peak RSS is read from /proc. Parallel
+#   efficiency is relative to the run on 1 thread, speedup to Serial.
+#
+# Results are printed as a table and written as JSON to --out.
+
+use strict;
+use warnings;
+
+use File::Basename qw(dirname);
+use File::Spec;
+use File::Temp qw(tempdir);
+use Getopt::Long;
+use IO::Select;
+use JSON::PP;
+use POSIX qw(:sys_wait_h);
+use Time::HiRes qw(time sleep);
+
+my @ALL_VARIANTS = qw(Serial OpenMP OpenMPSaveMembers OpenMPSaveMembersAVX Workers TheWorkers WithHPX);
+
+sub nproc {
+	my $n = `nproc 2>/dev/null`;
+	return $n && $n =~ /^(\d+)/ ? $1 : 1;
+}
+
+sub default_threads {
+	my @threads = (1);
+	push @threads, 2 * $threads[-1] while 2 * $threads[-1] <= nproc();
+	push @threads, nproc() if $threads[-1] != nproc();
+	return join ',', @threads;
+}
+
+my %opts = (
+	budget  => 60,
+	target  => -3,
+	seed    => 1,
+	threads => default_threads(),
+	out     => 'bench.json',
+	root    => File::Spec->catdir(dirname(File::Spec->rel2abs($0)), '..'),
+);
+GetOptions(\%opts, 'budget=f', 'target=f', 'seed=i', 'threads=s', 'out=s', 'root=s', 'help')
+	or die "Bad options, see $0 --help\n";
+if ($opts{help}) {
+	print <<"EOF";
+Usage: $0 [options] [VARIANT...]
+  --budget SECONDS  wall time of one run ($opts{budget})
+  --target FITNESS  fitness of the best member to reach ($opts{target})
+  --seed SEED       MEAVE_SEED of every run ($opts{seed})
+  --threads LIST    numbers of threads ($opts{threads})
+  --out FILE        JSON results ($opts{out})
+  --root DIR        directory of the variants ($opts{root})
+Variants: @ALL_VARIANTS
+EOF
+	exit 0;
+}
+my @variants = @ARGV ? @ARGV : @ALL_VARIANTS;
+my @threads = split /,/, $opts{threads};
+
+sub peak_rss_kb {
+	my $pid = shift;
+	open my $status, '<', "/proc/$pid/status" or return undef;
+	while (<$status>) {
+		return $1 + 0 if /^VmHWM:\s+(\d+)\s+kB/;
+	}
+	return undef;
+}
+
+# Runs the binary, returns the measurements.
+sub run_one {
+	my ($binary, $variant, $threads) = @_;
+
+	my $dir = tempdir('meave-bench-XXXXXX', TMPDIR => 1, CLEANUP => 1);
+	my @args = $variant eq 'WithHPX' ? ("--hpx:threads=$threads") : ();
+
+	my $start = time;
+	my $pid = open(my $out, '-|') // die "Cannot fork: $!";
+	if (!$pid) {
+		chdir $dir or die "Cannot chdir to \`$dir': $!";
+		$ENV{MEAVE_SEED} = $opts{seed};
+		$ENV{OMP_NUM_THREADS} = $threads;
+		$ENV{MEAVE_THREADS} = $threads;
+		$ENV{GLOG_logtostderr} = 1;
+		open STDERR, '>&', \*STDOUT or die "Cannot redirect stderr: $!";
+		exec $binary, @args or die "Cannot exec \`$binary': $!";
+	}
+
+	my %r = (populations => 0, evaluations => 0, simulated_steps => 0, seconds => 0,
+		time_to_target => undef, best_fitness => undef, peak_rss_kb => undef);
+	my $select = IO::Select->new($out);
+	my $buf = '';
+	my $finished = 0;
+	while (!$finished && (my $left = $start + $opts{budget} - time) > 0) {
+		$r{peak_rss_kb} = peak_rss_kb($pid) // $r{peak_rss_kb};
+		next unless $select->can_read($left < 0.5 ? $left : 0.5);
+		my $n = sysread $out, $buf, 65536, length $buf;
+		if (!$n) {
+			$finished = 1;
+			last;
+		}
+		while ($buf =~ s/^(.*)\n//) {
+			# Strip the prefix of glog.
+			(my $line = $1) =~ s/^[IWEF]\d{4} [\d:.]+\s+\d+ \S+\] //;
+			if ($line =~ /^\tPopulation: (\d+)/) {
+				$r{populations} = $1 + 1;
+			} elsif ($line =~ /^\tmax-fitness \(best member\): (\S+)\[/) {
+				$r{best_fitness} = $1 + 0 if !defined $r{best_fitness} || $1 > $r{best_fitness};
+				$r{time_to_target} //= time - $start if $1 >= $opts{target};
+			} elsif ($line =~ /^\tevaluations: (\d+); simulations: (\d+); simulated steps: (\d+)/) {
+				@r{qw(evaluations simulated_steps seconds)} = ($1 + 0, $3 + 0, time - $start);
+			}
+		}
+	}
+
+	if (!$finished) {
+		kill 'TERM', $pid;
+		for (1 .. 20) {
+			last if waitpid($pid, WNOHANG) == $pid;
+			sleep 0.1;
+		}
+		kill 'KILL', $pid;
+	}
+	close $out;
+
+	$r{status} = $r{seconds} ? 'ok' : 'no-statistics';
+	$r{evaluations_per_s} = $r{seconds} ? $r{evaluations} / $r{seconds} : 0;
+	$r{simulated_steps_per_s} = $r{seconds} ? $r{simulated_steps} / $r{seconds} : 0;
+	return \%r;
+}
+
+my @results;
+my $serial;
+for my $variant (@variants) {
+	my $dir = 'SimpleTrialParticleMultiswarmOptimization' . ($variant eq 'Serial' ? '' : $variant);
+	my $binary = File::Spec->catfile($opts{root}, $dir, 'simple-trial');
+	my $base;
+	for my $threads ($variant eq 'Serial' ? (1) : @threads) {
+		my $r;
+		if (-x $binary) {
+			print STDERR "$variant on $threads threads...\n";
+			$r = run_one($binary, $variant, $threads);
+		} else {
+			$r = { status => 'unavailable' };
+		}
+		$r->{variant} = $variant;
+		$r->{threads} = $threads + 0;
+
+		$base = $r->{evaluations_per_s} if $threads == 1;
+		$serial = $r->{evaluations_per_s} if $variant eq 'Serial';
+		$r->{parallel_efficiency} = $base && $r->{evaluations_per_s}
+			? $r->{evaluations_per_s} / ($threads * $base)
+			: undef;
+		push @results, $r;
+	}
+}
+for my $r (@results) {
+	$r->{speedup} = $serial && $r->{evaluations_per_s} ? $r->{evaluations_per_s} / $serial : undef;
+}
+
+printf "%-22s %7s %-13s %12s %16s %10s %8s %10s %12s\n",
+	qw(Variant Threads Status Evals/s SimSteps/s Efficiency Speedup ToTarget PeakRSS[kB]);
+for my $r (@results) {
+	printf "%-22s %7d %-13s %12.2f %16.0f %10s %8s %10s %12s\n",
+		$r->{variant}, $r->{threads}, $r->{status},
+		$r->{evaluations_per_s} // 0, $r->{simulated_steps_per_s} // 0,
+		defined $r->{parallel_efficiency} ? sprintf('%.2f', $r->{parallel_efficiency}) : '-',
+		defined $r->{speedup} ? sprintf('%.2f', $r->{speedup}) : '-',
+		defined $r->{time_to_target} ? sprintf('%.1f', $r->{time_to_target}) : '-',
+		$r->{peak_rss_kb} // '-';
+}
+
+my $json = JSON::PP->new->canonical->pretty;
+open my $json_out, '>', $opts{out} or die "Cannot open \`$opts{out}' for writing: $!";
+print $json_out $json->encode({
+	host    => (POSIX::uname())[1],
+	cpus    => nproc() + 0,
+	time    => time() + 0,
+	budget  => $opts{budget} + 0,
+	target  => $opts{target} + 0,
+	seed    => $opts{seed} + 0,
+	results => \@results,
+});
+close $json_out or die "Cannot write \`$opts{out}': $!";
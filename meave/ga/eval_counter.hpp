@@ -0,0 +1,92 @@
+#ifndef MEAVE_GA_EVAL_COUNTER_HPP_INCLUDED
+#	define MEAVE_GA_EVAL_COUNTER_HPP_INCLUDED
+
+#	include <atomic>
+#	include <cstdint>
+
+#	include "meave/commons.hpp"
+
+namespace meave { namespace ga {
+
+/**
+ * Counts fitness evaluations and the simulations they consist of, from any
+ *   thread. Evaluations of population statistics are counted apart, they are
+ *   not work of the optimizer. Logged with population statistics, the line is
+ *   parsed by meave/ga/bench/bench.pl .
+ */
+class EvalCounter {
+private:
+	$::atomic< ::uint64_t> evals_;
+	$::atomic< ::uint64_t> sims_;
+	$::atomic< ::uint64_t> stats_evals_;
+	$::atomic< ::uint64_t> stats_sims_;
+
+public:
+	EvalCounter() noexcept
+	:	evals_(0)
+	,	sims_(0)
+	,	stats_evals_(0)
+	,	stats_sims_(0) {
+	}
+
+	/**
+	 * One fitness evaluation of sims simulations.
+	 */
+	void add(const uns sims) noexcept {
+		evals_.fetch_add(1, $::memory_order_relaxed);
+		sims_.fetch_add(sims, $::memory_order_relaxed);
+	}
+
+	/**
+	 * One evaluation of population statistics.
+	 */
+	void add_statistics(const uns sims) noexcept {
+		stats_evals_.fetch_add(1, $::memory_order_relaxed);
+		stats_sims_.fetch_add(sims, $::memory_order_relaxed);
+	}
+
+	::uint64_t evals() const noexcept {
+		return evals_.load($::memory_order_relaxed);
+	}
+
+	::uint64_t sims() const noexcept {
+		return sims_.load($::memory_order_relaxed);
+	}
+
+	::uint64_t stats_evals() const noexcept {
+		return stats_evals_.load($::memory_order_relaxed);
+	}
+
+	::uint64_t stats_sims() const noexcept {
+		return stats_sims_.load($::memory_order_relaxed);
+	}
+
+	/**
+	 * Continues from the totals of a checkpoint.
+	 */
+	void restore(const ::uint64_t evals, const ::uint64_t sims, const ::uint64_t stats_evals, const ::uint64_t stats_sims) noexcept {
+		evals_.store(evals, $::memory_order_relaxed);
+		sims_.store(sims, $::memory_order_relaxed);
+		stats_evals_.store(stats_evals, $::memory_order_relaxed);
+		stats_sims_.store(stats_sims, $::memory_order_relaxed);
+	}
+
+	/**
+	 * Logs the totals so far, steps_per_sim is trials_num() of the experiment.
+	 */
+	void log(const uns steps_per_sim) const {
+		log(evals(), sims(), stats_evals(), stats_sims(), steps_per_sim);
+	}
+
+	/**
+	 * The line of log() for experiments counting by themselves.
+	 */
+	static void log(const ::uint64_t evals, const ::uint64_t sims, const ::uint64_t stats_evals, const ::uint64_t stats_sims, const uns steps_per_sim) {
+		LOG(INFO) << "\tevaluations: " << evals << "; simulations: " << sims << "; simulated steps: " << sims * steps_per_sim;
+		LOG(INFO) << "\tstatistics evaluations: " << stats_evals << "; simulations: " << stats_sims;
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_EVAL_COUNTER_HPP_INCLUDED
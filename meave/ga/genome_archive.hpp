@@ -0,0 +1,340 @@
+#ifndef MEAVE_GA_GENOME_ARCHIVE_HPP_INCLUDED
+#	define MEAVE_GA_GENOME_ARCHIVE_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+#	include "meave/lib/raii/fd.hpp"
+#	include "meave/lib/trace.hpp"
+
+#	include <algorithm>
+#	include <cerrno>
+#	include <cstdint>
+#	include <cstring>
+#	include <utility>
+#	include <vector>
+
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <sys/types.h>
+#	include <unistd.h>
+
+namespace meave { namespace ga {
+
+/**
+ * Append-only archive of genomes of all members of all populations of a
+ *   run, replacing members.dat preallocated for a fixed number of
+ *   populations.
+ *
+ * File layout (native byte order):
+ *   Header, padded to DATA_OFF
+ *   Header::records_ records {uint32_t population, uint32_t member, Float genome[gsize]}
+ *   Header::index_len_ IndexEntry {population, first record} sorted by population
+ *     at Header::index_off_ , written when the archive is closed
+ *
+ * Populations are appended in nondecreasing order. The file grows by extents
+ *   (fallocate + mremap), Header::records_ is updated after every record, so
+ *   the archive of a crashed run is readable, its index is then rebuilt by
+ *   the reader.
+ */
+struct GenomeArchiveFormat {
+	struct Header {
+		char magic_[8];
+		::uint32_t version_;
+		::uint32_t float_size_;	///< sizeof(Float) of genomes, 4 or 8 .
+		::uint32_t gsize_;
+		::uint32_t nn_;
+		::uint64_t records_;
+		::uint64_t index_off_;	///< 0 -- no index, the run didn't finish.
+		::uint64_t index_len_;
+	};
+
+	struct RecordHeader {
+		::uint32_t population_;
+		::uint32_t member_;
+	};
+
+	struct IndexEntry {
+		::uint32_t population_;
+		::uint32_t reserved_;
+		::uint64_t first_record_;
+	};
+
+	enum {
+		  VERSION = 1
+		, DATA_OFF = 4096
+	};
+
+	/**
+	 * @return The first 8 bytes of the file.
+	 */
+	static const char *magic() noexcept {
+		return "MEAVEGEN";
+	}
+
+	template<typename Float>
+	static constexpr ::size_t record_size(const uns gsize) noexcept {
+		return sizeof(RecordHeader) + gsize * sizeof(Float);
+	}
+};
+
+template<typename Float>
+class GenomeArchive : public GenomeArchiveFormat {
+private:
+	raii::FD fd_;
+	char *mem_;
+	::size_t mapped_;
+	const ::size_t extent_;
+	const uns gsize_;
+	const ::size_t record_size_;
+	::uint64_t records_;
+	$::vector<IndexEntry> index_;
+
+	Header &header() noexcept {
+		return *reinterpret_cast<Header*>(mem_);
+	}
+
+	/**
+	 * Makes the file and its mapping at least len bytes long, by whole extents.
+	 */
+	void reserve(const ::size_t len) {
+		if (len <= mapped_)
+			return;
+		const ::size_t mapped = (len + extent_ - 1) / extent_ * extent_;
+		const int err = ::posix_fallocate(*fd_, ::off_t(mapped_), ::off_t(mapped - mapped_));
+		if (err == EOPNOTSUPP || err == EINVAL) {
+			if (-1 == ::ftruncate(*fd_, ::off_t(mapped)))
+				throw Error("Cannot resize genome archive: %m");
+		} else if (err) {
+			errno = err;
+			throw Error("Cannot allocate genome archive: %m");
+		}
+
+		void *mem = ::mremap(mem_, mapped_, mapped, MREMAP_MAYMOVE);
+		if (mem == MAP_FAILED)
+			throw Error("Cannot remap genome archive: %m");
+		mem_ = static_cast<char*>(mem);
+		mapped_ = mapped;
+	}
+
+	::size_t record_off(const ::uint64_t record) const noexcept {
+		return DATA_OFF + record * record_size_;
+	}
+
+public:
+	/**
+	 * @param extent The file grows by multiples of extent bytes.
+	 */
+	GenomeArchive(const char *file_name, const uns gsize, const uns nn, const ::size_t extent = 64 << 20)
+	:	fd_(::open(file_name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+	,	mem_(nullptr)
+	,	mapped_(0)
+	,	extent_($::max< ::size_t>(extent, DATA_OFF))
+	,	gsize_(gsize)
+	,	record_size_(record_size<Float>(gsize))
+	,	records_(0) {
+		if (!fd_)
+			throw Error("Cannot open: %s: %m", file_name);
+		if (-1 == ::ftruncate(*fd_, ::off_t(extent_)))
+			throw Error("Cannot resize file %s: %m", file_name);
+		void *mem = ::mmap(0, extent_, PROT_READ | PROT_WRITE, MAP_SHARED, *fd_, 0);
+		if (mem == MAP_FAILED)
+			throw Error("Cannot mmap: %s: %m", file_name);
+		mem_ = static_cast<char*>(mem);
+		mapped_ = extent_;
+
+		::memcpy(header().magic_, magic(), sizeof(header().magic_));
+		header().version_ = VERSION;
+		header().float_size_ = sizeof(Float);
+		header().gsize_ = gsize;
+		header().nn_ = nn;
+		header().records_ = 0;
+		header().index_off_ = 0;
+		header().index_len_ = 0;
+	}
+	GenomeArchive(const GenomeArchive&) = delete;
+	GenomeArchive &operator=(const GenomeArchive&) = delete;
+
+	::uint64_t size() const noexcept {
+		return records_;
+	}
+
+	/**
+	 * Appends genome of member of population, populations must not decrease.
+	 *   Not thread-safe.
+	 */
+	void append(const uns population, const uns member, const Float *genome) {
+		const trace::Scope scope("genome archive", "io");
+		if (index_.empty() || index_.back().population_ < population)
+			index_.push_back(IndexEntry{population, 0, records_});
+		else if (index_.back().population_ > population)
+			throw Error("Population %u appended after population %u", population, unsigned(index_.back().population_));
+
+		reserve(record_off(records_ + 1));
+		char *p = mem_ + record_off(records_);
+		const RecordHeader record{population, member};
+		::memcpy(p, &record, sizeof record);
+		::memcpy(p + sizeof record, genome, gsize_ * sizeof(Float));
+		header().records_ = ++records_;
+	}
+
+	/**
+	 * Writes the index after the records and cuts the file to its used size.
+	 */
+	~GenomeArchive() noexcept {
+		try {
+			const ::size_t index_off = record_off(records_);
+			const ::size_t index_size = index_.size() * sizeof(IndexEntry);
+			reserve(index_off + index_size);
+			if (index_size)
+				::memcpy(mem_ + index_off, &index_[0], index_size);
+			header().index_len_ = index_.size();
+			header().index_off_ = index_off;
+
+			::munmap(mem_, mapped_);
+			if (-1 == ::ftruncate(*fd_, ::off_t(index_off + index_size)))
+				LOG(ERROR) << "Cannot truncate genome archive: " << ::strerror(errno);
+		} catch (const Error &e) {
+			LOG(ERROR) << "Index of genome archive is lost: " << e.what();
+			::munmap(mem_, mapped_);
+		}
+	}
+};
+
+/**
+ * Read-only view of a genome archive. Records are accessed in O(1), the
+ *   index gives the records of a population.
+ */
+template<typename Float>
+class GenomeArchiveReader : public GenomeArchiveFormat {
+private:
+	raii::FD fd_;
+	const char *mem_;
+	::size_t size_;
+	::size_t record_size_;
+	$::vector<IndexEntry> index_;
+
+	const Header &header() const noexcept {
+		return *reinterpret_cast<const Header*>(mem_);
+	}
+
+public:
+	explicit GenomeArchiveReader(const char *file_name)
+	:	fd_(::open(file_name, O_RDONLY | O_CLOEXEC))
+	,	mem_(nullptr)
+	,	size_(0)
+	,	record_size_(0) {
+		if (!fd_)
+			throw Error("Cannot open: %s: %m", file_name);
+		struct ::stat st;
+		if (-1 == ::fstat(*fd_, &st))
+			throw Error("Cannot stat: %s: %m", file_name);
+		size_ = st.st_size;
+		if (size_ < DATA_OFF)
+			throw Error("Not a genome archive: %s", file_name);
+
+		void *mem = ::mmap(0, size_, PROT_READ, MAP_SHARED, *fd_, 0);
+		if (mem == MAP_FAILED)
+			throw Error("Cannot mmap: %s: %m", file_name);
+		mem_ = static_cast<const char*>(mem);
+
+		if (::memcmp(header().magic_, magic(), sizeof(header().magic_))) {
+			::munmap(const_cast<char*>(mem_), size_);
+			throw Error("Not a genome archive: %s", file_name);
+		}
+		if (header().version_ != VERSION || header().float_size_ != sizeof(Float)) {
+			::munmap(const_cast<char*>(mem_), size_);
+			throw Error("Unsupported version %u or float size %u of genome archive: %s", unsigned(header().version_), unsigned(header().float_size_), file_name);
+		}
+		record_size_ = record_size<Float>(header().gsize_);
+		if (DATA_OFF + header().records_ * record_size_ > size_) {
+			::munmap(const_cast<char*>(mem_), size_);
+			throw Error("Genome archive is truncated: %s", file_name);
+		}
+
+		if (header().index_off_ && header().index_off_ + header().index_len_ * sizeof(IndexEntry) > size_) {
+			::munmap(const_cast<char*>(mem_), size_);
+			throw Error("Index of genome archive is truncated: %s", file_name);
+		}
+
+		if (header().index_off_) {
+			const IndexEntry *index = reinterpret_cast<const IndexEntry*>(mem_ + header().index_off_);
+			index_.assign(index, index + header().index_len_);
+		} else {
+			for (::uint64_t _ = 0; _ < size(); ++_) {
+				if (index_.empty() || index_.back().population_ != population(_))
+					index_.push_back(IndexEntry{population(_), 0, _});
+			}
+		}
+	}
+	GenomeArchiveReader(const GenomeArchiveReader&) = delete;
+	GenomeArchiveReader &operator=(const GenomeArchiveReader&) = delete;
+
+	~GenomeArchiveReader() noexcept {
+		::munmap(const_cast<char*>(mem_), size_);
+	}
+
+	uns gsize() const noexcept {
+		return header().gsize_;
+	}
+
+	uns nn() const noexcept {
+		return header().nn_;
+	}
+
+	/**
+	 * @return Whether the run finished and wrote the index.
+	 */
+	bool complete() const noexcept {
+		return header().index_off_;
+	}
+
+	::uint64_t size() const noexcept {
+		return header().records_;
+	}
+
+	uns population(const ::uint64_t record) const noexcept {
+		return reinterpret_cast<const RecordHeader*>(mem_ + DATA_OFF + record * record_size_)->population_;
+	}
+
+	uns member(const ::uint64_t record) const noexcept {
+		return reinterpret_cast<const RecordHeader*>(mem_ + DATA_OFF + record * record_size_)->member_;
+	}
+
+	const Float *genome(const ::uint64_t record) const noexcept {
+		return reinterpret_cast<const Float*>(mem_ + DATA_OFF + record * record_size_ + sizeof(RecordHeader));
+	}
+
+	/**
+	 * @return Populations present in the archive, ascending.
+	 */
+	$::vector<uns> populations() const {
+		$::vector<uns> $$;
+		for (const auto &$: index_)
+			$$.push_back($.population_);
+		return $$;
+	}
+
+	/**
+	 * @return [first, last) records of population, empty if there is no such population.
+	 *   O(1) when populations are numbered from 0 without gaps, O(log n) otherwise.
+	 */
+	$::pair< ::uint64_t, ::uint64_t> records(const uns population) const noexcept {
+		auto it = index_.begin();
+		if (population < index_.size() && index_[population].population_ == population) {
+			it += population;
+		} else {
+			it = $::lower_bound(index_.begin(), index_.end(), population, [](const IndexEntry &$, const uns p) {
+				return $.population_ < p;
+			});
+			if (it == index_.end() || it->population_ != population)
+				return $::make_pair(0, 0);
+		}
+		const ::uint64_t last = it + 1 == index_.end() ? size() : (it + 1)->first_record_;
+		return $::make_pair(it->first_record_, last);
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_GENOME_ARCHIVE_HPP_INCLUDED
@@ -0,0 +1,197 @@
+#ifndef MEAVE_GA_ISLANDS_HPP_INCLUDED
+#	define MEAVE_GA_ISLANDS_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+#	include "meave/lib/gettime.hpp"
+#	include "meave/lib/par/migration.hpp"
+#	include "meave/lib/raii/fork.hpp"
+#	include "meave/lib/raii/mmap_create.hpp"
+#	include "meave/lib/seed.hpp"
+#	include "meave/lib/str_printf.hpp"
+
+#	include <cstdint>
+#	include <random>
+#	include <vector>
+#	include <sys/stat.h>
+#	include <sys/types.h>
+#	include <sys/wait.h>
+#	include <unistd.h>
+
+namespace meave { namespace ga {
+
+enum class Topology {
+	  RING		///< Island i receives migrants from island i - 1 .
+	, FULL		///< Island receives migrants from all other islands.
+	, RANDOM	///< Island receives migrants from one randomly chosen island.
+};
+
+enum class MigrantSelection {
+	  BEST		///< Best members emigrate.
+	, RANDOM	///< Randomly chosen members emigrate.
+};
+
+/**
+ * Island model: every island is a separate process (raii::Fork), islands
+ *   exchange migrants through par::MigrationRing in a shared mapping of
+ *   ./migration.dat .
+ *
+ * @tparam Island
+ *           Island::Float -- type of genes and fitness
+ *           Island::Island() -- island is constructed in its own process
+ *           Island::emigrants(selection, n, out) -- writes n migrant records
+ *           Island::immigrants(n, in) -- takes n migrant records
+ *           Island::operator()(after_generation) -- runs the evolution and
+ *               calls after_generation(evaluations) after every generation
+ *
+ * Every island runs in its own directory ./island_NNN, so that results
+ *   of different islands don't overwrite each other.
+ */
+template<typename Island>
+class Islands {
+public:
+	typedef typename Island::Float Float;
+
+private:
+	typedef meave::par::MigrationRing<Float> Ring;
+
+	const uns islands_num_;
+	const uns interval_;
+	const uns migrants_;
+	const Topology topology_;
+	const MigrantSelection selection_;
+
+	/**
+	 * Sends migrants of the island and receives migrants of its neighbours.
+	 *   Nothing here waits for other islands.
+	 */
+	void migrate(Ring &ring, const uns island, Island &the_island, $::vector< ::uint64_t> &seen, $::default_random_engine &rand) const {
+		$::vector<Float> recs(migrants_ * ring.record_len());
+		the_island.emigrants(selection_, migrants_, &recs[0]);
+		for (uns _ = 0; _ < migrants_; ++_)
+			ring.publish(island, &recs[_ * ring.record_len()]);
+
+		recs.clear();
+		const auto receive = [&ring, &recs](const Float *rec) {
+			recs.insert(recs.end(), rec, rec + ring.record_len());
+		};
+		switch (topology_) {
+		case Topology::RING:
+			ring.collect((island + islands_num_ - 1) % islands_num_, &seen[(island + islands_num_ - 1) % islands_num_], receive);
+			break;
+
+		case Topology::FULL:
+			for (uns _ = 0; _ < islands_num_; ++_) {
+				if (_ != island)
+					ring.collect(_, &seen[_], receive);
+			}
+			break;
+
+		case Topology::RANDOM: {
+			const uns from = (island + $::uniform_int_distribution<uns>{1, islands_num_ - 1}(rand)) % islands_num_;
+			ring.collect(from, &seen[from], receive);
+			break;
+		}
+		}
+
+		if (!recs.empty())
+			the_island.immigrants(recs.size() / ring.record_len(), &recs[0]);
+		DLOG(INFO) << "Island " << island << " received " << recs.size() / ring.record_len() << " migrants";
+	}
+
+	int run_island(Ring &ring, const uns island) const noexcept {
+		try {
+			return run_island_or_throw(ring, island);
+		} catch (const $::exception &e) {
+			LOG(ERROR) << "Island " << island << " failed: " << e.what();
+			return 1;
+		}
+	}
+
+	int run_island_or_throw(Ring &ring, const uns island) const {
+		const $::string dir = str_printf("./island_%.3u", island);
+		if (-1 == ::mkdir(dir.c_str(), 0755) && errno != EEXIST)
+			throw Error("Cannot create directory: %s: %m", dir.c_str());
+		if (-1 == ::chdir(dir.c_str()))
+			throw Error("Cannot change directory: %s: %m", dir.c_str());
+
+		meave::seed_fork(island);
+		$::default_random_engine rand(meave::seed());
+		$::vector< ::uint64_t> seen(islands_num_, 0);
+		::uint64_t last_evaluations = 0;
+		uns generation = 0;
+
+		Island the_island;
+		the_island([&](const ::uint64_t evaluations) {
+			ring.add_evaluations(island, evaluations - last_evaluations);
+			last_evaluations = evaluations;
+			if (0 == ++generation % interval_ && islands_num_ > 1)
+				migrate(ring, island, the_island, seen, rand);
+		});
+
+		return 0;
+	}
+
+public:
+	Islands(const uns islands_num, const uns interval, const uns migrants, const Topology topology, const MigrantSelection selection)
+	:	islands_num_(islands_num)
+	,	interval_(interval)
+	,	migrants_(migrants)
+	,	topology_(topology)
+	,	selection_(selection) {
+	}
+
+	/**
+	 * Forks islands_num islands, every island is constructed in its own
+	 *   process. Reports throughput of islands every report_interval seconds
+	 *   and waits until all of them finish.
+	 * @param record_len Length of migrant record (fitness and genes).
+	 */
+	void operator()(const uns record_len, const double report_interval = 10.) {
+		const ::size_t size = Ring::size(islands_num_, islands_num_ * migrants_, record_len);
+		raii::MMapCreate mem("./migration.dat", size);
+		Ring ring(*mem, islands_num_, islands_num_ * migrants_, record_len);
+		ring.init();
+
+		const double begin = meave::getrealtime();
+		$::vector<raii::Fork> islands;
+		islands.reserve(islands_num_);
+		for (uns island = 0; island < islands_num_; ++island) {
+			islands.emplace_back([this, &ring](const uns island) {
+				return run_island(ring, island);
+			}, island);
+		}
+
+		$::vector< ::uint64_t> evaluations(islands_num_, 0);
+		for (uns running = islands_num_; running; ) {
+			const double before = meave::getrealtime();
+			::usleep(report_interval * 1000000);
+			const double dt = meave::getrealtime() - before;
+
+			LOG(INFO) << "Islands Statistics";
+			for (uns island = 0; island < islands_num_; ++island) {
+				int status;
+				if (islands[island].pid() != -1 && islands[island].try_wait(status)) {
+					--running;
+					if (!WIFEXITED(status) || WEXITSTATUS(status))
+						LOG(ERROR) << "Island " << island << " failed, status: " << status;
+				}
+
+				const ::uint64_t e = ring.evaluations(island);
+				LOG(INFO) << "\tIsland " << island << ": " << (e - evaluations[island]) / dt << " evaluations/s"
+					  << (islands[island].pid() == -1 ? " (done)" : "");
+				evaluations[island] = e;
+			}
+		}
+
+		const double elapsed = meave::getrealtime() - begin;
+		for (uns island = 0; island < islands_num_; ++island) {
+			LOG(INFO) << "Island " << island << ": " << ring.evaluations(island) << " evaluations, "
+				  << ring.evaluations(island) / elapsed << " evaluations/s";
+		}
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_ISLANDS_HPP_INCLUDED
@@ -0,0 +1,340 @@
+#ifndef MEAVE_GA_METRICS_HPP_INCLUDED
+#	define MEAVE_GA_METRICS_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+#	include "meave/lib/gettime.hpp"
+#	include "meave/lib/raii/fd.hpp"
+#	include "meave/lib/raii/mmap_create.hpp"
+#	include "meave/lib/str_printf.hpp"
+
+#	include <atomic>
+#	include <cstdint>
+#	include <cstdlib>
+#	include <cstring>
+#	include <memory>
+#	include <new>
+#	include <string>
+
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <sys/types.h>
+#	include <unistd.h>
+
+namespace meave { namespace ga {
+
+/**
+ * Live metrics of a run in a shared memory segment (a file in /dev/shm),
+ *   read by meave-top (meave/ga/simple-trial-analyse/meave-top.cpp) while
+ *   the run goes on.
+ *
+ * File layout (native byte order):
+ *   Header, padded to SLOTS_OFF
+ *   Header::slots_ Slot, one per thread, each on its own cache lines
+ *
+ * Every slot has one writer, its thread. It publishes its values by plain
+ *   relaxed stores guarded by a sequence lock: the sequence is odd while
+ *   the values change, a reader retries until it reads the same even
+ *   sequence before and after copying them. The writer never waits for
+ *   readers and shares no cache line with other writers, so watching the
+ *   run doesn't slow it down.
+ */
+struct MetricsFormat {
+	struct Header {
+		char magic_[8];		///< Written last, a reader ignores the segment until then.
+		::uint32_t version_;
+		::uint32_t slots_;
+		::uint32_t slot_size_;
+		::int32_t pid_;
+		double started_;	///< getrealtime() of creation.
+		char name_[64];		///< Name of the run, zero-terminated.
+	};
+
+	/**
+	 * Values of one thread, copied out of a slot.
+	 */
+	struct Values {
+		::uint64_t evaluations_;
+		::uint64_t simulations_;
+		::uint64_t cache_hits_;	///< Simulations avoided, e.g. cut by racing.
+		::uint64_t queue_depth_;	///< Tasks waiting for the thread (or its pool).
+		::uint64_t generation_;
+		::uint64_t task_;	///< Current task, e.g. index of a run of a sweep.
+		double best_fitness_;
+		double updated_;	///< getrealtime() of the last update, 0 -- never updated.
+	};
+
+	struct alignas(64) Slot {
+		$::atomic< ::uint32_t> seq_;
+		$::atomic< ::uint64_t> evaluations_;
+		$::atomic< ::uint64_t> simulations_;
+		$::atomic< ::uint64_t> cache_hits_;
+		$::atomic< ::uint64_t> queue_depth_;
+		$::atomic< ::uint64_t> generation_;
+		$::atomic< ::uint64_t> task_;
+		$::atomic<double> best_fitness_;
+		$::atomic<double> updated_;
+
+		/**
+		 * Called only by the writer of the slot, which needs no lock to
+		 *   read its own values.
+		 */
+		Values load_own() const noexcept {
+			return load_relaxed();
+		}
+
+		void store(const Values &v) noexcept {
+			const ::uint32_t seq = seq_.load($::memory_order_relaxed);
+			seq_.store(seq + 1, $::memory_order_relaxed);
+			$::atomic_thread_fence($::memory_order_release);
+			evaluations_.store(v.evaluations_, $::memory_order_relaxed);
+			simulations_.store(v.simulations_, $::memory_order_relaxed);
+			cache_hits_.store(v.cache_hits_, $::memory_order_relaxed);
+			queue_depth_.store(v.queue_depth_, $::memory_order_relaxed);
+			generation_.store(v.generation_, $::memory_order_relaxed);
+			task_.store(v.task_, $::memory_order_relaxed);
+			best_fitness_.store(v.best_fitness_, $::memory_order_relaxed);
+			updated_.store(v.updated_, $::memory_order_relaxed);
+			seq_.store(seq + 2, $::memory_order_release);
+		}
+
+		/**
+		 * Consistent copy of the values, for readers.
+		 * @return false When the writer kept changing them for all of
+		 *   attempts tries (e.g. it died in the middle of an update).
+		 */
+		bool load(Values &v, const uns attempts = 1000) const noexcept {
+			for (uns _ = 0; _ < attempts; ++_) {
+				const ::uint32_t seq = seq_.load($::memory_order_acquire);
+				if (seq & 1)
+					continue;
+				v = load_relaxed();
+				$::atomic_thread_fence($::memory_order_acquire);
+				if (seq == seq_.load($::memory_order_relaxed))
+					return true;
+			}
+			return false;
+		}
+
+	private:
+		Values load_relaxed() const noexcept {
+			Values $$;
+			$$.evaluations_ = evaluations_.load($::memory_order_relaxed);
+			$$.simulations_ = simulations_.load($::memory_order_relaxed);
+			$$.cache_hits_ = cache_hits_.load($::memory_order_relaxed);
+			$$.queue_depth_ = queue_depth_.load($::memory_order_relaxed);
+			$$.generation_ = generation_.load($::memory_order_relaxed);
+			$$.task_ = task_.load($::memory_order_relaxed);
+			$$.best_fitness_ = best_fitness_.load($::memory_order_relaxed);
+			$$.updated_ = updated_.load($::memory_order_relaxed);
+			return $$;
+		}
+	};
+
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && sizeof($::atomic<double>) == sizeof(double), "Slots are shared by processes, their atomics must be lock-free");
+
+	enum {
+		  VERSION = 1
+		, SLOTS_OFF = 4096
+	};
+
+	/**
+	 * @return The first 8 bytes of the file.
+	 */
+	static const char *magic() noexcept {
+		return "MEAVEMET";
+	}
+
+	/**
+	 * @return File name of the segment of process pid in dir.
+	 */
+	static $::string file_name(const char *dir, const ::pid_t pid) {
+		return str_printf("%s/meave-metrics.%d", dir, int(pid));
+	}
+
+	/**
+	 * @return glob(3) pattern of segments of all processes in dir.
+	 */
+	static $::string file_pattern(const char *dir) {
+		return str_printf("%s/meave-metrics.*", dir);
+	}
+
+	static constexpr ::size_t file_size(const uns slots) noexcept {
+		return SLOTS_OFF + slots * sizeof(Slot);
+	}
+};
+
+/**
+ * Metrics segment of this process, removed when the run ends.
+ */
+class Metrics : public MetricsFormat {
+private:
+	$::string file_name_;
+	raii::MMapCreate mem_;
+	uns slots_;
+
+	Header &header() noexcept {
+		return *static_cast<Header*>(*mem_);
+	}
+
+	Slot *slots() noexcept {
+		return reinterpret_cast<Slot*>(static_cast<char*>(*mem_) + SLOTS_OFF);
+	}
+
+public:
+	/**
+	 * @param threads Number of threads updating the metrics, a slot each.
+	 * @param name Name of the run shown by meave-top.
+	 */
+	Metrics(const uns threads, const char *name, const char *dir = "/dev/shm")
+	:	file_name_(MetricsFormat::file_name(dir, ::getpid()))
+	,	mem_(file_name_.c_str(), file_size(threads))
+	,	slots_(threads) {
+		// ftruncate() zeroed the file, slots start at sequence 0 with zero values.
+		for (uns _ = 0; _ < threads; ++_)
+			new (&slots()[_]) Slot();
+		header().version_ = VERSION;
+		header().slots_ = threads;
+		header().slot_size_ = sizeof(Slot);
+		header().pid_ = ::getpid();
+		header().started_ = getrealtime();
+		::strncpy(header().name_, name, sizeof(header().name_) - 1);
+		$::atomic_thread_fence($::memory_order_release);
+		::memcpy(header().magic_, magic(), sizeof(header().magic_));
+	}
+	Metrics(const Metrics&) = delete;
+	Metrics &operator=(const Metrics&) = delete;
+
+	~Metrics() noexcept {
+		::unlink(file_name_.c_str());
+	}
+
+	const $::string &file_name() const noexcept {
+		return file_name_;
+	}
+
+	uns slots_num() const noexcept {
+		return slots_;
+	}
+
+	/**
+	 * Updates slot th by fn(Values&), called with its current values; only
+	 *   the thread owning the slot may call it.
+	 */
+	template<typename Fn>
+	void update(const uns th, Fn &&fn) noexcept {
+		Slot &slot = slots()[th];
+		Values v = slot.load_own();
+		fn(v);
+		v.updated_ = getrealtime();
+		slot.store(v);
+	}
+};
+
+/**
+ * @return Directory of metrics segments of experiments, environment
+ *   variable MEAVE_METRICS, /dev/shm without it; empty -- no metrics.
+ */
+inline const char *metrics_dir() noexcept {
+	const char *$$ = ::getenv("MEAVE_METRICS");
+	return $$ ? $$ : "/dev/shm";
+}
+
+/**
+ * @return Metrics segment with a slot per thread, null when dir is empty or
+ *   when it cannot be created -- a run doesn't need it.
+ */
+inline $::unique_ptr<Metrics> make_metrics(const uns threads, const char *name, const char *dir = metrics_dir()) {
+	if (!*dir)
+		return nullptr;
+	try {
+		$::unique_ptr<Metrics> $$(new Metrics(threads, name, dir));
+		LOG(INFO) << "Metrics in " << $$->file_name();
+		return $$;
+	} catch (const Error &e) {
+		LOG(WARNING) << "No metrics: " << e.what();
+		return nullptr;
+	}
+}
+
+/**
+ * Read-only view of a metrics segment, possibly of another process.
+ */
+class MetricsReader : public MetricsFormat {
+private:
+	raii::FD fd_;
+	const char *mem_;
+	::size_t size_;
+
+	const Header &header() const noexcept {
+		return *reinterpret_cast<const Header*>(mem_);
+	}
+
+	const Slot *slots() const noexcept {
+		return reinterpret_cast<const Slot*>(mem_ + SLOTS_OFF);
+	}
+
+public:
+	explicit MetricsReader(const char *file_name)
+	:	fd_(::open(file_name, O_RDONLY | O_CLOEXEC))
+	,	mem_(nullptr)
+	,	size_(0) {
+		if (!fd_)
+			throw Error("Cannot open: %s: %m", file_name);
+		struct ::stat st;
+		if (-1 == ::fstat(*fd_, &st))
+			throw Error("Cannot stat: %s: %m", file_name);
+		size_ = st.st_size;
+		if (size_ < SLOTS_OFF)
+			throw Error("Not a metrics segment: %s", file_name);
+
+		void *mem = ::mmap(0, size_, PROT_READ, MAP_SHARED, *fd_, 0);
+		if (mem == MAP_FAILED)
+			throw Error("Cannot mmap: %s: %m", file_name);
+		mem_ = static_cast<const char*>(mem);
+
+		if (::memcmp(header().magic_, magic(), sizeof(header().magic_))) {
+			::munmap(const_cast<char*>(mem_), size_);
+			throw Error("Not a metrics segment (or not ready yet): %s", file_name);
+		}
+		$::atomic_thread_fence($::memory_order_acquire);
+		if (header().version_ != VERSION || header().slot_size_ != sizeof(Slot) || file_size(header().slots_) > size_) {
+			::munmap(const_cast<char*>(mem_), size_);
+			throw Error("Unsupported version %u or layout of metrics segment: %s", unsigned(header().version_), file_name);
+		}
+	}
+	MetricsReader(const MetricsReader&) = delete;
+	MetricsReader &operator=(const MetricsReader&) = delete;
+
+	~MetricsReader() noexcept {
+		::munmap(const_cast<char*>(mem_), size_);
+	}
+
+	uns slots_num() const noexcept {
+		return header().slots_;
+	}
+
+	::pid_t pid() const noexcept {
+		return header().pid_;
+	}
+
+	double started() const noexcept {
+		return header().started_;
+	}
+
+	$::string name() const {
+		return $::string(header().name_, ::strnlen(header().name_, sizeof(header().name_)));
+	}
+
+	/**
+	 * @return Whether v is a consistent copy of slot th.
+	 */
+	bool read(const uns th, Values &v) const noexcept {
+		return slots()[th].load(v);
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_METRICS_HPP_INCLUDED
@@ -0,0 +1,167 @@
+#ifndef MEAVE_GA_MULTI_FIDELITY_HPP_INCLUDED
+#	define MEAVE_GA_MULTI_FIDELITY_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+
+#	include <algorithm>
+#	include <cstdint>
+#	include <numeric>
+#	include <vector>
+
+namespace meave { namespace ga {
+
+/**
+ * @return Order of scenarios 0 .. n - 1 whose every prefix is spread over
+ *   the whole scenario grid: scenario k*s mod n for a stride s close to
+ *   n / golden ratio and coprime to n. For the 200x11 grid of FITNESS_FULL
+ *   (scenario = velocity*11 + start) every 11 consecutive scenarios cover
+ *   all start positions and velocities are spread evenly.
+ */
+inline $::vector<uns> mixed_scenario_order(const uns n) {
+	const auto coprime = [n](uns a) noexcept {
+		for (uns b = n; b; ) {
+			const uns r = a % b;
+			a = b;
+			b = r;
+		}
+		return a == 1;
+	};
+	uns stride = uns(n * 0.6180339887);
+	while (n > 1 && !coprime(stride))
+		++stride;
+
+	$::vector<uns> $$(n);
+	for (uns k = 0; k < n; ++k)
+		$$[k] = ::uint64_t(k) * stride % n;
+	return $$;
+}
+
+/**
+ * Multi-fidelity evaluation of a batch of candidates by successive halving.
+ *
+ * Fitness of a candidate is the mean score over n scenarios. All candidates
+ *   are scored on a coarse prefix of mixed_scenario_order(), the better
+ *   1/eta of them is promoted to an eta-times denser prefix and so on. Only
+ *   promoted candidates that are contenders (their estimate could change
+ *   something for the caller) are evaluated on all n scenarios. A denser
+ *   prefix extends the coarser one, so no scenario is scored twice.
+ */
+class SuccessiveHalving {
+public:
+	/**
+	 * Outcome for one candidate.
+	 */
+	struct Result {
+		float fitness_;		///< Mean score over scenarios_ first scenarios.
+		uns scenarios_;
+
+		bool full(const uns n) const noexcept {
+			return scenarios_ == n;
+		}
+	};
+
+private:
+	const uns n_;
+	const uns eta_;
+	$::vector<uns> order_;
+	$::vector<uns> rungs_;		///< Prefix lengths, the last one is n_.
+
+	::uint64_t scored_;		///< Scenarios scored so far.
+	::uint64_t full_cost_;		///< Scenarios that full evaluation of the same candidates would score.
+
+public:
+	/**
+	 * @param n Number of scenarios.
+	 * @param min_scenarios Size of the coarsest prefix, roughly.
+	 * @param eta Promotion ratio and growth of prefixes, at least 2.
+	 */
+	SuccessiveHalving(const uns n, const uns min_scenarios, const uns eta)
+	:	n_(n)
+	,	eta_($::max(2U, eta))
+	,	order_(mixed_scenario_order(n))
+	,	scored_(0)
+	,	full_cost_(0) {
+		for (uns m = n; m >= $::max(1U, min_scenarios); m /= eta_)
+			rungs_.push_back(m);
+		if (rungs_.empty())
+			rungs_.push_back(n);
+		$::reverse(rungs_.begin(), rungs_.end());
+	}
+
+	uns n() const noexcept {
+		return n_;
+	}
+
+	/**
+	 * @return Scenario number k of the mixed order.
+	 */
+	uns scenario(const uns k) const noexcept {
+		return order_[k];
+	}
+
+	const $::vector<uns> &rungs() const noexcept {
+		return rungs_;
+	}
+
+	/**
+	 * Evaluates candidates 0 .. m - 1 .
+	 * @param score score(candidate, scenario) -> float, may be called concurrently for different candidates.
+	 * @param contender contender(candidate, estimate) -> bool, whether a candidate is worth full evaluation.
+	 * @param for_each for_each(b, e, fn) calls fn(i) for i from [b, e), e.g. par::Workers::for_each .
+	 * @param results Array of m results.
+	 */
+	template<typename Score, typename Contender, typename ForEach>
+	void operator()(const uns m, Score &&score, Contender &&contender, ForEach &&for_each, Result results[]) {
+		$::vector<double> sums(m, 0.);
+		for (uns c = 0; c < m; ++c)
+			results[c] = Result{0.f, 0};
+
+		$::vector<uns> alive(m);
+		$::iota(alive.begin(), alive.end(), 0U);
+
+		for (uns rung = 0; rung < rungs_.size() && !alive.empty(); ++rung) {
+			const uns prefix = rungs_[rung];
+			const bool last = rung + 1 == rungs_.size();
+			if (last) {
+				alive.erase($::remove_if(alive.begin(), alive.end(), [&contender, results](const uns c) {
+					return results[c].scenarios_ && !contender(c, results[c].fitness_);
+				}), alive.end());
+			}
+
+			for_each(0U, uns(alive.size()), [this, &alive, &sums, &score, results, prefix](const uns _) {
+				const uns c = alive[_];
+				for (uns k = results[c].scenarios_; k < prefix; ++k)
+					sums[c] += score(c, order_[k]);
+				results[c] = Result{float(sums[c] / prefix), prefix};
+			});
+
+			if (!last) {
+				const uns keep = (alive.size() + eta_ - 1) / eta_;
+				$::stable_sort(alive.begin(), alive.end(), [results](const uns a, const uns b) {
+					return results[a].fitness_ > results[b].fitness_;
+				});
+				alive.resize(keep);
+			}
+		}
+
+		full_cost_ += ::uint64_t(m) * n_;
+		for (uns c = 0; c < m; ++c)
+			scored_ += results[c].scenarios_;
+	}
+
+	/**
+	 * @return Fraction of scenarios that evaluation of all candidates on
+	 *   all scenarios would score, but successive halving did not.
+	 */
+	double saved() const noexcept {
+		return full_cost_ ? 1. - double(scored_) / full_cost_ : 0.;
+	}
+
+	void reset_stats() noexcept {
+		scored_ = full_cost_ = 0;
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_MULTI_FIDELITY_HPP_INCLUDED
@@ -0,0 +1,334 @@
+#ifndef MEAVE_GA_NOVELTY_HPP_INCLUDED
+#	define MEAVE_GA_NOVELTY_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/ga/variation.hpp"
+#	include "meave/lib/cpu.hpp"
+#	include "meave/lib/simd/vec.hpp"
+
+#	include <algorithm>
+#	include <cmath>
+#	include <limits>
+#	include <utility>
+#	include <vector>
+
+namespace meave { namespace ga {
+
+namespace novelty {
+
+/**
+ * @return Squared Euclidean distance of behaviour descriptors a and b.
+ */
+template<typename Float>
+Float dist2(const Float a[], const Float b[], const uns dim) noexcept {
+	Float $$ = 0;
+	for (uns _ = 0; _ < dim; ++_)
+		$$ += (a[_] - b[_]) * (a[_] - b[_]);
+	return $$;
+}
+
+namespace aux {
+
+/**
+ * The vector variant for float, V a simd::Native<float, level>; masked
+ *   coordinates of the tail are loaded as zeros in both descriptors, so they
+ *   add nothing.
+ */
+template<typename V>
+MEAVE_SIMD_INLINE float dist2_vec(const float a[], const float b[], const uns dim) noexcept {
+	V sum = V::zero();
+	variation::aux::for_blocks<V>(dim, [&sum, a, b](const uns i, const auto &io) {
+		const V d = io.load(&a[i]) - io.load(&b[i]);
+		sum = fma(d, d, sum);
+	});
+	return reduce_add(sum);
+}
+
+typedef float (*Dist2)(const float[], const float[], uns);
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline float dist2_sse42(const float a[], const float b[], const uns dim) noexcept {
+	return dist2_vec<simd::Native<float, cpu::SSE42>>(a, b, dim);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline float dist2_avx2(const float a[], const float b[], const uns dim) noexcept {
+	return dist2_vec<simd::Native<float, cpu::AVX2>>(a, b, dim);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline float dist2_avx512(const float a[], const float b[], const uns dim) noexcept {
+	return dist2_vec<simd::Native<float, cpu::AVX512>>(a, b, dim);
+}
+
+inline const cpu::Kernels<Dist2> &dist2_kernels() noexcept {
+	static const cpu::Kernels<Dist2> $${{ &dist2<float>, &dist2_sse42, &dist2_avx2, &dist2_avx512 }};
+	return $$;
+}
+
+} /* namespace aux */
+
+/**
+ * By the widest variant the CPU has (meave/lib/cpu.hpp).
+ */
+inline float dist2(const float a[], const float b[], const uns dim) noexcept {
+	static const aux::Dist2 kernel = aux::dist2_kernels().impl();
+	return kernel(a, b, dim);
+}
+
+inline float dist2(const float a[], const float b[], const uns dim, const cpu::Level level) noexcept {
+	return aux::dist2_kernels().impl(level)(a, b, dim);
+}
+
+/**
+ * The k nearest descriptors found so far: a max-heap of (squared distance, index).
+ */
+template<typename Float>
+class Nearest {
+private:
+	const uns k_;
+	$::vector<$::pair<Float, uns>> heap_;
+
+public:
+	explicit Nearest(const uns k)
+	:	k_(k) {
+		heap_.reserve(k);
+	}
+
+	/**
+	 * @return Squared distance a descriptor must beat to be among the nearest,
+	 *   max until k are found and for k == 0 (nothing is kept then).
+	 */
+	Float bound() const noexcept {
+		return heap_.size() < k_ || heap_.empty() ? $::numeric_limits<Float>::max() : heap_.front().first;
+	}
+
+	void add(const Float d2, const uns idx) {
+		if (!k_)
+			return;
+		if (heap_.size() < k_) {
+			heap_.emplace_back(d2, idx);
+			$::push_heap(heap_.begin(), heap_.end());
+		} else if (d2 < heap_.front().first) {
+			$::pop_heap(heap_.begin(), heap_.end());
+			heap_.back() = $::make_pair(d2, idx);
+			$::push_heap(heap_.begin(), heap_.end());
+		}
+	}
+
+	/**
+	 * @return (squared distance, index) pairs, the nearest first.
+	 */
+	$::vector<$::pair<Float, uns>> &sorted() {
+		$::sort_heap(heap_.begin(), heap_.end());
+		return heap_;
+	}
+};
+
+} /* namespace novelty */
+
+/**
+ * Archive of behaviour descriptors (e.g. sampled outputs of run_sim) for
+ *   novelty search: novelty of a descriptor is its mean distance to the k
+ *   nearest descriptors of the archive.
+ *
+ * Descriptors are stored one after another. Small archives are searched by
+ *   brute force (novelty::dist2, vectorized for float). When the archive grows over
+ *   brute_max descriptors, a vantage-point tree is built over them and
+ *   rebuilt whenever descriptors appended after the last build (searched by
+ *   brute force) exceed a quarter of the indexed ones, so inserts stay
+ *   amortized O(log n).
+ *
+ * Queries are const and may run in parallel, inserts must not run
+ *   concurrently with anything else.
+ */
+template<typename Float = float>
+class NoveltyArchive {
+private:
+	/**
+	 * Inner node, or leaf (point_ == NONE) of points_[inside_, outside_) .
+	 */
+	struct Node {
+		uns point_;	///< Vantage point.
+		Float radius_;	///< Points of inside_ are closer than radius_ to point_, points of outside_ not.
+		uns inside_;	///< Index of node, NONE -- empty.
+		uns outside_;
+	};
+
+	enum : uns {
+		  NONE = ~0U
+		, LEAF = 16	///< Leaves of up to LEAF points are searched by brute force.
+	};
+
+	const uns dim_;
+	const uns brute_max_;
+	$::vector<Float> data_;
+	uns size_;
+
+	$::vector<Node> nodes_;
+	$::vector<uns> points_;	///< Points of the tree, ranges of leaves.
+	uns root_;
+	uns indexed_;		///< Descriptors [0, indexed_) are in the tree.
+
+	Float dist(const uns a, const uns b) const noexcept {
+		return ::sqrt(novelty::dist2(&data_[a * dim_], &data_[b * dim_], dim_));
+	}
+
+	/**
+	 * Builds subtree of points[b, e) .
+	 * @return Index of its root node.
+	 */
+	uns build(uns *points, const uns b, const uns e, $::vector<Float> &dists) {
+		if (b == e)
+			return NONE;
+		const uns node = nodes_.size();
+		if (e - b <= LEAF) {
+			nodes_.push_back(Node{NONE, 0, b, e});
+			return node;
+		}
+
+		// The vantage point is the middle one, the order of inserts is arbitrary enough.
+		$::swap(points[b], points[b + (e - b) / 2]);
+		nodes_.push_back(Node{points[b], 0, NONE, NONE});
+
+		for (uns _ = b + 1; _ < e; ++_)
+			dists[points[_]] = dist(points[b], points[_]);
+		const uns mid = b + 1 + (e - b - 1) / 2;
+		$::nth_element(points + b + 1, points + mid, points + e, [&dists](const uns x, const uns y) {
+			return dists[x] < dists[y];
+		});
+		nodes_[node].radius_ = dists[points[mid]];
+
+		const uns inside = build(points, b + 1, mid, dists);
+		const uns outside = build(points, mid, e, dists);
+		nodes_[node].inside_ = inside;
+		nodes_[node].outside_ = outside;
+		return node;
+	}
+
+	void rebuild() {
+		points_.resize(size_);
+		for (uns _ = 0; _ < size_; ++_)
+			points_[_] = _;
+		$::vector<Float> dists(size_);
+		nodes_.clear();
+		root_ = build(&points_[0], 0, size_, dists);
+		indexed_ = size_;
+	}
+
+	void search(const uns node, const Float *q, novelty::Nearest<Float> &nearest) const {
+		if (node == NONE)
+			return;
+		const Node &n = nodes_[node];
+		if (n.point_ == NONE) {
+			for (uns _ = n.inside_; _ < n.outside_; ++_)
+				nearest.add(novelty::dist2(q, &data_[points_[_] * dim_], dim_), points_[_]);
+			return;
+		}
+
+		const Float d2 = novelty::dist2(q, &data_[n.point_ * dim_], dim_);
+		nearest.add(d2, n.point_);
+
+		const Float d = ::sqrt(d2);
+		// The nearer side first, the other only if the ball of the k-th nearest reaches over radius_.
+		if (d < n.radius_) {
+			search(n.inside_, q, nearest);
+			if (d + ::sqrt(nearest.bound()) >= n.radius_)
+				search(n.outside_, q, nearest);
+		} else {
+			search(n.outside_, q, nearest);
+			if (d - ::sqrt(nearest.bound()) < n.radius_)
+				search(n.inside_, q, nearest);
+		}
+	}
+
+public:
+	/**
+	 * @param dim Length of a descriptor.
+	 * @param brute_max Archives up to this size are searched by brute force only.
+	 */
+	explicit NoveltyArchive(const uns dim, const uns brute_max = 2048)
+	:	dim_(dim)
+	,	brute_max_(brute_max)
+	,	size_(0)
+	,	root_(NONE)
+	,	indexed_(0) {
+	}
+
+	uns dim() const noexcept {
+		return dim_;
+	}
+
+	uns size() const noexcept {
+		return size_;
+	}
+
+	/**
+	 * @return Descriptor i in the order of inserts.
+	 */
+	const Float *operator[](const uns i) const noexcept {
+		return &data_[i * dim_];
+	}
+
+	/**
+	 * Appends n descriptors stored one after another.
+	 */
+	void insert(const uns n, const Float *descs) {
+		data_.insert(data_.end(), descs, descs + n * dim_);
+		size_ += n;
+		if (size_ > brute_max_ && size_ - indexed_ > indexed_ / 4)
+			rebuild();
+	}
+
+	void insert(const Float *desc) {
+		insert(1, desc);
+	}
+
+	/**
+	 * Finds the k nearest descriptors of q, the nearest first.
+	 * @param dists Distances, k or size() of them, whichever is less.
+	 * @param idxs Their indexes, may be null.
+	 * @return Number of descriptors found, min(k, size()).
+	 */
+	uns knn(const Float *q, const uns k, Float *dists, uns *idxs = nullptr) const {
+		novelty::Nearest<Float> nearest(k);
+		search(root_, q, nearest);
+		for (uns _ = indexed_; _ < size_; ++_)
+			nearest.add(novelty::dist2(q, &data_[_ * dim_], dim_), _);
+
+		const auto &sorted = nearest.sorted();
+		for (uns _ = 0; _ < sorted.size(); ++_) {
+			dists[_] = ::sqrt(sorted[_].first);
+			if (idxs)
+				idxs[_] = sorted[_].second;
+		}
+		return sorted.size();
+	}
+
+	/**
+	 * @return Mean distance of q to its k nearest descriptors, 0 for an empty archive.
+	 */
+	Float novelty(const Float *q, const uns k) const {
+		$::vector<Float> dists(k);
+		const uns found = knn(q, k, dists.data());
+		Float $$ = 0;
+		for (uns _ = 0; _ < found; ++_)
+			$$ += dists[_];
+		return found ? $$ / found : 0;
+	}
+
+	/**
+	 * Novelty of n descriptors stored one after another, computed in parallel
+	 *   by par_for(b, e, fn) calling fn(i) for i in [b, e) .
+	 */
+	template<typename ParFor>
+	void novelty(const uns n, const Float *queries, const uns k, Float *out, ParFor &&par_for) const {
+		par_for(0, n, [this, queries, k, out](const uns i) {
+			out[i] = novelty(&queries[i * dim_], k);
+		});
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_NOVELTY_HPP_INCLUDED
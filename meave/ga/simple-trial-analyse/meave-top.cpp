@@ -0,0 +1,239 @@
+/*
+ * Shows live metrics of running experiments (metrics segments,
+ *   meave/ga/metrics.hpp), refreshed like top.
+ *
+ * usage: meave-top [options] [segment ...]
+ *          -- without segments shows all of --dir, see meave-top --help
+ *
+ * Segments are only mapped for reading and slots are read without locks,
+ *   so the watched run is not slowed down. Rates are computed from the
+ *   previous refresh. A slot whose writer was in the middle of an update
+ *   for all attempts to read it shows its previous values, marked by *.
+ */
+
+#include <boost/program_options.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glob.h>
+#include <signal.h>
+
+#include <glog/logging.h>
+
+#include "meave/commons.hpp"
+#include "meave/lib/error.hpp"
+#include "meave/lib/gettime.hpp"
+#include "meave/ga/metrics.hpp"
+
+namespace {
+
+typedef meave::ga::MetricsReader MetricsReader;
+typedef MetricsReader::Values Values;
+
+struct Options {
+	double interval_;
+	bool once_;
+	$::string dir_;
+	$::vector<$::string> files_;
+
+	Options() noexcept
+	:	interval_(1.)
+	,	once_(false)
+	,	dir_("/dev/shm") {
+	}
+
+	bool parse(const int argc, const char * const argv[]) {
+		namespace po = boost::program_options;
+		using po::value;
+		using po::bool_switch;
+
+		const $::string S_USAGE = $::string("Usage: ") + argv[0] + " [options] [segment ...]";
+
+		po::options_description options("Options");
+		options.add_options()
+		("help"    , "display the help message and exit")
+		("interval", value(&interval_)->default_value(interval_), "seconds between refreshes")
+		("once"    , bool_switch(&once_)->default_value(once_), "print the metrics once, without clearing the screen")
+		("dir"     , value(&dir_)->default_value(dir_), "directory of metrics segments")
+		;
+
+		po::options_description hidden;
+		hidden.add_options()
+		("files", value(&files_), "metrics segments");
+
+		po::options_description all;
+		all.add(options).add(hidden);
+
+		po::positional_options_description positional;
+		positional.add("files", -1);
+
+		try {
+			po::variables_map option_map;
+			po::store(po::command_line_parser(argc, argv).options(all).positional(positional).run(), option_map);
+			if (option_map.count("help")) {
+				$::cerr << S_USAGE << "\n" << options << $::endl;
+				return false;
+			}
+			po::notify(option_map);
+		} catch (const po::error &error) {
+			$::cerr << "Error: " << error.what() << "\n\n" << S_USAGE << "\n" << options << $::endl;
+			return false;
+		}
+
+		if (!(interval_ > 0)) {
+			$::cerr << "Error: interval must be positive" << $::endl;
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @return Segments given on the command line, or all of dir_ .
+	 */
+	$::vector<$::string> segments() const {
+		if (!files_.empty())
+			return files_;
+
+		$::vector<$::string> $$;
+		::glob_t g;
+		if (!::glob(MetricsReader::file_pattern(dir_.c_str()).c_str(), 0, nullptr, &g)) {
+			for (::size_t _ = 0; _ < g.gl_pathc; ++_)
+				$$.push_back(g.gl_pathv[_]);
+		}
+		::globfree(&g);
+		return $$;
+	}
+};
+
+$::string hms(const double seconds) {
+	const unsigned s = seconds > 0 ? unsigned(seconds) : 0;
+	char $$[32];
+	::snprintf($$, sizeof $$, "%02u:%02u:%02u", s / 3600, s / 60 % 60, s % 60);
+	return $$;
+}
+
+/**
+ * Values of the previous refresh, for rates.
+ */
+struct Seen {
+	Values values_;
+	double at_;
+};
+
+class Top {
+private:
+	const Options &opts_;
+	$::map<$::pair<$::string, uns>, Seen> seen_;
+
+	static double rate(const ::uint64_t now, const ::uint64_t before, const double seconds) noexcept {
+		return now >= before && seconds > 0 ? (now - before) / seconds : 0;
+	}
+
+	void show(const $::string &file, $::ostream &out) {
+		const MetricsReader reader(file.c_str());
+		const double now = meave::getrealtime();
+		const bool alive = !::kill(reader.pid(), 0) || errno == EPERM;
+
+		out << reader.name() << "  pid " << reader.pid() << "  up " << hms(now - reader.started()) << (alive ? "" : "  (exited)") << "  " << file << "\n";
+		out << $::setw(4) << "th" << $::setw(6) << "task" << $::setw(7) << "gen"
+		    << $::setw(12) << "evals" << $::setw(10) << "evals/s"
+		    << $::setw(14) << "sims" << $::setw(11) << "sims/s"
+		    << $::setw(7) << "cut%" << $::setw(7) << "queue" << $::setw(12) << "best" << $::setw(8) << "age" << "\n";
+
+		Values total{};
+		double evals_rate = 0, sims_rate = 0;
+		for (uns th = 0; th < reader.slots_num(); ++th) {
+			Seen &seen = seen_[$::make_pair(file, th)];
+			Values v;
+			const bool consistent = reader.read(th, v);
+			if (!consistent)
+				v = seen.values_;
+
+			const double seconds = seen.at_ ? now - seen.at_ : 0;
+			const double er = rate(v.evaluations_, seen.values_.evaluations_, seconds);
+			const double sr = rate(v.simulations_, seen.values_.simulations_, seconds);
+			evals_rate += er;
+			sims_rate += sr;
+			total.evaluations_ += v.evaluations_;
+			total.simulations_ += v.simulations_;
+			total.cache_hits_ += v.cache_hits_;
+			if (v.updated_ && (!total.updated_ || v.best_fitness_ > total.best_fitness_))
+				total.best_fitness_ = v.best_fitness_;
+			total.updated_ = $::max(total.updated_, v.updated_);
+			if (consistent)
+				seen = Seen{v, now};
+
+			const double cut = v.simulations_ + v.cache_hits_ ? 100. * v.cache_hits_ / (v.simulations_ + v.cache_hits_) : 0;
+			out << $::setw(3) << th << (consistent ? ' ' : '*');
+			if (!v.updated_) {
+				out << "  idle\n";
+				continue;
+			}
+			out << $::setw(6) << v.task_ << $::setw(7) << v.generation_
+			    << $::setw(12) << v.evaluations_ << $::setw(10) << $::fixed << $::setprecision(1) << er
+			    << $::setw(14) << v.simulations_ << $::setw(11) << sr
+			    << $::setw(7) << cut << $::setw(7) << v.queue_depth_
+			    << $::setw(12) << $::setprecision(6) << v.best_fitness_
+			    << $::setw(8) << hms(now - v.updated_).substr(3) << "\n";
+		}
+
+		const double cut = total.simulations_ + total.cache_hits_ ? 100. * total.cache_hits_ / (total.simulations_ + total.cache_hits_) : 0;
+		out << $::setw(4) << "all" << $::setw(6) << "" << $::setw(7) << ""
+		    << $::setw(12) << total.evaluations_ << $::setw(10) << $::setprecision(1) << evals_rate
+		    << $::setw(14) << total.simulations_ << $::setw(11) << sims_rate
+		    << $::setw(7) << cut << $::setw(7) << ""
+		    << $::setw(12) << $::setprecision(6) << total.best_fitness_ << "\n\n";
+	}
+
+public:
+	explicit Top(const Options &opts) noexcept
+	:	opts_(opts) {
+	}
+
+	void refresh() {
+		// Written at once, so the screen doesn't flicker.
+		$::ostringstream out;
+		if (!opts_.once_)
+			out << "\033[H\033[2J";
+		const $::vector<$::string> files = opts_.segments();
+		if (files.empty())
+			out << "No metrics segments in " << opts_.dir_ << "\n";
+		for (const auto &$: files) {
+			try {
+				show($, out);
+			} catch (const meave::Error &e) {
+				// E.g. the run ended and removed its segment in the meantime.
+				out << $ << ": " << e.what() << "\n\n";
+			}
+		}
+		$::cout << out.str() << $::flush;
+	}
+};
+
+} /* Anonymouse Namespace */
+
+int
+main(int argc, char *argv[]) {
+	google::InitGoogleLogging(argv[0]);
+
+	Options opts;
+	if (!opts.parse(argc, argv))
+		return 1;
+
+	Top top(opts);
+	for (;;) {
+		top.refresh();
+		if (opts.once_)
+			return 0;
+		$::this_thread::sleep_for($::chrono::duration<double>(opts.interval_));
+	}
+}
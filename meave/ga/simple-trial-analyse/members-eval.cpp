@@ -0,0 +1,382 @@
+/*
+ * Re-evaluates genomes saved by SimpleTrialParticleMultiswarmOptimizationOpenMPSaveMembers
+ *   in members.dat (genome archive, meave/ga/genome_archive.hpp) on the full
+ *   grid of scenarios of FITNESS_FULL.
+ *
+ * usage: members-eval [options] <members.dat>
+ *          -- see members-eval --help
+ *
+ * The archive is mapped, selected members are evaluated in parallel by chunks
+ *   and results of a chunk are written before the next one starts, so the
+ *   output is streamed. Scenarios of one genome are simulated 8 at once by
+ *   ctrnn::NNLanes . Initial noise of a member is drawn from a generator
+ *   seeded by --seed and the record index, results therefore don't depend
+ *   on the number of threads.
+ *
+ * Output is TSV (Population, Member, Fitness), or with --binary records
+ *   {uint32_t population, uint32_t member, float fitness} in native byte
+ *   order. --trajectory writes trajectories of output members to the
+ *   trajectory log (meave/ga/trajectory.hpp).
+ */
+
+#include <boost/program_options.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "meave/commons.hpp"
+#include "meave/ctrnn/lanes.hpp"
+#include "meave/lib/error.hpp"
+#include "meave/lib/par/workers.hpp"
+#include "meave/ga/genome_archive.hpp"
+#include "meave/ga/trajectory.hpp"
+
+namespace {
+
+typedef float Float;
+typedef meave::ga::GenomeArchiveReader<Float> Members;
+typedef meave::ga::TrajectoryLog TrajectoryLog;
+typedef meave::ctrnn::NNLanes<Float> NNLanes;
+
+struct Options {
+	$::string members_file_;
+	$::string out_file_;
+	$::string trajectory_file_;
+	bool binary_;
+	bool best_;
+	int population_;
+	int member_;
+	uns threads_;
+	uns seed_;
+
+	uns nn_;	///< From the archive.
+	float range_;
+	float randinit_;
+	uns trial_;
+	uns eval_;
+	float ts_;
+
+	Options() noexcept
+	:	out_file_("-")
+	,	binary_(false)
+	,	best_(false)
+	,	population_(-1)
+	,	member_(-1)
+	,	threads_($::max(1U, $::thread::hardware_concurrency()))
+	,	seed_(0)
+	,	nn_(0)
+	,	range_(5.f)
+	,	randinit_(1.f)
+	,	trial_(50)
+	,	eval_(30)
+	,	ts_(0.1) {
+	}
+
+	uns gsize() const noexcept {
+		return nn_*nn_ + 2*nn_;
+	}
+
+	/**
+	 * @todo int/float (0.1) has big rounding error, the same as in the experiment.
+	 */
+	uns trials_num() const noexcept {
+		return static_cast<uns>( static_cast<Float>(trial_)/ts_ );
+	}
+
+	uns evals_num() const noexcept {
+		return static_cast<uns>( static_cast<Float>(eval_/ts_) );
+	}
+
+	bool parse(const int argc, const char * const argv[]) {
+		namespace po = boost::program_options;
+		using po::value;
+		using po::bool_switch;
+
+		const $::string S_USAGE = $::string("Usage: ") + argv[0] + " [options] <members.dat>";
+
+		po::options_description options("Options");
+		options.add_options()
+		("help"      , "display the help message and exit")
+		("out"       , value(&out_file_)->default_value(out_file_), "output file, - for stdout")
+		("binary"    , bool_switch(&binary_)->default_value(binary_), "binary output instead of TSV")
+		("trajectory", value(&trajectory_file_)->default_value(trajectory_file_), "trajectory log of output members")
+		("best"      , bool_switch(&best_)->default_value(best_), "output only the best member of every population")
+		("population", value(&population_)->default_value(population_), "evaluate only this population (-1 -- all)")
+		("member"    , value(&member_)->default_value(member_), "evaluate only this member of populations (-1 -- all)")
+		("threads"   , value(&threads_)->default_value(threads_), "number of threads")
+		("seed"      , value(&seed_)->default_value(seed_), "seed of initial noise of neurons")
+		("range"     , value(&range_)->default_value(range_), "range of weights [-range, +range]")
+		("randinit"  , value(&randinit_)->default_value(randinit_), "range of initial noise of neurons")
+		("trial"     , value(&trial_)->default_value(trial_), "units of time for each trial")
+		("eval"      , value(&eval_)->default_value(eval_), "time at which the agent starts being evaluated")
+		("ts"        , value(&ts_)->default_value(ts_, "0.1"), "time step of Euler integration")
+		;
+
+		po::options_description hidden;
+		hidden.add_options()
+		("members-file", value(&members_file_), "members.dat");
+
+		po::options_description all;
+		all.add(options).add(hidden);
+
+		po::positional_options_description positional;
+		positional.add("members-file", 1);
+
+		try {
+			po::variables_map option_map;
+			po::store(po::command_line_parser(argc, argv).options(all).positional(positional).run(), option_map);
+			if (option_map.count("help")) {
+				$::cerr << S_USAGE << "\n" << options << $::endl;
+				return false;
+			}
+			po::notify(option_map);
+		} catch (const po::error &error) {
+			$::cerr << "Error: " << error.what() << "\n\n" << S_USAGE << "\n" << options << $::endl;
+			return false;
+		}
+
+		if (members_file_.empty()) {
+			$::cerr << S_USAGE << "\n" << options << $::endl;
+			return false;
+		}
+		if (!threads_ || eval_ >= trial_ || !(ts_ > 0)) {
+			$::cerr << "Error: threads must be positive, eval less than trial and ts positive" << $::endl;
+			return false;
+		}
+		return true;
+	}
+};
+
+class Evaluator {
+private:
+	const Options &opts_;
+	const NNLanes nn_lanes_;
+
+	enum {
+		  VELOCITIES_NUM = 200
+		, STARTS_NUM = 11
+		, SCENARIOS_NUM = VELOCITIES_NUM * STARTS_NUM
+		, LANES = NNLanes::LANES_NUM
+	};
+	static_assert(SCENARIOS_NUM % LANES == 0, "Scenarios are simulated by whole batches of lanes.");
+
+public:
+	explicit Evaluator(const Options &opts)
+	:	opts_(opts)
+	,	nn_lanes_(opts.nn_, opts.ts_) {
+	}
+
+	/**
+	 * FITNESS_FULL of the genome, the same computation as run_sim() of the
+	 *   experiment, wr gets rows of trajectories as its writer does.
+	 */
+	template<typename Wr>
+	Float operator()(const Float *genome, const ::uint64_t seed, Wr &&wr) const {
+		const uns nn = opts_.nn_;
+		const Float range = opts_.range_;
+		$::vector<Float> w(nn * nn), b(nn), tc(nn);
+		for (uns _ = 0; _ < nn * nn; ++_)
+			w[_] = genome[_] * 2 * range - range;
+		for (uns _ = 0; _ < nn; ++_) {
+			b[_] = genome[nn * nn + _] * 2 * range - range;
+			tc[_] = ::exp(4 * genome[nn * nn + nn + _]);
+		}
+
+		$::default_random_engine rand(seed);
+		$::uniform_real_distribution<Float> dist;
+
+		$::unique_ptr<NNLanes::Lanes[]> y(new NNLanes::Lanes[nn]);
+		$::unique_ptr<NNLanes::Lanes[]> ei(new NNLanes::Lanes[nn]);
+		$::unique_ptr<NNLanes::Lanes[]> v(new NNLanes::Lanes[nn]);
+
+		double sum = 0;
+		for (uns scenario = 0; scenario < SCENARIOS_NUM; scenario += LANES) {
+			Float start[LANES], vel[LANES], distance[LANES], f[LANES];
+			for (uns l = 0; l < LANES; ++l) {
+				start[l] = distance[l] = Float((scenario + l) % STARTS_NUM * 10);
+				vel[l] = Float((scenario + l) / STARTS_NUM) / 100;
+				f[l] = 0;
+			}
+			for (uns i = 0; i < nn; ++i) {
+				for (uns l = 0; l < LANES; ++l) {
+					v[i][l] = -b[i] + dist(rand) * 2 * opts_.randinit_ - opts_.randinit_;
+					ei[i][l] = 0;
+				}
+			}
+
+			for (uns trial_idx = 0; trial_idx < opts_.trials_num(); ++trial_idx) {
+				nn_lanes_.sigm(&v[0], &b[0], &y[0]);
+				for (uns l = 0; l < LANES; ++l) {
+					distance[l] += opts_.ts_ * vel[l];
+					ei[0][l] = distance[l] / 20;
+				}
+				nn_lanes_.val(&y[0], &tc[0], &ei[0], &w[0], &v[0]);
+
+				const NNLanes::Lanes &out = v[nn - 1];
+				for (uns l = 0; l < LANES; ++l) {
+					wr(start[l], ei[0][l], trial_idx, out[l], vel[l], f[l]);
+					if (trial_idx > opts_.evals_num())
+						f[l] += ::meave::math::abs(out[l] - vel[l]);
+				}
+			}
+
+			for (uns l = 0; l < LANES; ++l)
+				sum += 1 - f[l] / (opts_.trial_ - opts_.eval_);
+		}
+		return Float(sum / SCENARIOS_NUM);
+	}
+};
+
+struct Nothing {
+	void operator()(...) const noexcept { }
+};
+
+struct Result {
+	::uint32_t population_;
+	::uint32_t member_;
+	float fitness_;
+};
+
+class Sink {
+private:
+	$::ofstream file_;
+	const bool binary_;
+
+	$::ostream &out() noexcept {
+		return file_.is_open() ? file_ : $::cout;
+	}
+
+public:
+	Sink(const $::string &file_name, const bool binary)
+	:	binary_(binary) {
+		if (file_name != "-") {
+			file_.open(file_name, $::ofstream::binary | $::ofstream::trunc);
+			if (!file_)
+				throw meave::Error("Cannot open: %s: %m", file_name.c_str());
+		}
+		if (!binary_)
+			out() << "Population" << "\t" << "Member" << "\t" << "Fitness" << "\n";
+	}
+
+	void operator()(const Result &$) {
+		if (binary_)
+			out().write(reinterpret_cast<const char*>(&$), sizeof $);
+		else
+			out() << $.population_ << "\t" << $.member_ << "\t" << $.fitness_ << "\n";
+	}
+
+	void flush() {
+		if (!out().flush())
+			throw meave::Error("Cannot write results");
+	}
+};
+
+void run(Options &opts) {
+	const Members members(opts.members_file_.c_str());
+	opts.nn_ = members.nn();
+	if (members.gsize() != opts.gsize())
+		throw meave::Error("Genome size %u doesn't match %u neurons", members.gsize(), opts.nn_);
+	if (!members.complete())
+		LOG(WARNING) << "The run didn't finish, its archive has no index.";
+	const Evaluator evaluator(opts);
+	meave::par::Workers workers(opts.threads_);
+	$::unique_ptr<TrajectoryLog> trajectory_log;
+	if (!opts.trajectory_file_.empty())
+		trajectory_log.reset(new TrajectoryLog(opts.trajectory_file_.c_str()));
+	Sink sink(opts.out_file_, opts.binary_);
+
+	/*
+	 * Evaluates records idxs in parallel, with trajectories if asked.
+	 */
+	const auto evaluate = [&](const $::vector< ::size_t> &idxs, $::vector<Float> &fits, const bool trajectories) {
+		fits.resize(idxs.size());
+		workers.for_each(0, uns(idxs.size()), [&](const uns _) {
+			const ::size_t idx = idxs[_];
+			const ::uint64_t seed = (::uint64_t(opts.seed_) << 32) ^ idx;
+			if (trajectories) {
+				TrajectoryLog::Appender trajectory(*trajectory_log, members.population(idx), members.member(idx));
+				fits[_] = evaluator(members.genome(idx), seed, trajectory);
+			} else {
+				fits[_] = evaluator(members.genome(idx), seed, Nothing());
+			}
+		});
+	};
+
+	// A single population is found by the index.
+	$::pair< ::size_t, ::size_t> range(0, members.size());
+	if (opts.population_ >= 0)
+		range = members.records(opts.population_);
+
+	enum { CHUNK = 1024 };
+	$::map< ::uint32_t, $::pair< ::size_t, Float>> bests;	///< population -> (record, fitness)
+	$::vector< ::size_t> idxs;
+	$::vector<Float> fits;
+	::size_t evaluated = 0;
+	for (::size_t b = range.first; b < range.second; b += CHUNK) {
+		idxs.clear();
+		for (::size_t idx = b; idx < $::min(range.second, b + CHUNK); ++idx) {
+			if (opts.member_ >= 0 && members.member(idx) != uns(opts.member_))
+				continue;
+			idxs.push_back(idx);
+		}
+
+		evaluate(idxs, fits, trajectory_log && !opts.best_);
+		evaluated += idxs.size();
+
+		for (uns _ = 0; _ < idxs.size(); ++_) {
+			const uns population = members.population(idxs[_]);
+			if (!opts.best_) {
+				sink(Result{population, members.member(idxs[_]), fits[_]});
+				continue;
+			}
+			const auto it = bests.emplace(population, $::make_pair(idxs[_], fits[_])).first;
+			if (it->second.second < fits[_])
+				it->second = $::make_pair(idxs[_], fits[_]);
+		}
+		sink.flush();
+		LOG(INFO) << "Evaluated " << evaluated << " members";
+	}
+
+	if (opts.best_) {
+		for (const auto &$: bests)
+			sink(Result{$.first, members.member($.second.first), $.second.second});
+		sink.flush();
+
+		// Trajectories are written by a second pass over the bests only, with the same seeds.
+		if (trajectory_log) {
+			idxs.clear();
+			for (const auto &$: bests)
+				idxs.push_back($.second.first);
+			evaluate(idxs, fits, true);
+		}
+	}
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(int argc, char *argv[]) {
+	google::InitGoogleLogging(argv[0]);
+
+	Options opts;
+	if (!opts.parse(argc, argv))
+		return 1;
+
+	try {
+		run(opts);
+	} catch (const meave::Error &e) {
+		$::cerr << argv[0] << ": " << e.what() << $::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Converts trajectory log (meave/ga/trajectory.hpp) to TSV files in the
+ *   layout of results_PPP_MMM.csv, that analyze.R reads.
+ *
+ * usage: trajectory-tsv <trajectory.dat>
+ *          -- writes results_PPP_MMM.csv of every member into the current directory
+ *        trajectory-tsv <trajectory.dat> <population> <member>
+ *          -- writes TSV of one member to stdout
+ *
+ * The log is read block by block, so it may be bigger than memory.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "meave/commons.hpp"
+#include "meave/lib/error.hpp"
+#include "meave/lib/str_printf.hpp"
+#include "meave/ga/trajectory.hpp"
+
+namespace {
+
+typedef meave::ga::TrajectoryLog TrajectoryLog;
+
+void write_header($::ostream &o) {
+	o << "Population" << "\t"
+	  << "Member" << "\t"
+	  << "Experiment" << "\t"
+	  << "Start" << "\t"
+	  << "Input" << "\t"
+	  << "RealOutput" << "\t"
+	  << "ExpectedOutput" << "\t"
+	  << "f" << "\n";
+}
+
+void write_rows($::ostream &o, const TrajectoryLog::BlockHeader &header, const char *columns) {
+	const uns n = header.rows_;
+	const ::uint32_t *experiment = reinterpret_cast<const ::uint32_t*>(columns);
+	const float *start = reinterpret_cast<const float*>(experiment + n);
+	const float *input = start + n;
+	const float *real = input + n;
+	const float *expected = real + n;
+	const float *f = expected + n;
+
+	for (uns _ = 0; _ < n; ++_) {
+		o << header.population_ << "\t"
+		  << header.member_ << "\t"
+		  << experiment[_] << "\t"
+		  << start[_] << "\t"
+		  << input[_] << "\t"
+		  << real[_] << "\t"
+		  << expected[_] << "\t"
+		  << f[_] << "\n";
+	}
+}
+
+/**
+ * Calls fn(header, columns) for every block of the log.
+ */
+template<typename Fn>
+void for_blocks(const char *file_name, Fn &&fn) {
+	$::ifstream in(file_name, $::ifstream::binary);
+	if (!in)
+		throw meave::Error("Cannot open: %s: %m", file_name);
+
+	TrajectoryLog::Header header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof header) || ::memcmp(header.magic_, TrajectoryLog::magic(), sizeof header.magic_))
+		throw meave::Error("Not a trajectory log: %s", file_name);
+	if (header.version_ != TrajectoryLog::VERSION)
+		throw meave::Error("Unsupported version %u of trajectory log: %s", unsigned(header.version_), file_name);
+
+	$::vector<char> columns;
+	for (::uint64_t off = sizeof header; off < header.used_; ) {
+		TrajectoryLog::BlockHeader block;
+		if (!in.read(reinterpret_cast<char*>(&block), sizeof block))
+			throw meave::Error("Trajectory log is truncated: %s", file_name);
+		columns.resize(block.rows_ * TrajectoryLog::row_size());
+		if (!in.read(&columns[0], columns.size()))
+			throw meave::Error("Trajectory log is truncated: %s", file_name);
+
+		fn(block, static_cast<const char*>(&columns[0]));
+		off += sizeof block + columns.size();
+	}
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(int argc, char *argv[]) {
+	if (argc != 2 && argc != 4) {
+		$::cerr << "usage: " << argv[0] << " <trajectory.dat> [<population> <member>]" << $::endl;
+		return 1;
+	}
+
+	try {
+		if (argc == 4) {
+			const uns population = ::strtoul(argv[2], nullptr, 10);
+			const uns member = ::strtoul(argv[3], nullptr, 10);
+			write_header($::cout);
+			for_blocks(argv[1], [population, member](const TrajectoryLog::BlockHeader &header, const char *columns) {
+				if (header.population_ == population && header.member_ == member)
+					write_rows($::cout, header, columns);
+			});
+			return $::cout.flush() ? 0 : 1;
+		}
+
+		// Blocks of different members are interleaved, a file is therefore
+		//   truncated only when its member is seen for the first time.
+		$::set<$::pair<uns, uns>> seen;
+		for_blocks(argv[1], [&seen](const TrajectoryLog::BlockHeader &header, const char *columns) {
+			const bool first = seen.emplace(header.population_, header.member_).second;
+			const $::string file_name = meave::str_printf("./results_%.3u_%.3u.csv", unsigned(header.population_), unsigned(header.member_));
+			$::ofstream out(file_name, first ? $::ofstream::trunc : $::ofstream::app);
+			if (first)
+				write_header(out);
+			write_rows(out, header, columns);
+			if (!out)
+				throw meave::Error("Cannot write: %s", file_name.c_str());
+		});
+	} catch (const meave::Error &e) {
+		$::cerr << argv[0] << ": " << e.what() << $::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,222 @@
+#ifndef MEAVE_GA_TRAJECTORY_HPP_INCLUDED
+#	define MEAVE_GA_TRAJECTORY_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+#	include "meave/lib/raii/fd.hpp"
+#	include "meave/lib/trace.hpp"
+
+#	include <algorithm>
+#	include <cstdint>
+#	include <cstring>
+#	include <mutex>
+#	include <vector>
+
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <sys/types.h>
+#	include <unistd.h>
+
+namespace meave { namespace ga {
+
+/**
+ * Append-only binary log of trajectories written during full fitness
+ *   evaluation (population, member, experiment, start, input, real output,
+ *   expected output, f), replacing text files results_PPP_MMM.csv .
+ *
+ * File layout (native byte order):
+ *   Header, then blocks up to Header::used_ . A block holds rows of one
+ *   member of one population: BlockHeader followed by columns
+ *     uint32_t experiment[rows]
+ *     float start[rows], input[rows], real[rows], expected[rows], f[rows]
+ * Values are stored as float, that's what single precision variants compute.
+ *
+ * The file is mapped and grows by doubling (ftruncate + mremap). Header::used_
+ *   is updated after every block, so the log of a crashed run is readable up
+ *   to the last complete block.
+ * simple-trial-analyse/trajectory-tsv converts the log back to TSV.
+ */
+class TrajectoryLog {
+public:
+	struct Header {
+		char magic_[8];
+		::uint32_t version_;
+		::uint32_t reserved_;
+		::uint64_t used_;	///< Bytes of the file used by header and blocks.
+	};
+
+	struct BlockHeader {
+		::uint32_t population_;
+		::uint32_t member_;
+		::uint32_t rows_;
+		::uint32_t reserved_;
+	};
+
+	enum { VERSION = 1 };
+
+	/**
+	 * @return The first 8 bytes of the file.
+	 */
+	static const char *magic() noexcept {
+		return "MEAVETRJ";
+	}
+
+	static constexpr ::size_t row_size() noexcept {
+		return sizeof(::uint32_t) + 5 * sizeof(float);
+	}
+
+	/**
+	 * Rows of one member, flushed into the log by blocks of block_rows rows.
+	 *   Every appender must be used by one thread only.
+	 */
+	class Appender {
+	private:
+		TrajectoryLog &log_;
+		const BlockHeader header_;
+		$::vector< ::uint32_t> experiment_;
+		$::vector<float> start_;
+		$::vector<float> input_;
+		$::vector<float> real_;
+		$::vector<float> expected_;
+		$::vector<float> f_;
+		uns rows_;
+
+	public:
+		Appender(TrajectoryLog &log, const uns population, const uns member, const uns block_rows = 4096)
+		:	log_(log)
+		,	header_{population, member, 0, 0}
+		,	experiment_(block_rows)
+		,	start_(block_rows)
+		,	input_(block_rows)
+		,	real_(block_rows)
+		,	expected_(block_rows)
+		,	f_(block_rows)
+		,	rows_(0) {
+		}
+		Appender(const Appender&) = delete;
+		Appender &operator=(const Appender&) = delete;
+
+		/**
+		 * Signature of the writer of fitness().
+		 */
+		void operator()(const float start, const float input, const uns experiment, const double real, const double expected, const double f) {
+			experiment_[rows_] = experiment;
+			start_[rows_] = start;
+			input_[rows_] = input;
+			real_[rows_] = real;
+			expected_[rows_] = expected;
+			f_[rows_] = f;
+			if (++rows_ == experiment_.size())
+				flush();
+		}
+
+		void flush() {
+			if (!rows_)
+				return;
+
+			BlockHeader header = header_;
+			header.rows_ = rows_;
+			log_.append(header, [this](char *p) {
+				const auto column = [this, &p](const void *c, const ::size_t item_size) {
+					::memcpy(p, c, rows_ * item_size);
+					p += rows_ * item_size;
+				};
+				column(&experiment_[0], sizeof(experiment_[0]));
+				column(&start_[0], sizeof(float));
+				column(&input_[0], sizeof(float));
+				column(&real_[0], sizeof(float));
+				column(&expected_[0], sizeof(float));
+				column(&f_[0], sizeof(float));
+			});
+			rows_ = 0;
+		}
+
+		~Appender() noexcept {
+			try {
+				flush();
+			} catch (const $::exception &e) {
+				LOG(ERROR) << "Trajectory of member " << header_.member_ << " is lost: " << e.what();
+			}
+		}
+	};
+
+private:
+	raii::FD fd_;
+	char *mem_;
+	::size_t mapped_;
+	::size_t used_;
+	$::mutex mutex_;
+
+	Header &header() noexcept {
+		return *reinterpret_cast<Header*>(mem_);
+	}
+
+	void grow(const ::size_t len) {
+		const ::size_t mapped = $::max(2 * mapped_, len);
+		if (-1 == ::ftruncate(*fd_, ::off_t(mapped)))
+			throw Error("Cannot resize trajectory log: %m");
+		void *mem = ::mremap(mem_, mapped_, mapped, MREMAP_MAYMOVE);
+		if (mem == MAP_FAILED)
+			throw Error("Cannot remap trajectory log: %m");
+		mem_ = static_cast<char*>(mem);
+		mapped_ = mapped;
+	}
+
+	/**
+	 * Appends block with header and rows written by write_columns(p).
+	 *   The lock is taken once per block of an Appender (thousands of
+	 *   simulated steps), not per row, so unlike the printer of SimpleTrial
+	 *   it isn't worth a queue (meave/lib/par/mpsc_queue.hpp) and a writer
+	 *   thread copying every block once more.
+	 */
+	template<typename Fn>
+	void append(const BlockHeader &header, Fn &&write_columns) {
+		const trace::Scope scope("trajectory log", "io");
+		const ::size_t len = sizeof header + header.rows_ * row_size();
+		const $::lock_guard<$::mutex> lock(mutex_);
+		if (used_ + len > mapped_)
+			grow(used_ + len);
+
+		::memcpy(mem_ + used_, &header, sizeof header);
+		write_columns(mem_ + used_ + sizeof header);
+		used_ += len;
+		this->header().used_ = used_;
+	}
+
+public:
+	explicit TrajectoryLog(const char *file_name, const ::size_t initial_size = 64 << 20)
+	:	fd_(::open(file_name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+	,	mem_(nullptr)
+	,	mapped_($::max(initial_size, sizeof(Header)))
+	,	used_(sizeof(Header)) {
+		if (!fd_)
+			throw Error("Cannot open: %s: %m", file_name);
+		if (-1 == ::ftruncate(*fd_, ::off_t(mapped_)))
+			throw Error("Cannot resize file %s: %m", file_name);
+		void *mem = ::mmap(0, mapped_, PROT_READ | PROT_WRITE, MAP_SHARED, *fd_, 0);
+		if (mem == MAP_FAILED)
+			throw Error("Cannot mmap: %s: %m", file_name);
+		mem_ = static_cast<char*>(mem);
+
+		::memcpy(header().magic_, magic(), sizeof(header().magic_));
+		header().version_ = VERSION;
+		header().reserved_ = 0;
+		header().used_ = used_;
+	}
+	TrajectoryLog(const TrajectoryLog&) = delete;
+	TrajectoryLog &operator=(const TrajectoryLog&) = delete;
+
+	/**
+	 * Cuts the file to its used size.
+	 */
+	~TrajectoryLog() noexcept {
+		::munmap(mem_, mapped_);
+		if (-1 == ::ftruncate(*fd_, ::off_t(used_)))
+			LOG(ERROR) << "Cannot truncate trajectory log: " << ::strerror(errno);
+	}
+};
+
+} } /* namespace meave::ga */
+
+#endif // MEAVE_GA_TRAJECTORY_HPP_INCLUDED
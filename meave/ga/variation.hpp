@@ -0,0 +1,420 @@
+#ifndef MEAVE_GA_VARIATION_HPP_INCLUDED
+#	define MEAVE_GA_VARIATION_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/cpu.hpp"
+#	include "meave/lib/math.hpp"
+#	include "meave/lib/simd/vec.hpp"
+
+/**
+ * Variation operators of GA strategies over whole genomes.
+ *
+ * Every function works on n genes. Random numbers are not drawn inside,
+ *   they are passed in as vectors with one number per gene (or as a scalar
+ *   where the original operator draws one number per genome).
+ * Operands are only combined gene by gene, so n may also cover a batch of
+ *   consecutive genomes stored one after another, and the destination may
+ *   be the same array as one of the parents.
+ *
+ * Templates are plain per-gene loops; overloads for float run the widest
+ *   variant the CPU has (meave/lib/cpu.hpp), whatever the -m flags, e.g. 8
+ *   genes at once with AVX2; the tail is done by masked loads/stores. The
+ *   overloads with a cpu::Level run the variant of the level (e.g. to test
+ *   it).
+ */
+namespace meave { namespace ga { namespace variation {
+
+/**
+ * Particle Swarm Optimization move:
+ *   v = omega*v + psi_p*rp*(best - x) + psi_s*rs*(subswarm - x) + psi_g*rg*(global - x)
+ *   x = x + v
+ */
+template<typename Float>
+void pso_move(Float x[], Float v[], const Float best[], const Float subswarm[], const Float global[],
+	      const Float rp[], const Float rs[], const Float rg[], const uns n,
+	      const Float omega, const Float psi_p, const Float psi_s, const Float psi_g) noexcept {
+	for (uns _ = 0; _ < n; ++_) {
+		v[_] = omega * v[_] +
+		       psi_p * rp[_] * (best[_] - x[_]) +
+		       psi_s * rs[_] * (subswarm[_] - x[_]) +
+		       psi_g * rg[_] * (global[_] - x[_]);
+		x[_] += v[_];
+	}
+}
+
+/**
+ * Differential Evolution trial vector (DE/rand/1/bin):
+ *   t = frac(abs(u < CR ? a + F*(b - c) : x))
+ */
+template<typename Float>
+void de_trial(Float t[], const Float x[], const Float a[], const Float b[], const Float c[],
+	      const Float u[], const uns n, const Float F, const Float CR) noexcept {
+	for (uns _ = 0; _ < n; ++_) {
+		const Float m = a[_] + F * (b[_] - c[_]);
+		const Float y = meave::math::abs(u[_] < CR ? m : x[_]);
+		t[_] = y - long(y);
+	}
+}
+
+/**
+ * Gene by gene crossover with Gaussian mutation reflected into [0, 1]:
+ *   d = (u < recprob ? m : f) + sigma*g
+ */
+template<typename Float>
+void gen_child_item_by_item(Float d[], const Float m[], const Float f[], const Float u[], const Float g[],
+			    const uns n, const Float recprob, const Float sigma) noexcept {
+	for (uns _ = 0; _ < n; ++_) {
+		Float y = (u[_] < recprob ? m[_] : f[_]) + g[_] * sigma;
+		if (y > 1)
+			y = 2 - y;
+		d[_] = meave::math::abs(y);
+	}
+}
+
+/**
+ * Linear crossover with Gaussian mutation reflected into [0, 1]:
+ *   d = (u < recprob ? m : r*m + (1 - r)*f) + sigma*g
+ */
+template<typename Float>
+void gen_child_linear(Float d[], const Float m[], const Float f[], const Float r, const Float u[], const Float g[],
+		      const uns n, const Float recprob, const Float sigma) noexcept {
+	for (uns _ = 0; _ < n; ++_) {
+		Float y = (u[_] < recprob ? m[_] : r*m[_] + (1 - r)*f[_]) + g[_] * sigma;
+		if (y > 1)
+			y = 2 - y;
+		d[_] = meave::math::abs(y);
+	}
+}
+
+/**
+ * Blend of parents with Gaussian mutation wrapped by its fractional part:
+ *   d = frac((u < recprob ? r*m + (1 - r)*f : (1 - r)*m + r*f) + sigma*g)
+ */
+template<typename Float>
+void gen_child_normal(Float d[], const Float m[], const Float f[], const Float r, const Float u[], const Float g[],
+		      const uns n, const Float recprob, const Float sigma) noexcept {
+	for (uns _ = 0; _ < n; ++_) {
+		const Float y = (u[_] < recprob ? r*m[_] + (1 - r)*f[_] : (1 - r)*m[_] + r*f[_]) + g[_] * sigma;
+		d[_] = y - long(y);
+	}
+}
+
+namespace aux {
+
+/** Loads and stores of V::LANES whole genes. */
+template<typename V>
+struct Full {
+	MEAVE_SIMD_INLINE V load(const float *p) const noexcept {
+		return V::load(p);
+	}
+	MEAVE_SIMD_INLINE void store(float *p, const V &x) const noexcept {
+		x.store(p);
+	}
+};
+
+/** Loads and stores of the first `left' genes, the rest is neither read nor written. */
+template<typename V>
+struct Tail {
+	const uns left_;
+
+	MEAVE_SIMD_INLINE V load(const float *p) const noexcept {
+		return V::load(p, left_);
+	}
+	MEAVE_SIMD_INLINE void store(float *p, const V &x) const noexcept {
+		x.store(p, left_);
+	}
+};
+
+/**
+ * Calls fn(i, io) for every block of V::LANES genes starting at i, io is
+ *   Full or Tail for the last incomplete block.
+ */
+template<typename V, typename Fn>
+MEAVE_SIMD_INLINE void for_blocks(const uns n, const Fn &fn) noexcept {
+	uns i = 0;
+	for (; i + V::LANES <= n; i += V::LANES)
+		fn(i, Full<V>());
+	if (i < n)
+		fn(i, Tail<V>{n - i});
+}
+
+template<typename V>
+MEAVE_SIMD_INLINE V frac(const V &x) noexcept {
+	return x - trunc(x);
+}
+
+/** (x > 1 ? 2 - x : x) */
+template<typename V>
+MEAVE_SIMD_INLINE V reflect(const V &x) noexcept {
+	return blend(x > V(1.f), x, V(2.f) - x);
+}
+
+/** r*a + (1 - r)*b */
+template<typename V>
+MEAVE_SIMD_INLINE V lerp(const V &r, const V &a, const V &b) noexcept {
+	return fma(r, a - b, b);
+}
+
+/*
+ * The vector variants of the operators for float, V a simd::Native<float,
+ *   level>; compiled for every level of meave/lib/cpu.hpp, the templates
+ *   above are the scalar ones.
+ */
+
+template<typename V>
+MEAVE_SIMD_INLINE void pso_move_vec(float x[], float v[], const float best[], const float subswarm[], const float global[],
+				    const float rp[], const float rs[], const float rg[], const uns n,
+				    const float omega, const float psi_p, const float psi_s, const float psi_g) noexcept {
+	const V o = omega;
+	const V pp = psi_p;
+	const V ps = psi_s;
+	const V pg = psi_g;
+	for_blocks<V>(n, [=](const uns i, const auto &io) {
+		const V xi = io.load(&x[i]);
+		V vi = o * io.load(&v[i]);
+		vi = fma(pp * io.load(&rp[i]), io.load(&best[i]) - xi, vi);
+		vi = fma(ps * io.load(&rs[i]), io.load(&subswarm[i]) - xi, vi);
+		vi = fma(pg * io.load(&rg[i]), io.load(&global[i]) - xi, vi);
+		io.store(&v[i], vi);
+		io.store(&x[i], xi + vi);
+	});
+}
+
+template<typename V>
+MEAVE_SIMD_INLINE void de_trial_vec(float t[], const float x[], const float a[], const float b[], const float c[],
+				    const float u[], const uns n, const float F, const float CR) noexcept {
+	const V f = F;
+	const V cr = CR;
+	for_blocks<V>(n, [=](const uns i, const auto &io) {
+		const V m = fma(f, io.load(&b[i]) - io.load(&c[i]), io.load(&a[i]));
+		io.store(&t[i], frac(abs(blend(io.load(&u[i]) < cr, io.load(&x[i]), m))));
+	});
+}
+
+template<typename V>
+MEAVE_SIMD_INLINE void gen_child_item_by_item_vec(float d[], const float m[], const float f[], const float u[], const float g[],
+						  const uns n, const float recprob, const float sigma) noexcept {
+	const V p = recprob;
+	const V s = sigma;
+	for_blocks<V>(n, [=](const uns i, const auto &io) {
+		const V y = blend(io.load(&u[i]) < p, io.load(&f[i]), io.load(&m[i]));
+		io.store(&d[i], abs(reflect(fma(io.load(&g[i]), s, y))));
+	});
+}
+
+template<typename V>
+MEAVE_SIMD_INLINE void gen_child_linear_vec(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+					    const uns n, const float recprob, const float sigma) noexcept {
+	const V rr = r;
+	const V p = recprob;
+	const V s = sigma;
+	for_blocks<V>(n, [=](const uns i, const auto &io) {
+		const V mi = io.load(&m[i]);
+		const V y = blend(io.load(&u[i]) < p, lerp(rr, mi, io.load(&f[i])), mi);
+		io.store(&d[i], abs(reflect(fma(io.load(&g[i]), s, y))));
+	});
+}
+
+template<typename V>
+MEAVE_SIMD_INLINE void gen_child_normal_vec(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+					    const uns n, const float recprob, const float sigma) noexcept {
+	const V rr = r;
+	const V p = recprob;
+	const V s = sigma;
+	for_blocks<V>(n, [=](const uns i, const auto &io) {
+		const V mi = io.load(&m[i]);
+		const V fi = io.load(&f[i]);
+		const V y = blend(io.load(&u[i]) < p, lerp(rr, fi, mi), lerp(rr, mi, fi));
+		io.store(&d[i], frac(fma(io.load(&g[i]), s, y)));
+	});
+}
+
+typedef void (*PsoMove)(float[], float[], const float[], const float[], const float[],
+			const float[], const float[], const float[], uns, float, float, float, float);
+typedef void (*DeTrial)(float[], const float[], const float[], const float[], const float[],
+			const float[], uns, float, float);
+typedef void (*GenChildItemByItem)(float[], const float[], const float[], const float[], const float[],
+				   uns, float, float);
+typedef void (*GenChild)(float[], const float[], const float[], float, const float[], const float[],
+			 uns, float, float);
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline void pso_move_sse42(float x[], float v[], const float best[], const float subswarm[], const float global[],
+			   const float rp[], const float rs[], const float rg[], const uns n,
+			   const float omega, const float psi_p, const float psi_s, const float psi_g) noexcept {
+	pso_move_vec<simd::Native<float, cpu::SSE42>>(x, v, best, subswarm, global, rp, rs, rg, n, omega, psi_p, psi_s, psi_g);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline void pso_move_avx2(float x[], float v[], const float best[], const float subswarm[], const float global[],
+			  const float rp[], const float rs[], const float rg[], const uns n,
+			  const float omega, const float psi_p, const float psi_s, const float psi_g) noexcept {
+	pso_move_vec<simd::Native<float, cpu::AVX2>>(x, v, best, subswarm, global, rp, rs, rg, n, omega, psi_p, psi_s, psi_g);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline void pso_move_avx512(float x[], float v[], const float best[], const float subswarm[], const float global[],
+			    const float rp[], const float rs[], const float rg[], const uns n,
+			    const float omega, const float psi_p, const float psi_s, const float psi_g) noexcept {
+	pso_move_vec<simd::Native<float, cpu::AVX512>>(x, v, best, subswarm, global, rp, rs, rg, n, omega, psi_p, psi_s, psi_g);
+}
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline void de_trial_sse42(float t[], const float x[], const float a[], const float b[], const float c[],
+			   const float u[], const uns n, const float F, const float CR) noexcept {
+	de_trial_vec<simd::Native<float, cpu::SSE42>>(t, x, a, b, c, u, n, F, CR);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline void de_trial_avx2(float t[], const float x[], const float a[], const float b[], const float c[],
+			  const float u[], const uns n, const float F, const float CR) noexcept {
+	de_trial_vec<simd::Native<float, cpu::AVX2>>(t, x, a, b, c, u, n, F, CR);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline void de_trial_avx512(float t[], const float x[], const float a[], const float b[], const float c[],
+			    const float u[], const uns n, const float F, const float CR) noexcept {
+	de_trial_vec<simd::Native<float, cpu::AVX512>>(t, x, a, b, c, u, n, F, CR);
+}
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline void gen_child_item_by_item_sse42(float d[], const float m[], const float f[], const float u[], const float g[],
+					 const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_item_by_item_vec<simd::Native<float, cpu::SSE42>>(d, m, f, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline void gen_child_item_by_item_avx2(float d[], const float m[], const float f[], const float u[], const float g[],
+					const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_item_by_item_vec<simd::Native<float, cpu::AVX2>>(d, m, f, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline void gen_child_item_by_item_avx512(float d[], const float m[], const float f[], const float u[], const float g[],
+					  const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_item_by_item_vec<simd::Native<float, cpu::AVX512>>(d, m, f, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline void gen_child_linear_sse42(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+				   const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_linear_vec<simd::Native<float, cpu::SSE42>>(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline void gen_child_linear_avx2(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+				  const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_linear_vec<simd::Native<float, cpu::AVX2>>(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline void gen_child_linear_avx512(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+				    const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_linear_vec<simd::Native<float, cpu::AVX512>>(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline void gen_child_normal_sse42(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+				   const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_normal_vec<simd::Native<float, cpu::SSE42>>(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline void gen_child_normal_avx2(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+				  const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_normal_vec<simd::Native<float, cpu::AVX2>>(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline void gen_child_normal_avx512(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+				    const uns n, const float recprob, const float sigma) noexcept {
+	gen_child_normal_vec<simd::Native<float, cpu::AVX512>>(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+inline const cpu::Kernels<PsoMove> &pso_move_kernels() noexcept {
+	static const cpu::Kernels<PsoMove> $${{ &pso_move<float>, &pso_move_sse42, &pso_move_avx2, &pso_move_avx512 }};
+	return $$;
+}
+
+inline const cpu::Kernels<DeTrial> &de_trial_kernels() noexcept {
+	static const cpu::Kernels<DeTrial> $${{ &de_trial<float>, &de_trial_sse42, &de_trial_avx2, &de_trial_avx512 }};
+	return $$;
+}
+
+inline const cpu::Kernels<GenChildItemByItem> &gen_child_item_by_item_kernels() noexcept {
+	static const cpu::Kernels<GenChildItemByItem> $${{ &gen_child_item_by_item<float>, &gen_child_item_by_item_sse42, &gen_child_item_by_item_avx2, &gen_child_item_by_item_avx512 }};
+	return $$;
+}
+
+inline const cpu::Kernels<GenChild> &gen_child_linear_kernels() noexcept {
+	static const cpu::Kernels<GenChild> $${{ &gen_child_linear<float>, &gen_child_linear_sse42, &gen_child_linear_avx2, &gen_child_linear_avx512 }};
+	return $$;
+}
+
+inline const cpu::Kernels<GenChild> &gen_child_normal_kernels() noexcept {
+	static const cpu::Kernels<GenChild> $${{ &gen_child_normal<float>, &gen_child_normal_sse42, &gen_child_normal_avx2, &gen_child_normal_avx512 }};
+	return $$;
+}
+
+} /* namespace aux */
+
+inline void pso_move(float x[], float v[], const float best[], const float subswarm[], const float global[],
+		     const float rp[], const float rs[], const float rg[], const uns n,
+		     const float omega, const float psi_p, const float psi_s, const float psi_g) noexcept {
+	static const aux::PsoMove kernel = aux::pso_move_kernels().impl();
+	kernel(x, v, best, subswarm, global, rp, rs, rg, n, omega, psi_p, psi_s, psi_g);
+}
+
+inline void pso_move(float x[], float v[], const float best[], const float subswarm[], const float global[],
+		     const float rp[], const float rs[], const float rg[], const uns n,
+		     const float omega, const float psi_p, const float psi_s, const float psi_g, const cpu::Level level) noexcept {
+	aux::pso_move_kernels().impl(level)(x, v, best, subswarm, global, rp, rs, rg, n, omega, psi_p, psi_s, psi_g);
+}
+
+inline void de_trial(float t[], const float x[], const float a[], const float b[], const float c[],
+		     const float u[], const uns n, const float F, const float CR) noexcept {
+	static const aux::DeTrial kernel = aux::de_trial_kernels().impl();
+	kernel(t, x, a, b, c, u, n, F, CR);
+}
+
+inline void de_trial(float t[], const float x[], const float a[], const float b[], const float c[],
+		     const float u[], const uns n, const float F, const float CR, const cpu::Level level) noexcept {
+	aux::de_trial_kernels().impl(level)(t, x, a, b, c, u, n, F, CR);
+}
+
+inline void gen_child_item_by_item(float d[], const float m[], const float f[], const float u[], const float g[],
+				   const uns n, const float recprob, const float sigma) noexcept {
+	static const aux::GenChildItemByItem kernel = aux::gen_child_item_by_item_kernels().impl();
+	kernel(d, m, f, u, g, n, recprob, sigma);
+}
+
+inline void gen_child_item_by_item(float d[], const float m[], const float f[], const float u[], const float g[],
+				   const uns n, const float recprob, const float sigma, const cpu::Level level) noexcept {
+	aux::gen_child_item_by_item_kernels().impl(level)(d, m, f, u, g, n, recprob, sigma);
+}
+
+inline void gen_child_linear(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+			     const uns n, const float recprob, const float sigma) noexcept {
+	static const aux::GenChild kernel = aux::gen_child_linear_kernels().impl();
+	kernel(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+inline void gen_child_linear(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+			     const uns n, const float recprob, const float sigma, const cpu::Level level) noexcept {
+	aux::gen_child_linear_kernels().impl(level)(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+inline void gen_child_normal(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+			     const uns n, const float recprob, const float sigma) noexcept {
+	static const aux::GenChild kernel = aux::gen_child_normal_kernels().impl();
+	kernel(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+inline void gen_child_normal(float d[], const float m[], const float f[], const float r, const float u[], const float g[],
+			     const uns n, const float recprob, const float sigma, const cpu::Level level) noexcept {
+	aux::gen_child_normal_kernels().impl(level)(d, m, f, r, u, g, n, recprob, sigma);
+}
+
+} } } /* namespace meave::ga::variation */
+
+#endif // MEAVE_GA_VARIATION_HPP_INCLUDED
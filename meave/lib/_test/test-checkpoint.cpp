@@ -0,0 +1,96 @@
+/*
+ * g++ -std=gnu++1y -I../../.. -pthread -o test-checkpoint test-checkpoint.cpp -lglog
+ */
+
+#undef NDEBUG
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include <glog/logging.h>
+
+#include "../checkpoint.hpp"
+
+int
+main(void) {
+	const char *file_name = "./test-checkpoint.dat";
+	::unlink(file_name);
+
+	std::string payload;
+	FILE *f;
+	assert(!meave::checkpoint::load(file_name, payload));
+
+	std::default_random_engine rand(42);
+	rand.discard(10);
+	std::ostringstream rand_state;
+	rand_state << rand;
+
+	{
+		meave::checkpoint::Writer writer(file_name);
+		for (unsigned _ = 0; _ < 100; ++_) {
+			meave::checkpoint::Out out;
+			out.put(_).put(std::vector<float>(_, 0.5f)).put(rand_state.str());
+			writer(std::move(out));
+		}
+		// The last checkpoint is written before the writer is destroyed.
+	}
+
+	assert(meave::checkpoint::load(file_name, payload));
+	meave::checkpoint::In in(std::move(payload));
+	unsigned n;
+	in.get(n);
+	assert(n == 99);
+	std::vector<float> v(n);
+	in.get(v);
+	assert(v == std::vector<float>(99, 0.5f));
+	std::string s;
+	in.get(s);
+	std::default_random_engine restored;
+	std::istringstream(s) >> restored;
+	assert(restored == rand);
+	try {
+		in.get(n);
+		assert(0);
+	} catch (const meave::Error &e) {
+		std::cerr << "OK: " << e.what() << std::endl;
+	}
+
+	// Flip one byte of the payload.
+	f = ::fopen(file_name, "r+");
+	assert(f);
+	::fseek(f, -1, SEEK_END);
+	::fputc('x', f);
+	::fclose(f);
+	try {
+		meave::checkpoint::load(file_name, payload);
+		assert(0);
+	} catch (const meave::Error &e) {
+		std::cerr << "OK: " << e.what() << std::endl;
+	}
+
+	// Header claiming a huge payload isn't trusted.
+	{
+		meave::checkpoint::Writer writer(file_name);
+		meave::checkpoint::Out out;
+		out.put(42U);
+		writer(std::move(out));
+	}
+	f = ::fopen(file_name, "r+");
+	assert(f);
+	const std::uint64_t len = ~std::uint64_t(0) >> 8;
+	::fseek(f, 16, SEEK_SET);
+	::fwrite(&len, sizeof len, 1, f);
+	::fclose(f);
+	try {
+		meave::checkpoint::load(file_name, payload);
+		assert(0);
+	} catch (const meave::Error &e) {
+		std::cerr << "OK: " << e.what() << std::endl;
+	}
+
+	::unlink(file_name);
+	return 0;
+}
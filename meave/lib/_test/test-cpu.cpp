@@ -0,0 +1,189 @@
+/*
+ * g++ -std=gnu++1y -I../../.. -O2 -mavx -o test-cpu test-cpu.cpp -lglog
+ *
+ * -mavx only for meave/ctrnn/neuron.hpp, the kernels need no -m flags.
+ */
+
+#undef NDEBUG
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "meave/commons.hpp"
+#include "meave/ctrnn/lanes.hpp"
+#include "meave/lib/checksum/fletcher.hpp"
+#include "meave/lib/cpu.hpp"
+#include "meave/lib/gettime.hpp"
+#include "meave/lib/hash/rolhash_lanes.hpp"
+#include "meave/lib/math/funcs_array.hpp"
+
+/*
+ * Checks that every variant of the dispatched kernels the CPU can run
+ *   gives the results of the scalar one, and measures them.
+ */
+
+namespace {
+
+namespace cpu = meave::cpu;
+
+typedef $::mt19937 Random;
+
+/**
+ * Calls fn(level) for all levels the CPU has.
+ */
+template<typename Fn>
+void for_levels(Fn &&fn) {
+	for (int l = cpu::SCALAR; l <= cpu::detected(); ++l)
+		fn(cpu::Level(l));
+}
+
+void check_level() {
+	// Unknown names are rejected, known ones round-trip.
+	assert(::meave_cpu_level_parse("avx3") == -1);
+	for (int l = cpu::SCALAR; l < cpu::LEVELS; ++l)
+		assert(::meave_cpu_level_parse(cpu::name(cpu::Level(l))) == l);
+
+	// MEAVE_SIMD caps the level for the rest of the process; set before the
+	//   first call, as from the command line.
+	::setenv("MEAVE_SIMD", "sse42", 1);
+	assert(cpu::level() == $::min(cpu::detected(), cpu::SSE42));
+	::setenv("MEAVE_SIMD", "avx512", 1);
+	assert(cpu::level() == $::min(cpu::detected(), cpu::SSE42));
+
+	const cpu::Kernels<int> kernels{{ 1, 0, 3, 0 }};
+	assert(kernels.impl(cpu::SCALAR) == 1);
+	assert(kernels.impl(cpu::SSE42) == 1);
+	assert(kernels.impl(cpu::AVX2) == 3);
+	assert(kernels.impl(cpu::AVX512) == 3);
+	$::cerr << "cpu: " << cpu::name(cpu::detected()) << ", running " << cpu::name(cpu::level()) << $::endl;
+}
+
+void check_fletcher(Random &rand) {
+	namespace ch = meave::checksum;
+	$::vector<unsigned> data(1 << 16);
+	for (auto &$: data)
+		$ = rand();
+	const char *p = reinterpret_cast<const char*>(data.data());
+
+	for (::size_t size = 0; size < 300; size += 4) {
+		const auto expected = ch::fletcher_aligned_slow(p, size);
+		for_levels([&](const cpu::Level l) {
+			const auto real = ch::fletcher_aligned(p, size, l);
+			assert(!::memcmp(expected.x, real.x, sizeof(real.x)));
+		});
+	}
+	for_levels([&](const cpu::Level l) {
+		const auto expected = ch::fletcher_aligned_slow(p, data.size() * sizeof(unsigned));
+		const double t0 = meave::gettime();
+		for (uns _ = 0; _ < 1000; ++_)
+			assert(!::memcmp(expected.x, ch::fletcher_aligned(p, data.size() * sizeof(unsigned), l).x, sizeof(expected.x)));
+		const double t1 = meave::gettime();
+		$::cerr << "fletcher " << cpu::name(l) << ": " << 1000. * data.size() * sizeof(unsigned) / (t1 - t0) / 1e9 << " GB/s" << $::endl;
+	});
+}
+
+void check_rolhash(Random &rand) {
+	namespace rh = meave::rolhash;
+	$::vector< ::uint8_t> data(1 << 16);
+	for (auto &$: data)
+		$ = rand();
+
+	assert(!rh::lanes8<13>(data.data(), 0));
+	for (::size_t len = 0; len < 300; ++len) {
+		const auto expected = rh::lanes8<13>(data.data() + 1, len, cpu::SCALAR);
+		for_levels([&](const cpu::Level l) {
+			assert(rh::lanes8<13>(data.data() + 1, len, l) == expected);
+			assert(rh::lanes8<7>(data.data(), len, l) == rh::lanes8<7>(data.data(), len, cpu::SCALAR));
+		});
+	}
+	for_levels([&](const cpu::Level l) {
+		const double t0 = meave::gettime();
+		for (uns _ = 0; _ < 1000; ++_)
+			rh::lanes8<13>(data.data(), data.size(), l);
+		const double t1 = meave::gettime();
+		$::cerr << "rolhash " << cpu::name(l) << ": " << 1000. * data.size() / (t1 - t0) / 1e9 << " GB/s" << $::endl;
+	});
+}
+
+void check_math() {
+	namespace ma = meave::math;
+	const uns LEN = 4099;
+	$::vector<float> x(LEN), y(LEN), s(LEN);
+	// num of exp_pade22() overflows above about 86.
+	for (uns _ = 0; _ < LEN; ++_)
+		x[_] = (_ - 2049.f) / 26.f;
+
+	for_levels([&](const cpu::Level l) {
+		ma::exp_approx(y.data(), x.data(), LEN, l);
+		ma::sigmoid_approx(s.data(), x.data(), LEN, l);
+		for (uns _ = 0; _ < LEN; ++_) {
+			assert($::fabs(y[_] / ma::exp_approx(x[_]) - 1) < 1e-5);
+			assert($::fabs(s[_] - ma::sigmoid_approx(x[_])) < 1e-6);
+		}
+
+		const double t0 = meave::gettime();
+		for (uns _ = 0; _ < 1000; ++_)
+			ma::sigmoid_approx(s.data(), x.data(), LEN, l);
+		const double t1 = meave::gettime();
+		$::cerr << "sigmoid_approx " << cpu::name(l) << ": " << (t1 - t0) / 1000 / LEN * 1e9 << " ns" << $::endl;
+	});
+}
+
+void check_lanes(Random &rand) {
+	typedef meave::ctrnn::NNLanes<double> NNLanes;
+	const uns UNITS = 20;
+	const NNLanes nn(meave::ctrnn::UnitsNum<uns>(UNITS), meave::ctrnn::TimeStep<double>(0.01));
+	$::uniform_real_distribution<double> dist(-1, 1);
+
+	$::unique_ptr<NNLanes::Lanes[]> y(new NNLanes::Lanes[UNITS]);
+	$::unique_ptr<NNLanes::Lanes[]> ei(new NNLanes::Lanes[UNITS]);
+	$::vector<double> tc(UNITS), b(UNITS), w(UNITS * UNITS);
+	for (uns i = 0; i < UNITS; ++i) {
+		tc[i] = 1 + dist(rand) / 2;
+		b[i] = dist(rand);
+		for (uns l = 0; l < NNLanes::LANES_NUM; ++l) {
+			y[i][l] = dist(rand);
+			ei[i][l] = dist(rand);
+		}
+	}
+	for (auto &$: w)
+		$ = dist(rand);
+
+	$::unique_ptr<NNLanes::Lanes[]> v_expected(new NNLanes::Lanes[UNITS]());
+	$::unique_ptr<NNLanes::Lanes[]> y_expected(new NNLanes::Lanes[UNITS]);
+	nn.val(y.get(), tc.data(), ei.get(), w.data(), v_expected.get(), cpu::SCALAR);
+	nn.sigm(v_expected.get(), b.data(), y_expected.get(), cpu::SCALAR);
+	for_levels([&](const cpu::Level l) {
+		$::unique_ptr<NNLanes::Lanes[]> v(new NNLanes::Lanes[UNITS]());
+		$::unique_ptr<NNLanes::Lanes[]> y_real(new NNLanes::Lanes[UNITS]);
+		nn.val(y.get(), tc.data(), ei.get(), w.data(), v.get(), l);
+		nn.sigm(v.get(), b.data(), y_real.get(), l);
+		for (uns i = 0; i < UNITS; ++i) {
+			for (uns k = 0; k < NNLanes::LANES_NUM; ++k) {
+				// Up to FMA.
+				assert($::fabs(v[i][k] - v_expected[i][k]) < 1e-12);
+				assert($::fabs(y_real[i][k] - y_expected[i][k]) < 1e-12);
+			}
+		}
+	});
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	Random rand(42);
+
+	check_level();
+	check_fletcher(rand);
+	check_rolhash(rand);
+	check_math();
+	check_lanes(rand);
+
+	return 0;
+}
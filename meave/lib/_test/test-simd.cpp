@@ -0,0 +1,348 @@
+/*
+ * g++ -std=gnu++1y -I../../.. -O2 -o test-simd test-simd.cpp
+ */
+
+#undef NDEBUG
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include <immintrin.h>
+
+#include "meave/commons.hpp"
+#include "meave/lib/cpu.hpp"
+#include "meave/lib/gettime.hpp"
+#include "meave/lib/simd/math.hpp"
+#include "meave/lib/simd/vec.hpp"
+
+/*
+ * Checks simd::Vec at every level the CPU has against plain code, the
+ *   accuracy of simd::exp() and that exp_pade22() by Vec is as fast as
+ *   by intrinsics.
+ */
+
+namespace {
+
+namespace cpu = meave::cpu;
+namespace simd = meave::simd;
+
+typedef $::mt19937 Random;
+
+template<typename Fn>
+void for_levels(Fn &&fn) {
+	for (int l = cpu::SCALAR; l <= cpu::detected(); ++l)
+		fn(cpu::Level(l));
+}
+
+enum : uns { LEN = 64 };
+
+enum Op : uns { ADD, SUB, MUL, DIV, FMA, FNMA, MIN, MAX, ABS, ROUND, SQRT, BLEND, MASK, GATHER, LOAD_TAIL, STORE_TAIL, POW2, OPS };
+enum Red : uns { ANY, ALL, SUM, RMIN, RMAX, REDS };
+
+template<typename T>
+struct Ops {
+	typedef T Out[OPS][LEN];
+	typedef T Reds[REDS][LEN];
+	typedef void (*Kernel)(const T*, const T*, Out&, Reds&);
+
+	/**
+	 * Every operation of Vec, chunk by chunk.
+	 */
+	template<typename V>
+	MEAVE_SIMD_INLINE static void body(const T *a, const T *b, Out &out, Reds &reds) noexcept {
+		const uns W = V::LANES;
+		for (uns i = 0; i < LEN; i += W) {
+			const V x = V::load(&a[i]);
+			const V y = V::load(&b[i]);
+			(x + y).store(&out[ADD][i]);
+			(x - y).store(&out[SUB][i]);
+			(x * y).store(&out[MUL][i]);
+			(x / y).store(&out[DIV][i]);
+			fma(x, y, x).store(&out[FMA][i]);
+			fnma(x, y, x).store(&out[FNMA][i]);
+			min(x, y).store(&out[MIN][i]);
+			max(x, y).store(&out[MAX][i]);
+			abs(x).store(&out[ABS][i]);
+			round(x * T(4)).store(&out[ROUND][i]);
+			sqrt(abs(x)).store(&out[SQRT][i]);
+			blend(x < y, x, y).store(&out[BLEND][i]);
+			blend((x < y) & ~(x < V::zero()), V(0), V(1)).store(&out[MASK][i]);
+
+			::int32_t idx[W];
+			for (uns l = 0; l < W; ++l)
+				idx[l] = (7 * (i + l) + 3) % LEN;
+			V::gather(a, idx).store(&out[GATHER][i]);
+
+			const uns n = i / W % (W + 1);
+			V::load(&a[i], n).store(&out[LOAD_TAIL][i]);
+			x.store(&out[STORE_TAIL][i], n);
+			pow2(round(x * T(8))).store(&out[POW2][i]);
+
+			reds[ANY][i / W] = (x < y).any();
+			reds[ALL][i / W] = (x < y).all();
+			reds[SUM][i / W] = reduce_add(x);
+			reds[RMIN][i / W] = reduce_min(x);
+			reds[RMAX][i / W] = reduce_max(x);
+		}
+	}
+
+	static void scalar(const T *a, const T *b, Out &out, Reds &reds) noexcept {
+		body<simd::Native<T, cpu::SCALAR>>(a, b, out, reds);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_SSE42)
+	static void sse42(const T *a, const T *b, Out &out, Reds &reds) noexcept {
+		body<simd::Native<T, cpu::SSE42>>(a, b, out, reds);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX2)
+	static void avx2(const T *a, const T *b, Out &out, Reds &reds) noexcept {
+		body<simd::Native<T, cpu::AVX2>>(a, b, out, reds);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX512)
+	static void avx512(const T *a, const T *b, Out &out, Reds &reds) noexcept {
+		body<simd::Native<T, cpu::AVX512>>(a, b, out, reds);
+	}
+
+	static const cpu::Kernels<Kernel> kernels;
+};
+
+template<typename T>
+const cpu::Kernels<typename Ops<T>::Kernel> Ops<T>::kernels{{ &scalar, &sse42, &avx2, &avx512 }};
+
+template<typename T>
+void check_ops(Random &rand) {
+	$::uniform_real_distribution<T> dist(-10, 10);
+	T a[LEN], b[LEN];
+	for (uns _ = 0; _ < LEN; ++_) {
+		a[_] = dist(rand);
+		b[_] = _ % 5 ? dist(rand) : a[_];
+	}
+
+	for_levels([&](const cpu::Level level) {
+		const uns W = simd::lanes<T>(level);
+		typename Ops<T>::Out out;
+		typename Ops<T>::Reds reds;
+		for (auto &$: out[STORE_TAIL])
+			$ = -1;
+		Ops<T>::kernels.impl(level)(a, b, out, reds);
+
+		for (uns i = 0; i < LEN; ++i) {
+			const uns l = i % W, n = i / W % (W + 1);
+			assert(out[ADD][i] == a[i] + b[i]);
+			assert(out[SUB][i] == a[i] - b[i]);
+			assert(out[MUL][i] == a[i] * b[i]);
+			assert(out[DIV][i] == a[i] / b[i]);
+			// Fused or not.
+			assert($::fabs(out[FMA][i] - (a[i] * b[i] + a[i])) <= 1e-5 * $::fabs(a[i] * b[i]));
+			assert($::fabs(out[FNMA][i] - (a[i] - a[i] * b[i])) <= 1e-5 * $::fabs(a[i] * b[i]));
+			assert(out[MIN][i] == $::min(a[i], b[i]));
+			assert(out[MAX][i] == $::max(a[i], b[i]));
+			assert(out[ABS][i] == $::fabs(a[i]));
+			assert(out[ROUND][i] == $::rint(a[i] * 4));
+			assert(out[SQRT][i] == $::sqrt($::fabs(a[i])));
+			assert(out[BLEND][i] == (a[i] < b[i] ? b[i] : a[i]));
+			assert(out[MASK][i] == (a[i] < b[i] && a[i] >= 0 ? 1 : 0));
+			assert(out[GATHER][i] == a[(7 * i + 3) % LEN]);
+			assert(out[LOAD_TAIL][i] == (l < n ? a[i] : 0));
+			assert(out[STORE_TAIL][i] == (l < n ? a[i] : -1));
+			assert(out[POW2][i] == $::ldexp(T(1), int($::rint(a[i] * 8))));
+		}
+		for (uns c = 0; c < LEN / W; ++c) {
+			bool any = false, all = true;
+			T sum = 0, lo = a[c * W], hi = a[c * W];
+			for (uns l = 0; l < W; ++l) {
+				const T x = a[c * W + l];
+				any |= x < b[c * W + l];
+				all &= x < b[c * W + l];
+				sum += x;
+				lo = $::min(lo, x);
+				hi = $::max(hi, x);
+			}
+			assert(reds[ANY][c] == any);
+			assert(reds[ALL][c] == all);
+			assert($::fabs(reds[SUM][c] - sum) <= 1e-5 * W * 10);
+			assert(reds[RMIN][c] == lo);
+			assert(reds[RMAX][c] == hi);
+		}
+	});
+}
+
+template<typename T>
+struct Exp {
+	typedef void (*Kernel)(const T*, T*, T*, uns);
+
+	template<typename V>
+	MEAVE_SIMD_INLINE static void body(const T *x, T *e, T *s, const uns len) noexcept {
+		uns _ = 0;
+		for (; _ + V::LANES <= len; _ += V::LANES) {
+			exp(V::load(&x[_])).store(&e[_]);
+			sigmoid(V::load(&x[_])).store(&s[_]);
+		}
+		exp(V::load(&x[_], len - _)).store(&e[_], len - _);
+		sigmoid(V::load(&x[_], len - _)).store(&s[_], len - _);
+	}
+
+	static void scalar(const T *x, T *e, T *s, const uns len) noexcept {
+		body<simd::Native<T, cpu::SCALAR>>(x, e, s, len);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_SSE42)
+	static void sse42(const T *x, T *e, T *s, const uns len) noexcept {
+		body<simd::Native<T, cpu::SSE42>>(x, e, s, len);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX2)
+	static void avx2(const T *x, T *e, T *s, const uns len) noexcept {
+		body<simd::Native<T, cpu::AVX2>>(x, e, s, len);
+	}
+
+	MEAVE_TARGET(MEAVE_ISA_AVX512)
+	static void avx512(const T *x, T *e, T *s, const uns len) noexcept {
+		body<simd::Native<T, cpu::AVX512>>(x, e, s, len);
+	}
+
+	static const cpu::Kernels<Kernel> kernels;
+};
+
+template<typename T>
+const cpu::Kernels<typename Exp<T>::Kernel> Exp<T>::kernels{{ &scalar, &sse42, &avx2, &avx512 }};
+
+/**
+ * exp() within 2 ulp of libm's (itself within 1 ulp) inside the clamping
+ *   range, sigmoid() within 2 ulp + eps of 1 / (1 + exp(-x)).
+ */
+template<typename T>
+void check_exp() {
+	typedef simd::aux::ExpConsts<T> C;
+	const uns LEN = 100003;
+	const T eps = $::numeric_limits<T>::epsilon();
+	$::vector<T> x(LEN), e(LEN), s(LEN);
+	for (uns _ = 0; _ < LEN; ++_)
+		x[_] = C::LO + (C::HI - C::LO) * _ / (LEN - 1);
+
+	for_levels([&](const cpu::Level level) {
+		Exp<T>::kernels.impl(level)(x.data(), e.data(), s.data(), LEN);
+		T max_err = 0;
+		for (uns _ = 0; _ < LEN; ++_) {
+			const T expected = $::exp(x[_]);
+			max_err = $::max(max_err, $::fabs(e[_] / expected - 1));
+			assert($::fabs(s[_] - 1 / (1 + $::exp(-x[_]))) <= 3 * eps);
+		}
+		assert(max_err <= 3 * eps);
+		$::cerr << "exp<" << sizeof(T) << "> " << cpu::name(level) << ": " << max_err / eps << " eps" << $::endl;
+	});
+}
+
+typedef void (*PadeKernel)(const float*, float*, uns);
+
+template<typename V>
+MEAVE_SIMD_INLINE void pade_body(const float *src, float *dst, const uns len) noexcept {
+	for (uns _ = 0; _ + V::LANES <= len; _ += V::LANES) {
+		V num, den;
+		simd::exp_pade22(V::load(&src[_]), num, den);
+		(num / den).store(&dst[_]);
+	}
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+void pade_vec_avx2(const float *src, float *dst, const uns len) noexcept {
+	pade_body<simd::Native<float, cpu::AVX2>>(src, dst, len);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+void pade_vec_avx512(const float *src, float *dst, const uns len) noexcept {
+	pade_body<simd::Native<float, cpu::AVX512>>(src, dst, len);
+}
+
+/**
+ * The intrinsics exp_approx(float*, ...) had before simd::Vec.
+ */
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+void pade_intrin_avx2(const float *src, float *dst, const uns len) noexcept {
+	for (uns _ = 0; _ + 8 <= len; _ += 8) {
+		__m256 x = _mm256_loadu_ps(&src[_]);
+		x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-87.f)), _mm256_set1_ps(+88.f));
+		const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		const __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693147181f), x);
+		const __m256 r2 = _mm256_mul_ps(r, r);
+		const __m256 two_n = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23));
+		const __m256 twelve = _mm256_set1_ps(12.f);
+		const __m256 num = _mm256_mul_ps(_mm256_add_ps(_mm256_fmadd_ps(_mm256_set1_ps(6.f), r, twelve), r2), two_n);
+		const __m256 den = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(6.f), r, twelve), r2);
+		_mm256_storeu_ps(&dst[_], _mm256_div_ps(num, den));
+	}
+}
+
+// GCC 12 warns about the undefined sources of unmasked AVX-512 intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+void pade_intrin_avx512(const float *src, float *dst, const uns len) noexcept {
+	for (uns _ = 0; _ + 16 <= len; _ += 16) {
+		__m512 x = _mm512_loadu_ps(&src[_]);
+		x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(-87.f)), _mm512_set1_ps(+88.f));
+		const __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.44269504f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		const __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693147181f), x);
+		const __m512 r2 = _mm512_mul_ps(r, r);
+		const __m512 two_n = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23));
+		const __m512 twelve = _mm512_set1_ps(12.f);
+		const __m512 num = _mm512_mul_ps(_mm512_add_ps(_mm512_fmadd_ps(_mm512_set1_ps(6.f), r, twelve), r2), two_n);
+		const __m512 den = _mm512_add_ps(_mm512_fnmadd_ps(_mm512_set1_ps(6.f), r, twelve), r2);
+		_mm512_storeu_ps(&dst[_], _mm512_div_ps(num, den));
+	}
+}
+
+#pragma GCC diagnostic pop
+
+/**
+ * The same results as the intrinsics and the same time, within noise.
+ */
+void check_overhead() {
+	const uns LEN = 4096;
+	$::vector<float> x(LEN), y(LEN), z(LEN);
+	for (uns _ = 0; _ < LEN; ++_)
+		x[_] = (_ - 2048.f) / 24.f;
+
+	const auto run = [&](const char *name, const PadeKernel vec, const PadeKernel intrin) {
+		vec(x.data(), y.data(), LEN);
+		intrin(x.data(), z.data(), LEN);
+		assert(!::memcmp(y.data(), z.data(), LEN * sizeof(float)));
+
+		double best[2] = { 1e9, 1e9 };
+		for (uns rep = 0; rep < 20; ++rep) {
+			const PadeKernel kernels[2] = { vec, intrin };
+			for (uns k = 0; k < 2; ++k) {
+				const double t0 = meave::gettime();
+				for (uns _ = 0; _ < 100; ++_)
+					kernels[k](x.data(), y.data(), LEN);
+				best[k] = $::min(best[k], meave::gettime() - t0);
+			}
+		}
+		$::cerr << "exp_pade22 " << name << ": Vec " << best[0] / 100 / LEN * 1e9 << " ns, intrinsics " << best[1] / 100 / LEN * 1e9 << " ns" << $::endl;
+	};
+	if (cpu::detected() >= cpu::AVX2)
+		run("avx2", &pade_vec_avx2, &pade_intrin_avx2);
+	if (cpu::detected() >= cpu::AVX512)
+		run("avx512", &pade_vec_avx512, &pade_intrin_avx512);
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	Random rand(42);
+
+	check_ops<float>(rand);
+	check_ops<double>(rand);
+	check_exp<float>();
+	check_exp<double>();
+	check_overhead();
+
+	return 0;
+}
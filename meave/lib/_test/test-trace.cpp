@@ -0,0 +1,118 @@
+/*
+ * g++ -std=gnu++1y -I../../.. -O2 -pthread -o test-trace test-trace.cpp -lglog
+ */
+
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "../gettime.hpp"
+#include "../trace.hpp"
+
+namespace {
+
+constexpr unsigned THREADS = 4;
+constexpr unsigned SCOPES = 1000;
+
+/**
+ * Nested scopes, the inner one is recorded (ends) first.
+ */
+void work(volatile unsigned &sink) {
+	const meave::trace::Scope outer("outer", "test");
+	for (unsigned _ = 0; _ < 100; ++_)
+		sink = sink + _;
+	const meave::trace::Scope inner("inner", "test");
+	for (unsigned _ = 0; _ < 100; ++_)
+		sink = sink + _;
+}
+
+void check_trace(const char *file_name) {
+	auto &tracer = meave::trace::Tracer::instance();
+	volatile unsigned sink = 0;
+
+	// Not started: nothing recorded.
+	work(sink);
+
+	tracer.start(file_name);
+	std::vector<std::thread> threads;
+	for (unsigned th = 0; th < THREADS; ++th) {
+		threads.emplace_back([&sink]() {
+			for (unsigned _ = 0; _ < SCOPES; ++_)
+				work(sink);
+		});
+	}
+	for (auto &$: threads)
+		$.join();
+	tracer.pause();
+	work(sink);
+	tracer.resume();
+	work(sink);
+	assert(tracer.stop() == 0);
+
+	std::ifstream in(file_name);
+	std::string line;
+	std::getline(in, line);
+	assert(line == "[");
+	unsigned outer = 0, inner = 0;
+	bool closed = false;
+	while (std::getline(in, line)) {
+		if (line == "]") {
+			closed = true;
+			continue;
+		}
+		assert(!closed);
+		assert(line.front() == '{' && (line.back() == ',' || line.back() == '}'));
+		assert(line.find("\"ph\":\"X\"") != std::string::npos);
+		double ts = -1, dur = -1;
+		assert(2 == ::sscanf(line.substr(line.find("\"ts\":")).c_str(), "\"ts\":%lf,\"dur\":%lf", &ts, &dur));
+		assert(ts >= 0 && dur >= 0);
+		outer += line.find("\"name\":\"outer\"") != std::string::npos;
+		inner += line.find("\"name\":\"inner\"") != std::string::npos;
+	}
+	assert(closed);
+	assert(outer == THREADS * SCOPES + 1 && inner == outer);
+	std::cerr << outer + inner << " events" << std::endl;
+	::unlink(file_name);
+}
+
+void measure(const char *file_name) {
+	constexpr unsigned REPEAT = 1000000;
+	auto &tracer = meave::trace::Tracer::instance();
+	volatile unsigned sink = 0;
+
+	const double t0 = meave::gettime();
+	for (unsigned _ = 0; _ < REPEAT; ++_) {
+		const meave::trace::Scope scope("off", "test");
+		sink = sink + 1;
+	}
+	const double t1 = meave::gettime();
+
+	tracer.start(file_name);
+	const double t2 = meave::gettime();
+	for (unsigned _ = 0; _ < REPEAT; ++_) {
+		const meave::trace::Scope scope("on", "test");
+		sink = sink + 1;
+	}
+	const double t3 = meave::gettime();
+	const auto dropped = tracer.stop();
+	::unlink(file_name);
+
+	std::cerr << "scope: " << (t1 - t0) / REPEAT * 1e9 << " ns off, " << (t3 - t2) / REPEAT * 1e9 << " ns on (" << dropped << " dropped)" << std::endl;
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_trace("./test-trace.json");
+	measure("./test-trace.json");
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <meave/lib/utils.hpp>
+#include <meave/lib/bench/bench.hpp>
+
+/*
+ * Checks statistics of samples, the JSON file and comparison with it as
+ *   a baseline.
+ */
+
+namespace {
+
+namespace mb = meave::bench;
+
+void check_stats() {
+	const mb::Stats s = mb::Stats::of({ 4, 1, 3, 2 });
+	assert(s.n_ == 4);
+	assert(s.min_ == 1 && s.max_ == 4);
+	assert(s.median_ == 2.5 && s.mean_ == 2.5);
+	assert(::fabs(s.stddev_ - ::sqrt(5. / 3)) < 1e-12);
+	assert(::fabs(s.ci95_ - 3.182 * s.stddev_ / 2 / 2.5) < 1e-12);
+
+	const mb::Stats one = mb::Stats::of({ 7 });
+	assert(one.median_ == 7 && one.stddev_ == 0 && $::isinf(one.ci95_));
+	assert(mb::Stats::of({}).n_ == 0);
+
+	assert(mb::t975(1) == 12.706 && mb::t975(30) == 2.042 && mb::t975(1000) == 1.980);
+}
+
+mb::Options quick() {
+	mb::Options $$;
+	$$.warmup_ = 0.001;
+	$$.sample_ = 0.0005;
+	$$.max_time_ = 0.1;
+	$$.counters_ = false;
+	return $$;
+}
+
+void check_baseline() {
+	char json[] = "/tmp/test-bench-XXXXXX";
+	const int fd = ::mkstemp(json);
+	assert(fd != -1);
+	::close(fd);
+
+	const $::string name = "sum \"quoted\"";
+	{
+		mb::Options opt = quick();
+		opt.json_ = json;
+		mb::Runner runner(opt);
+		uns x = 1;
+		const mb::Result *r = runner.run(name, [&]() {
+			for (uns _ = 0; _ < 100; ++_)
+				x += _;
+			mb::do_not_optimize(x);
+		}, mb::Throughput::elems(100));
+		assert(r && r->calls_ >= 1);
+		assert(r->ns_.n_ >= opt.min_samples_ && r->ns_.n_ <= opt.max_samples_);
+		assert(r->ns_.min_ <= r->ns_.median_ && r->ns_.median_ <= r->ns_.max_);
+		assert(r->per_second() > 0 && !r->baseline_);
+		assert(runner.finish() == 0);
+	}
+
+	const auto baseline = mb::aux::read_baseline(json);
+	assert(baseline.size() == 1 && baseline.count(name) && baseline.at(name) > 0);
+
+	{
+		mb::Options opt = quick();
+		opt.baseline_ = json;
+		opt.filter_ = "quoted";
+		mb::Runner runner(opt);
+		assert(!runner.run("other", []() {}));
+		const mb::Result *r = runner.run(name, []() {});
+		assert(r && r->baseline_ == baseline.at(name));
+		assert(r->change() == r->ns_.median_ / r->baseline_ - 1);
+		assert(runner.finish() == 0);
+	}
+	::unlink(json);
+
+	mb::Result slower{};
+	slower.ns_ = mb::Stats::of({ 110, 110 });
+	slower.baseline_ = 100;
+	assert(slower.regression(0.05) && !slower.regression(0.2));
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_stats();
+	check_baseline();
+
+	return 0;
+}
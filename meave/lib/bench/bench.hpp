@@ -0,0 +1,435 @@
+#ifndef MEAVE_LIB_BENCH_BENCH_HPP_INCLUDED
+#	define MEAVE_LIB_BENCH_BENCH_HPP_INCLUDED
+
+#	include <chrono>
+#	include <cmath>
+#	include <cstdint>
+#	include <cstdio>
+#	include <cstdlib>
+#	include <cstring>
+#	include <ctime>
+#	include <map>
+#	include <memory>
+#	include <string>
+#	include <vector>
+
+#	include <sched.h>
+#	include <unistd.h>
+
+#	include "meave/lib/bench/counters.hpp"
+#	include "meave/lib/bench/stats.hpp"
+#	include "meave/lib/cpu.hpp"
+#	include "meave/lib/error.hpp"
+#	include "meave/lib/utils.hpp"
+
+/*
+ * Harness of micro and macro benchmarks:
+ *
+ *	meave::bench::Runner runner;
+ *	runner.run("crc32c", [&]() {
+ *		meave::bench::do_not_optimize(crc32c(p, len, 0));
+ *	}, meave::bench::Throughput::bytes(len));
+ *	return runner.finish() ? 1 : 0;
+ *
+ * A benchmark is a function called over and over: warmed up and timed to
+ *   choose how many calls make a sample of Options::sample_ seconds, then
+ *   sampled until the mean is known to Options::ci_ (or time is up). The
+ *   thread is pinned to its CPU meanwhile. Results go to stderr, with
+ *   MEAVE_BENCH_JSON also to a JSON file, and MEAVE_BENCH_BASELINE names
+ *   such a file of an earlier run to compare with.
+ */
+
+namespace meave { namespace bench {
+
+/**
+ * Makes the compiler believe value is used, so that its computation is
+ *   not optimized out; nothing is stored.
+ */
+template<typename T>
+inline void do_not_optimize(const T &value) noexcept {
+	__asm__ __volatile__("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * As above, and the compiler must also assume value changed, e.g. to keep
+ *   a loop-invariant input from being hoisted out of the benchmark.
+ */
+template<typename T>
+inline void do_not_optimize(T &value) noexcept {
+	__asm__ __volatile__("" : "+r,m"(value) : : "memory");
+}
+
+/**
+ * Makes the compiler believe all memory is read and written here, e.g.
+ *   so that stores to a buffer are not dropped.
+ */
+inline void clobber_memory() noexcept {
+	__asm__ __volatile__("" : : : "memory");
+}
+
+/**
+ * Work of one call of a benchmark, for GB/s or elements/s and cycles per
+ *   byte or element.
+ */
+struct Throughput {
+	enum Unit { NONE, BYTES, ELEMS };
+
+	Unit unit_;
+	double per_call_;
+
+	static Throughput bytes(const double n) noexcept {
+		return Throughput{BYTES, n};
+	}
+
+	static Throughput elems(const double n) noexcept {
+		return Throughput{ELEMS, n};
+	}
+};
+
+struct Options {
+	enum : int { CURRENT = -1, NONE = -2 };
+
+	double warmup_;	///< Seconds of calls before sampling.
+	double sample_;	///< Seconds of a sample at least.
+	uns min_samples_;
+	uns max_samples_;
+	double max_time_;	///< Seconds of sampling of a benchmark at most.
+	double ci_;	///< Enough samples when Stats::ci95_ is below.
+	int cpu_;	///< CPU to pin the thread to, CURRENT or NONE.
+	bool counters_;	///< Hardware counters, if there are any.
+	double tolerance_;	///< Slower than the baseline by more, beyond ci95_, is a regression.
+	$::string filter_;	///< Only benchmarks with this in the name.
+	$::string json_;	///< File to write results to.
+	$::string baseline_;	///< File of results to compare with.
+
+	Options() noexcept
+	:	warmup_(0.05)
+	,	sample_(0.01)
+	,	min_samples_(5)
+	,	max_samples_(200)
+	,	max_time_(2)
+	,	ci_(0.01)
+	,	cpu_(CURRENT)
+	,	counters_(true)
+	,	tolerance_(0.05) {
+	}
+
+	/**
+	 * Defaults changed by the environment: MEAVE_BENCH_JSON,
+	 *   MEAVE_BENCH_BASELINE, MEAVE_BENCH_FILTER, MEAVE_BENCH_CPU (a number
+	 *   or "none"), MEAVE_BENCH_COUNTERS=0, MEAVE_BENCH_TIME (max_time_) and
+	 *   MEAVE_BENCH_TOLERANCE.
+	 */
+	static Options from_env() {
+		Options $$;
+		if (const char *s = ::getenv("MEAVE_BENCH_JSON"))
+			$$.json_ = s;
+		if (const char *s = ::getenv("MEAVE_BENCH_BASELINE"))
+			$$.baseline_ = s;
+		if (const char *s = ::getenv("MEAVE_BENCH_FILTER"))
+			$$.filter_ = s;
+		if (const char *s = ::getenv("MEAVE_BENCH_CPU"))
+			$$.cpu_ = !::strcmp(s, "none") ? NONE : ::atoi(s);
+		if (const char *s = ::getenv("MEAVE_BENCH_COUNTERS"))
+			$$.counters_ = ::atoi(s);
+		if (const char *s = ::getenv("MEAVE_BENCH_TIME"))
+			$$.max_time_ = ::atof(s);
+		if (const char *s = ::getenv("MEAVE_BENCH_TOLERANCE"))
+			$$.tolerance_ = ::atof(s);
+		return $$;
+	}
+};
+
+struct Result {
+	$::string name_;
+	::uint64_t calls_;	///< Per sample.
+	Stats ns_;	///< Nanoseconds per call.
+	Throughput throughput_;
+	double cycles_;	///< Per call, median of samples; 0 without counters.
+	double instructions_;
+	double baseline_;	///< ns_.median_ of the baseline, 0 if it has none.
+
+	/**
+	 * @return Bytes or elements per second.
+	 */
+	double per_second() const noexcept {
+		return throughput_.per_call_ / ns_.median_ * 1e9;
+	}
+
+	/**
+	 * @return Relative change of the median against the baseline.
+	 */
+	double change() const noexcept {
+		return baseline_ ? ns_.median_ / baseline_ - 1 : 0;
+	}
+
+	bool regression(const double tolerance) const noexcept {
+		return baseline_ && change() > tolerance + ns_.ci95_;
+	}
+};
+
+namespace aux {
+
+inline double now() noexcept {
+	return $::chrono::duration<double>($::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Writes s as a JSON string.
+ */
+inline void json_string($::FILE *out, const $::string &s) noexcept {
+	::fputc('"', out);
+	for (const char c: s) {
+		if (c == '"' || c == '\\')
+			::fprintf(out, "\\%c", c);
+		else if ((unsigned char)c < 0x20)
+			::fprintf(out, "\\u%04x", c);
+		else
+			::fputc(c, out);
+	}
+	::fputc('"', out);
+}
+
+/**
+ * Writes x as a JSON number, null where JSON has none (inf, NaN).
+ */
+inline void json_number($::FILE *out, const char *key, const double x) noexcept {
+	if ($::isfinite(x))
+		::fprintf(out, ",\"%s\":%.9g", key, x);
+	else
+		::fprintf(out, ",\"%s\":null", key);
+}
+
+/**
+ * @return Medians of ns per call by names of benchmarks in file_name
+ *   written by Runner::finish(), one benchmark per line.
+ */
+inline $::map<$::string, double> read_baseline(const $::string &file_name) {
+	$::unique_ptr<$::FILE, int(*)($::FILE*)> in(::fopen(file_name.c_str(), "r"), ::fclose);
+	if (!in)
+		throw Error("Cannot open baseline: %s: %m", file_name.c_str());
+
+	$::map<$::string, double> $$;
+	$::string line;
+	for (int c; (c = ::fgetc(in.get())) != EOF; ) {
+		if (c != '\n') {
+			line += c;
+			continue;
+		}
+		static const char NAME[] = "{\"name\":\"", MEDIAN[] = "\"ns_median\":";
+		const ::size_t median = line.find(MEDIAN);
+		if (!line.compare(0, sizeof(NAME) - 1, NAME) && median != $::string::npos) {
+			$::string name;
+			for (::size_t _ = sizeof(NAME) - 1; _ < line.size() && line[_] != '"'; ++_)
+				name += line[_] == '\\' ? line[++_] : line[_];
+			$$[name] = ::strtod(&line[median + sizeof(MEDIAN) - 1], nullptr);
+		}
+		line.clear();
+	}
+	return $$;
+}
+
+/**
+ * @return "12.3 ms" and the like.
+ */
+inline $::string human_time(const double ns) {
+	char $$[32];
+	if (ns < 1e3)
+		::snprintf($$, sizeof($$), "%.3g ns", ns);
+	else if (ns < 1e6)
+		::snprintf($$, sizeof($$), "%.3g us", ns / 1e3);
+	else if (ns < 1e9)
+		::snprintf($$, sizeof($$), "%.3g ms", ns / 1e6);
+	else
+		::snprintf($$, sizeof($$), "%.3g s", ns / 1e9);
+	return $$;
+}
+
+} /* namespace aux */
+
+class Runner {
+private:
+	const Options opt_;
+	$::unique_ptr<Counters> counters_;	///< Null when switched off.
+	::cpu_set_t mask_;	///< Affinity before pinning.
+	int cpu_;	///< Pinned to, -1 if not.
+	$::map<$::string, double> baseline_;
+	$::vector<Result> results_;
+
+	template<typename Fn>
+	static double batch(Fn &fn, const ::uint64_t calls) {
+		const double t0 = aux::now();
+		for (::uint64_t _ = 0; _ < calls; ++_) {
+			fn();
+			__asm__ __volatile__("");	// Keeps the calls, even of an empty fn.
+		}
+		return aux::now() - t0;
+	}
+
+	void print(const Result &r) const {
+		::fprintf(stderr, "%s: %s +-%.2g%% (%u x %llu calls)", r.name_.c_str(), aux::human_time(r.ns_.median_).c_str(),
+			100 * r.ns_.ci95_, r.ns_.n_, (unsigned long long)r.calls_);
+		static const char *UNIT[] = { "", "B", "elem" };
+		if (r.throughput_.unit_ == Throughput::BYTES)
+			::fprintf(stderr, ", %.3g GB/s", r.per_second() / 1e9);
+		else if (r.throughput_.unit_ == Throughput::ELEMS && r.per_second() >= 1e9)
+			::fprintf(stderr, ", %.3g Gelem/s", r.per_second() / 1e9);
+		else if (r.throughput_.unit_ == Throughput::ELEMS)
+			::fprintf(stderr, ", %.3g Melem/s", r.per_second() / 1e6);
+		if (r.cycles_) {
+			if (r.throughput_.unit_ != Throughput::NONE)
+				::fprintf(stderr, ", %.3g cycles/%s", r.cycles_ / r.throughput_.per_call_, UNIT[r.throughput_.unit_]);
+			else
+				::fprintf(stderr, ", %.3g cycles", r.cycles_);
+			::fprintf(stderr, ", IPC %.2f", r.instructions_ / r.cycles_);
+		}
+		if (r.baseline_)
+			::fprintf(stderr, ", baseline %+.1f%%%s", 100 * r.change(), r.regression(opt_.tolerance_) ? " REGRESSION" : "");
+		::fputc('\n', stderr);
+	}
+
+	void write_json() const {
+		$::unique_ptr<$::FILE, int(*)($::FILE*)> out(::fopen(opt_.json_.c_str(), "w"), ::fclose);
+		if (!out)
+			throw Error("Cannot open: %s: %m", opt_.json_.c_str());
+		char host[256] = "";
+		::gethostname(host, sizeof(host) - 1);
+		::fprintf(out.get(), "{\n\"context\":{\"time\":%lld,\"host\":", (long long)::time(nullptr));
+		aux::json_string(out.get(), host);
+		::fprintf(out.get(), ",\"cpu\":\"%s\",\"pinned\":%d,\"counters\":", cpu::name(cpu::level()), cpu_);
+		aux::json_string(out.get(), !counters_ ? "off" : counters_->ok() ? "on" : counters_->why());
+		::fputs("},\n\"benchmarks\":[\n", out.get());
+		for (const auto &r: results_) {
+			::fputs("{\"name\":", out.get());
+			aux::json_string(out.get(), r.name_);
+			::fprintf(out.get(), ",\"calls\":%llu,\"samples\":%u", (unsigned long long)r.calls_, r.ns_.n_);
+			aux::json_number(out.get(), "ns_median", r.ns_.median_);
+			aux::json_number(out.get(), "ns_mean", r.ns_.mean_);
+			aux::json_number(out.get(), "ns_min", r.ns_.min_);
+			aux::json_number(out.get(), "ns_max", r.ns_.max_);
+			aux::json_number(out.get(), "ns_stddev", r.ns_.stddev_);
+			aux::json_number(out.get(), "ci95", r.ns_.ci95_);
+			if (r.throughput_.unit_ != Throughput::NONE) {
+				const bool bytes = r.throughput_.unit_ == Throughput::BYTES;
+				aux::json_number(out.get(), bytes ? "bytes" : "elems", r.throughput_.per_call_);
+				aux::json_number(out.get(), "per_second", r.per_second());
+			}
+			if (r.cycles_) {
+				aux::json_number(out.get(), "cycles", r.cycles_);
+				aux::json_number(out.get(), "instructions", r.instructions_);
+			}
+			if (r.baseline_)
+				aux::json_number(out.get(), "baseline_ns", r.baseline_);
+			::fputs(&r == &results_.back() ? "}\n" : "},\n", out.get());
+		}
+		::fputs("]\n}\n", out.get());
+		if (::ferror(out.get()))
+			throw Error("Cannot write: %s", opt_.json_.c_str());
+	}
+
+public:
+	/**
+	 * Pins the thread (until destruction) and reads the baseline.
+	 */
+	explicit Runner(const Options &opt = Options::from_env())
+	:	opt_(opt)
+	,	counters_(opt.counters_ ? new Counters() : nullptr)
+	,	cpu_(-1) {
+		if (!opt_.baseline_.empty())
+			baseline_ = aux::read_baseline(opt_.baseline_);
+
+		if (opt_.cpu_ != Options::NONE) {
+			if (::sched_getaffinity(0, sizeof(mask_), &mask_))
+				throw Error("Cannot get affinity: %m");
+			const int cpu = opt_.cpu_ == Options::CURRENT ? ::sched_getcpu() : opt_.cpu_;
+			::cpu_set_t one;
+			CPU_ZERO(&one);
+			CPU_SET(cpu, &one);
+			if (::sched_setaffinity(0, sizeof(one), &one))
+				throw Error("Cannot pin to CPU %d: %m", cpu);
+			cpu_ = cpu;
+		}
+
+		::fprintf(stderr, "bench: %s, pinned to %d, counters %s\n", cpu::name(cpu::level()), cpu_,
+			!counters_ ? "off" : counters_->ok() ? "on" : counters_->why().c_str());
+	}
+	Runner(const Runner&) = delete;
+	Runner &operator=(const Runner&) = delete;
+
+	~Runner() noexcept {
+		if (cpu_ != -1)
+			::sched_setaffinity(0, sizeof(mask_), &mask_);
+	}
+
+	/**
+	 * Measures fn(), a call of which does throughput of work.
+	 * @return The result, null when the name doesn't pass the filter.
+	 */
+	template<typename Fn>
+	const Result *run(const $::string &name, Fn &&fn, const Throughput &throughput = Throughput()) {
+		if (name.find(opt_.filter_) == $::string::npos)
+			return nullptr;
+
+		// Warm-up, doubling calls until a batch takes a sample.
+		::uint64_t calls = 1;
+		double spent = 0;
+		for (;;) {
+			const double t = batch(fn, calls);
+			spent += t;
+			if (t >= opt_.sample_ || calls >> 40) {
+				calls = $::max<::uint64_t>(1, calls * opt_.sample_ / t);
+				break;
+			}
+			calls *= 2;
+		}
+		while (spent < opt_.warmup_)
+			spent += batch(fn, calls);
+
+		$::vector<double> ns, cycles, instructions;
+		Stats stats{};
+		const double t0 = aux::now();
+		do {
+			if (counters_)
+				counters_->start();
+			const double t = batch(fn, calls);
+			if (counters_) {
+				const Counters::Values v = counters_->stop();
+				cycles.push_back(v.cycles_ / calls);
+				instructions.push_back(v.instructions_ / calls);
+			}
+			ns.push_back(t / calls * 1e9);
+			stats = Stats::of(ns);
+		} while (stats.n_ < opt_.max_samples_
+			&& (stats.n_ < opt_.min_samples_ || (stats.ci95_ > opt_.ci_ && aux::now() - t0 < opt_.max_time_)));
+
+		const auto baseline = baseline_.find(name);
+		results_.push_back(Result{name, calls, stats, throughput,
+			Stats::of(cycles).median_, Stats::of(instructions).median_,
+			baseline == baseline_.end() ? 0 : baseline->second});
+		print(results_.back());
+		return &results_.back();
+	}
+
+	const $::vector<Result> &results() const noexcept {
+		return results_;
+	}
+
+	/**
+	 * Writes the JSON file, if any.
+	 * @return Number of regressions against the baseline.
+	 */
+	uns finish() {
+		if (!opt_.json_.empty())
+			write_json();
+		uns $$ = 0;
+		for (const auto &r: results_)
+			$$ += r.regression(opt_.tolerance_);
+		if (!opt_.baseline_.empty())
+			::fprintf(stderr, "bench: %u of %zu slower than %s\n", $$, results_.size(), opt_.baseline_.c_str());
+		return $$;
+	}
+};
+
+} } /* namespace meave::bench */
+
+#endif // MEAVE_LIB_BENCH_BENCH_HPP_INCLUDED
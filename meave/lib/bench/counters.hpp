@@ -0,0 +1,105 @@
+#ifndef MEAVE_LIB_BENCH_COUNTERS_HPP_INCLUDED
+#	define MEAVE_LIB_BENCH_COUNTERS_HPP_INCLUDED
+
+#	include <cstdint>
+#	include <cstring>
+#	include <string>
+
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+
+#	include "meave/lib/str_printf.hpp"
+#	include "meave/lib/utils.hpp"
+
+namespace meave { namespace bench {
+
+/**
+ * CPU cycles and retired instructions of the calling thread in user space,
+ *   by perf_event_open(2). They are often not there (a container, a VM
+ *   without a PMU, kernel.perf_event_paranoid > 2): then ok() is false,
+ *   why() says why and benchmarks go on without them.
+ */
+class Counters {
+public:
+	struct Values {
+		double cycles_;
+		double instructions_;
+	};
+
+private:
+	enum : uns { CYCLES, INSTRUCTIONS, NUM };
+
+	int fd_[NUM];
+	$::string why_;
+
+	static int open(const ::uint64_t config, const int group) noexcept {
+		struct ::perf_event_attr attr;
+		::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config;
+		attr.disabled = group == -1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return ::syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+	}
+
+public:
+	Counters() noexcept {
+		fd_[CYCLES] = open(PERF_COUNT_HW_CPU_CYCLES, -1);
+		fd_[INSTRUCTIONS] = fd_[CYCLES] == -1 ? -1 : open(PERF_COUNT_HW_INSTRUCTIONS, fd_[CYCLES]);
+		if (fd_[INSTRUCTIONS] == -1)
+			why_ = str_printf("perf_event_open: %m");
+	}
+	Counters(const Counters&) = delete;
+	Counters &operator=(const Counters&) = delete;
+
+	~Counters() noexcept {
+		for (const int $: fd_) {
+			if ($ != -1)
+				::close($);
+		}
+	}
+
+	bool ok() const noexcept {
+		return why_.empty();
+	}
+
+	const $::string &why() const noexcept {
+		return why_;
+	}
+
+	void start() noexcept {
+		if (!ok())
+			return;
+		::ioctl(fd_[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		::ioctl(fd_[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+
+	/**
+	 * @return Counts since start(), scaled up when the kernel multiplexed
+	 *   the counters; zeros when they are not there.
+	 */
+	Values stop() noexcept {
+		Values $${0, 0};
+		if (!ok())
+			return $$;
+		::ioctl(fd_[CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+		// nr, time_enabled, time_running, values[nr]
+		::uint64_t buf[3 + NUM];
+		if (::read(fd_[CYCLES], buf, sizeof(buf)) != ssize_t(sizeof(buf)) || !buf[2])
+			return $$;
+		const double scale = double(buf[1]) / buf[2];
+		$$.cycles_ = buf[3 + CYCLES] * scale;
+		$$.instructions_ = buf[3 + INSTRUCTIONS] * scale;
+		return $$;
+	}
+};
+
+} } /* namespace meave::bench */
+
+#endif // MEAVE_LIB_BENCH_COUNTERS_HPP_INCLUDED
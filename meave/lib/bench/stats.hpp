@@ -0,0 +1,68 @@
+#ifndef MEAVE_LIB_BENCH_STATS_HPP_INCLUDED
+#	define MEAVE_LIB_BENCH_STATS_HPP_INCLUDED
+
+#	include <algorithm>
+#	include <cmath>
+#	include <vector>
+
+#	include "meave/lib/utils.hpp"
+
+namespace meave { namespace bench {
+
+/**
+ * @return 0.975 quantile of Student's t with dof degrees of freedom,
+ *   rounded up between the tabulated ones.
+ */
+inline double t975(const uns dof) noexcept {
+	static const double TABLE[] = {
+		  12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228
+		, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086
+		, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+	};
+	if (!dof)
+		return HUGE_VAL;
+	if (dof <= sizeof(TABLE) / sizeof(*TABLE))
+		return TABLE[dof - 1];
+	return dof <= 40 ? 2.042 : dof <= 60 ? 2.021 : dof <= 120 ? 2.000 : 1.980;
+}
+
+/**
+ * Summary of samples, e.g. nanoseconds per iteration of a benchmark.
+ */
+struct Stats {
+	uns n_;
+	double min_;
+	double max_;
+	double median_;
+	double mean_;
+	double stddev_;
+	double ci95_;	///< Half-width of the 95% confidence interval of the mean, relative to the mean.
+
+	static Stats of($::vector<double> samples) noexcept {
+		Stats $${};
+		$$.n_ = samples.size();
+		if (!$$.n_)
+			return $$;
+
+		$::sort(samples.begin(), samples.end());
+		$$.min_ = samples.front();
+		$$.max_ = samples.back();
+		$$.median_ = $$.n_ % 2 ? samples[$$.n_ / 2] : (samples[$$.n_ / 2 - 1] + samples[$$.n_ / 2]) / 2;
+
+		double sum = 0;
+		for (const double $: samples)
+			sum += $;
+		$$.mean_ = sum / $$.n_;
+
+		double sq = 0;
+		for (const double $: samples)
+			sq += ($ - $$.mean_) * ($ - $$.mean_);
+		$$.stddev_ = $$.n_ > 1 ? $::sqrt(sq / ($$.n_ - 1)) : 0;
+		$$.ci95_ = $$.n_ > 1 && $$.mean_ ? t975($$.n_ - 1) * $$.stddev_ / $::sqrt(double($$.n_)) / $$.mean_ : HUGE_VAL;
+		return $$;
+	}
+};
+
+} } /* namespace meave::bench */
+
+#endif // MEAVE_LIB_BENCH_STATS_HPP_INCLUDED
@@ -0,0 +1,311 @@
+#ifndef MEAVE_LIB_CHECKPOINT_HPP_INCLUDED
+#	define MEAVE_LIB_CHECKPOINT_HPP_INCLUDED
+
+#	include <cerrno>
+#	include <condition_variable>
+#	include <cstdint>
+#	include <cstring>
+#	include <mutex>
+#	include <string>
+#	include <thread>
+#	include <type_traits>
+#	include <vector>
+
+#	include <fcntl.h>
+#	include <libgen.h>
+#	include <sys/stat.h>
+#	include <sys/types.h>
+#	include <unistd.h>
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+#	include "meave/lib/raii/fd.hpp"
+#	include "meave/lib/trace.hpp"
+
+/**
+ * Crash-consistent checkpoints of an optimizer state.
+ *
+ * The file is a header (magic, version, length and FNV-1a hash of the
+ *   payload) followed by the payload: items put by Out one after another in
+ *   native byte order, without any padding.
+ *
+ * A new checkpoint is written into <file>.tmp, fsync()-ed and renamed over
+ *   the old one, so the file always holds a complete checkpoint. Files it
+ *   refers to (e.g. statistics written up to it) are fsync()-ed before.
+ */
+namespace meave { namespace checkpoint {
+
+namespace aux {
+
+struct Header {
+	char magic_[8];
+	::uint32_t version_;
+	::uint32_t reserved_;
+	::uint64_t len_;
+	::uint64_t hash_;
+};
+
+constexpr char MAGIC[8] = {'M', 'E', 'A', 'V', 'E', 'C', 'K', 'P'};
+constexpr ::uint32_t VERSION = 1;
+
+inline ::uint64_t fnv1a(const char *p, ::size_t len) noexcept {
+	::uint64_t hash = 0xcbf29ce484222325ULL;
+	while (len--) {
+		hash ^= ::uint8_t(*p++);
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+inline bool write_all(const int fd, const char *p, ::size_t len) noexcept {
+	while (len) {
+		const ::ssize_t ret = ::write(fd, p, len);
+		if (ret == -1 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			return false;
+		p += ret;
+		len -= ret;
+	}
+	return true;
+}
+
+} /* namespace aux */
+
+/**
+ * Payload being built.
+ */
+class Out {
+private:
+	$::string buf_;
+
+public:
+	template<typename T>
+	Out &put(const T &$) {
+		static_assert($::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		buf_.append(reinterpret_cast<const char*>(&$), sizeof $);
+		return *this;
+	}
+
+	template<typename T>
+	Out &put(const $::vector<T> &$) {
+		static_assert($::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		put(::uint64_t($.size()));
+		buf_.append(reinterpret_cast<const char*>($.data()), $.size() * sizeof(T));
+		return *this;
+	}
+
+	Out &put(const $::string &$) {
+		put(::uint64_t($.size()));
+		buf_.append($);
+		return *this;
+	}
+
+	const $::string &payload() const noexcept {
+		return buf_;
+	}
+
+	$::string release() noexcept {
+		return $::move(buf_);
+	}
+};
+
+/**
+ * Payload being read, items are got in the same order they were put.
+ */
+class In {
+private:
+	$::string buf_;
+	::size_t off_;
+
+	const char *take(const ::size_t len) {
+		if (buf_.size() - off_ < len)
+			throw Error("Checkpoint is truncated");
+		const char *$$ = &buf_[off_];
+		off_ += len;
+		return $$;
+	}
+
+public:
+	explicit In($::string &&payload) noexcept
+	:	buf_($::move(payload))
+	,	off_(0) {
+	}
+
+	template<typename T>
+	In &get(T &$) {
+		static_assert($::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		::memcpy(&$, take(sizeof $), sizeof $);
+		return *this;
+	}
+
+	/**
+	 * Vector is read only if it has the expected size.
+	 */
+	template<typename T>
+	In &get($::vector<T> &$) {
+		::uint64_t len;
+		get(len);
+		if (len != $.size())
+			throw Error("Checkpoint has %lu items instead of %lu", static_cast<unsigned long>(len), static_cast<unsigned long>($.size()));
+		::memcpy($.data(), take(len * sizeof(T)), len * sizeof(T));
+		return *this;
+	}
+
+	In &get($::string &$) {
+		::uint64_t len;
+		get(len);
+		$.assign(take(len), len);
+		return *this;
+	}
+};
+
+/**
+ * Reads checkpoint from the file.
+ * @return false When there is no checkpoint.
+ * @throw Error When the checkpoint cannot be read or is corrupted.
+ */
+inline bool load(const $::string &file_name, $::string &payload) {
+	const raii::FD fd{::open(file_name.c_str(), O_RDONLY | O_CLOEXEC)};
+	if (!fd) {
+		if (errno == ENOENT)
+			return false;
+		throw Error("Cannot open: %s: %m", file_name.c_str());
+	}
+
+	aux::Header header;
+	if (::ssize_t(sizeof header) != ::read(*fd, &header, sizeof header))
+		throw Error("Cannot read header of checkpoint: %s", file_name.c_str());
+	if (::memcmp(header.magic_, aux::MAGIC, sizeof aux::MAGIC) || header.version_ != aux::VERSION)
+		throw Error("Not a checkpoint of version %u: %s", unsigned(aux::VERSION), file_name.c_str());
+	// Length from a corrupted header must not be allocated.
+	struct ::stat st;
+	if (-1 == ::fstat(*fd, &st))
+		throw Error("Cannot stat: %s: %m", file_name.c_str());
+	if (header.len_ != ::uint64_t(st.st_size) - sizeof header)
+		throw Error("Checkpoint is corrupted, %lu bytes of payload instead of %lu: %s",
+			static_cast<unsigned long>(st.st_size - sizeof header), static_cast<unsigned long>(header.len_), file_name.c_str());
+
+	payload.resize(header.len_);
+	for (::size_t off = 0; off < payload.size(); ) {
+		const ::ssize_t ret = ::read(*fd, &payload[off], payload.size() - off);
+		if (ret == -1 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			throw Error("Cannot read checkpoint: %s: %m", file_name.c_str());
+		off += ret;
+	}
+	if (header.hash_ != aux::fnv1a(payload.data(), payload.size()))
+		throw Error("Checkpoint is corrupted: %s", file_name.c_str());
+
+	return true;
+}
+
+/**
+ * Writes checkpoints in a background thread.
+ *
+ * The caller only hands the payload over, the thread does the I/O (and
+ *   fsync(), which takes long). When the thread doesn't keep up, only the
+ *   newest checkpoint is written.
+ */
+class Writer {
+private:
+	const $::string file_name_;
+	const $::vector<$::string> deps_;	///< Files fsync()-ed before every checkpoint.
+	$::string pending_;
+	bool has_pending_;
+	bool stop_;
+	$::mutex mutex_;
+	$::condition_variable cv_;
+	$::thread thread_;
+
+	bool write(const $::string &payload) const noexcept {
+		const trace::Scope scope("checkpoint", "io");
+		for (const $::string &dep: deps_) {
+			const raii::FD fd{::open(dep.c_str(), O_RDONLY | O_CLOEXEC)};
+			if (!fd || -1 == ::fsync(*fd))
+				return false;
+		}
+
+		const $::string tmp_name = file_name_ + ".tmp";
+		{
+			const raii::FD fd{::open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+			if (!fd)
+				return false;
+
+			aux::Header header{{}, aux::VERSION, 0, payload.size(), aux::fnv1a(payload.data(), payload.size())};
+			::memcpy(header.magic_, aux::MAGIC, sizeof aux::MAGIC);
+			if (!aux::write_all(*fd, reinterpret_cast<const char*>(&header), sizeof header) ||
+			    !aux::write_all(*fd, payload.data(), payload.size()) ||
+			    -1 == ::fsync(*fd))
+				return false;
+		}
+		if (-1 == ::rename(tmp_name.c_str(), file_name_.c_str()))
+			return false;
+
+		// The rename itself must reach the disk too.
+		$::string dir_name = file_name_;
+		const raii::FD dir{::open(::dirname(&dir_name[0]), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+		return dir && -1 != ::fsync(*dir);
+	}
+
+	void run() noexcept {
+		$::string payload;
+		for (;;) {
+			{
+				$::unique_lock<$::mutex> lock(mutex_);
+				cv_.wait(lock, [this]() { return has_pending_ || stop_; });
+				if (!has_pending_)
+					return;
+				payload.swap(pending_);
+				has_pending_ = false;
+			}
+
+			if (!write(payload))
+				LOG(ERROR) << "Cannot write checkpoint " << file_name_ << ": " << ::strerror(errno);
+		}
+	}
+
+public:
+	/**
+	 * @param deps Files the checkpoints refer to; their data written before
+	 *   a checkpoint is handed over reaches the disk before the checkpoint.
+	 */
+	explicit Writer(const $::string &file_name, const $::vector<$::string> &deps = $::vector<$::string>())
+	:	file_name_(file_name)
+	,	deps_(deps)
+	,	has_pending_(false)
+	,	stop_(false)
+	,	thread_([this]() { run(); }) {
+	}
+	Writer(const Writer&) = delete;
+	Writer &operator=(const Writer&) = delete;
+
+	/**
+	 * Hands the checkpoint over to the thread, doesn't wait for any I/O.
+	 */
+	void operator()(Out &&out) {
+		{
+			const $::lock_guard<$::mutex> lock(mutex_);
+			pending_ = out.release();
+			has_pending_ = true;
+		}
+		cv_.notify_one();
+	}
+
+	/**
+	 * Writes the last checkpoint handed over and stops the thread.
+	 */
+	~Writer() noexcept {
+		{
+			const $::lock_guard<$::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		cv_.notify_one();
+		thread_.join();
+	}
+};
+
+} } /* namespace meave::checkpoint */
+
+#endif // MEAVE_LIB_CHECKPOINT_HPP_INCLUDED
@@ -8,24 +8,25 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <immintrin.h>
 
-namespace meave { namespace checksum {
-
-typedef ::uint64_t FletcherChecksum __attribute__((vector_size(32)));
+#include "meave/lib/cpu.hpp"
 
-namespace aux {
+namespace meave { namespace checksum {
 
-union u4x64 {
-	FletcherChecksum vec;
+/**
+ * A plain struct rather than a vector: it is passed the same way with and
+ *   without AVX, so callers need no -m flags (see meave/lib/cpu.hpp).
+ */
+struct FletcherChecksum {
 	::uint64_t x[4];
 };
 
-} /* namespace aux */
-
-FletcherChecksum fletcher_aligned_slow(const char *p, const ::size_t size) {
+inline FletcherChecksum fletcher_aligned_slow(const char *p, const ::size_t size) {
 	assert(0 == ::uintptr_t(p) % alignof(unsigned));
 
-	aux::u4x64 $${};
+	FletcherChecksum $${};
 
 	auto u = reinterpret_cast<const unsigned*>(p);
 	for (::size_t i = 0; i < size / sizeof(*u); ++i) {
@@ -35,7 +36,160 @@ FletcherChecksum fletcher_aligned_slow(const char *p, const ::size_t size) {
 		$$.x[3] += $$.x[2];
 	}
 
-	return $$.vec;
+	return $$;
+}
+
+namespace aux {
+
+/**
+ * Lane variants: word i goes to lane i % LANES, which keeps its own four
+ *   sums. A word at distance t from the end has weight C(t + j - 1, j) in
+ *   sum j; within its lane (t = LANES*k - l) that weight is a polynomial of
+ *   k, a combination of the lane's sums. Everything is modulo 2^64 as in
+ *   fletcher_aligned_slow() and gives exactly its result.
+ */
+enum : unsigned { LANES = 8 };
+
+typedef ::uint64_t LaneSums[4][LANES];	///< [sum][lane]
+
+/**
+ * @return C(n, r) for r <= 3 and any, also negative, n.
+ */
+constexpr ::int64_t binom(const ::int64_t n, const unsigned r) noexcept {
+	return r == 0 ? 1 : r == 1 ? n : r == 2 ? n*(n - 1)/2 : n*(n - 1)*(n - 2)/6;
+}
+
+/**
+ * coef_[j][i][l] -- weight of sum i of lane l in sum j of the whole.
+ */
+struct LaneCoefs {
+	::uint64_t coef_[4][4][LANES];
+
+	LaneCoefs() noexcept {
+		::memset(coef_, 0, sizeof(coef_));
+		for (unsigned l = 0; l < LANES; ++l) {
+			for (unsigned j = 0; j < 4; ++j) {
+				// Lane sum i weighs C(k + i - 1, i), that is 0 at k = -m for
+				//   m < i and (-1)^i at k = -i: solve at k = 0, -1, ..., -j.
+				::int64_t c[4] = {};
+				for (unsigned m = 0; m <= j; ++m) {
+					const ::int64_t k = -::int64_t(m);
+					::int64_t rest = binom(::int64_t(LANES)*k - l + j - 1, j);
+					for (unsigned i = 0; i < m; ++i)
+						rest -= c[i] * binom(k + i - 1, i);
+					c[m] = m % 2 ? -rest : rest;
+				}
+				for (unsigned i = 0; i <= j; ++i)
+					coef_[j][i][l] = ::uint64_t(c[i]);
+			}
+		}
+	}
+};
+
+/**
+ * Sums of words u[0] ... u[words - 1] from lane sums a of their first
+ *   words - words % LANES words.
+ */
+inline void fletcher_combine(const LaneSums &a, const unsigned *u, const ::size_t words, ::uint64_t $$[4]) noexcept {
+	static const LaneCoefs coefs;
+	for (unsigned j = 0; j < 4; ++j) {
+		$$[j] = 0;
+		for (unsigned i = 0; i <= j; ++i) {
+			for (unsigned l = 0; l < LANES; ++l)
+				$$[j] += coefs.coef_[j][i][l] * a[i][l];
+		}
+	}
+	for (::size_t i = words - words % LANES; i < words; ++i) {
+		$$[0] += u[i];
+		$$[1] += $$[0];
+		$$[2] += $$[1];
+		$$[3] += $$[2];
+	}
+}
+
+inline void fletcher_scalar(const char *p, const ::size_t size, ::uint64_t $$[4]) noexcept {
+	::memcpy($$, fletcher_aligned_slow(p, size).x, 4 * sizeof(*$$));
+}
+
+MEAVE_TARGET("avx2")
+inline void fletcher_avx2(const char *p, const ::size_t size, ::uint64_t $$[4]) noexcept {
+	const unsigned *u = reinterpret_cast<const unsigned*>(p);
+	const ::size_t words = size / sizeof(*u);
+	__m256i a[4][LANES/4];
+	for (auto &sum: a)
+		for (auto &$: sum)
+			$ = _mm256_setzero_si256();
+	for (::size_t i = 0; i + LANES <= words; i += LANES) {
+		for (unsigned h = 0; h < LANES/4; ++h) {
+			const __m256i x = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&u[i + 4*h])));
+			a[0][h] = _mm256_add_epi64(a[0][h], x);
+			a[1][h] = _mm256_add_epi64(a[1][h], a[0][h]);
+			a[2][h] = _mm256_add_epi64(a[2][h], a[1][h]);
+			a[3][h] = _mm256_add_epi64(a[3][h], a[2][h]);
+		}
+	}
+	LaneSums sums;
+	for (unsigned j = 0; j < 4; ++j)
+		for (unsigned h = 0; h < LANES/4; ++h)
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&sums[j][4*h]), a[j][h]);
+	fletcher_combine(sums, u, words, $$);
+}
+
+// GCC 12 warns about the undefined sources of unmasked AVX-512 intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+MEAVE_TARGET("avx512f")
+inline void fletcher_avx512(const char *p, const ::size_t size, ::uint64_t $$[4]) noexcept {
+	const unsigned *u = reinterpret_cast<const unsigned*>(p);
+	const ::size_t words = size / sizeof(*u);
+	__m512i a0 = _mm512_setzero_si512(), a1 = a0, a2 = a0, a3 = a0;
+	for (::size_t i = 0; i + LANES <= words; i += LANES) {
+		const __m512i x = _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&u[i])));
+		a0 = _mm512_add_epi64(a0, x);
+		a1 = _mm512_add_epi64(a1, a0);
+		a2 = _mm512_add_epi64(a2, a1);
+		a3 = _mm512_add_epi64(a3, a2);
+	}
+	LaneSums sums;
+	_mm512_storeu_si512(sums[0], a0);
+	_mm512_storeu_si512(sums[1], a1);
+	_mm512_storeu_si512(sums[2], a2);
+	_mm512_storeu_si512(sums[3], a3);
+	fletcher_combine(sums, u, words, $$);
+}
+
+#pragma GCC diagnostic pop
+
+typedef void (*FletcherKernel)(const char*, ::size_t, ::uint64_t[4]);
+
+inline const cpu::Kernels<FletcherKernel> &fletcher_kernels() noexcept {
+	// Two 64-bit lanes of SSE were slower than the scalar loop.
+	static const cpu::Kernels<FletcherKernel> $${{ &fletcher_scalar, nullptr, &fletcher_avx2, &fletcher_avx512 }};
+	return $$;
+}
+
+} /* namespace aux */
+
+/**
+ * fletcher_aligned_slow() by the variant of level (e.g. to test it).
+ */
+inline FletcherChecksum fletcher_aligned(const char *p, const ::size_t size, const cpu::Level level) noexcept {
+	assert(0 == ::uintptr_t(p) % alignof(unsigned));
+	FletcherChecksum $$;
+	aux::fletcher_kernels().impl(level)(p, size, $$.x);
+	return $$;
+}
+
+/**
+ * fletcher_aligned_slow() by the best variant for the CPU, chosen once.
+ */
+inline FletcherChecksum fletcher_aligned(const char *p, const ::size_t size) noexcept {
+	assert(0 == ::uintptr_t(p) % alignof(unsigned));
+	static const aux::FletcherKernel kernel = aux::fletcher_kernels().impl();
+	FletcherChecksum $$;
+	kernel(p, size, $$.x);
+	return $$;
 }
 
 } } /* meave::checksum */
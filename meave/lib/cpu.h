@@ -0,0 +1,82 @@
+#ifndef MEAVE_LIB_CPU_H_INCLUDED
+#	define MEAVE_LIB_CPU_H_INCLUDED
+
+/*
+ * Instruction set levels of SIMD kernels, detected at run time (cpuid), so
+ *   one binary built without -m flags runs the best kernels the machine has.
+ *   Used by C (meave/crc) and C++ (meave/lib/cpu.hpp) alike.
+ *
+ * Environment variable MEAVE_SIMD=scalar|sse42|avx2|avx512 forces a lower
+ *   level, e.g. to test or benchmark the fallbacks; a level the CPU doesn't
+ *   have is never used, MEAVE_SIMD only caps the detected one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum meave_cpu_level {
+	  MEAVE_CPU_SCALAR = 0
+	, MEAVE_CPU_SSE42	/* SSE4.2 (crc32, popcnt) */
+	, MEAVE_CPU_AVX2	/* AVX2 and FMA */
+	, MEAVE_CPU_AVX512	/* AVX-512 F, BW, DQ and VL */
+	, MEAVE_CPU_LEVELS
+};
+
+static inline const char *meave_cpu_level_name(const enum meave_cpu_level level) {
+	static const char *const names[MEAVE_CPU_LEVELS] = { "scalar", "sse42", "avx2", "avx512" };
+	return (unsigned)level < MEAVE_CPU_LEVELS ? names[level] : "?";
+}
+
+/**
+ * @return Level named name, -1 for an unknown name.
+ */
+static inline int meave_cpu_level_parse(const char *name) {
+	int level;
+	for (level = 0; level < MEAVE_CPU_LEVELS; ++level) {
+		if (!strcmp(name, meave_cpu_level_name((enum meave_cpu_level)level)))
+			return level;
+	}
+	return -1;
+}
+
+/**
+ * @return The highest level the CPU (and the OS) supports.
+ */
+static inline enum meave_cpu_level meave_cpu_detect(void) {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+	 && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")
+	 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return MEAVE_CPU_AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return MEAVE_CPU_AVX2;
+	if (__builtin_cpu_supports("sse4.2"))
+		return MEAVE_CPU_SSE42;
+	return MEAVE_CPU_SCALAR;
+}
+
+/**
+ * @return Level of kernels to run: the detected one, capped by MEAVE_SIMD.
+ *   Determined by the first call, every later call returns the same.
+ */
+static inline enum meave_cpu_level meave_cpu_level(void) {
+	static int cached = -1;
+	int level = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+	if (__builtin_expect(level >= 0, 1))
+		return (enum meave_cpu_level)level;
+
+	level = meave_cpu_detect();
+	const char *forced = getenv("MEAVE_SIMD");
+	if (forced) {
+		const int max = meave_cpu_level_parse(forced);
+		if (max < 0)
+			fprintf(stderr, "MEAVE_SIMD: unknown level %s, using %s\n", forced, meave_cpu_level_name((enum meave_cpu_level)level));
+		else if (max < level)
+			level = max;
+	}
+	__atomic_store_n(&cached, level, __ATOMIC_RELAXED);
+	return (enum meave_cpu_level)level;
+}
+
+#endif // MEAVE_LIB_CPU_H_INCLUDED
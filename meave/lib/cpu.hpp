@@ -0,0 +1,81 @@
+#ifndef MEAVE_LIB_CPU_HPP_INCLUDED
+#	define MEAVE_LIB_CPU_HPP_INCLUDED
+
+#	include "meave/lib/cpu.h"
+
+/**
+ * Kernel compiled for an instruction set level regardless of the -m flags
+ *   of the translation unit, e.g. MEAVE_TARGET("avx2,fma"). It may only be
+ *   called where cpu::level() allows it. Kernels take and return no vector
+ *   types: those are passed differently with and without AVX.
+ */
+#	define MEAVE_TARGET(isa) __attribute__((target(isa)))
+
+/**
+ * Instruction sets of the levels, e.g. MEAVE_TARGET(MEAVE_ISA_AVX2); each
+ *   one has all that meave_cpu_detect() checks for the level.
+ */
+#	define MEAVE_ISA_SSE42 "sse4.2"
+#	define MEAVE_ISA_AVX2 "avx2,fma"
+#	define MEAVE_ISA_AVX512 "avx512f,avx512bw,avx512dq,avx512vl,avx2,fma"
+
+namespace meave { namespace cpu {
+
+enum Level : int {
+	  SCALAR = MEAVE_CPU_SCALAR
+	, SSE42 = MEAVE_CPU_SSE42
+	, AVX2 = MEAVE_CPU_AVX2
+	, AVX512 = MEAVE_CPU_AVX512
+	, LEVELS = MEAVE_CPU_LEVELS
+};
+
+/**
+ * @return Level of kernels to run, see meave/lib/cpu.h (MEAVE_SIMD).
+ */
+inline Level level() noexcept {
+	return Level(::meave_cpu_level());
+}
+
+/**
+ * @return The highest level of the CPU, regardless of MEAVE_SIMD.
+ */
+inline Level detected() noexcept {
+	static const Level $$ = Level(::meave_cpu_detect());
+	return $$;
+}
+
+inline const char *name(const Level level) noexcept {
+	return ::meave_cpu_level_name(static_cast<enum ::meave_cpu_level>(level));
+}
+
+/**
+ * Variants of a kernel, one per level; a null variant means the level has
+ *   nothing better than the level below.
+ */
+template<typename Fn>
+struct Kernels {
+	Fn at_[LEVELS];
+
+	/**
+	 * @return Best variant up to level l, e.g. to test all variants
+	 *   against the scalar one.
+	 */
+	Fn impl(const Level l) const noexcept {
+		for (int _ = l; _ > SCALAR; --_) {
+			if (at_[_])
+				return at_[_];
+		}
+		return at_[SCALAR];
+	}
+
+	/**
+	 * @return Variant to run on this machine.
+	 */
+	Fn impl() const noexcept {
+		return impl(level());
+	}
+};
+
+} } /* namespace meave::cpu */
+
+#endif // MEAVE_LIB_CPU_HPP_INCLUDED
@@ -10,14 +10,14 @@ namespace meave {
 
 namespace {
 
-double gettime() noexcept {
+inline double gettime() noexcept {
 	struct timeval tv;
 	if (-1 == ::gettimeofday(&tv, nullptr))
 		::abort(); // This could only happen by some mistake in the program.
 	return tv.tv_sec + tv.tv_usec/1000000.0;
 }
 
-double getrealtime() noexcept {
+inline double getrealtime() noexcept {
 	struct timespec ts;
 	if (-1 == ::clock_gettime(CLOCK_REALTIME, &ts))
 		::abort(); // This could only happen by some mistake in the program.
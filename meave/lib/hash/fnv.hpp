@@ -5,8 +5,12 @@
  * https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
  */
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
-#include <meave/lib/vec.hpp>
+#ifdef __AVX__
+#	include <meave/lib/simd.hpp>
+#endif
 
 namespace meave { namespace fnv {
 
@@ -22,7 +26,7 @@ constexpr ::uint64_t fnv_prime() noexcept {
 
 } /* namespace aux */
 
-::uint64_t naive1(const uint8_t *$, ::size_t len) noexcept {
+inline ::uint64_t naive1(const uint8_t *$, ::size_t len) noexcept {
 	::uint64_t hash = aux::fnv_offset_basis();
 	for (const ::uint8_t *p = $; len--; ++p) {
 		hash *= aux::fnv_prime();
@@ -31,7 +35,7 @@ constexpr ::uint64_t fnv_prime() noexcept {
 	return hash;
 }
 
-::uint64_t naive1a(const uint8_t *$, ::size_t len) noexcept {
+inline ::uint64_t naive1a(const uint8_t *$, ::size_t len) noexcept {
 	::uint64_t hash = aux::fnv_offset_basis();
 	for (const ::uint8_t *p = $; len--; ++p) {
 		hash ^= *p;
@@ -40,9 +44,19 @@ constexpr ::uint64_t fnv_prime() noexcept {
 	return hash;
 }
 
-meave::vec::AVX naive1_vec(const ::uint8_t *$, ::size_t len) noexcept {
+/*
+ * Four lanes, byte i goes to lane i % 4. There are no SIMD variants
+ *   dispatched by the CPU (meave/lib/cpu.hpp): every lane is one chain of
+ *   dependent multiplications and scalar imul runs the four chains in
+ *   parallel. On 64 MiB the AVX2 variant (two _mm256_mul_epu32, the prime is
+ *   2^40 + 0x1b3) took 2.7 times and the AVX-512DQ one (_mm256_mullo_epi64)
+ *   3.9 times as long as the scalar loop. They return an AVX vector, so
+ *   they exist only with -mavx.
+ */
+#ifdef __AVX__
+inline meave::simd::AVX naive1_vec(const ::uint8_t *$, ::size_t len) noexcept {
 	assert(0 == len % 4);
-	meave::vec::AVX hash{ .qw_ = { aux::fnv_offset_basis(), aux::fnv_offset_basis(), aux::fnv_offset_basis(), aux::fnv_offset_basis() }};
+	meave::simd::AVX hash(_mm256_set1_epi64x(aux::fnv_offset_basis()));
 	for (const ::uint8_t *p = $; len; len -= 4) {
 		hash.qw_[0] *= aux::fnv_prime();
 		hash.qw_[1] *= aux::fnv_prime();
@@ -56,9 +70,9 @@ meave::vec::AVX naive1_vec(const ::uint8_t *$, ::size_t len) noexcept {
 	return hash;
 }
 
-meave::vec::AVX naive1a_vec(const ::uint8_t *$, ::size_t len) noexcept {
+inline meave::simd::AVX naive1a_vec(const ::uint8_t *$, ::size_t len) noexcept {
 	assert(0 == len % 4);
-	meave::vec::AVX hash{ .qw_ = { aux::fnv_offset_basis(), aux::fnv_offset_basis(), aux::fnv_offset_basis(), aux::fnv_offset_basis() }};
+	meave::simd::AVX hash(_mm256_set1_epi64x(aux::fnv_offset_basis()));
 	for (const ::uint8_t *p = $; len; len -= 4) {
 		hash.qw_[0] ^= *p++;
 		hash.qw_[1] ^= *p++;
@@ -71,6 +85,7 @@ meave::vec::AVX naive1a_vec(const ::uint8_t *$, ::size_t len) noexcept {
 	}
 	return hash;
 }
+#endif
 
 #ifdef INTEL_WILL_EVER_REALEASE_64BIT_UINT_VEC_OPS
 meave::vec::AVX avx1(const ::uint8_t *$, ::size_t len) noexcept {
@@ -0,0 +1,143 @@
+#ifndef MEAVE_LIB_HASH_ROLHASH_LANES_HPP_INCLUDED
+#	define MEAVE_LIB_HASH_ROLHASH_LANES_HPP_INCLUDED
+
+#	include <cstddef>
+#	include <cstdint>
+#	include <cstring>
+#	include <immintrin.h>
+
+#	include "meave/lib/cpu.hpp"
+
+namespace meave { namespace rolhash {
+
+/*
+ * Rolling hash of eight 32-bit lanes, the layout of the main loop of
+ *   rolhash_kernel_avx2() (rolhash_kernels.S): word i of the input goes to
+ *   lane i % 8, every lane is rotated left by ROL_BITS before a word is
+ *   XORed in, the last block is padded with zeros and the result is the XOR
+ *   of the lanes. All variants give the same hash; lanes8() runs the best
+ *   one of the CPU. The assembler kernel is not one of them: it is
+ *   unfinished (it returns lane 0 and ignores the tail).
+ */
+
+namespace aux { namespace lanes {
+
+enum : ::size_t { BLOCK = 32 };
+
+/**
+ * @return Number of blocks of len bytes; the last one is copied to last,
+ *   padded with zeros.
+ */
+inline ::size_t blocks(const ::uint8_t *p, const ::size_t len, ::uint8_t last[BLOCK]) noexcept {
+	::memset(last, 0, BLOCK);
+	if (!len)
+		return 0;
+	const ::size_t $$ = (len + BLOCK - 1) / BLOCK;
+	::memcpy(last, &p[($$ - 1) * BLOCK], len - ($$ - 1) * BLOCK);
+	return $$;
+}
+
+/**
+ * @return Block i of n blocks of p, the padded last.
+ */
+inline const ::uint8_t *block(const ::uint8_t *p, const ::size_t i, const ::size_t n, const ::uint8_t *last) noexcept {
+	return i + 1 < n ? &p[i * BLOCK] : last;
+}
+
+template <unsigned ROL_BITS>
+::uint32_t scalar(const ::uint8_t *p, const ::size_t len) noexcept {
+	::uint8_t last[BLOCK];
+	const ::size_t n = blocks(p, len, last);
+	::uint32_t h[8] = {};
+	for (::size_t i = 0; i < n; ++i) {
+		::uint32_t w[8];
+		::memcpy(w, block(p, i, n, last), sizeof(w));
+		for (unsigned l = 0; l < 8; ++l)
+			h[l] = ((h[l] << ROL_BITS) | (h[l] >> (32 - ROL_BITS))) ^ w[l];
+	}
+	::uint32_t $$ = 0;
+	for (unsigned l = 0; l < 8; ++l)
+		$$ ^= h[l];
+	return $$;
+}
+
+template <unsigned ROL_BITS>
+MEAVE_TARGET("sse4.2")
+::uint32_t sse42(const ::uint8_t *p, const ::size_t len) noexcept {
+	::uint8_t last[BLOCK];
+	const ::size_t n = blocks(p, len, last);
+	__m128i h0 = _mm_setzero_si128();
+	__m128i h1 = _mm_setzero_si128();
+	for (::size_t i = 0; i < n; ++i) {
+		const ::uint8_t *b = block(p, i, n, last);
+		h0 = _mm_or_si128(_mm_slli_epi32(h0, ROL_BITS), _mm_srli_epi32(h0, 32 - ROL_BITS));
+		h1 = _mm_or_si128(_mm_slli_epi32(h1, ROL_BITS), _mm_srli_epi32(h1, 32 - ROL_BITS));
+		h0 = _mm_xor_si128(h0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+		h1 = _mm_xor_si128(h1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 16)));
+	}
+	__m128i h = _mm_xor_si128(h0, h1);
+	h = _mm_xor_si128(h, _mm_unpackhi_epi64(h, h));
+	h = _mm_xor_si128(h, _mm_srli_epi64(h, 32));
+	return _mm_cvtsi128_si32(h);
+}
+
+template <unsigned ROL_BITS>
+MEAVE_TARGET("avx2")
+::uint32_t avx2(const ::uint8_t *p, const ::size_t len) noexcept {
+	::uint8_t last[BLOCK];
+	const ::size_t n = blocks(p, len, last);
+	__m256i h = _mm256_setzero_si256();
+	for (::size_t i = 0; i < n; ++i) {
+		h = _mm256_or_si256(_mm256_slli_epi32(h, ROL_BITS), _mm256_srli_epi32(h, 32 - ROL_BITS));
+		h = _mm256_xor_si256(h, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block(p, i, n, last))));
+	}
+	__m128i x = _mm_xor_si128(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+	x = _mm_xor_si128(x, _mm_unpackhi_epi64(x, x));
+	x = _mm_xor_si128(x, _mm_srli_epi64(x, 32));
+	return _mm_cvtsi128_si32(x);
+}
+
+template <unsigned ROL_BITS>
+MEAVE_TARGET("avx512f,avx512vl")
+::uint32_t avx512(const ::uint8_t *p, const ::size_t len) noexcept {
+	::uint8_t last[BLOCK];
+	const ::size_t n = blocks(p, len, last);
+	__m256i h = _mm256_setzero_si256();
+	for (::size_t i = 0; i < n; ++i)
+		h = _mm256_xor_si256(_mm256_rol_epi32(h, ROL_BITS), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block(p, i, n, last))));
+	__m128i x = _mm_xor_si128(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+	x = _mm_xor_si128(x, _mm_unpackhi_epi64(x, x));
+	x = _mm_xor_si128(x, _mm_srli_epi64(x, 32));
+	return _mm_cvtsi128_si32(x);
+}
+
+typedef ::uint32_t (*Kernel)(const ::uint8_t*, ::size_t);
+
+template <unsigned ROL_BITS>
+const cpu::Kernels<Kernel> &kernels() noexcept {
+	static const cpu::Kernels<Kernel> $${{ &scalar<ROL_BITS>, &sse42<ROL_BITS>, &avx2<ROL_BITS>, &avx512<ROL_BITS> }};
+	return $$;
+}
+
+} } /* namespace aux::lanes */
+
+/**
+ * The hash by the variant of level (e.g. to test it).
+ */
+template <unsigned ROL_BITS>
+::uint32_t lanes8(const ::uint8_t *p, const ::size_t len, const cpu::Level level) noexcept {
+	return aux::lanes::kernels<ROL_BITS>().impl(level)(p, len);
+}
+
+/**
+ * The hash by the best variant for the CPU, chosen once.
+ */
+template <unsigned ROL_BITS>
+::uint32_t lanes8(const ::uint8_t *p, const ::size_t len) noexcept {
+	static const aux::lanes::Kernel kernel = aux::lanes::kernels<ROL_BITS>().impl();
+	return kernel(p, len);
+}
+
+} } /* namespace meave::rolhash */
+
+#endif // MEAVE_LIB_HASH_ROLHASH_LANES_HPP_INCLUDED
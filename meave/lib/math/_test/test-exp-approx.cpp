@@ -0,0 +1,41 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include <meave/commons.hpp>
+#include <meave/lib/math/funcs.hpp>
+
+/*
+ * Checks accuracy of exp_approx() and sigmoid_approx() against libm.
+ */
+
+namespace {
+
+void test() {
+	double max_exp_err = 0;
+	double max_sigm_err = 0;
+	for (int i = -300000; i <= +300000; ++i) {
+		const float x = i / 10000.f;
+		max_exp_err = $::max(max_exp_err, $::fabs(double(meave::math::exp_approx(x)) / ::exp(double(x)) - 1));
+		max_sigm_err = $::max(max_sigm_err, $::fabs(double(meave::math::sigmoid_approx(x)) - 1 / (1 + ::exp(-double(x)))));
+	}
+
+	$::cerr << "exp_approx relative error: " << max_exp_err << $::endl;
+	$::cerr << "sigmoid_approx absolute error: " << max_sigm_err << $::endl;
+	assert(max_exp_err < 1e-5);
+	assert(max_sigm_err < 1e-5);
+
+	assert(meave::math::exp_approx(-1000.f) >= 0);
+	assert(meave::math::sigmoid_approx(+1000.f) == 1.f);
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	test();
+
+	return 0;
+}
@@ -2,7 +2,7 @@
 #include <iostream>
 
 #include <meave/lib/math/funcs_approx.hpp>
-#include <meave/lib/gettime.hpp>
+#include <meave/lib/bench/bench.hpp>
 #include <meave/lib/utils.hpp>
 #include <meave/lib/raii/mmap_pointer.hpp>
 
@@ -10,7 +10,7 @@
 
 namespace {
 
-void test() {
+void test(meave::bench::Runner &runner) {
 	meave::raii::MMapPointer<float> src{{ARRAY_LEN}};
 	meave::raii::MMapPointer<float> dst_exp{{ARRAY_LEN}};
 	meave::raii::MMapPointer<float> dst_pade22{{ARRAY_LEN}};
@@ -19,22 +19,17 @@ void test() {
 		src[i] = dst_exp[i] = dst_pade22[i] = i / 10000.f;
 	}
 
-	
-	{
-		const double b1 = meave::getrealtime();
+	runner.run("libc", [&]() {
 		for (uns i = 0; i < ARRAY_LEN; ++i) {
-			dst_exp[i] = ::exp(dst_exp[i]);
+			dst_exp[i] = ::exp(src[i]);
 		}
-		const double e1 = meave::getrealtime();
-		$::cerr << "libc: " << (e1 - b1) << $::endl;
-	}
+		meave::bench::clobber_memory();
+	}, meave::bench::Throughput::elems(ARRAY_LEN));
 
-	{
-		const double b2 = meave::getrealtime();
+	runner.run("pade22", [&]() {
 		::exp_pade22(*dst_pade22, *src, ARRAY_LEN);
-		const double e2 = meave::getrealtime();
-		$::cerr << "pade22: " << (e2 - b2) << $::endl;
-	}
+		meave::bench::clobber_memory();
+	}, meave::bench::Throughput::elems(ARRAY_LEN));
 
 	$::cout << "Value" << '|' << "Exp" << '|' << "Pade22" << $::endl;
 	for (uns i = 0; i < ARRAY_LEN; ++i) {
@@ -46,7 +41,8 @@ void test() {
 
 int
 main(void) {
-	test();
+	meave::bench::Runner runner;
+	test(runner);
 
-	return 0;
+	return runner.finish() ? 1 : 0;
 }
@@ -3,7 +3,7 @@
 #include <iostream>
 
 #include <meave/lib/math/funcs_approx.hpp>
-#include <meave/lib/gettime.hpp>
+#include <meave/lib/bench/bench.hpp>
 #include <meave/lib/raii/mmap_pointer.hpp>
 #include <meave/lib/math/precalculate.hpp>
 #include <meave/lib/utils.hpp>
@@ -12,7 +12,7 @@
 
 namespace {
 
-void test() {
+void test(meave::bench::Runner &runner) {
 	meave::raii::MMapPointer<float> src{ARRAY_LEN};
 	meave::raii::MMapPointer<float> dst_exp2f{ARRAY_LEN};
 	meave::raii::MMapPointer<float> dst_exp2_taylor{ARRAY_LEN};
@@ -25,49 +25,41 @@ void test() {
 	}
 	$::random_shuffle(&src[0], &src[ARRAY_LEN]);
 
-	{
-		const double b1 = meave::getrealtime();
+	const auto elems = meave::bench::Throughput::elems(ARRAY_LEN);
+
+	runner.run("libc", [&]() {
 		for (uns i = 0; i < ARRAY_LEN; ++i) {
-			dst_exp2f[i] = ::exp2f(dst_exp2f[i]);
+			dst_exp2f[i] = ::exp2f(src[i]);
 		}
-		const double e1 = meave::getrealtime();
-		$::cerr << "libc: " << (e1 - b1) << $::endl;
-	}
+		meave::bench::clobber_memory();
+	}, elems);
 
-	{
-		const double b2 = meave::getrealtime();
+	runner.run("taylor4", [&]() {
 		::exp2_taylor(*dst_exp2_taylor, *src, ARRAY_LEN);
-		const double e2 = meave::getrealtime();
-		$::cerr << "taylor4: " << (e2 - b2) << $::endl;
-	}
+		meave::bench::clobber_memory();
+	}, elems);
 
-	{
-		const double b = meave::getrealtime();
+	runner.run("taylor4_one", [&]() {
 		for (uns i = 0; i < ARRAY_LEN; i += 8) {
 			*(v8sf*)&dst_exp2_taylor_one[i] = ::exp2_taylor_one(*(v8sf*)&src[i]);
 		}
-		const double e = meave::getrealtime();
-		$::cerr << "taylor4_one: " << (e - b) << $::endl;
-	}
+		meave::bench::clobber_memory();
+	}, elems);
 
-	{
-		const double b = meave::getrealtime();
+	runner.run("precalculated", [&]() {
 		for (uns i = 0; i < ARRAY_LEN; i += 8) {
 			*(meave::vec::AVX*)&dst_precalculated[i] = meave::math::precalculated<::exp2f>(*(meave::vec::AVX*)&src[i]);
 		}
-		const double e = meave::getrealtime();
-		$::cerr << "precalculated: " << (e - b) << $::endl;
-	}
+		meave::bench::clobber_memory();
+	}, elems);
 
-	{
-		// This is calculation of exp(x), not exp2(x), it is here to compare speed!
-		const double b = meave::getrealtime();
+	// This is calculation of exp(x), not exp2(x), it is here to compare speed!
+	runner.run("exp256", [&]() {
 		for (uns i = 0; i < ARRAY_LEN; i += 8) {
 			*(v8sf*)&dst_exp256[i] = ::exp256_ps(*(v8sf*)&src[i]);
 		}
-		const double e = meave::getrealtime();
-		$::cerr << "exp256: " << (e - b) << $::endl;
-	}
+		meave::bench::clobber_memory();
+	}, elems);
 
 	float max_abs_err = 0.f;
 	float max_rel_err = 0.f;
@@ -98,7 +90,8 @@ void test() {
 
 int
 main(void) {
-	test();
+	meave::bench::Runner runner;
+	test(runner);
 
-	return 0;
+	return runner.finish() ? 1 : 0;
 }
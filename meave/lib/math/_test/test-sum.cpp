@@ -0,0 +1,93 @@
+#undef NDEBUG
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/bench/bench.hpp>
+#include <meave/lib/cpu.hpp>
+#include <meave/lib/math/sum.hpp>
+
+/*
+ * Checks accuracy of compensated sums (also when compiled with -Ofast), that
+ *   the variants of all levels agree, and measures the one of this CPU
+ *   against plain summation.
+ */
+
+namespace {
+
+$::default_random_engine rand_;
+
+long double exact_sum(const $::vector<float> &x) {
+	long double $$ = 0;
+	for (const float $: x)
+		$$ += $;
+	return $$;
+}
+
+/**
+ * Values of both signs and very different magnitudes, their sum is small.
+ */
+$::vector<float> ill_conditioned(const uns n) {
+	$::uniform_real_distribution<float> dist(-1.f, 1.f);
+	$::vector<float> $$(n);
+	for (uns _ = 0; _ < n; ++_)
+		$$[_] = dist(rand_) * (_ % 7 ? 1.f : 1e6f);
+	return $$;
+}
+
+void check_accuracy() {
+	for (uns n = 0; n < 300; ++n) {
+		const $::vector<float> x = ill_conditioned(n);
+		const long double exact = exact_sum(x);
+		const float vec = meave::math::compensated_sum(x.empty() ? nullptr : &x[0], n);
+		const float scalar = meave::math::compensated_sum<float>(x.empty() ? nullptr : &x[0], n);
+		// Both are exact up to the rounding of the result and of the error terms.
+		assert(::fabsl(vec - exact) <= 1e-6 * ::fabsl(exact) + 1e-3);
+		assert(::fabsl(scalar - exact) <= 1e-6 * ::fabsl(exact) + 1e-3);
+		for (int l = meave::cpu::SCALAR; l <= meave::cpu::detected(); ++l)
+			assert(meave::math::compensated_sum(x.empty() ? nullptr : &x[0], n, meave::cpu::Level(l)) == vec);
+	}
+
+	// 1 + many tiny numbers: a plain float sum doesn't move from 1 at all.
+	$::vector<float> x(100001, 1e-8f);
+	x[0] = 1.f;
+	assert(::fabs(meave::math::compensated_sum(&x[0], x.size()) - 1.001f) < 1e-6);
+	assert(::fabs(meave::math::compensated_sum<float>(&x[0], x.size()) - 1.001f) < 1e-6);
+}
+
+float plain_sum(const float x[], const uns n) {
+	float $$ = 0;
+	for (uns _ = 0; _ < n; ++_)
+		$$ += x[_];
+	return $$;
+}
+
+void measure(meave::bench::Runner &runner, const uns n) {
+	const $::vector<float> x = ill_conditioned(n);
+	const $::string suffix = "." + $::to_string(n);
+
+	runner.run("plain" + suffix, [&]() {
+		meave::bench::do_not_optimize(plain_sum(&x[0], n));
+	}, meave::bench::Throughput::elems(n));
+	runner.run("compensated" + suffix, [&]() {
+		meave::bench::do_not_optimize(meave::math::compensated_sum(&x[0], n));
+	}, meave::bench::Throughput::elems(n));
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_accuracy();
+
+	meave::bench::Runner runner;
+	measure(runner, 200);
+	measure(runner, 4096);
+
+	return runner.finish() ? 1 : 0;
+}
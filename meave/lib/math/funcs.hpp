@@ -2,6 +2,8 @@
 #	define MEAVE_LIB_MATH_FUNCS_HPP
 
 #	include <cmath>
+#	include <cstdint>
+#	include <cstring>
 
 namespace meave { namespace math {
 
@@ -12,6 +14,45 @@ Float sigmoid(const Float x)
 	return 1 / (1 + exp_value);
 }
 
+namespace aux {
+
+/**
+ * exp(x) = num / den without libm: x = n*ln(2) + r with |r| <= ln(2)/2,
+ *   exp(r) by its Pade (2,2) approximant and 2^n assembled in the exponent
+ *   bits. Relative error is below 1e-5, very small or large x are clamped.
+ */
+inline void exp_pade22(float x, float &num, float &den) noexcept {
+	x = x < -87.f ? -87.f : x > +88.f ? +88.f : x;
+	const float n = __builtin_rintf(x * 1.44269504f);
+	const float r = x - n * 0.693147181f;
+
+	const float r2 = r * r;
+	const ::uint32_t bits = ::uint32_t(int(n) + 127) << 23;
+	float two_n;
+	::memcpy(&two_n, &bits, sizeof(two_n));
+	num = (12.f + 6.f*r + r2) * two_n;
+	den = 12.f - 6.f*r + r2;
+}
+
+} /* namespace aux */
+
+inline float exp_approx(const float x) noexcept {
+	float num, den;
+	aux::exp_pade22(x, num, den);
+	return num / den;
+}
+
+/**
+ * sigmoid() by the approximation of exp_approx() with a single division,
+ *   good enough for screening, not for results.
+ */
+template <typename Float>
+Float sigmoid_approx(const Float x) noexcept {
+	float num, den;
+	aux::exp_pade22(float(-x), num, den);
+	return Float(den / (den + num));
+}
+
 template<typename T>
 T abs(const T &x) {
 	return x >= T() ? x : -x;
@@ -30,16 +71,18 @@ T rel_err(const T &x, const T &y) {
 
 } } /* namespace meave::math */
 
-/* Simd Part */
+/* Simd Part, only with -mavx (array variants for any CPU: meave/lib/math/funcs_array.hpp) */
+#	ifdef __AVX__
 #	include "meave/lib/simd.hpp"
 
 namespace meave { namespace math {
 
-meave::simd::AVX abs(const meave::simd::AVX &x) noexcept {
+inline meave::simd::AVX abs(const meave::simd::AVX &x) noexcept {
 	// http://stackoverflow.com/questions/5508628/how-to-absolute-2-double-or-4-floats-using-sse-instruction-set-up-to-sse4
 	return ::meave::simd::AVX{{ _mm256_andnot_ps(_mm256_set1_ps(-0.f), x) }};
 }
 
 } } /* namespace meave::math */
+#	endif
 
 #endif
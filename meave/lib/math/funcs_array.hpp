@@ -0,0 +1,132 @@
+#ifndef MEAVE_LIB_MATH_FUNCS_ARRAY_HPP_INCLUDED
+#	define MEAVE_LIB_MATH_FUNCS_ARRAY_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/cpu.hpp"
+#	include "meave/lib/math/funcs.hpp"
+#	include "meave/lib/simd/math.hpp"
+
+namespace meave { namespace math {
+
+/*
+ * exp_approx() and sigmoid_approx() of whole arrays, by the widest variant
+ *   the CPU has (meave/lib/cpu.hpp). The vector variants compute the same
+ *   Pade (2,2) approximation by meave/lib/simd/math.hpp; with FMA they may
+ *   differ from the scalar one in the last bit.
+ */
+
+namespace aux { namespace array {
+
+typedef void (*Kernel)(float*, const float*, uns);
+
+inline void exp_scalar(float *dst, const float *src, const uns len) noexcept {
+	for (uns _ = 0; _ < len; ++_)
+		dst[_] = exp_approx(src[_]);
+}
+
+inline void sigmoid_scalar(float *dst, const float *src, const uns len) noexcept {
+	for (uns _ = 0; _ < len; ++_)
+		dst[_] = sigmoid_approx(src[_]);
+}
+
+/**
+ * The vector variants, V a simd::Native<float, level>; the tail by masked
+ *   loads and stores.
+ */
+template<typename V>
+MEAVE_SIMD_INLINE void exp_vec(float *dst, const float *src, const uns len) noexcept {
+	V num, den;
+	uns _ = 0;
+	for (; _ + V::LANES <= len; _ += V::LANES) {
+		simd::exp_pade22(V::load(&src[_]), num, den);
+		(num / den).store(&dst[_]);
+	}
+	if (_ < len) {
+		simd::exp_pade22(V::load(&src[_], len - _), num, den);
+		(num / den).store(&dst[_], len - _);
+	}
+}
+
+template<typename V>
+MEAVE_SIMD_INLINE void sigmoid_vec(float *dst, const float *src, const uns len) noexcept {
+	V num, den;
+	uns _ = 0;
+	for (; _ + V::LANES <= len; _ += V::LANES) {
+		simd::exp_pade22(-V::load(&src[_]), num, den);
+		(den / (den + num)).store(&dst[_]);
+	}
+	if (_ < len) {
+		simd::exp_pade22(-V::load(&src[_], len - _), num, den);
+		(den / (den + num)).store(&dst[_], len - _);
+	}
+}
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline void exp_sse42(float *dst, const float *src, const uns len) noexcept {
+	exp_vec<simd::Native<float, cpu::SSE42>>(dst, src, len);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline void exp_avx2(float *dst, const float *src, const uns len) noexcept {
+	exp_vec<simd::Native<float, cpu::AVX2>>(dst, src, len);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline void exp_avx512(float *dst, const float *src, const uns len) noexcept {
+	exp_vec<simd::Native<float, cpu::AVX512>>(dst, src, len);
+}
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline void sigmoid_sse42(float *dst, const float *src, const uns len) noexcept {
+	sigmoid_vec<simd::Native<float, cpu::SSE42>>(dst, src, len);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline void sigmoid_avx2(float *dst, const float *src, const uns len) noexcept {
+	sigmoid_vec<simd::Native<float, cpu::AVX2>>(dst, src, len);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline void sigmoid_avx512(float *dst, const float *src, const uns len) noexcept {
+	sigmoid_vec<simd::Native<float, cpu::AVX512>>(dst, src, len);
+}
+
+inline const cpu::Kernels<Kernel> &exp_kernels() noexcept {
+	static const cpu::Kernels<Kernel> $${{ &exp_scalar, &exp_sse42, &exp_avx2, &exp_avx512 }};
+	return $$;
+}
+
+inline const cpu::Kernels<Kernel> &sigmoid_kernels() noexcept {
+	static const cpu::Kernels<Kernel> $${{ &sigmoid_scalar, &sigmoid_sse42, &sigmoid_avx2, &sigmoid_avx512 }};
+	return $$;
+}
+
+} } /* namespace aux::array */
+
+/**
+ * dst[i] = exp_approx(src[i]), dst may be src.
+ */
+inline void exp_approx(float *dst, const float *src, const uns len) noexcept {
+	static const aux::array::Kernel kernel = aux::array::exp_kernels().impl();
+	kernel(dst, src, len);
+}
+
+inline void exp_approx(float *dst, const float *src, const uns len, const cpu::Level level) noexcept {
+	aux::array::exp_kernels().impl(level)(dst, src, len);
+}
+
+/**
+ * dst[i] = sigmoid_approx(src[i]), dst may be src.
+ */
+inline void sigmoid_approx(float *dst, const float *src, const uns len) noexcept {
+	static const aux::array::Kernel kernel = aux::array::sigmoid_kernels().impl();
+	kernel(dst, src, len);
+}
+
+inline void sigmoid_approx(float *dst, const float *src, const uns len, const cpu::Level level) noexcept {
+	aux::array::sigmoid_kernels().impl(level)(dst, src, len);
+}
+
+} } /* namespace meave::math */
+
+#endif // MEAVE_LIB_MATH_FUNCS_ARRAY_HPP_INCLUDED
@@ -0,0 +1,201 @@
+#ifndef MEAVE_LIB_MATH_SUM_HPP
+#	define MEAVE_LIB_MATH_SUM_HPP
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/cpu.hpp"
+#	include "meave/lib/simd/vec.hpp"
+
+namespace meave { namespace math {
+
+namespace aux {
+
+/**
+ * Hides the value from the optimizer, so that -ffast-math (-Ofast of the
+ *   experiments) cannot simplify error terms of compensated sums to zero;
+ *   every intermediate result of TwoSum has to be hidden, otherwise
+ *   reassociation finds a + b - fl(a + b) .
+ */
+template<typename T>
+MEAVE_SIMD_INLINE T opaque(T x) noexcept {
+	asm("" : "+x"(x));
+	return x;
+}
+
+/**
+ * opaque() of a simd::Vec; a single lane as a float, the asm cannot take
+ *   a 4 byte vector.
+ */
+template<typename T, uns N>
+MEAVE_SIMD_INLINE simd::Vec<T, N> opaque(const simd::Vec<T, N> &x) noexcept {
+	typename simd::Vec<T, N>::Raw r = x.raw();
+	asm("" : "+v"(r));
+	return simd::Vec<T, N>(r);
+}
+
+template<typename T>
+MEAVE_SIMD_INLINE simd::Vec<T, 1> opaque(const simd::Vec<T, 1> &x) noexcept {
+	return simd::Vec<T, 1>(opaque(x[0]));
+}
+
+/**
+ * s + err = a + b exactly (Knuth's TwoSum), s = fl(a + b) .
+ */
+template<typename Float>
+MEAVE_SIMD_INLINE Float two_sum(const Float a, const Float b, Float &err) noexcept {
+	const Float s = opaque(a + b);
+	const Float bb = opaque(s - a);
+	const Float aa = opaque(s - bb);
+	err = opaque(a - aa) + opaque(b - bb);
+	return s;
+}
+
+} /* namespace aux */
+
+/**
+ * Compensated (Kahan-Babuska) sum: rounding errors of additions are
+ *   accumulated separately and added at the end, the result is as accurate
+ *   as summation in twice the precision. Depends only on the order of add().
+ */
+template<typename Float>
+class CompensatedSum {
+private:
+	Float sum_;
+	Float err_;
+
+public:
+	CompensatedSum() noexcept
+	:	sum_(0)
+	,	err_(0) {
+	}
+
+	void add(const Float x) noexcept {
+		Float err;
+		sum_ = aux::two_sum(sum_, x, err);
+		err_ += err;
+	}
+
+	/**
+	 * Adds the sum of other, e.g. a partial sum of a chunk.
+	 */
+	void add(const CompensatedSum &other) noexcept {
+		add(other.sum_);
+		err_ += other.err_;
+	}
+
+	Float value() const noexcept {
+		return sum_ + err_;
+	}
+};
+
+/**
+ * @return Compensated sum of x[0] .. x[n - 1] , the result depends only on
+ *   the values, not on how (e.g. by which threads) they were computed.
+ */
+template<typename Float>
+Float compensated_sum(const Float x[], const uns n) noexcept {
+	CompensatedSum<Float> $$;
+	for (uns _ = 0; _ < n; ++_)
+		$$.add(x[_]);
+	return $$.value();
+}
+
+namespace aux {
+
+enum : uns { SUM_LANES = 16 };
+
+/**
+ * SUM_LANES compensated sums of elements congruent modulo SUM_LANES, in
+ *   SUM_LANES / V::LANES accumulators V (to hide latency of additions),
+ *   combined pairwise at the end (lane i with lane i + half, half = 8, 4,
+ *   2, 1). Lanes are computed alike whatever V is, so all the variants give
+ *   the same result. TwoSum is 6 additions per element: test-sum measures
+ *   3-5x plain summation for 200 floats and 1.4-1.6x for 4096 (AVX-512,
+ *   in L1), which is negligible next to the 200 simulations it sums.
+ */
+template<typename V>
+MEAVE_SIMD_INLINE float compensated_sum_vec(const float x[], const uns n) noexcept {
+	enum : uns { W = V::LANES, K = SUM_LANES / W };
+	V s[K], e[K];
+	for (uns k = 0; k < K; ++k)
+		s[k] = e[k] = V::zero();
+	const auto add = [&s, &e](const uns k, const V &v) {
+		V err;
+		s[k] = two_sum(s[k], v, err);
+		e[k] += err;
+	};
+
+	uns i = 0;
+	for (; i + SUM_LANES <= n; i += SUM_LANES) {
+		// Accumulators stay in registers only when unrolled.
+		#pragma GCC unroll 64
+		for (uns k = 0; k < K; ++k)
+			add(k, V::load(&x[i + k * W]));
+	}
+	// Missing elements of the tail are zeros, adding them is exact.
+	for (uns k = 0; i + k * W < n; ++k) {
+		const uns left = n - i - k * W;
+		add(k, left >= W ? V::load(&x[i + k * W]) : V::load(&x[i + k * W], left));
+	}
+
+	float ss[SUM_LANES], ee[SUM_LANES];
+	for (uns k = 0; k < K; ++k) {
+		s[k].store(&ss[k * W]);
+		e[k].store(&ee[k * W]);
+	}
+	// Independent TwoSums on every level, unlike a chain of SUM_LANES of them.
+	#pragma GCC unroll 8
+	for (uns half = SUM_LANES / 2; half; half /= 2) {
+		#pragma GCC unroll 64
+		for (uns _ = 0; _ < half; ++_) {
+			float err;
+			ss[_] = two_sum(ss[_], ss[_ + half], err);
+			ee[_] += opaque(ee[_ + half] + err);
+		}
+	}
+	return ss[0] + ee[0];
+}
+
+typedef float (*SumKernel)(const float[], uns);
+
+inline float compensated_sum_scalar(const float x[], const uns n) noexcept {
+	return compensated_sum_vec<simd::Vec<float, 1>>(x, n);
+}
+
+MEAVE_TARGET(MEAVE_ISA_SSE42)
+inline float compensated_sum_sse42(const float x[], const uns n) noexcept {
+	return compensated_sum_vec<simd::Native<float, cpu::SSE42>>(x, n);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX2)
+inline float compensated_sum_avx2(const float x[], const uns n) noexcept {
+	return compensated_sum_vec<simd::Native<float, cpu::AVX2>>(x, n);
+}
+
+MEAVE_TARGET(MEAVE_ISA_AVX512)
+inline float compensated_sum_avx512(const float x[], const uns n) noexcept {
+	return compensated_sum_vec<simd::Native<float, cpu::AVX512>>(x, n);
+}
+
+inline const cpu::Kernels<SumKernel> &compensated_sum_kernels() noexcept {
+	static const cpu::Kernels<SumKernel> $${{ &compensated_sum_scalar, &compensated_sum_sse42, &compensated_sum_avx2, &compensated_sum_avx512 }};
+	return $$;
+}
+
+} /* namespace aux */
+
+/**
+ * By the widest variant the CPU has (meave/lib/cpu.hpp), the result does
+ *   not depend on which one it is.
+ */
+inline float compensated_sum(const float x[], const uns n) noexcept {
+	static const aux::SumKernel kernel = aux::compensated_sum_kernels().impl();
+	return kernel(x, n);
+}
+
+inline float compensated_sum(const float x[], const uns n, const cpu::Level level) noexcept {
+	return aux::compensated_sum_kernels().impl(level)(x, n);
+}
+
+} } /* namespace meave::math */
+
+#endif // MEAVE_LIB_MATH_SUM_HPP
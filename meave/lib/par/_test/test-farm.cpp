@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/gettime.hpp>
+#include <meave/lib/par/farm.hpp>
+#include <meave/lib/par/workers.hpp>
+#include <meave/lib/seed.hpp>
+
+/*
+ * Checks that the farm returns the same fitnesses as an in-process
+ *   evaluation, also when one of the workers dies, that workers don't
+ *   repeat each other's MEAVE_SEED seeds, and compares
+ *   evaluations per second of the farm with meave::par::Workers .
+ *
+ * ./test-farm [workers] [genomes]
+ */
+
+namespace {
+
+constexpr uns GSIZE = 15;
+const char *const DIE_FILE = "./test-farm.die";
+
+/** Some deterministic work that takes a while. Not inlined, so that all callers get the same result. */
+__attribute__((noinline)) float fitness(const float *genome) noexcept {
+	float f = 0;
+	for (uns i = 0; i < 20000; ++i)
+		f += ::sinf(genome[i % GSIZE] * i);
+	return f;
+}
+
+/** The first worker evaluating a negative genome dies. */
+float mortal_fitness(const float *genome) noexcept {
+	if (genome[0] < 0) {
+		const int fd = ::open(DIE_FILE, O_CREAT | O_EXCL | O_WRONLY, 0600);
+		if (fd != -1)
+			::_exit(EXIT_FAILURE);
+	}
+	return fitness(genome);
+}
+
+/** Next seed of the worker, exact in a float. */
+float seed_fitness(const float*) noexcept {
+	return meave::seed() >> 8;
+}
+
+bool compare(const char *name, const $::vector<float> &expected, const $::vector<float> &real) {
+	for (uns _ = 0; _ < expected.size(); ++_) {
+		if (expected[_] != real[_]) {
+			$::cerr << name << ": [" << _ << "] " << expected[_] << " != " << real[_] << $::endl;
+			return false;
+		}
+	}
+	$::cerr << name << ": OK" << $::endl;
+	return true;
+}
+
+} /* anonymous namespace */
+
+int
+main(int argc, char *argv[]) {
+	const uns workers_num = argc > 1 ? ::atoi(argv[1]) : $::max(2U, $::thread::hardware_concurrency());
+	const uns n = argc > 2 ? ::atoi(argv[2]) : 2000;
+
+	$::default_random_engine rand;
+	$::uniform_real_distribution<float> dist(0, 1);
+	$::vector<float> genomes(n * GSIZE);
+	for (auto &g: genomes)
+		g = dist(rand);
+
+	$::vector<float> expected(n);
+	const double b_serial = meave::getrealtime();
+	for (uns _ = 0; _ < n; ++_)
+		expected[_] = fitness(&genomes[_ * GSIZE]);
+	const double e_serial = meave::getrealtime();
+
+	bool ok = true;
+
+	{
+		meave::par::Workers workers(workers_num);
+		$::vector<float> real(n);
+		const double b = meave::getrealtime();
+		workers.for_each(0, n, [&](const uns _) { real[_] = fitness(&genomes[_ * GSIZE]); });
+		const double e = meave::getrealtime();
+		ok = compare("threads", expected, real) && ok;
+		$::cerr << "serial: " << n / (e_serial - b_serial) << " evaluations/s; "
+			<< workers_num << " threads: " << n / (e - b) << " evaluations/s" << $::endl;
+	}
+
+	for (const uns depth: {1U, 4U}) {
+		meave::par::Farm<float> farm(workers_num, depth, GSIZE, fitness);
+		$::vector<float> real(n);
+		const double b = meave::getrealtime();
+		farm.evaluate(&genomes[0], n, &real[0]);
+		const double e = meave::getrealtime();
+		ok = compare("farm", expected, real) && ok;
+		$::cerr << workers_num << " processes, depth " << depth << ": " << n / (e - b) << " evaluations/s" << $::endl;
+	}
+
+	{
+		::unlink(DIE_FILE);
+		meave::par::Farm<float> farm($::max(2U, workers_num), 4, GSIZE, mortal_fitness);
+		$::vector<float> real(n);
+		genomes[(n / 2) * GSIZE] = -genomes[(n / 2) * GSIZE];
+		expected[n / 2] = fitness(&genomes[(n / 2) * GSIZE]);
+		farm.evaluate(&genomes[0], n, &real[0]);
+		ok = compare("farm with a dying worker", expected, real) && ok;
+		ok = (0 == ::access(DIE_FILE, F_OK)) && ok;
+		::unlink(DIE_FILE);
+	}
+
+	{
+		::setenv("MEAVE_SEED", "1", 1);
+		meave::par::Farm<float> farm($::max(2U, workers_num), 1, GSIZE, seed_fitness);
+		$::vector<float> seeds(64);
+		farm.evaluate(&genomes[0], seeds.size(), &seeds[0]);
+		$::sort(seeds.begin(), seeds.end());
+		const bool distinct = $::adjacent_find(seeds.begin(), seeds.end()) == seeds.end();
+		$::cerr << "seeds of workers: " << (distinct ? "OK" : "repeated") << $::endl;
+		ok = distinct && ok;
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+#undef NDEBUG
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/gettime.hpp>
+#include <meave/lib/par/mpsc_queue.hpp>
+
+/*
+ * Producers push numbered records, the consumer checks that records of
+ *   every producer come exactly once and in order (BLOCK) or that nothing
+ *   but the dropped ones is lost (DROP). Reports cost of push().
+ */
+
+namespace {
+
+constexpr uns PRODUCERS = 4;
+constexpr uns RECORDS = 200000;
+
+struct Record {
+	uns producer_;
+	uns seq_;
+	double payload_[2];
+};
+
+void run(const meave::par::Backpressure backpressure) {
+	meave::par::MpscQueue<Record> queue(256, backpressure);
+	$::atomic<uns> running{PRODUCERS};
+	$::vector<double> push_ns(PRODUCERS);
+
+	$::vector<$::thread> producers;
+	for (uns p = 0; p < PRODUCERS; ++p) {
+		producers.emplace_back([&queue, &running, &push_ns, p]() {
+			const double begin = meave::getrealtime();
+			for (uns _ = 0; _ < RECORDS; ++_)
+				queue.push(Record{p, _, {double(p), double(_)}});
+			push_ns[p] = (meave::getrealtime() - begin) * 1e9 / RECORDS;
+			--running;
+		});
+	}
+
+	$::vector<uns> next(PRODUCERS, 0);
+	::uint64_t received = 0;
+	Record r;
+	for (;;) {
+		const bool done = !running.load();
+		while (queue.pop(r)) {
+			assert(r.producer_ < PRODUCERS);
+			assert(r.payload_[0] == r.producer_ && r.payload_[1] == r.seq_);
+			if (backpressure == meave::par::Backpressure::BLOCK)
+				assert(r.seq_ == next[r.producer_]);
+			else
+				assert(r.seq_ >= next[r.producer_]);
+			next[r.producer_] = r.seq_ + 1;
+			++received;
+		}
+		if (done)
+			break;
+		$::this_thread::yield();
+	}
+	for (auto &th: producers)
+		th.join();
+
+	assert(received + queue.dropped() == ::uint64_t(PRODUCERS) * RECORDS);
+	if (backpressure == meave::par::Backpressure::BLOCK)
+		assert(!queue.dropped());
+
+	$::cerr << (backpressure == meave::par::Backpressure::BLOCK ? "BLOCK" : "DROP")
+		<< ": received " << received << ", dropped " << queue.dropped()
+		<< ", push " << push_ns[0] << " ns" << $::endl;
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	run(meave::par::Backpressure::BLOCK);
+	run(meave::par::Backpressure::DROP);
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#undef NDEBUG
+
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/par/steal_pool.hpp>
+
+/*
+ * Tasks that resubmit themselves must take turns round-robin on a single
+ *   thread; a tree of tasks submitted from tasks must be finished completely
+ *   by any number of threads, with idle threads stealing.
+ */
+
+namespace {
+
+typedef meave::par::StealPool StealPool;
+
+void check_round_robin() {
+	constexpr uns TASKS = 5;
+	constexpr uns STEPS = 100;
+
+	$::vector<uns> order;
+	{
+		StealPool pool(1);
+		$::vector<$::function<void()>> steps(TASKS);
+		$::vector<uns> done(TASKS, 0);
+		for (uns t = 0; t < TASKS; ++t) {
+			steps[t] = [&pool, &steps, &done, &order, t]() {
+				order.push_back(t);
+				if (++done[t] < STEPS)
+					pool.submit(steps[t]);
+			};
+		}
+		// Submitted by a task, so that the first ones don't run before the last ones are queued.
+		pool.submit([&pool, &steps]() {
+			for (uns t = 0; t < TASKS; ++t)
+				pool.submit(steps[t]);
+		});
+		pool.wait();
+	}
+
+	assert(order.size() == TASKS * STEPS);
+	for (uns _ = 0; _ < order.size(); ++_)
+		assert(order[_] == _ % TASKS);
+}
+
+void check_tree(const uns threads_num) {
+	constexpr uns DEPTH = 14;
+
+	$::atomic<uns> leaves(0);
+	$::vector<$::atomic<uns>> per_thread(threads_num);
+	for (auto &$: per_thread)
+		$ = 0;
+
+	StealPool pool(threads_num);
+	$::function<void(uns)> node = [&](const uns depth) {
+		if (depth == DEPTH) {
+			++leaves;
+			return;
+		}
+		for (uns _ = 0; _ < 2; ++_)
+			pool.submit([&node, depth]() { node(depth + 1); });
+	};
+	// One root, all other tasks are submitted by tasks of its thread, so others must steal.
+	pool.submit([&node]() { node(0); });
+	pool.wait();
+
+	assert(leaves == 1U << DEPTH);
+	$::cerr << threads_num << " threads: " << leaves << " leaves" << $::endl;
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_round_robin();
+	check_tree(1);
+	check_tree(4);
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/gettime.hpp>
+#include <meave/lib/par/topology.hpp>
+#include <meave/lib/par/workers.hpp>
+
+/*
+ * Prints the topology, checks placements and benchmarks a memory-bound
+ *   sweep over per-thread slices for every placement, once with slices
+ *   first-touched by their threads and once touched by the main thread.
+ *   The difference shows on machines with more NUMA nodes.
+ */
+
+namespace {
+
+typedef meave::par::Placement Placement;
+typedef meave::par::Topology Topology;
+
+constexpr ::size_t ITEMS = 1 << 24;
+constexpr uns PASSES = 10;
+
+const char *name(const Placement placement) noexcept {
+	switch (placement) {
+	case Placement::NONE: return "none";
+	case Placement::COMPACT: return "compact";
+	case Placement::SCATTER: return "scatter";
+	case Placement::ONE_PER_CORE: return "one-per-core";
+	}
+	return "?";
+}
+
+void check(const Topology &topology) {
+	const uns n = topology.pus_num();
+
+	for (const Placement placement: {Placement::COMPACT, Placement::SCATTER}) {
+		const $::vector<uns> pus = topology.placement(placement, n);
+		assert($::set<uns>(pus.begin(), pus.end()).size() == n);
+		const $::vector<uns> twice = topology.placement(placement, 2 * n);
+		for (uns _ = 0; _ < n; ++_)
+			assert(twice[_] == twice[_ + n] && twice[_] == pus[_]);
+	}
+
+	const $::vector<uns> compact = topology.placement(Placement::COMPACT, n);
+	for (uns _ = 0; _ < n; ++_)
+		assert(compact[_] == _);
+
+	const $::vector<uns> one_per_core = topology.placement(Placement::ONE_PER_CORE, topology.cores_num());
+	$::set<uns> cores;
+	for (const uns pu: one_per_core)
+		assert(cores.insert(topology.pus()[pu].core_).second);
+
+	// Scatter uses every NUMA node before it uses a second core of any of them.
+	const $::vector<uns> scatter = topology.placement(Placement::SCATTER, $::min(n, topology.numa_nodes_num()));
+	$::set<uns> nodes;
+	for (const uns pu: scatter)
+		nodes.insert(topology.pus()[pu].numa_node_);
+	assert(nodes.size() == scatter.size());
+}
+
+double sweep(const Topology &topology, const Placement placement, const bool first_touch) {
+	const uns threads_num = topology.threads_num(placement);
+	const $::vector<uns> pus = topology.placement(placement, threads_num);
+	meave::par::Workers workers(threads_num, [&topology, &pus, placement](const uns th_id) {
+		if (placement != Placement::NONE && !topology.bind_thread(pus[th_id]))
+			$::cerr << "Cannot bind thread " << th_id << ": " << ::strerror(errno) << $::endl;
+	});
+
+	meave::par::FirstTouchArray<double> data(ITEMS);
+	if (first_touch) {
+		workers.for_threads([&workers, &data](const uns th_id) {
+			const auto s = workers.slice(0, ITEMS, th_id);
+			$::iota(&data[s.first], &data[s.second], double(s.first));
+		});
+	} else {
+		$::iota(data.begin(), data.end(), 0.);
+	}
+
+	const double begin = meave::getrealtime();
+	double sum = 0;
+	for (uns _ = 0; _ < PASSES; ++_) {
+		sum += workers(0, ITEMS, [&data](const uns i) -> double {
+			return data[i];
+		});
+	}
+	const double elapsed = meave::getrealtime() - begin;
+	assert(sum == PASSES * (ITEMS - 1.) * ITEMS / 2);
+
+	return PASSES * ITEMS * sizeof(double) / elapsed / (1 << 30);
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	const Topology topology;
+	$::cerr << "PUs: " << topology.pus_num() << ", cores: " << topology.cores_num()
+		<< ", NUMA nodes: " << topology.numa_nodes_num() << $::endl;
+	for (const auto &pu: topology.pus()) {
+		$::cerr << "\tcpu " << pu.os_index_ << ": core " << pu.core_ << ", smt " << pu.smt_
+			<< ", L2 " << int(pu.l2_) << ", L3 " << int(pu.l3_) << ", node " << pu.numa_node_ << $::endl;
+	}
+
+	check(topology);
+
+	for (const Placement placement: {Placement::NONE, Placement::COMPACT, Placement::SCATTER, Placement::ONE_PER_CORE}) {
+		$::cerr << name(placement) << ": "
+			<< sweep(topology, placement, true) << " GiB/s first-touch, "
+			<< sweep(topology, placement, false) << " GiB/s main-thread-touch" << $::endl;
+	}
+
+	return 0;
+}
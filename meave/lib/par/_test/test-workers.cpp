@@ -0,0 +1,63 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <meave/commons.hpp>
+#include <meave/lib/par/workers.hpp>
+
+/*
+ * Checks that Workers::sum() gives bit-identical results for any number of
+ *   threads, unlike summing per-thread slices by operator().
+ */
+
+namespace {
+
+bool same(const float a, const float b) noexcept {
+	return !::memcmp(&a, &b, sizeof a);
+}
+
+void check_sum() {
+	$::default_random_engine rand;
+	$::uniform_real_distribution<float> dist(-1.f, 1.f);
+	$::vector<float> x(2201);
+	for (uns _ = 0; _ < x.size(); ++_)
+		x[_] = dist(rand) * (_ % 5 ? 1.f : 1e5f);
+
+	long double exact = 0;
+	for (const float $: x)
+		exact += $;
+
+	const auto fn = [&x](const uns i) { return x[i]; };
+	float first = 0;
+	float first_slices = 0;
+	uns slices_differ = 0;
+	for (uns threads = 1; threads <= 8; ++threads) {
+		meave::par::Workers workers(threads);
+		for (uns _ = 0; _ < 20; ++_) {
+			const float s = workers.sum(0, x.size(), fn);
+			if (threads == 1 && !_)
+				first = s;
+			assert(same(s, first));
+		}
+		const float slices = workers(0, x.size(), fn);
+		if (threads == 1)
+			first_slices = slices;
+		slices_differ += !same(slices, first_slices);
+	}
+	assert(::fabsl(first - exact) <= 1e-6 * ::fabsl(exact) + 1e-3);
+	$::cerr << "sum " << first << ", per-thread slices differed for " << slices_differ << " of 7 other thread counts" << $::endl;
+}
+
+} /* Anonymouse Namespace */
+
+int
+main(void) {
+	check_sum();
+
+	return 0;
+}
@@ -0,0 +1,244 @@
+#ifndef MEAVE_LIB_PAR_FARM_HPP_INCLUDED
+#	define MEAVE_LIB_PAR_FARM_HPP_INCLUDED
+
+#	include <algorithm>
+#	include <cerrno>
+#	include <cstdint>
+#	include <cstring>
+#	include <deque>
+#	include <type_traits>
+#	include <vector>
+
+#	include <poll.h>
+#	include <sys/socket.h>
+#	include <sys/types.h>
+#	include <unistd.h>
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+#	include "meave/lib/raii/fd.hpp"
+#	include "meave/lib/raii/fork.hpp"
+#	include "meave/lib/seed.hpp"
+
+namespace meave { namespace par {
+
+/**
+ * Farm of worker processes evaluating fitness of genomes.
+ *
+ * Workers are forked in the constructor, each of them is connected to the
+ *   master by a Unix domain socket (socketpair). A worker is a copy of the
+ *   master process, so eval can be any function of the master, e.g. a lambda
+ *   calling a fitness method of the GA. Workers draw seeds of their own
+ *   (meave::seed_fork()), also with MEAVE_SEED.
+ *
+ * Framing (native byte order, both sides are the same binary):
+ *   request:  uint32_t id, uint32_t len, Float genome[len]
+ *   response: uint32_t id, Float fitness
+ *
+ * Up to depth requests are outstanding per worker, so workers don't wait
+ *   for the master between evaluations. When a worker dies, its outstanding
+ *   requests are sent to the remaining workers.
+ */
+template<typename Float>
+class Farm {
+	static_assert($::is_trivially_copyable<Float>::value, "Float must be trivially copyable");
+
+private:
+	struct Request {
+		::uint32_t id_;
+		::uint32_t len_;
+	};
+
+	struct Response {
+		::uint32_t id_;
+		Float fitness_;
+	};
+
+	struct Worker {
+		raii::FD fd_;
+		raii::Fork process_;
+		$::vector< ::uint32_t> in_flight_;
+		$::vector<char> buf_;		///< Responses read so far, the last one may be incomplete.
+		::size_t buf_len_;
+	};
+
+	const uns len_;
+	const uns depth_;
+	$::vector<Worker> workers_;
+
+	static bool write_all(const int fd, const void *p, ::size_t len) noexcept {
+		const char *c = static_cast<const char*>(p);
+		while (len) {
+			const ::ssize_t ret = ::send(fd, c, len, MSG_NOSIGNAL);
+			if (ret == -1 && errno == EINTR)
+				continue;
+			if (ret <= 0)
+				return false;
+			c += ret;
+			len -= ret;
+		}
+		return true;
+	}
+
+	static bool read_all(const int fd, void *p, ::size_t len) noexcept {
+		char *c = static_cast<char*>(p);
+		while (len) {
+			const ::ssize_t ret = ::read(fd, c, len);
+			if (ret == -1 && errno == EINTR)
+				continue;
+			if (ret <= 0)
+				return false;
+			c += ret;
+			len -= ret;
+		}
+		return true;
+	}
+
+	template<typename Eval>
+	static int serve(const int fd, const uns len, Eval &eval) noexcept {
+		Float genome[len];
+		for (;;) {
+			Request req;
+			if (!read_all(fd, &req, sizeof req))
+				return 0;
+			if (req.len_ != len || !read_all(fd, genome, sizeof genome))
+				return 1;
+
+			const Response resp{req.id_, eval(static_cast<const Float*>(genome))};
+			if (!write_all(fd, &resp, sizeof resp))
+				return 1;
+		}
+	}
+
+	bool send(Worker &w, const ::uint32_t id, const Float *genome) noexcept {
+		const Request req{id, len_};
+		if (!write_all(*w.fd_, &req, sizeof req) || !write_all(*w.fd_, genome, len_ * sizeof(Float)))
+			return false;
+		w.in_flight_.push_back(id);
+		return true;
+	}
+
+	/**
+	 * Closes connection to the worker and returns its work into the queue.
+	 */
+	void bury(Worker &w, $::deque< ::uint32_t> &queue) noexcept {
+		LOG(ERROR) << "Worker " << w.process_.pid() << " died, requeueing " << w.in_flight_.size() << " requests";
+		queue.insert(queue.begin(), w.in_flight_.begin(), w.in_flight_.end());
+		w.in_flight_.clear();
+		w.buf_len_ = 0;
+		w.fd_ = raii::FD();
+		$::error_code ec;
+		w.process_.wait(ec);
+	}
+
+public:
+	/**
+	 * Forks workers_num workers evaluating eval(const Float genome[len]).
+	 * @param depth Number of outstanding requests per worker.
+	 */
+	template<typename Eval>
+	Farm(const uns workers_num, const uns depth, const uns len, Eval &&eval)
+	:	len_(len)
+	,	depth_(depth) {
+		workers_.reserve(workers_num);
+		for (uns _ = 0; _ < workers_num; ++_) {
+			int fds[2];
+			if (-1 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds))
+				throw Error("Cannot create socketpair: %m");
+			raii::FD master{fds[0]};
+			raii::FD worker{fds[1]};
+
+			raii::Fork process{[this, &worker, &master, &eval, len, _]() {
+				// Ends of other workers must not be kept open by this one.
+				for (Worker &w: workers_)
+					w.fd_ = raii::FD();
+				master = raii::FD();
+				meave::seed_fork(_);
+				return serve(*worker, len, eval);
+			}};
+
+			workers_.push_back(Worker{$::move(master), $::move(process), {}, $::vector<char>(depth * sizeof(Response)), 0});
+		}
+	}
+	Farm(const Farm&) = delete;
+	Farm &operator=(const Farm&) = delete;
+
+	uns workers_num() const noexcept {
+		return workers_.size();
+	}
+
+	/**
+	 * Evaluates n genomes stored one after another and writes their
+	 *   fitnesses into fitnesses.
+	 * @throw Error When all workers are dead.
+	 */
+	void evaluate(const Float *genomes, const uns n, Float *fitnesses) {
+		$::deque< ::uint32_t> queue;
+		for (uns _ = 0; _ < n; ++_)
+			queue.push_back(_);
+
+		$::vector<struct ::pollfd> pfds(workers_.size());
+		for (uns done = 0; done < n; ) {
+			uns alive = 0;
+			for (uns _ = 0; _ < workers_.size(); ++_) {
+				Worker &w = workers_[_];
+				while (w.fd_ && w.in_flight_.size() < depth_ && !queue.empty()) {
+					const ::uint32_t id = queue.front();
+					queue.pop_front();
+					if (!send(w, id, &genomes[::size_t(id) * len_])) {
+						queue.push_front(id);
+						bury(w, queue);
+					}
+				}
+				pfds[_] = {w.fd_ ? *w.fd_ : -1, POLLIN, 0};
+				alive += bool(w.fd_);
+			}
+			if (!alive)
+				throw Error("All %u workers of the farm are dead", unsigned(workers_.size()));
+
+			if (-1 == ::poll(&pfds[0], pfds.size(), -1)) {
+				if (errno == EINTR)
+					continue;
+				throw Error("Cannot poll workers: %m");
+			}
+
+			for (uns _ = 0; _ < workers_.size(); ++_) {
+				Worker &w = workers_[_];
+				if (!w.fd_ || !pfds[_].revents)
+					continue;
+
+				const ::ssize_t ret = ::read(*w.fd_, &w.buf_[w.buf_len_], w.buf_.size() - w.buf_len_);
+				if (ret == -1 && errno == EINTR)
+					continue;
+				if (ret <= 0) {
+					bury(w, queue);
+					continue;
+				}
+
+				w.buf_len_ += ret;
+				::size_t off = 0;
+				for (; off + sizeof(Response) <= w.buf_len_; off += sizeof(Response)) {
+					Response resp;
+					::memcpy(&resp, &w.buf_[off], sizeof resp);
+					fitnesses[resp.id_] = resp.fitness_;
+					w.in_flight_.erase($::find(w.in_flight_.begin(), w.in_flight_.end(), resp.id_));
+					++done;
+				}
+				::memmove(&w.buf_[0], &w.buf_[off], w.buf_len_ - off);
+				w.buf_len_ -= off;
+			}
+		}
+	}
+
+	/**
+	 * Closes connections, workers exit when they see EOF.
+	 */
+	~Farm() noexcept {
+		for (Worker &w: workers_)
+			w.fd_ = raii::FD();
+	}
+};
+
+} } /* namespace meave::par */
+
+#endif // MEAVE_LIB_PAR_FARM_HPP_INCLUDED
@@ -0,0 +1,169 @@
+#ifndef MEAVE_LIB_PAR_MIGRATION_HPP_INCLUDED
+#	define MEAVE_LIB_PAR_MIGRATION_HPP_INCLUDED
+
+#	include <atomic>
+#	include <cstdint>
+#	include <cstring>
+#	include <new>
+#	include <type_traits>
+
+#	include "meave/commons.hpp"
+
+namespace meave { namespace par {
+
+/**
+ * Migration board for islands running in different processes.
+ *
+ * It lives in a memory shared by all islands (MAP_SHARED mapping created
+ *   before fork()). Every island owns one outbox with a ring of slots,
+ *   it is the only writer of the outbox, everybody may read it.
+ * Slots are protected by sequence counters (seqlock): a writer never waits
+ *   for readers, a reader that catches a slot in the middle of a write just
+ *   skips it. Nobody takes a lock, so a slow or dead island cannot stall
+ *   the others.
+ *
+ * Records are arrays of record_len() items of T .
+ *   The outbox also counts evaluations done by the island, so that the
+ *   driver can watch progress.
+ */
+template<typename T>
+class MigrationRing {
+	static_assert($::is_trivially_copyable<T>::value, "T must be trivially copyable");
+	static_assert(sizeof($::atomic< ::uint64_t>) == sizeof(::uint64_t), "atomic<uint64_t> has a lock");
+
+private:
+	enum { CACHE_LINE = 64 };
+
+	struct alignas(CACHE_LINE) Outbox {
+		$::atomic< ::uint64_t> ticket_;		///< Number of records ever published.
+		$::atomic< ::uint64_t> evaluations_;	///< Fitness evaluations done by the island.
+	};
+
+	struct alignas(CACHE_LINE) Slot {
+		$::atomic< ::uint64_t> seq_;		///< Odd while the slot is being written.
+	};
+
+	const uns islands_;
+	const uns slots_;
+	const uns record_len_;
+	char *const mem_;
+
+	static ::size_t round_up(const ::size_t $) noexcept {
+		return ($ + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+	}
+
+	::size_t slot_size() const noexcept {
+		return round_up(sizeof(Slot) + record_len_ * sizeof(T));
+	}
+
+	::size_t outbox_size() const noexcept {
+		return round_up(sizeof(Outbox)) + slots_ * slot_size();
+	}
+
+	Outbox &outbox(const uns island) const noexcept {
+		return *reinterpret_cast<Outbox*>(mem_ + island * outbox_size());
+	}
+
+	Slot &slot(const uns island, const ::uint64_t ticket) const noexcept {
+		return *reinterpret_cast<Slot*>(mem_ + island * outbox_size() + round_up(sizeof(Outbox)) + ticket % slots_ * slot_size());
+	}
+
+	static T *record(Slot &slot) noexcept {
+		return reinterpret_cast<T*>(&slot + 1);
+	}
+
+public:
+	/**
+	 * @return Size of memory needed for the board.
+	 */
+	static ::size_t size(const uns islands, const uns slots, const uns record_len) noexcept {
+		return islands * (round_up(sizeof(Outbox)) + slots * round_up(sizeof(Slot) + record_len * sizeof(T)));
+	}
+
+	/**
+	 * Attaches to the board in mem. The one, that creates the memory,
+	 *   calls init() before the board is used by others.
+	 */
+	MigrationRing(void *mem, const uns islands, const uns slots, const uns record_len) noexcept
+	:	islands_(islands)
+	,	slots_(slots)
+	,	record_len_(record_len)
+	,	mem_(static_cast<char*>(mem)) {
+	}
+
+	void init() noexcept {
+		for (uns island = 0; island < islands_; ++island) {
+			new(&outbox(island)) Outbox{{0}, {0}};
+			for (uns _ = 0; _ < slots_; ++_)
+				new(&slot(island, _)) Slot{{0}};
+		}
+	}
+
+	uns islands() const noexcept {
+		return islands_;
+	}
+
+	uns record_len() const noexcept {
+		return record_len_;
+	}
+
+	/**
+	 * Publishes a record into outbox of the island, the oldest one is
+	 *   overwritten. Must be called only by the owner of the outbox.
+	 */
+	void publish(const uns island, const T *rec) noexcept {
+		Outbox &o = outbox(island);
+		const ::uint64_t ticket = o.ticket_.load($::memory_order_relaxed);
+		Slot &s = slot(island, ticket);
+
+		const ::uint64_t seq = s.seq_.load($::memory_order_relaxed);
+		s.seq_.store(seq + 1, $::memory_order_relaxed);
+		$::atomic_thread_fence($::memory_order_release);
+		::memcpy(record(s), rec, record_len_ * sizeof(T));
+		s.seq_.store(seq + 2, $::memory_order_release);
+
+		o.ticket_.store(ticket + 1, $::memory_order_release);
+	}
+
+	/**
+	 * Calls fn(rec) for every record published by the island since *since
+	 *   and still present in its ring. Records being overwritten are skipped.
+	 * *since is moved behind the last published record.
+	 * @return Number of records passed to fn.
+	 */
+	template<typename Fn>
+	uns collect(const uns island, ::uint64_t *since, Fn &&fn) const {
+		const ::uint64_t end = outbox(island).ticket_.load($::memory_order_acquire);
+		::uint64_t ticket = *since + slots_ < end ? end - slots_ : *since;
+		*since = end;
+
+		T rec[record_len_];
+		uns $$ = 0;
+		for (; ticket < end; ++ticket) {
+			Slot &s = slot(island, ticket);
+			const ::uint64_t seq = s.seq_.load($::memory_order_acquire);
+			if (seq & 1)
+				continue;
+			::memcpy(rec, record(s), record_len_ * sizeof(T));
+			$::atomic_thread_fence($::memory_order_acquire);
+			if (seq != s.seq_.load($::memory_order_relaxed))
+				continue;
+
+			fn(static_cast<const T*>(rec));
+			++$$;
+		}
+		return $$;
+	}
+
+	void add_evaluations(const uns island, const ::uint64_t evaluations) noexcept {
+		outbox(island).evaluations_.fetch_add(evaluations, $::memory_order_relaxed);
+	}
+
+	::uint64_t evaluations(const uns island) const noexcept {
+		return outbox(island).evaluations_.load($::memory_order_relaxed);
+	}
+};
+
+} } /* namespace meave::par */
+
+#endif // MEAVE_LIB_PAR_MIGRATION_HPP_INCLUDED
@@ -0,0 +1,137 @@
+#ifndef MEAVE_LIB_PAR_MPSC_QUEUE_HPP_INCLUDED
+#	define MEAVE_LIB_PAR_MPSC_QUEUE_HPP_INCLUDED
+
+#	include <atomic>
+#	include <cstdint>
+#	include <thread>
+#	include <type_traits>
+#	include <vector>
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+
+namespace meave { namespace par {
+
+/**
+ * What push() does when the queue is full.
+ */
+enum class Backpressure {
+	  BLOCK		///< Wait until the consumer makes room.
+	, DROP		///< Throw the record away and count it.
+};
+
+/**
+ * Bounded queue of fixed-size records, many producers and one consumer.
+ *
+ * Every cell has a sequence number telling whether it is free for the
+ *   ticket of a producer or full for the ticket of the consumer (D. Vyukov's
+ *   bounded queue). A producer takes a ticket by one CAS and copies the
+ *   record, nobody takes a lock and producers never wait for each other
+ *   longer than it takes to copy a record.
+ */
+template<typename T>
+class MpscQueue {
+	static_assert($::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+private:
+	enum { CACHE_LINE = 64 };
+
+	struct Cell {
+		$::atomic< ::uint64_t> seq_;
+		T data_;
+	};
+
+	const Backpressure backpressure_;
+	const ::uint64_t mask_;
+	$::vector<Cell> cells_;
+
+	alignas(CACHE_LINE) $::atomic< ::uint64_t> enqueue_pos_;
+	alignas(CACHE_LINE) $::atomic< ::uint64_t> dequeue_pos_;
+	alignas(CACHE_LINE) $::atomic< ::uint64_t> dropped_;
+
+	bool try_push(const T &$) noexcept {
+		::uint64_t pos = enqueue_pos_.load($::memory_order_relaxed);
+		Cell *cell;
+		for (;;) {
+			cell = &cells_[pos & mask_];
+			const ::uint64_t seq = cell->seq_.load($::memory_order_acquire);
+			const ::int64_t diff = ::int64_t(seq - pos);
+			if (diff == 0) {
+				if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, $::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return false;
+			} else {
+				pos = enqueue_pos_.load($::memory_order_relaxed);
+			}
+		}
+
+		cell->data_ = $;
+		cell->seq_.store(pos + 1, $::memory_order_release);
+		return true;
+	}
+
+public:
+	/**
+	 * @param capacity Number of records, it must be a power of two.
+	 */
+	MpscQueue(const uns capacity, const Backpressure backpressure)
+	:	backpressure_(backpressure)
+	,	mask_(capacity - 1)
+	,	cells_(capacity)
+	,	enqueue_pos_(0)
+	,	dequeue_pos_(0)
+	,	dropped_(0) {
+		if (!capacity || (capacity & (capacity - 1)))
+			throw Error("Capacity of queue must be a power of two: %u", capacity);
+		for (uns _ = 0; _ < capacity; ++_)
+			cells_[_].seq_.store(_, $::memory_order_relaxed);
+	}
+	MpscQueue(const MpscQueue&) = delete;
+	MpscQueue &operator=(const MpscQueue&) = delete;
+
+	/**
+	 * Called by producers.
+	 * @return false When the record was dropped.
+	 */
+	bool push(const T &$) noexcept {
+		if (try_push($))
+			return true;
+
+		if (backpressure_ == Backpressure::DROP) {
+			dropped_.fetch_add(1, $::memory_order_relaxed);
+			return false;
+		}
+
+		while (!try_push($))
+			$::this_thread::yield();
+		return true;
+	}
+
+	/**
+	 * Called by the consumer only.
+	 * @return false When the queue is empty.
+	 */
+	bool pop(T &$) noexcept {
+		const ::uint64_t pos = dequeue_pos_.load($::memory_order_relaxed);
+		Cell &cell = cells_[pos & mask_];
+		if (cell.seq_.load($::memory_order_acquire) != pos + 1)
+			return false;
+
+		$ = cell.data_;
+		cell.seq_.store(pos + mask_ + 1, $::memory_order_release);
+		dequeue_pos_.store(pos + 1, $::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+	 * @return Number of records dropped because the queue was full.
+	 */
+	::uint64_t dropped() const noexcept {
+		return dropped_.load($::memory_order_relaxed);
+	}
+};
+
+} } /* namespace meave::par */
+
+#endif // MEAVE_LIB_PAR_MPSC_QUEUE_HPP_INCLUDED
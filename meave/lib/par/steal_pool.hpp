@@ -0,0 +1,189 @@
+#ifndef MEAVE_LIB_PAR_STEAL_POOL_HPP_INCLUDED
+#	define MEAVE_LIB_PAR_STEAL_POOL_HPP_INCLUDED
+
+#	include <atomic>
+#	include <condition_variable>
+#	include <deque>
+#	include <functional>
+#	include <memory>
+#	include <mutex>
+#	include <thread>
+#	include <vector>
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/trace.hpp"
+
+namespace meave { namespace par {
+
+/**
+ * Pool of threads running independent tasks, with a queue per thread and
+ *   work stealing.
+ *
+ * A thread takes tasks from the front of its own queue and a task submitted
+ *   by a running task goes to the back of the queue of its thread, so tasks
+ *   that resubmit themselves (e.g. one step of a long computation) take
+ *   turns round-robin. An idle thread steals from the back of the other
+ *   queues. Tasks submitted from outside of the pool are spread over the
+ *   queues round-robin.
+ *
+ * Unlike Workers, the calling thread doesn't take part in the work.
+ */
+class StealPool {
+public:
+	typedef $::function<void()> Task;
+
+private:
+	struct Queue {
+		$::mutex mutex_;
+		$::deque<Task> tasks_;
+	};
+
+	$::vector<$::unique_ptr<Queue>> queues_;
+	$::vector<$::thread> threads_;
+
+	$::mutex mutex_;
+	$::condition_variable cv_work_;
+	$::condition_variable cv_done_;
+	$::atomic<uns> next_queue_;
+	$::atomic< ::uint64_t> queued_;	///< Tasks in queues.
+	::uint64_t pending_;		///< Tasks submitted and not finished, under mutex_.
+	bool stop_;
+
+	/**
+	 * @return Index of the pool thread running the caller, ~0U outside of the pool.
+	 */
+	static uns &th_id() noexcept {
+		static thread_local uns $$ = ~0U;
+		return $$;
+	}
+
+	bool pop(const uns th, Task &task) {
+		{
+			Queue &q = *queues_[th];
+			$::lock_guard<$::mutex> lock(q.mutex_);
+			if (!q.tasks_.empty()) {
+				task = $::move(q.tasks_.front());
+				q.tasks_.pop_front();
+				--queued_;
+				return true;
+			}
+		}
+		for (uns _ = 1; _ < queues_.size(); ++_) {
+			Queue &q = *queues_[(th + _) % queues_.size()];
+			$::lock_guard<$::mutex> lock(q.mutex_);
+			if (!q.tasks_.empty()) {
+				task = $::move(q.tasks_.back());
+				q.tasks_.pop_back();
+				--queued_;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void run(const uns th, const $::function<void(uns)> &on_start) noexcept {
+		th_id() = th;
+		if (on_start)
+			on_start(th);
+
+		Task task;
+		for (;;) {
+			if (!pop(th, task)) {
+				$::unique_lock<$::mutex> lock(mutex_);
+				cv_work_.wait(lock, [this]() { return stop_ || queued_; });
+				if (stop_ && !queued_)
+					return;
+				continue;
+			}
+
+			{
+				const trace::Scope scope("task", "pool");
+				task();
+			}
+			task = nullptr;
+
+			$::lock_guard<$::mutex> lock(mutex_);
+			if (!--pending_)
+				cv_done_.notify_all();
+		}
+	}
+
+public:
+	/**
+	 * @param on_start Called as on_start(th_id) by every thread before its
+	 *   first task, e.g. to bind it to a CPU (see topology.hpp).
+	 */
+	explicit StealPool(const uns threads_num, const $::function<void(uns)> &on_start = nullptr)
+	:	next_queue_(0)
+	,	queued_(0)
+	,	pending_(0)
+	,	stop_(false) {
+		for (uns _ = 0; _ < $::max(1U, threads_num); ++_)
+			queues_.emplace_back(new Queue);
+		for (uns _ = 0; _ < queues_.size(); ++_)
+			threads_.emplace_back([this, _, on_start]() { run(_, on_start); });
+	}
+	StealPool(const StealPool&) = delete;
+	StealPool &operator=(const StealPool&) = delete;
+
+	uns threads_num() const noexcept {
+		return queues_.size();
+	}
+
+	/**
+	 * @return Index of the pool thread running the caller, ~0U outside of any pool.
+	 */
+	static uns current() noexcept {
+		return th_id();
+	}
+
+	/**
+	 * @return Tasks waiting in queues, a snapshot.
+	 */
+	::uint64_t queued() const noexcept {
+		return queued_.load($::memory_order_relaxed);
+	}
+
+	void submit(Task task) {
+		{
+			$::lock_guard<$::mutex> lock(mutex_);
+			++pending_;
+		}
+		const uns th = th_id() < queues_.size() ? th_id() : next_queue_++ % queues_.size();
+		{
+			Queue &q = *queues_[th];
+			$::lock_guard<$::mutex> lock(q.mutex_);
+			q.tasks_.push_back($::move(task));
+			++queued_;
+		}
+		// Under the mutex, so that no thread misses the task between its check and wait.
+		$::lock_guard<$::mutex> lock(mutex_);
+		cv_work_.notify_one();
+	}
+
+	/**
+	 * Waits until all submitted tasks, including those they submit, are finished.
+	 */
+	void wait() {
+		$::unique_lock<$::mutex> lock(mutex_);
+		cv_done_.wait(lock, [this]() { return !pending_; });
+	}
+
+	/**
+	 * Finishes all submitted tasks.
+	 */
+	~StealPool() noexcept {
+		wait();
+		{
+			$::lock_guard<$::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		cv_work_.notify_all();
+		for (auto &th: threads_)
+			th.join();
+	}
+};
+
+} } /* namespace meave::par */
+
+#endif // MEAVE_LIB_PAR_STEAL_POOL_HPP_INCLUDED
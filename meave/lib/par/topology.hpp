@@ -0,0 +1,260 @@
+#ifndef MEAVE_LIB_PAR_TOPOLOGY_HPP_INCLUDED
+#	define MEAVE_LIB_PAR_TOPOLOGY_HPP_INCLUDED
+
+#	include <algorithm>
+#	include <cstdint>
+#	include <tuple>
+#	include <type_traits>
+#	include <vector>
+
+#	include <sys/mman.h>
+
+#	include <hwloc.h>
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+
+namespace meave { namespace par {
+
+/**
+ * Order in which threads are placed on processing units.
+ */
+enum class Placement {
+	  NONE		///< Threads are not bound, the scheduler moves them freely.
+	, COMPACT	///< Fill SMT siblings of a core, then cores of a node, then next node.
+	, SCATTER	///< Round-robin over NUMA nodes, other cores first, SMT siblings last.
+	, ONE_PER_CORE	///< One thread per physical core, in order of COMPACT.
+};
+
+/**
+ * Machine topology as discovered by hwloc: processing units (PUs, i.e.
+ *   hardware threads), their cores, L2 and L3 caches and NUMA nodes.
+ * Only PUs the process is allowed to run on are listed.
+ *
+ * Works with hwloc 1.11 (built by _/_/build-hwloc.pl) and with hwloc 2.x .
+ */
+class Topology {
+public:
+	enum { NONE = ~0U };
+
+	/**
+	 * One processing unit, all indexes are logical (dense, from 0).
+	 * NONE stands for an object hwloc doesn't know of.
+	 */
+	struct Pu {
+		uns os_index_;	///< Index of the CPU for the OS.
+		uns core_;
+		uns smt_;	///< Rank of the PU among SMT siblings of its core.
+		uns l2_;
+		uns l3_;
+		uns numa_node_;
+	};
+
+private:
+	::hwloc_topology_t topology_;
+	$::vector<Pu> pus_;
+	uns cores_num_;
+	uns numa_nodes_num_;
+
+	static uns logical_index(const ::hwloc_obj_t obj) noexcept {
+		return obj ? obj->logical_index : uns(NONE);
+	}
+
+	static ::hwloc_obj_t cache(::hwloc_obj_t obj, const uns level) noexcept {
+		for (; obj; obj = obj->parent) {
+#	if HWLOC_API_VERSION >= 0x00020000
+			if ((level == 2 && obj->type == HWLOC_OBJ_L2CACHE) || (level == 3 && obj->type == HWLOC_OBJ_L3CACHE))
+				return obj;
+#	else
+			if (obj->type == HWLOC_OBJ_CACHE && obj->attr->cache.depth == level && obj->attr->cache.type != HWLOC_OBJ_CACHE_INSTRUCTION)
+				return obj;
+#	endif
+		}
+		return nullptr;
+	}
+
+	void discover() {
+		const int nodes_num = ::hwloc_get_nbobjs_by_type(topology_, HWLOC_OBJ_NUMANODE);
+		numa_nodes_num_ = $::max(1, nodes_num);
+		cores_num_ = $::max(0, ::hwloc_get_nbobjs_by_type(topology_, HWLOC_OBJ_CORE));
+
+		const int pus_num = ::hwloc_get_nbobjs_by_type(topology_, HWLOC_OBJ_PU);
+		if (pus_num <= 0)
+			throw Error("No processing unit found");
+
+		for (int _ = 0; _ < pus_num; ++_) {
+			const ::hwloc_obj_t pu = ::hwloc_get_obj_by_type(topology_, HWLOC_OBJ_PU, _);
+			const ::hwloc_obj_t core = ::hwloc_get_ancestor_obj_by_type(topology_, HWLOC_OBJ_CORE, pu);
+
+			// NUMA nodes are not ancestors of PUs in hwloc 2, they are found by cpuset.
+			uns numa_node = 0;
+			for (int node_idx = 0; node_idx < nodes_num; ++node_idx) {
+				const ::hwloc_obj_t node = ::hwloc_get_obj_by_type(topology_, HWLOC_OBJ_NUMANODE, node_idx);
+				if (node->cpuset && ::hwloc_bitmap_isset(node->cpuset, pu->os_index)) {
+					numa_node = node_idx;
+					break;
+				}
+			}
+
+			pus_.push_back(Pu{
+				  pu->os_index
+				, core ? core->logical_index : uns(_)
+				, core ? pu->sibling_rank : 0
+				, logical_index(cache(pu, 2))
+				, logical_index(cache(pu, 3))
+				, numa_node
+			});
+		}
+		if (!cores_num_)
+			cores_num_ = pus_.size();
+	}
+
+public:
+	Topology() {
+		if (-1 == ::hwloc_topology_init(&topology_))
+			throw Error("Cannot initialize hwloc topology: %m");
+		try {
+			if (-1 == ::hwloc_topology_load(topology_))
+				throw Error("Cannot load hwloc topology: %m");
+			discover();
+		} catch (...) {
+			::hwloc_topology_destroy(topology_);
+			throw;
+		}
+	}
+	Topology(const Topology&) = delete;
+	Topology &operator=(const Topology&) = delete;
+
+	const $::vector<Pu> &pus() const noexcept {
+		return pus_;
+	}
+
+	uns pus_num() const noexcept {
+		return pus_.size();
+	}
+
+	uns cores_num() const noexcept {
+		return cores_num_;
+	}
+
+	uns numa_nodes_num() const noexcept {
+		return numa_nodes_num_;
+	}
+
+	/**
+	 * @return Number of threads that fill the machine for the placement.
+	 */
+	uns threads_num(const Placement placement) const noexcept {
+		return placement == Placement::ONE_PER_CORE ? cores_num() : pus_num();
+	}
+
+	/**
+	 * @return Indexes into pus() for threads 0 .. threads_num - 1 .
+	 *   When there are more threads than PUs, the order starts over again.
+	 */
+	$::vector<uns> placement(const Placement placement, const uns threads_num) const {
+		$::vector<uns> order;
+		for (uns _ = 0; _ < pus_.size(); ++_) {
+			if (placement != Placement::ONE_PER_CORE || !pus_[_].smt_)
+				order.push_back(_);
+		}
+
+		if (placement == Placement::SCATTER) {
+			// Rank of the core of every PU among cores of its NUMA node.
+			$::vector<uns> core_rank(pus_.size());
+			$::vector<uns> cores_seen(numa_nodes_num_, 0);
+			for (uns _ = 0; _ < pus_.size(); ++_) {
+				const bool new_core = !_ || pus_[_].core_ != pus_[_ - 1].core_;
+				if (new_core)
+					++cores_seen[pus_[_].numa_node_];
+				core_rank[_] = cores_seen[pus_[_].numa_node_] - 1;
+			}
+			$::stable_sort(order.begin(), order.end(), [this, &core_rank](const uns a, const uns b) {
+				return $::make_tuple(pus_[a].smt_, core_rank[a], pus_[a].numa_node_)
+				     < $::make_tuple(pus_[b].smt_, core_rank[b], pus_[b].numa_node_);
+			});
+		}
+
+		$::vector<uns> $$(threads_num);
+		for (uns _ = 0; _ < threads_num; ++_)
+			$$[_] = order[_ % order.size()];
+		return $$;
+	}
+
+	/**
+	 * Binds the calling thread to the PU, its memory is then allocated on
+	 *   the NUMA node of the PU by the first touch.
+	 * @return false When the OS refused the binding (errno is set).
+	 */
+	bool bind_thread(const uns pu_idx) const noexcept {
+		const ::hwloc_obj_t pu = ::hwloc_get_obj_by_type(topology_, HWLOC_OBJ_PU, pu_idx);
+		return pu && 0 == ::hwloc_set_cpubind(topology_, pu->cpuset, HWLOC_CPUBIND_THREAD);
+	}
+
+	~Topology() noexcept {
+		::hwloc_topology_destroy(topology_);
+	}
+};
+
+/**
+ * Array of trivial items, whose pages are not touched before the first
+ *   write. Every page is therefore placed on the NUMA node of the thread that
+ *   writes it first, e.g. a slice of population is local to the thread that
+ *   initializes and later evaluates it.
+ * Memory is zeroed like anonymous mmap always is.
+ */
+template<typename T>
+class FirstTouchArray {
+	static_assert($::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+private:
+	T *mem_;
+	::size_t size_;
+
+public:
+	explicit FirstTouchArray(const ::size_t size)
+	:	mem_(nullptr)
+	,	size_(size) {
+		if (!size_)
+			return;
+		void *mem = ::mmap(0, size_ * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mem == MAP_FAILED)
+			throw Error("Cannot mmap memory of size: %zu: %m", size_ * sizeof(T));
+		mem_ = static_cast<T*>(mem);
+	}
+	FirstTouchArray(const FirstTouchArray&) = delete;
+	FirstTouchArray &operator=(const FirstTouchArray&) = delete;
+
+	::size_t size() const noexcept {
+		return size_;
+	}
+
+	T *begin() noexcept {
+		return mem_;
+	}
+	const T *begin() const noexcept {
+		return mem_;
+	}
+	T *end() noexcept {
+		return mem_ + size_;
+	}
+	const T *end() const noexcept {
+		return mem_ + size_;
+	}
+
+	T &operator[](const ::size_t i) noexcept {
+		return mem_[i];
+	}
+	const T &operator[](const ::size_t i) const noexcept {
+		return mem_[i];
+	}
+
+	~FirstTouchArray() noexcept {
+		if (mem_)
+			::munmap(mem_, size_ * sizeof(T));
+	}
+};
+
+} } /* namespace meave::par */
+
+#endif // MEAVE_LIB_PAR_TOPOLOGY_HPP_INCLUDED
@@ -0,0 +1,233 @@
+#ifndef MEAVE_LIB_PAR_WORKERS_HPP_INCLUDED
+#	define MEAVE_LIB_PAR_WORKERS_HPP_INCLUDED
+
+#	include <algorithm>
+#	include <atomic>
+#	include <condition_variable>
+#	include <cstdint>
+#	include <functional>
+#	include <mutex>
+#	include <thread>
+#	include <type_traits>
+#	include <utility>
+#	include <vector>
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/math/sum.hpp"
+#	include "meave/lib/trace.hpp"
+
+namespace meave { namespace par {
+
+/**
+ * Fixed pool of threads for data-parallel loops over [b, e).
+ *
+ * The calling thread always takes part in the work, so Workers(1) has
+ *   no threads at all and runs everything serially.
+ * Calls from inside of a running loop are evaluated serially by the
+ *   calling thread, nested loops therefore cannot deadlock.
+ */
+class Workers {
+private:
+	$::vector<$::thread> threads_;
+
+	$::mutex dispatch_mutex_;
+	$::mutex mutex_;
+	$::condition_variable cv_start_;
+	$::condition_variable cv_done_;
+	$::function<void(uns)> job_;
+	::uint64_t generation_;
+	uns pending_;
+	bool stop_;
+
+	static bool &inside() noexcept {
+		static thread_local bool $$ = false;
+		return $$;
+	}
+
+	void run(const uns th_id, const $::function<void(uns)> &on_start) noexcept {
+		if (on_start)
+			on_start(th_id);
+		inside() = true;
+		::uint64_t generation = 0;
+		for (;;) {
+			{
+				$::unique_lock<$::mutex> lock(mutex_);
+				cv_start_.wait(lock, [this, generation]() { return stop_ || generation_ != generation; });
+				if (stop_)
+					return;
+				generation = generation_;
+			}
+
+			{
+				const trace::Scope scope("task", "pool");
+				job_(th_id);
+			}
+
+			$::lock_guard<$::mutex> lock(mutex_);
+			if (!--pending_)
+				cv_done_.notify_one();
+		}
+	}
+
+	/**
+	 * Runs job(th_id) on every thread of the pool including the calling one
+	 *   and returns after all of them are finished.
+	 */
+	void dispatch(const $::function<void(uns)> &job) {
+		$::lock_guard<$::mutex> dispatch_lock(dispatch_mutex_);
+		{
+			$::lock_guard<$::mutex> lock(mutex_);
+			job_ = job;
+			pending_ = threads_.size();
+			++generation_;
+		}
+		cv_start_.notify_all();
+
+		inside() = true;
+		{
+			const trace::Scope scope("task", "pool");
+			job_(0);
+		}
+		inside() = false;
+
+		$::unique_lock<$::mutex> lock(mutex_);
+		cv_done_.wait(lock, [this]() { return !pending_; });
+	}
+
+public:
+	/**
+	 * @param on_start Called as on_start(th_id) by every thread before its
+	 *   first job, on_start(0) is called by the constructing thread. It's the
+	 *   place to bind threads to CPUs (see topology.hpp).
+	 */
+	explicit Workers(const uns threads_num, const $::function<void(uns)> &on_start = nullptr)
+	:	generation_(0)
+	,	pending_(0)
+	,	stop_(false) {
+		if (on_start)
+			on_start(0);
+		for (uns th_id = 1; th_id < threads_num; ++th_id) {
+			threads_.emplace_back([this, th_id, on_start]() { run(th_id, on_start); });
+		}
+	}
+	Workers(const Workers&) = delete;
+	Workers &operator=(const Workers&) = delete;
+
+	uns threads_num() const noexcept {
+		return threads_.size() + 1;
+	}
+
+	/**
+	 * @return [from, to) -- the slice of [b, e) that operator() gives to
+	 *   thread th_id .
+	 */
+	$::pair<uns, uns> slice(const uns b, const uns e, const uns th_id) const noexcept {
+		const uns n = threads_num();
+		return $::make_pair(uns(b + ::uint64_t(th_id) * (e - b) / n), uns(b + ::uint64_t(th_id + 1) * (e - b) / n));
+	}
+
+	/**
+	 * Calls fn(th_id) once on every thread of the pool, e.g. to first-touch
+	 *   the slice(b, e, th_id) that the thread works on later.
+	 */
+	template<typename Fn>
+	void for_threads(Fn &&fn) {
+		if (inside() || threads_.empty()) {
+			for (uns th_id = 0; th_id < threads_num(); ++th_id)
+				fn(th_id);
+			return;
+		}
+
+		dispatch([&fn](const uns th_id) { fn(th_id); });
+	}
+
+	/**
+	 * Calls fn(i) for every i from [b, e) .
+	 * Items are handed out one by one, so this is suitable also for items
+	 *   with very different costs. Order of calls is unspecified.
+	 */
+	template<typename Fn>
+	void for_each(const uns b, const uns e, Fn &&fn) {
+		if (inside() || threads_.empty() || e - b < 2) {
+			for (uns i = b; i < e; ++i)
+				fn(i);
+			return;
+		}
+
+		$::atomic<uns> next{b};
+		dispatch([&next, e, &fn](uns) {
+			for (uns i; (i = next.fetch_add(1, $::memory_order_relaxed)) < e; )
+				fn(i);
+		});
+	}
+
+	/**
+	 * @return Sum (operator+) of fn(i) for every i from [b, e) .
+	 * The range is split into one contiguous slice per thread and partial
+	 *   results are combined in order of slices, so for a given number of
+	 *   threads the result doesn't depend on scheduling.
+	 */
+	template<typename Fn>
+	auto operator()(const uns b, const uns e, Fn &&fn) -> typename $::decay<decltype(fn(b))>::type {
+		typedef typename $::decay<decltype(fn(b))>::type R;
+
+		if (inside() || threads_.empty()) {
+			R $$ = R();
+			for (uns i = b; i < e; ++i)
+				$$ = $$ + fn(i);
+			return $$;
+		}
+
+		$::vector<R> partials(threads_num());
+		dispatch([this, &partials, b, e, &fn](const uns th_id) {
+			const auto s = slice(b, e, th_id);
+			R r = R();
+			for (uns i = s.first; i < s.second; ++i)
+				r = r + fn(i);
+			partials[th_id] = r;
+		});
+
+		R $$ = R();
+		for (const R &r: partials)
+			$$ = $$ + r;
+		return $$;
+	}
+
+	/**
+	 * @return Compensated sum (meave/lib/math/sum.hpp) of floating point
+	 *   fn(i) for every i from [b, e), bit-identical for any number of threads:
+	 *   chunks of CHUNK consecutive items are summed in order of items, by
+	 *   whichever thread, and partial sums in order of chunks.
+	 */
+	template<typename Fn>
+	auto sum(const uns b, const uns e, Fn &&fn) -> typename $::decay<decltype(fn(b))>::type {
+		typedef typename $::decay<decltype(fn(b))>::type R;
+		enum : uns { CHUNK = 8 };
+
+		const uns chunks = (e - b + CHUNK - 1) / CHUNK;
+		$::vector<math::CompensatedSum<R>> partials(chunks);
+		for_each(0, chunks, [&partials, b, e, &fn](const uns c) {
+			for (uns i = b + c * CHUNK; i < $::min(e, b + (c + 1) * CHUNK); ++i)
+				partials[c].add(fn(i));
+		});
+
+		math::CompensatedSum<R> $$;
+		for (const auto &p: partials)
+			$$.add(p);
+		return $$.value();
+	}
+
+	~Workers() noexcept {
+		{
+			$::lock_guard<$::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		cv_start_.notify_all();
+		for (auto &th: threads_)
+			th.join();
+	}
+};
+
+} } /* namespace meave::par */
+
+#endif // MEAVE_LIB_PAR_WORKERS_HPP_INCLUDED
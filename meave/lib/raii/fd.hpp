@@ -26,6 +26,8 @@ namespace meave { namespace raii {
 
 		FD& operator=(const FD&) = delete;
 		FD& operator=(FD&&x) {
+			if (fd_ != -1 && fd_ != x.fd_)
+				::close(fd_);
 			fd_ = x.fd_;
 			x.fd_ = -1;
 
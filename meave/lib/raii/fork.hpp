@@ -3,6 +3,7 @@
 
 #	include <cstdlib>
 #	include <limits>
+#	include <sys/wait.h>
 #	include <unistd.h>
 
 #	include "meave/commons.hpp"
@@ -22,7 +23,7 @@ public:
 	:	pid_(-1) {
 	}
 	template<typename Fn, typename... Args>
-	explicit Fork(Fn &&fn, Args&&... args) throw(std::system_error) {
+	explicit Fork(Fn &&fn, Args&&... args) {
 		pid_ = ::fork();
 		switch (pid_) {
 		case 0: {
@@ -77,7 +78,7 @@ public:
 		return pid_;
 	}
 
-	int wait() throw(std::system_error) {
+	int wait() {
 		assert(pid_ != -1);
 
 		int status;
@@ -88,6 +89,24 @@ public:
 		pid_ = -1;
 		return status;
 	}
+	/**
+	 * Doesn't block.
+	 * @return Whether the process has finished, its status is then in status.
+	 */
+	bool try_wait(int &status) {
+		assert(pid_ != -1);
+
+		int ret;
+		while (-1 == (ret = waitpid(pid_, &status, WNOHANG))) {
+			if (errno != EINTR)
+				throw SE();
+		}
+		if (!ret)
+			return false;
+
+		pid_ = -1;
+		return true;
+	}
 	int wait(std::error_code &ec) noexcept {
 		assert(pid_ != -1);
 
@@ -31,7 +31,7 @@ namespace meave { namespace raii {
 			if (-1 == ::ftruncate(*fd, ::off_t(file_size)))
 				throw Error("Cannot resize file %s: %m", filename);
 
-			void *mem = ::mmap(0, file_size, PROT_WRITE, MAP_SHARED, *fd, 0);
+			void *mem = ::mmap(0, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
 			if (mem == MAP_FAILED)
 				throw Error("Cannot mmap: %s: %m", filename);
 
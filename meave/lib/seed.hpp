@@ -3,6 +3,7 @@
 
 #include "meave/commons.hpp"
 
+#include <atomic>
 #include <cstdlib>
 #include <functional>
 #include <thread>
@@ -12,7 +13,41 @@
 
 namespace meave {
 
-unsigned seed() noexcept {
+namespace aux {
+
+/**
+ * Position in the MEAVE_SEED sequence: stream of the process and calls of
+ *   seed() in it.
+ */
+struct SeedState {
+	std::atomic<unsigned> stream_;
+	std::atomic<unsigned> calls_;
+};
+
+inline SeedState &seed_state() noexcept {
+	static SeedState $${{0}, {0}};
+	return $$;
+}
+
+} /* namespace aux */
+
+/**
+ * @return Seed of a random generator, different in every call. With
+ *   environment variable MEAVE_SEED the sequence of seeds is fixed, e.g. for
+ *   benchmarks; generators seeded by different threads then get the same
+ *   seeds, in the order the threads call seed(). Forked processes get their
+ *   own sequences by seed_fork().
+ */
+inline unsigned seed() noexcept {
+	static const char *const fixed = ::getenv("MEAVE_SEED");
+	if (fixed) {
+		aux::SeedState &state = aux::seed_state();
+		// Distinct for up to 2^16 streams of 2^16 seeds, odd multiplier is a bijection.
+		const auto $$ = static_cast<unsigned>(::strtoul(fixed, nullptr, 0)) + 0x9e3779b9U * ((state.stream_ << 16) + state.calls_++);
+		DLOG(INFO) << "Seed: " << $$;
+		return $$;
+	}
+
 	struct timeval tv;
 	if (-1 == gettimeofday(&tv, nullptr)) {
 		::abort();
@@ -29,6 +64,20 @@ unsigned seed() noexcept {
 	return $$;
 }
 
+/**
+ * Starts the MEAVE_SEED sequence of the child-th (0, 1, ...) forked child
+ *   of this process, to be called in the child. Otherwise every child (an
+ *   island, a worker of a farm) would repeat the seeds of its siblings from
+ *   the point of the fork. The stream is derived from the stream of the
+ *   parent, so workers of different islands differ too (up to 256 children
+ *   per process). Seeds not fixed by MEAVE_SEED differ by the PID already.
+ */
+inline void seed_fork(const unsigned child) noexcept {
+	aux::SeedState &state = aux::seed_state();
+	state.stream_ = state.stream_ * 0x101U + child + 1;
+	state.calls_ = 0;
+}
+
 } /* namespace meave */
 
 #endif // MEAVE_SEED_HPP
@@ -0,0 +1,94 @@
+#ifndef MEAVE_LIB_SIMD_MATH_HPP_INCLUDED
+#	define MEAVE_LIB_SIMD_MATH_HPP_INCLUDED
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/simd/vec.hpp"
+
+/*
+ * Functions of meave/lib/math/funcs.hpp lane by lane, without libm. They
+ *   are in meave::simd (found by ADL), since a meave::math::exp() would hide
+ *   ::exp() in meave::math.
+ */
+
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace meave { namespace simd {
+
+namespace aux {
+
+template<typename T>
+struct ExpConsts;
+
+/**
+ * Range of x with normal results (wider x is clamped), ln(2) split to
+ *   hi + lo with n * hi exact (fdlibm) and the degree of the Taylor
+ *   polynomial for |r| <= ln(2)/2 below half an ulp.
+ */
+template<>
+struct ExpConsts<float> {
+	static constexpr float LO = -87.f, HI = +88.f;
+	static constexpr float LOG2E = 1.44269504f;
+	static constexpr float LN2_HI = 6.9314575195e-01f, LN2_LO = 1.4286067653e-06f;
+	enum : uns { DEGREE = 7 };
+};
+
+template<>
+struct ExpConsts<double> {
+	static constexpr double LO = -708., HI = +709.;
+	static constexpr double LOG2E = 1.4426950408889634;
+	static constexpr double LN2_HI = 6.93147180369123816490e-01, LN2_LO = 1.90821492927058770002e-10;
+	enum : uns { DEGREE = 13 };
+};
+
+template<typename T>
+constexpr T inv_factorial(const uns k) noexcept {
+	return k ? inv_factorial<T>(k - 1) / T(k) : T(1);
+}
+
+} /* namespace aux */
+
+/**
+ * exp(x) within 2 ulp: x = n*ln(2) + r, exp(r) by its Taylor polynomial
+ *   and 2^n by pow2(). x is clamped to [LO, HI] of aux::ExpConsts.
+ */
+template<typename T, uns N>
+MEAVE_SIMD_INLINE Vec<T, N> exp(const Vec<T, N> &arg) noexcept {
+	typedef aux::ExpConsts<T> C;
+	const Vec<T, N> x = min(max(arg, C::LO), C::HI);
+	const Vec<T, N> n = round(x * C::LOG2E);
+	const Vec<T, N> r = fnma(n, C::LN2_LO, fnma(n, C::LN2_HI, x));
+
+	Vec<T, N> p = aux::inv_factorial<T>(C::DEGREE);
+	for (int k = C::DEGREE - 1; k >= 0; --k)
+		p = fma(p, r, aux::inv_factorial<T>(k));
+	return p * pow2(n);
+}
+
+/**
+ * meave::math::sigmoid() of the lanes.
+ */
+template<typename T, uns N>
+MEAVE_SIMD_INLINE Vec<T, N> sigmoid(const Vec<T, N> &x) noexcept {
+	return 1 / (1 + exp(-x));
+}
+
+/**
+ * meave::math::aux::exp_pade22() of the lanes.
+ */
+template<uns N>
+MEAVE_SIMD_INLINE void exp_pade22(const Vec<float, N> &arg, Vec<float, N> &num, Vec<float, N> &den) noexcept {
+	const Vec<float, N> x = min(max(arg, -87.f), +88.f);
+	const Vec<float, N> n = round(x * 1.44269504f);
+	const Vec<float, N> r = fnma(n, 0.693147181f, x);
+
+	const Vec<float, N> r2 = r * r;
+	num = (fma(6.f, r, 12.f) + r2) * pow2(n);
+	den = fnma(6.f, r, 12.f) + r2;
+}
+
+} } /* namespace meave::simd */
+
+#	pragma GCC diagnostic pop
+
+#endif // MEAVE_LIB_SIMD_MATH_HPP_INCLUDED
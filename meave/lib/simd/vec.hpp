@@ -0,0 +1,431 @@
+#ifndef MEAVE_LIB_SIMD_VEC_HPP_INCLUDED
+#	define MEAVE_LIB_SIMD_VEC_HPP_INCLUDED
+
+#	include <cmath>
+#	include <cstdint>
+#	include <cstring>
+#	include <limits>
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/cpu.hpp"
+
+/*
+ * Vec<T, N> -- N lanes of float or double, a GCC vector with operators.
+ *   There is one implementation for all instruction sets: code of a Vec
+ *   is always inlined and compiled for the kernel it is inlined into, so
+ *   Vec<float, 16> is a zmm register in a MEAVE_TARGET(MEAVE_ISA_AVX512)
+ *   kernel, two ymm in an AVX2 one and four xmm in a scalar one. Native<T,
+ *   level> is the width of the level (one lane for cpu::SCALAR) and a kernel
+ *   for every level is a template over it, e.g.
+ *
+ *	template<typename V> MEAVE_SIMD_INLINE void body(float *p, uns len);
+ *	MEAVE_TARGET(MEAVE_ISA_AVX2)
+ *	void avx2(float *p, uns len) { body<simd::Native<float, cpu::AVX2>>(p, len); }
+ *
+ *   Intrinsics could not be used here: an always_inline function with them
+ *   needs the target of its caller, which a template body cannot have.
+ *   fma() is fused where the target has FMA (-ffp-contract=fast, the
+ *   default of -std=gnu++*); the experiments are built with
+ *   -ffp-contract=off, so that the levels don't differ by it.
+ */
+
+/**
+ * Inlined into the caller whatever the optimization, so that it gets the
+ *   instruction set of the caller.
+ */
+#	define MEAVE_SIMD_INLINE __attribute__((always_inline)) inline
+
+// Vectors are passed only between always_inline functions; still, none
+//   is returned bare and none is passed by value, GCC notes even those.
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace meave { namespace simd {
+
+namespace aux {
+
+template<typename T>
+struct Traits;
+
+template<>
+struct Traits<float> {
+	typedef ::int32_t Int;
+	static constexpr int MANT_BITS = 23;
+	static constexpr Int BIAS = 127;
+	/// 1.5 * 2^MANT_BITS, an integer n < 2^22 added to it is in its low bits.
+	static constexpr float MAGIC = 12582912.f;
+	static constexpr Int MAGIC_BITS = 0x4B400000;
+};
+
+template<>
+struct Traits<double> {
+	typedef ::int64_t Int;
+	static constexpr int MANT_BITS = 52;
+	static constexpr Int BIAS = 1023;
+	static constexpr double MAGIC = 6755399441055744.;
+	static constexpr Int MAGIC_BITS = 0x4338000000000000LL;
+};
+
+} /* namespace aux */
+
+/**
+ * @return Lanes of T in a register of level.
+ */
+template<typename T>
+constexpr uns lanes(const cpu::Level level) noexcept {
+	return level >= cpu::AVX512 ? 64 / sizeof(T) : level >= cpu::AVX2 ? 32 / sizeof(T) : level >= cpu::SSE42 ? 16 / sizeof(T) : 1;
+}
+
+template<typename T, uns N>
+class Vec;
+
+/**
+ * Result of a comparison of Vec<T, N>: a lane is all ones or zero.
+ */
+template<typename T, uns N>
+class Mask {
+public:
+	typedef typename aux::Traits<T>::Int Int;
+	typedef Int Raw __attribute__((vector_size(N * sizeof(T))));
+
+private:
+	Raw m_;
+
+public:
+	Mask() = default;
+
+	MEAVE_SIMD_INLINE explicit Mask(const Raw &m) noexcept
+	:	m_(m) {
+	}
+
+	/**
+	 * Lanes below n set, e.g. for the tail of an array.
+	 */
+	MEAVE_SIMD_INLINE static Mask first(const uns n) noexcept {
+		Raw $$;
+		for (uns l = 0; l < N; ++l)
+			$$[l] = l < n ? -1 : 0;
+		return Mask($$);
+	}
+
+	MEAVE_SIMD_INLINE const Raw &raw() const noexcept {
+		return m_;
+	}
+
+	MEAVE_SIMD_INLINE bool operator[](const uns l) const noexcept {
+		return m_[l];
+	}
+
+	MEAVE_SIMD_INLINE bool any() const noexcept {
+		Int $$ = 0;
+		for (uns l = 0; l < N; ++l)
+			$$ |= m_[l];
+		return $$;
+	}
+
+	MEAVE_SIMD_INLINE bool all() const noexcept {
+		Int $$ = -1;
+		for (uns l = 0; l < N; ++l)
+			$$ &= m_[l];
+		return $$;
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator&(const Mask &a, const Mask &b) noexcept {
+		return Mask(a.m_ & b.m_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator|(const Mask &a, const Mask &b) noexcept {
+		return Mask(a.m_ | b.m_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator^(const Mask &a, const Mask &b) noexcept {
+		return Mask(a.m_ ^ b.m_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator~(const Mask &a) noexcept {
+		return Mask(~a.m_);
+	}
+};
+
+template<typename T, uns N>
+class Vec {
+	static_assert(N && !(N & (N - 1)), "N must be a power of two");
+
+public:
+	enum : uns { LANES = N };
+
+	typedef T Raw __attribute__((vector_size(N * sizeof(T))));
+	typedef simd::Mask<T, N> Mask;
+
+private:
+	typedef aux::Traits<T> Traits;
+	typedef typename Mask::Int Int;
+	typedef typename Mask::Raw RawInt;
+
+	Raw v_;
+
+public:
+	Vec() = default;
+
+	/**
+	 * All lanes x, also an implicit conversion: v * 2.f
+	 */
+	MEAVE_SIMD_INLINE Vec(const T x) noexcept {
+		for (uns l = 0; l < N; ++l)
+			v_[l] = x;
+	}
+
+	MEAVE_SIMD_INLINE explicit Vec(const Raw &v) noexcept
+	:	v_(v) {
+	}
+
+	MEAVE_SIMD_INLINE static Vec zero() noexcept {
+		return Vec(Raw{});
+	}
+
+	MEAVE_SIMD_INLINE const Raw &raw() const noexcept {
+		return v_;
+	}
+
+	MEAVE_SIMD_INLINE T operator[](const uns l) const noexcept {
+		return v_[l];
+	}
+
+	/**
+	 * N elements of p, no alignment needed.
+	 */
+	MEAVE_SIMD_INLINE static Vec load(const T *p) noexcept {
+		Vec $$;
+		::memcpy(&$$.v_, p, sizeof($$.v_));
+		return $$;
+	}
+
+	/**
+	 * The first n < N elements of p, other lanes zero; reads nothing past
+	 *   p[n - 1].
+	 */
+	MEAVE_SIMD_INLINE static Vec load(const T *p, const uns n) noexcept {
+		Vec $$ = zero();
+		for (uns l = 0; l < N; ++l) {
+			if (l < n)
+				$$.v_[l] = p[l];
+		}
+		return $$;
+	}
+
+	/**
+	 * p[l] = base[idx[l]]
+	 */
+	MEAVE_SIMD_INLINE static Vec gather(const T *base, const ::int32_t idx[N]) noexcept {
+		Vec $$;
+		for (uns l = 0; l < N; ++l)
+			$$.v_[l] = base[idx[l]];
+		return $$;
+	}
+
+	MEAVE_SIMD_INLINE void store(T *p) const noexcept {
+		::memcpy(p, &v_, sizeof(v_));
+	}
+
+	/**
+	 * The first n < N lanes to p, writes nothing past p[n - 1].
+	 */
+	MEAVE_SIMD_INLINE void store(T *p, const uns n) const noexcept {
+		for (uns l = 0; l < N; ++l) {
+			if (l < n)
+				p[l] = v_[l];
+		}
+	}
+
+	MEAVE_SIMD_INLINE Vec operator-() const noexcept {
+		return Vec(-v_);
+	}
+
+	MEAVE_SIMD_INLINE Vec &operator+=(const Vec &x) noexcept {
+		v_ += x.v_;
+		return *this;
+	}
+
+	MEAVE_SIMD_INLINE Vec &operator-=(const Vec &x) noexcept {
+		v_ -= x.v_;
+		return *this;
+	}
+
+	MEAVE_SIMD_INLINE Vec &operator*=(const Vec &x) noexcept {
+		v_ *= x.v_;
+		return *this;
+	}
+
+	MEAVE_SIMD_INLINE Vec &operator/=(const Vec &x) noexcept {
+		v_ /= x.v_;
+		return *this;
+	}
+
+	MEAVE_SIMD_INLINE friend Vec operator+(const Vec &a, const Vec &b) noexcept {
+		return Vec(a.v_ + b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Vec operator-(const Vec &a, const Vec &b) noexcept {
+		return Vec(a.v_ - b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Vec operator*(const Vec &a, const Vec &b) noexcept {
+		return Vec(a.v_ * b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Vec operator/(const Vec &a, const Vec &b) noexcept {
+		return Vec(a.v_ / b.v_);
+	}
+
+	/**
+	 * a * b + c
+	 */
+	MEAVE_SIMD_INLINE friend Vec fma(const Vec &a, const Vec &b, const Vec &c) noexcept {
+		return Vec(a.v_ * b.v_ + c.v_);
+	}
+
+	/**
+	 * c - a * b
+	 */
+	MEAVE_SIMD_INLINE friend Vec fnma(const Vec &a, const Vec &b, const Vec &c) noexcept {
+		return Vec(c.v_ - a.v_ * b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator<(const Vec &a, const Vec &b) noexcept {
+		return Mask(a.v_ < b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator<=(const Vec &a, const Vec &b) noexcept {
+		return Mask(a.v_ <= b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator>(const Vec &a, const Vec &b) noexcept {
+		return Mask(a.v_ > b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator>=(const Vec &a, const Vec &b) noexcept {
+		return Mask(a.v_ >= b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator==(const Vec &a, const Vec &b) noexcept {
+		return Mask(a.v_ == b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Mask operator!=(const Vec &a, const Vec &b) noexcept {
+		return Mask(a.v_ != b.v_);
+	}
+
+	/**
+	 * Lanes of b where m is set, of a elsewhere (as blendv).
+	 */
+	MEAVE_SIMD_INLINE friend Vec blend(const Mask &m, const Vec &a, const Vec &b) noexcept {
+		return Vec(m.raw() ? b.v_ : a.v_);
+	}
+
+	/**
+	 * Like minps: b where either is NaN.
+	 */
+	MEAVE_SIMD_INLINE friend Vec min(const Vec &a, const Vec &b) noexcept {
+		return Vec(a.v_ < b.v_ ? a.v_ : b.v_);
+	}
+
+	MEAVE_SIMD_INLINE friend Vec max(const Vec &a, const Vec &b) noexcept {
+		return Vec(a.v_ > b.v_ ? a.v_ : b.v_);
+	}
+
+	/**
+	 * min() and max() of a scalar, e.g. a constant bound: GCC 12 compiles
+	 *   those of a constant vector to cmpps and blendvps instead of minps or
+	 *   maxps (unless -ffinite-math-only -fno-signed-zeros), so the empty asm
+	 *   hides the value (any scalar float fits an xmm register).
+	 */
+	MEAVE_SIMD_INLINE friend Vec min(const Vec &a, T b) noexcept {
+		__asm__("" : "+x"(b));
+		return min(a, Vec(b));
+	}
+
+	MEAVE_SIMD_INLINE friend Vec max(const Vec &a, T b) noexcept {
+		__asm__("" : "+x"(b));
+		return max(a, Vec(b));
+	}
+
+	MEAVE_SIMD_INLINE friend Vec abs(const Vec &a) noexcept {
+		return Vec(Raw(RawInt(a.v_) & $::numeric_limits<Int>::max()));
+	}
+
+	/**
+	 * To the nearest integer, ties to even (in the default rounding mode).
+	 */
+	MEAVE_SIMD_INLINE friend Vec round(const Vec &a) noexcept {
+		Vec $$;
+		for (uns l = 0; l < N; ++l)
+			$$.v_[l] = $::rint(a.v_[l]);
+		return $$;
+	}
+
+	/**
+	 * To the integer towards zero, as a cast to an integer (of a value that
+	 *   fits).
+	 */
+	MEAVE_SIMD_INLINE friend Vec trunc(const Vec &a) noexcept {
+		Vec $$;
+		for (uns l = 0; l < N; ++l)
+			$$.v_[l] = $::trunc(a.v_[l]);
+		return $$;
+	}
+
+	MEAVE_SIMD_INLINE friend Vec sqrt(const Vec &a) noexcept {
+		Vec $$;
+		for (uns l = 0; l < N; ++l)
+			$$.v_[l] = $::sqrt(a.v_[l]);
+		return $$;
+	}
+
+	/**
+	 * 2^n for integral n of normal results (-126 <= n <= 127 for float),
+	 *   assembled in the exponent bits.
+	 */
+	MEAVE_SIMD_INLINE friend Vec pow2(const Vec &n) noexcept {
+		const RawInt i = RawInt(n.v_ + Traits::MAGIC) - Traits::MAGIC_BITS;
+		return Vec(Raw((i + Traits::BIAS) << Traits::MANT_BITS));
+	}
+
+	/**
+	 * Sums of lanes by halves: (a0 + a2) + (a1 + a3) for four lanes, the
+	 *   same order whatever the instruction set.
+	 */
+	MEAVE_SIMD_INLINE friend T reduce_add(const Vec &a) noexcept {
+		Raw t = a.v_;
+		for (uns w = N / 2; w; w /= 2) {
+			for (uns l = 0; l < w; ++l)
+				t[l] += t[l + w];
+		}
+		return t[0];
+	}
+
+	MEAVE_SIMD_INLINE friend T reduce_min(const Vec &a) noexcept {
+		T $$ = a.v_[0];
+		for (uns l = 1; l < N; ++l)
+			$$ = a.v_[l] < $$ ? a.v_[l] : $$;
+		return $$;
+	}
+
+	MEAVE_SIMD_INLINE friend T reduce_max(const Vec &a) noexcept {
+		T $$ = a.v_[0];
+		for (uns l = 1; l < N; ++l)
+			$$ = a.v_[l] > $$ ? a.v_[l] : $$;
+		return $$;
+	}
+};
+
+/**
+ * Vec of the width of level, at most MAX lanes.
+ */
+template<typename T, cpu::Level LEVEL, uns MAX = 64>
+using Native = Vec<T, (lanes<T>(LEVEL) < MAX ? lanes<T>(LEVEL) : MAX)>;
+
+} } /* namespace meave::simd */
+
+#	pragma GCC diagnostic pop
+
+#endif // MEAVE_LIB_SIMD_VEC_HPP_INCLUDED
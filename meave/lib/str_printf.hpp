@@ -7,7 +7,7 @@
 
 namespace meave {
 
-std::string
+inline std::string
 str_printf(const char *msg, va_list args) noexcept
 {
 	va_list args2;
@@ -24,7 +24,7 @@ str_printf(const char *msg, va_list args) noexcept
 	return ret;
 }
 
-std::string
+inline std::string
 str_printf(const char *msg, ...) noexcept
 {
 	va_list args;
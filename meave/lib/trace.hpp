@@ -0,0 +1,344 @@
+#ifndef MEAVE_LIB_TRACE_HPP_INCLUDED
+#	define MEAVE_LIB_TRACE_HPP_INCLUDED
+
+#	include <atomic>
+#	include <chrono>
+#	include <condition_variable>
+#	include <cstdint>
+#	include <cstdio>
+#	include <cstdlib>
+#	include <memory>
+#	include <mutex>
+#	include <thread>
+#	include <vector>
+
+#	include <time.h>
+#	include <unistd.h>
+
+#	if defined(__x86_64__) || defined(__i386__)
+#		include <x86intrin.h>
+#	endif
+
+#	include "meave/commons.hpp"
+#	include "meave/lib/error.hpp"
+
+namespace meave { namespace trace {
+
+/**
+ * @return Timestamp counter, CLOCK_MONOTONIC nanoseconds where there is none.
+ */
+inline ::uint64_t ticks() noexcept {
+#	if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#	else
+	struct ::timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#	endif
+}
+
+/**
+ * Span of a phase on one thread, written as a complete event ("ph": "X")
+ *   of Chrome trace-event format: one record for the begin and the end, so
+ *   a dropped record never leaves an unmatched begin.
+ */
+struct Event {
+	const char *name_;	///< String literal, stored by pointer.
+	const char *cat_;
+	::uint64_t begin_;
+	::uint64_t end_;
+};
+
+/**
+ * Ring buffer of events of one thread: the thread pushes, the flusher
+ *   drains. When the flusher lags behind, events are dropped and counted,
+ *   the thread never waits.
+ */
+class Buffer {
+private:
+	enum : uns { CAPACITY = 1 << 14 };
+
+	Event events_[CAPACITY];
+	$::atomic< ::uint64_t> head_;	///< Written by the thread.
+	char pad_[64];			///< head_ and tail_ on different cache lines.
+	$::atomic< ::uint64_t> tail_;	///< Written by the flusher.
+	$::atomic< ::uint64_t> dropped_;
+	const uns tid_;
+
+public:
+	explicit Buffer(const uns tid) noexcept
+	:	head_(0)
+	,	tail_(0)
+	,	dropped_(0)
+	,	tid_(tid) {
+	}
+
+	uns tid() const noexcept {
+		return tid_;
+	}
+
+	::uint64_t dropped() const noexcept {
+		return dropped_.load($::memory_order_relaxed);
+	}
+
+	void push(const Event &e) noexcept {
+		const ::uint64_t head = head_.load($::memory_order_relaxed);
+		if (head - tail_.load($::memory_order_acquire) == CAPACITY) {
+			dropped_.fetch_add(1, $::memory_order_relaxed);
+			return;
+		}
+		events_[head % CAPACITY] = e;
+		head_.store(head + 1, $::memory_order_release);
+	}
+
+	/**
+	 * Calls fn(event) for every event pushed so far, by the flusher only.
+	 */
+	template<typename Fn>
+	void drain(Fn &&fn) {
+		::uint64_t tail = tail_.load($::memory_order_relaxed);
+		const ::uint64_t head = head_.load($::memory_order_acquire);
+		for (; tail < head; ++tail)
+			fn(events_[tail % CAPACITY]);
+		tail_.store(tail, $::memory_order_release);
+	}
+};
+
+/**
+ * Process-wide tracer: threads record events into their own Buffer, a
+ *   background thread writes them every FLUSH_MS to a JSON array of Chrome
+ *   trace events (chrome://tracing, Perfetto).
+ *
+ * While tracing is off, recording costs one relaxed load and a branch.
+ *   The trace of a killed run lacks only the closing bracket, which trace
+ *   viewers accept.
+ */
+class Tracer {
+private:
+	enum : uns { FLUSH_MS = 100 };
+
+	$::mutex mutex_;
+	$::vector<$::unique_ptr<Buffer>> buffers_;	///< Kept after their threads exit, until drained.
+	$::FILE *out_;
+	bool first_;
+	::uint64_t ticks0_;
+	double us_per_tick_;
+	::uint64_t dropped_;
+
+	$::mutex flush_mutex_;
+	$::condition_variable cv_stop_;
+	bool stop_;
+	$::thread flusher_;
+
+	Tracer() noexcept
+	:	out_(nullptr)
+	,	first_(true)
+	,	ticks0_(0)
+	,	us_per_tick_(0)
+	,	dropped_(0)
+	,	stop_(false) {
+	}
+
+	static $::atomic<bool> &on() noexcept {
+		// Constant-initialized, so the check needs no guard of a local static.
+		static $::atomic<bool> $$(false);
+		return $$;
+	}
+
+	static Buffer *&local() noexcept {
+		static thread_local Buffer *$$ = nullptr;
+		return $$;
+	}
+
+	Buffer &buffer() {
+		if (!local()) {
+			$::lock_guard<$::mutex> lock(mutex_);
+			buffers_.emplace_back(new Buffer(buffers_.size()));
+			local() = buffers_.back().get();
+		}
+		return *local();
+	}
+
+	/**
+	 * @return Microseconds per tick, measured against the monotonic clock.
+	 */
+	static double calibrate() noexcept {
+		const auto t0 = $::chrono::steady_clock::now();
+		const ::uint64_t c0 = ticks();
+		$::this_thread::sleep_for($::chrono::milliseconds(20));
+		const ::uint64_t c1 = ticks();
+		const auto t1 = $::chrono::steady_clock::now();
+		return $::chrono::duration<double, $::micro>(t1 - t0).count() / (c1 - c0);
+	}
+
+	/**
+	 * Writes events of all buffers, under mutex_.
+	 */
+	void write() {
+		const int pid = ::getpid();
+		for (auto &buffer: buffers_) {
+			buffer->drain([this, pid, &buffer](const Event &e) {
+				const double ts = ::int64_t(e.begin_ - ticks0_) * us_per_tick_;
+				const double dur = (e.end_ - e.begin_) * us_per_tick_;
+				::fprintf(out_, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u}",
+					first_ ? "\n" : ",\n", e.name_, e.cat_, ts, dur, pid, buffer->tid());
+				first_ = false;
+			});
+		}
+		::fflush(out_);
+	}
+
+	void flush_loop() {
+		$::unique_lock<$::mutex> flush_lock(flush_mutex_);
+		while (!cv_stop_.wait_for(flush_lock, $::chrono::milliseconds(FLUSH_MS), [this]() { return stop_; })) {
+			$::lock_guard<$::mutex> lock(mutex_);
+			write();
+		}
+	}
+
+public:
+	Tracer(const Tracer&) = delete;
+	Tracer &operator=(const Tracer&) = delete;
+
+	static Tracer &instance() {
+		static Tracer $$;
+		return $$;
+	}
+
+	static bool enabled() noexcept {
+		return on().load($::memory_order_relaxed);
+	}
+
+	/**
+	 * Records e if tracing is on, from any thread.
+	 */
+	static void record(const Event &e) {
+		if (enabled())
+			instance().buffer().push(e);
+	}
+
+	/**
+	 * Starts writing events to file_name .
+	 */
+	void start(const char *file_name) {
+		$::lock_guard<$::mutex> lock(mutex_);
+		if (out_)
+			throw Error("Tracing already started");
+		out_ = ::fopen(file_name, "w");
+		if (!out_)
+			throw Error("Cannot open: %s: %m", file_name);
+		::fputs("[", out_);
+		first_ = true;
+		us_per_tick_ = calibrate();
+		ticks0_ = ticks();
+		stop_ = false;
+		flusher_ = $::thread([this]() { flush_loop(); });
+		on().store(true, $::memory_order_relaxed);
+	}
+
+	/**
+	 * Switches recording off and on while the trace is open, e.g. to trace
+	 *   only a part of a run.
+	 */
+	void pause() noexcept {
+		on().store(false, $::memory_order_relaxed);
+	}
+
+	void resume() noexcept {
+		$::lock_guard<$::mutex> lock(mutex_);
+		on().store(out_ != nullptr, $::memory_order_relaxed);
+	}
+
+	/**
+	 * Writes the remaining events and closes the trace.
+	 * @return Events dropped because the flusher couldn't keep up.
+	 */
+	::uint64_t stop() {
+		on().store(false, $::memory_order_relaxed);
+		{
+			$::lock_guard<$::mutex> flush_lock(flush_mutex_);
+			stop_ = true;
+		}
+		cv_stop_.notify_all();
+		if (flusher_.joinable())
+			flusher_.join();
+
+		$::lock_guard<$::mutex> lock(mutex_);
+		if (!out_)
+			return 0;
+		write();
+		::fputs("\n]\n", out_);
+		::fclose(out_);
+		out_ = nullptr;
+		::uint64_t $$ = 0;
+		for (const auto &$: buffers_)
+			$$ += $->dropped();
+		$$ -= dropped_;
+		dropped_ += $$;
+		return $$;
+	}
+};
+
+/**
+ * Traces the scope as event name of category cat; both must be string
+ *   literals.
+ */
+class Scope {
+private:
+	const char *name_;
+	const char *cat_;
+	::uint64_t begin_;	///< 0 -- not traced.
+
+public:
+	Scope(const char *name, const char *cat) noexcept
+	:	name_(name)
+	,	cat_(cat)
+	,	begin_(Tracer::enabled() ? ticks() : 0) {
+	}
+	Scope(const Scope&) = delete;
+	Scope &operator=(const Scope&) = delete;
+
+	~Scope() noexcept {
+		if (begin_)
+			Tracer::record(Event{name_, cat_, begin_, ticks()});
+	}
+};
+
+/**
+ * Trace of the whole run to the file named by environment variable
+ *   MEAVE_TRACE, nothing is recorded without it. A trace that cannot be
+ *   written is logged, the run goes on without it.
+ */
+class Session {
+private:
+	bool started_;
+
+public:
+	Session()
+	:	started_(false) {
+		const char *file_name = ::getenv("MEAVE_TRACE");
+		if (!file_name)
+			return;
+		try {
+			Tracer::instance().start(file_name);
+			started_ = true;
+			LOG(INFO) << "Tracing to " << file_name;
+		} catch (const Error &e) {
+			LOG(ERROR) << "No tracing: " << e.what();
+		}
+	}
+	Session(const Session&) = delete;
+	Session &operator=(const Session&) = delete;
+
+	~Session() noexcept {
+		if (!started_)
+			return;
+		const ::uint64_t dropped = Tracer::instance().stop();
+		if (dropped)
+			LOG(WARNING) << "Tracing dropped " << dropped << " events";
+	}
+};
+
+} } /* namespace meave::trace */
+
+#endif // MEAVE_LIB_TRACE_HPP_INCLUDED